@@ -0,0 +1,1025 @@
+// BuLang Benchmark Runner - Console only (no graphics)
+// Runs all .bu scripts in scripts/bench under each VM variant and reports timings,
+// per-frame time for process scenes and peak memory of each run
+
+#include "interpreter.hpp"
+#include "platform.hpp"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <thread>
+
+// ============================================================
+// Colors
+// ============================================================
+#define C_RESET   "\033[0m"
+#define C_RED     "\033[1;31m"
+#define C_GREEN   "\033[1;32m"
+#define C_CYAN    "\033[1;36m"
+
+// ============================================================
+// Helpers
+// ============================================================
+static std::string loadFile(const char *path)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) return "";
+    return std::string((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+}
+
+static std::vector<std::string> listBuFiles(const char *dir)
+{
+    std::vector<std::string> files;
+    DIR *d = opendir(dir);
+    if (!d) return files;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != nullptr)
+    {
+        std::string name = entry->d_name;
+        if (name.size() > 3 && name.substr(name.size() - 3) == ".bu")
+        {
+            files.push_back(std::string(dir) + "/" + name);
+        }
+    }
+    closedir(d);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static std::string getBasename(const std::string &path)
+{
+    size_t pos = path.find_last_of('/');
+    return (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+
+static double nowMs()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// VM logs (Info, dump messages) go to /dev/null while timing
+struct QuietScope
+{
+    int savedOut, savedErr;
+    bool active;
+
+    explicit QuietScope(bool enable) : savedOut(-1), savedErr(-1), active(enable)
+    {
+        if (!active) return;
+        fflush(stdout);
+        fflush(stderr);
+        savedOut = dup(1);
+        savedErr = dup(2);
+        int devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, 1);
+        dup2(devNull, 2);
+        close(devNull);
+    }
+
+    ~QuietScope()
+    {
+        if (!active) return;
+        fflush(stdout);
+        fflush(stderr);
+        dup2(savedOut, 1);
+        dup2(savedErr, 2);
+        close(savedOut);
+        close(savedErr);
+    }
+};
+
+// ============================================================
+// VM variants: each script runs once per variant
+// ============================================================
+struct Variant
+{
+    const char *name;
+    void (*configure)(Interpreter &vm);
+};
+
+static void configureDefault(Interpreter &vm) { (void)vm; }
+static void configureNoQuickening(Interpreter &vm) { vm.setQuickening(false); }
+static void configureNoSuper(Interpreter &vm) { vm.setSuperinstructions(false); }
+static void configureNoRegisterTier(Interpreter &vm) { vm.setRegisterTier(false); }
+static void configureNoDirectCalls(Interpreter &vm) { vm.setDirectCalls(false); }
+static void configureNoFolding(Interpreter &vm) { vm.setConstantFolding(false); }
+static void configureNoPeephole(Interpreter &vm) { vm.setPeephole(false); }
+static void configureNoInline(Interpreter &vm) { vm.setInlining(false); }
+static void configureNoSwitchTable(Interpreter &vm) { vm.setSwitchTables(false); }
+static void configureNoIncrementalGC(Interpreter &vm) { vm.setIncrementalGC(false); }
+static void configureNoNursery(Interpreter &vm) { vm.setGenerationalGC(false); }
+
+static const Variant variants[] = {
+    {"default", configureDefault},
+    {"no-quicken", configureNoQuickening},
+    {"no-super", configureNoSuper},
+    {"no-regtier", configureNoRegisterTier},
+    {"no-direct", configureNoDirectCalls},
+    {"no-fold", configureNoFolding},
+    {"no-peephole", configureNoPeephole},
+    {"no-inline", configureNoInline},
+    {"no-swtable", configureNoSwitchTable},
+    {"no-incgc", configureNoIncrementalGC},
+    {"no-nursery", configureNoNursery},
+};
+static const int variantCount = sizeof(variants) / sizeof(variants[0]);
+
+// ============================================================
+// Run one script: elapsed ms (compile + run), ms per frame and peak RSS
+// ============================================================
+static const int MAX_FRAMES = 100000;
+static const int GC_FRAME_BUDGET_US = 1000; // gcStep por frame, como em main/src/main.cpp
+
+struct RunResult
+{
+    double ms;       // -1 on error
+    double frameMs;  // 0 se o script não tem processos
+    long peakKb;
+};
+
+static RunResult runScript(const std::string &code, const Variant &variant, bool verbose)
+{
+    RunResult result = {-1.0, 0.0, 0};
+    QuietScope quiet(!verbose);
+
+    Interpreter vm;
+    vm.registerAll();
+    variant.configure(vm);
+
+    double start = nowMs();
+    bool ok = vm.run(code.c_str(), false);
+
+    // Scripts com processos: corre frames até todos terminarem
+    double framesStart = nowMs();
+    int frames = 0;
+    for (; ok && frames < MAX_FRAMES && vm.getTotalAliveProcesses() > 0; frames++)
+    {
+        vm.update(1.0f / 60.0f);
+        vm.gcStep(GC_FRAME_BUDGET_US);
+    }
+    double end = nowMs();
+
+    if (ok)
+    {
+        result.ms = end - start;
+        result.frameMs = frames > 0 ? (end - framesStart) / frames : 0.0;
+    }
+    return result;
+}
+
+// Cada run num processo filho: o pico de RSS (ru_maxrss) fica isolado por run
+static RunResult runScriptForked(const std::string &code, const Variant &variant, bool verbose)
+{
+    RunResult result = {-1.0, 0.0, 0};
+    int fds[2];
+    if (pipe(fds) != 0) return result;
+
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return result;
+    }
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+        RunResult child = runScript(code, variant, verbose);
+        ssize_t written = write(fds[1], &child, sizeof(child));
+        _exit(written == (ssize_t)sizeof(child) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    RunResult child;
+    bool received = read(fds[0], &child, sizeof(child)) == (ssize_t)sizeof(child);
+    close(fds[0]);
+
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    wait4(pid, &status, 0, &usage);
+
+    if (received && WIFEXITED(status) && WEXITSTATUS(status) == 0)
+    {
+        result = child;
+        result.peakKb = usage.ru_maxrss;
+    }
+    return result;
+}
+
+// ============================================================
+// Startup: compile da fonte vs load do .buc (sem correr o script)
+// ============================================================
+struct StartupResult
+{
+    double compileMs; // -1 on error
+    double loadMs;    // -1 on error
+    long bucBytes;
+};
+
+static double timeCompile(const std::string &code)
+{
+    Interpreter vm;
+    vm.registerAll();
+    double start = nowMs();
+    bool ok = vm.compile(code.c_str(), false);
+    double end = nowMs();
+    return ok ? end - start : -1.0;
+}
+
+static double timeLoad(const std::string &code, const char *cachePath)
+{
+    Interpreter vm;
+    vm.registerAll();
+    double start = nowMs();
+    bool ok = vm.loadBytecode(cachePath, code.c_str());
+    double end = nowMs();
+    return ok ? end - start : -1.0;
+}
+
+static StartupResult measureStartup(const std::string &code, int runs, bool verbose)
+{
+    StartupResult result = {-1.0, -1.0, 0};
+    QuietScope quiet(!verbose);
+
+    char cachePath[64];
+    snprintf(cachePath, sizeof(cachePath), "/tmp/bu_bench_%d.buc", (int)getpid());
+    {
+        Interpreter vm;
+        vm.registerAll();
+        if (!vm.compile(code.c_str(), false) || !vm.saveBytecode(cachePath, code.c_str()))
+        {
+            remove(cachePath);
+            return result;
+        }
+    }
+
+    FILE *f = fopen(cachePath, "rb");
+    if (f)
+    {
+        fseek(f, 0, SEEK_END);
+        result.bucBytes = ftell(f);
+        fclose(f);
+    }
+
+    for (int r = 0; r < runs; r++)
+    {
+        double c = timeCompile(code);
+        double l = timeLoad(code, cachePath);
+        if (c < 0.0 || l < 0.0)
+        {
+            result.compileMs = result.loadMs = -1.0;
+            break;
+        }
+        if (r == 0 || c < result.compileMs) result.compileMs = c;
+        if (r == 0 || l < result.loadMs) result.loadMs = l;
+    }
+
+    remove(cachePath);
+    return result;
+}
+
+// ============================================================
+// Compile throughput: MB/s de fonte num script grande gerado
+// (nomes únicos por unidade: identificadores, strings, números, classes)
+// ============================================================
+static std::string makeCompileSource(int units, int first = 0)
+{
+    std::string src;
+    char buf[1024];
+    for (int i = first; i < first + units; i++)
+    {
+        snprintf(buf, sizeof(buf),
+                 "struct Particle_%d { position_x, position_y, velocity_x, velocity_y }\n"
+                 "def update_particle_%d(particle, delta_time) {\n"
+                 "    var gravity_constant = 9.81;\n"
+                 "    var drag_coefficient = 0x1F;\n"
+                 "    particle.velocity_y = particle.velocity_y + gravity_constant * delta_time;\n"
+                 "    for (var step = 0; step < 4; step++) {\n"
+                 "        if (step == 2 && particle.position_y > 100) { particle.velocity_y = -particle.velocity_y; }\n"
+                 "    }\n"
+                 "    var label_text = \"particle %d\\tupdated\\n\";\n"
+                 "    var config = {name: \"spark\", \"max_speed\": 12.5, count: %d};\n"
+                 "    return particle.position_x + particle.velocity_x * delta_time / drag_coefficient;\n"
+                 "}\n"
+                 "class Emitter_%d {\n"
+                 "    var spawn_rate;\n"
+                 "    var particle_list;\n"
+                 "    def init(rate) { self.spawn_rate = rate; self.particle_list = []; }\n"
+                 "    def emit(count) {\n"
+                 "        foreach (existing in self.particle_list) { update_particle_%d(existing, 0.016); }\n"
+                 "        return len(self.particle_list) + count * self.spawn_rate;\n"
+                 "    }\n"
+                 "}\n",
+                 i, i, i, i, i, i);
+        src += buf;
+    }
+    return src;
+}
+
+static double measureCompileThroughput(const std::string &code, int runs, bool verbose, double *bestMs)
+{
+    QuietScope quiet(!verbose);
+    double best = -1.0;
+    for (int r = 0; r < runs; r++)
+    {
+        double ms = timeCompile(code);
+        if (ms < 0.0)
+            return -1.0;
+        if (best < 0.0 || ms < best)
+            best = ms;
+    }
+    *bestMs = best;
+    return best > 0.0 ? (code.size() / (1024.0 * 1024.0)) / (best / 1000.0) : 0.0;
+}
+
+// ============================================================
+// Include units: projecto com N bibliotecas, compile a frio vs
+// re-compile na mesma VM depois de editar uma só biblioteca
+// ============================================================
+struct IncludeProject
+{
+    std::vector<std::string> names;
+    std::vector<std::string> sources;
+};
+
+static const char *projectFileLoader(const char *filename, size_t *outSize, void *userdata)
+{
+    IncludeProject *project = (IncludeProject *)userdata;
+    for (size_t i = 0; i < project->names.size(); i++)
+    {
+        if (project->names[i] == filename)
+        {
+            *outSize = project->sources[i].size();
+            return project->sources[i].c_str();
+        }
+    }
+    *outSize = 0;
+    return nullptr;
+}
+
+// Devolve o main: um include por biblioteca
+static std::string makeIncludeProject(int libraries, IncludeProject *project)
+{
+    const int unitsPerLibrary = 8;
+    std::string mainCode;
+    for (int i = 0; i < libraries; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "lib_%d.bu", i);
+        project->names.push_back(name);
+        project->sources.push_back(makeCompileSource(unitsPerLibrary, i * unitsPerLibrary));
+        mainCode += "include \"" + project->names.back() + "\";\n";
+    }
+    return mainCode;
+}
+
+static bool measureIncludeUnits(int libraries, int runs, bool verbose, double *coldMs, double *editMs)
+{
+    QuietScope quiet(!verbose);
+
+    IncludeProject project;
+    std::string mainCode = makeIncludeProject(libraries, &project);
+
+    *coldMs = *editMs = -1.0;
+    for (int r = 0; r < runs; r++)
+    {
+        Interpreter vm;
+        vm.registerAll();
+        vm.setFileLoader(projectFileLoader, &project);
+
+        double start = nowMs();
+        bool ok = vm.compile(mainCode.c_str(), false);
+        double cold = nowMs() - start;
+
+        // Edita a biblioteca do meio: só essa passa outra vez pelo lexer
+        project.sources[libraries / 2] += "// edit\n";
+        start = nowMs();
+        ok = ok && vm.compile(mainCode.c_str(), false);
+        double edit = nowMs() - start;
+
+        if (!ok)
+            return false;
+        if (r == 0 || cold < *coldMs) *coldMs = cold;
+        if (r == 0 || edit < *editMs) *editMs = edit;
+    }
+    return true;
+}
+
+// Compile a frio do projecto com o lexer dos includes em 'threads' threads
+static double measureParallelIncludes(int libraries, int threads, int runs, bool verbose)
+{
+    QuietScope quiet(!verbose);
+
+    IncludeProject project;
+    std::string mainCode = makeIncludeProject(libraries, &project);
+
+    double best = -1.0;
+    for (int r = 0; r < runs; r++)
+    {
+        Interpreter vm;
+        vm.registerAll();
+        vm.setFileLoader(projectFileLoader, &project);
+        vm.setCompileThreads(threads);
+
+        double start = nowMs();
+        bool ok = vm.compile(mainCode.c_str(), false);
+        double ms = nowMs() - start;
+        if (!ok)
+            return -1.0;
+        if (best < 0.0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+// ============================================================
+// String building: relatório linha a linha com s = s + ... vs
+// StringBuilder. O script confirma o tamanho final (falha se difere)
+// ============================================================
+static const char *REPORT_LINE = "frame %d px=1.500000 hp=100\n";
+
+static size_t reportBytes(int lines)
+{
+    size_t bytes = 0;
+    char buf[64];
+    for (int i = 0; i < lines; i++)
+        bytes += snprintf(buf, sizeof(buf), REPORT_LINE, i);
+    return bytes;
+}
+
+static std::string makeReportSource(int lines, bool builder)
+{
+    char buf[512];
+    if (builder)
+    {
+        snprintf(buf, sizeof(buf),
+                 "var px = 1.5;\n"
+                 "var sb = StringBuilder();\n"
+                 "for (var i = 0; i < %d; i++) {\n"
+                 "    sb.append(\"frame \", i, \" px=\", px, \" hp=100\\n\");\n"
+                 "}\n"
+                 "var report = sb.build();\n"
+                 "if (len(report) != %zu) { throw \"report size\"; }\n",
+                 lines, reportBytes(lines));
+    }
+    else
+    {
+        snprintf(buf, sizeof(buf),
+                 "var px = 1.5;\n"
+                 "var report = \"\";\n"
+                 "for (var i = 0; i < %d; i++) {\n"
+                 "    report = report + \"frame \" + i + \" px=\" + px + \" hp=100\\n\";\n"
+                 "}\n"
+                 "if (len(report) != %zu) { throw \"report size\"; }\n",
+                 lines, reportBytes(lines));
+    }
+    return buf;
+}
+
+// Melhor tempo (compile + run) em 'runs' runs, -1 se o script falha
+static double measureReport(int lines, bool builder, int runs, bool verbose)
+{
+    std::string code = makeReportSource(lines, builder);
+    double best = -1.0;
+    for (int r = 0; r < runs; r++)
+    {
+        RunResult run = runScript(code, variants[0], verbose);
+        if (run.ms < 0.0)
+            return -1.0;
+        if (best < 0.0 || run.ms < best)
+            best = run.ms;
+    }
+    return best;
+}
+
+// ============================================================
+// GC pauses: cena com muitos objetos vivos que gera lixo e mexe em
+// objetos antigos a cada frame; stop-the-world vs incremental
+// ============================================================
+struct PauseResult
+{
+    double maxPauseMs;  // passo/coleta mais longa
+    double worstFrameMs;
+    double totalMs;     // -1 on error
+    size_t cycles;
+};
+
+static std::string makeGCSceneSource(int entities, int frames)
+{
+    char buf[1024];
+    snprintf(buf, sizeof(buf),
+             "class Entity {\n"
+             "    var x; var y; var tags;\n"
+             "    def init(i) { self.x = i; self.y = i * 2; self.tags = [\"e\" + i]; }\n"
+             "}\n"
+             "var world = [];\n"
+             "for (var i = 0; i < %d; i++) { world.push(Entity(i)); }\n"
+             "process spawner(frames) {\n"
+             "    while (frames > 0) {\n"
+             "        for (var i = 0; i < 2000; i++) {\n"
+             "            var e = world[(frames * 7919 + i) %% %d];\n"
+             "            e.tags = [\"f\" + frames, i];\n"
+             "        }\n"
+             "        frames = frames - 1;\n"
+             "        frame;\n"
+             "    }\n"
+             "}\n"
+             "spawner(%d);\n",
+             entities, entities, frames);
+    return buf;
+}
+
+static PauseResult measureGCPauses(const std::string &code, bool incremental, bool verbose)
+{
+    PauseResult result = {0.0, 0.0, -1.0, 0};
+    QuietScope quiet(!verbose);
+
+    Interpreter vm;
+    vm.registerAll();
+    vm.setIncrementalGC(incremental);
+
+    double start = nowMs();
+    bool ok = vm.run(code.c_str(), false);
+    for (int frames = 0; ok && frames < MAX_FRAMES && vm.getTotalAliveProcesses() > 0; frames++)
+    {
+        double frameStart = nowMs();
+        vm.update(1.0f / 60.0f);
+        vm.gcStep(GC_FRAME_BUDGET_US);
+        double frameMs = nowMs() - frameStart;
+        if (frameMs > result.worstFrameMs)
+            result.worstFrameMs = frameMs;
+    }
+    double end = nowMs();
+
+    if (ok)
+    {
+        result.totalMs = end - start;
+        result.maxPauseMs = vm.getGCMaxPauseUs() / 1000.0;
+        result.cycles = vm.getGCCycles();
+    }
+    return result;
+}
+
+// ============================================================
+// Nursery: heap vivo grande + temporários (arrays, maps, closures) por
+// iteração; com a nursery os temporários morrem em minors sem percorrer o heap
+// ============================================================
+struct NurseryResult
+{
+    double totalMs; // -1 on error
+    size_t majors;
+    size_t minors;
+    size_t promoted;
+};
+
+static std::string makeNurserySource(int live, int iterations)
+{
+    char buf[1024];
+    snprintf(buf, sizeof(buf),
+             "var world = [];\n"
+             "for (var i = 0; i < %d; i++) { world.push([i, \"e\" + i]); }\n"
+             "def offset(d) { def apply(v) { return v + d; } return apply; }\n"
+             "var acc = 0;\n"
+             "for (var i = 0; i < %d; i++) {\n"
+             "    var p = [i, i + 1];\n"
+             "    var m = {x: p[0], y: p[1]};\n"
+             "    var f = offset(m.y);\n"
+             "    acc = acc + f(1) - m.x;\n"
+             "}\n"
+             "if (acc != %d || len(world) != %d) { throw \"nursery\"; }\n",
+             live, iterations, iterations * 2, live);
+    return buf;
+}
+
+static NurseryResult measureNursery(const std::string &code, bool generational, bool verbose)
+{
+    NurseryResult result = {-1.0, 0, 0, 0};
+    QuietScope quiet(!verbose);
+
+    Interpreter vm;
+    vm.registerAll();
+    vm.setGenerationalGC(generational);
+
+    double start = nowMs();
+    bool ok = vm.run(code.c_str(), false);
+    double end = nowMs();
+
+    if (ok)
+    {
+        result.totalMs = end - start;
+        result.majors = vm.getGCCycles();
+        result.minors = vm.getTotalMinorCollections();
+        result.promoted = vm.getTotalPromoted();
+    }
+    return result;
+}
+
+// ============================================================
+// Sweep: N objetos vivos + N mortos (arrays e structs), uma coleta completa;
+// o sweep percorre os bitmaps dos slabs de cada tipo
+// ============================================================
+struct SweepResult
+{
+    double gcMs;    // runGC completo (mark + sweep), -1 on error
+    double sweepMs; // só o sweep
+    size_t freed;
+};
+
+static std::string makeSweepSource(int live, int dead)
+{
+    char buf[1024];
+    snprintf(buf, sizeof(buf),
+             "struct P { x, y }\n"
+             "var live = [];\n"
+             "var trash = [];\n"
+             "for (var i = 0; i < %d; i++) { live.push(P(i, i)); }\n"
+             "for (var i = 0; i < %d; i++) {\n"
+             "    if (i %% 2 == 0) { trash.push([i]); } else { trash.push(P(i, 0)); }\n"
+             "}\n"
+             "trash = nil;\n",
+             live, dead);
+    return buf;
+}
+
+static SweepResult measureSweep(const std::string &code, bool verbose)
+{
+    SweepResult result = {-1.0, 0.0, 0};
+    QuietScope quiet(!verbose);
+
+    Interpreter vm;
+    vm.registerAll();
+
+    if (!vm.run(code.c_str(), false))
+        return result;
+
+    size_t before = vm.getTotalArrays() + vm.getTotalStructs();
+    double start = nowMs();
+    vm.runGC();
+    result.gcMs = nowMs() - start;
+    result.sweepMs = vm.getGCLastSweepUs() / 1000.0;
+    result.freed = before - (vm.getTotalArrays() + vm.getTotalStructs());
+    return result;
+}
+
+// ============================================================
+// Main
+// ============================================================
+static void usage(const char *prog)
+{
+    printf("BuLang Benchmark Runner\n\n");
+    printf("Usage: %s [options] [file.bu | directory]\n\n", prog);
+    printf("  -n <runs>   Runs per script/variant (default: 5)\n");
+    printf("  -v          Verbose (show script output)\n");
+    printf("  -h          Help\n\n");
+    printf("Default: runs all scripts/bench/*.bu\n");
+}
+
+int main(int argc, char *argv[])
+{
+    bool verbose = false;
+    int runs = 5;
+    const char *target = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-v") == 0)                       verbose = true;
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)  runs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-h") == 0)                  { usage(argv[0]); return 0; }
+        else                                                   target = argv[i];
+    }
+    if (runs < 1) runs = 1;
+
+    std::vector<std::string> files;
+
+    if (target)
+    {
+        DIR *d = opendir(target);
+        if (d) { closedir(d); files = listBuFiles(target); }
+        else   { files.push_back(target); }
+    }
+    else
+    {
+        const char *dirs[] = { "scripts/bench", "../scripts/bench" };
+        for (auto &dir : dirs)
+        {
+            files = listBuFiles(dir);
+            if (!files.empty()) break;
+        }
+    }
+
+    if (files.empty())
+    {
+        fprintf(stderr, "No .bu benchmark files found.\n");
+        return 1;
+    }
+
+    printf(C_CYAN "BuLang Benchmark Runner" C_RESET " - %zu script(s), %d run(s)\n", files.size(), runs);
+    printf("  Value: %zu bytes (%s), Fiber: %zu bytes, Process: %zu bytes\n\n", sizeof(Value),
+           USE_NAN_BOXING ? "nan-boxed" : "tagged", sizeof(Fiber), sizeof(Process));
+    printf("  %-32s %-14s %10s %10s %10s %10s\n", "script", "variant", "min ms", "avg ms", "frame ms", "peak KB");
+
+    int failures = 0;
+
+    for (auto &file : files)
+    {
+        std::string code = loadFile(file.c_str());
+        std::string name = getBasename(file);
+        if (code.empty())
+        {
+            printf("  %-32s " C_RED "could not read" C_RESET "\n", name.c_str());
+            failures++;
+            continue;
+        }
+
+        double baseline = 0.0;
+        for (int v = 0; v < variantCount; v++)
+        {
+            double best = 0.0, total = 0.0, bestFrame = 0.0;
+            long peakKb = 0;
+            bool failed = false;
+
+            for (int r = 0; r < runs; r++)
+            {
+                RunResult run = runScriptForked(code, variants[v], verbose);
+                if (run.ms < 0.0) { failed = true; break; }
+                total += run.ms;
+                if (r == 0 || run.ms < best) best = run.ms;
+                if (r == 0 || run.frameMs < bestFrame) bestFrame = run.frameMs;
+                if (run.peakKb > peakKb) peakKb = run.peakKb;
+            }
+
+            if (failed)
+            {
+                printf("  %-32s %-14s " C_RED "%10s" C_RESET "\n", name.c_str(), variants[v].name, "FAIL");
+                failures++;
+                continue;
+            }
+
+            char frameCol[32];
+            if (bestFrame > 0.0) snprintf(frameCol, sizeof(frameCol), "%.3f", bestFrame);
+            else                 snprintf(frameCol, sizeof(frameCol), "-");
+
+            if (v == 0)
+            {
+                baseline = best;
+                printf("  %-32s %-14s %10.2f %10.2f %10s %10ld\n", name.c_str(), variants[v].name, best, total / runs,
+                       frameCol, peakKb);
+            }
+            else
+            {
+                printf("  %-32s %-14s %10.2f %10.2f %10s %10ld  " C_GREEN "(%.2fx of default)" C_RESET "\n", "",
+                       variants[v].name, best, total / runs, frameCol, peakKb, baseline > 0.0 ? best / baseline : 0.0);
+            }
+        }
+    }
+
+    // Arranque: quanto do compile o .buc poupa
+    printf("\n  %-32s %12s %12s %10s\n", "startup", "source ms", ".buc ms", ".buc KB");
+    for (auto &file : files)
+    {
+        std::string code = loadFile(file.c_str());
+        std::string name = getBasename(file);
+        if (code.empty())
+            continue;
+
+        StartupResult st = measureStartup(code, runs, verbose);
+        if (st.compileMs < 0.0)
+        {
+            printf("  %-32s " C_RED "%12s" C_RESET "\n", name.c_str(), "FAIL");
+            failures++;
+            continue;
+        }
+        printf("  %-32s %12.3f %12.3f %10.1f  " C_GREEN "(%.2fx faster)" C_RESET "\n", name.c_str(), st.compileMs,
+               st.loadMs, st.bucBytes / 1024.0, st.loadMs > 0.0 ? st.compileMs / st.loadMs : 0.0);
+    }
+
+    // Compile throughput (lexer + compiler, sem correr)
+    printf("\n  %-32s %12s %12s %10s\n", "compile throughput", "source KB", "best ms", "MB/s");
+    const int unitCounts[] = {250, 1000};
+    for (int units : unitCounts)
+    {
+        std::string code = makeCompileSource(units);
+        char name[64];
+        snprintf(name, sizeof(name), "generated_%d_units", units);
+        double bestMs = 0.0;
+        double mbps = measureCompileThroughput(code, runs, verbose, &bestMs);
+        if (mbps < 0.0)
+        {
+            printf("  %-32s " C_RED "%12s" C_RESET "\n", name, "FAIL");
+            failures++;
+            continue;
+        }
+        printf("  %-32s %12.1f %12.3f %10.2f\n", name, code.size() / 1024.0, bestMs, mbps);
+    }
+
+    // Includes: re-compile depois de editar um ficheiro (unidades em cache)
+    printf("\n  %-32s %12s %12s\n", "include units", "cold ms", "edit-1 ms");
+    const int libraryCounts[] = {20, 100};
+    for (int libraries : libraryCounts)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "%d_libraries", libraries);
+        double coldMs = 0.0, editMs = 0.0;
+        if (!measureIncludeUnits(libraries, runs, verbose, &coldMs, &editMs))
+        {
+            printf("  %-32s " C_RED "%12s" C_RESET "\n", name, "FAIL");
+            failures++;
+            continue;
+        }
+        printf("  %-32s %12.3f %12.3f  " C_GREEN "(%.2fx faster)" C_RESET "\n", name, coldMs, editMs,
+               editMs > 0.0 ? coldMs / editMs : 0.0);
+    }
+
+    // Includes: lexer das unidades numa thread vs uma por core
+    int cores = (int)std::thread::hardware_concurrency();
+    char coresCol[32];
+    snprintf(coresCol, sizeof(coresCol), "%d threads ms", cores > 0 ? cores : 1);
+    printf("\n  %-32s %12s %12s\n", "parallel includes", "1 thread ms", coresCol);
+    {
+        const int libraries = 200;
+        char name[64];
+        snprintf(name, sizeof(name), "%d_files", libraries);
+        double serialMs = measureParallelIncludes(libraries, 1, runs, verbose);
+        double parallelMs = measureParallelIncludes(libraries, 0, runs, verbose);
+        if (serialMs < 0.0 || parallelMs < 0.0)
+        {
+            printf("  %-32s " C_RED "%12s" C_RESET "\n", name, "FAIL");
+            failures++;
+        }
+        else
+        {
+            printf("  %-32s %12.3f %12.3f  " C_GREEN "(%.2fx faster)" C_RESET "\n", name, serialMs, parallelMs,
+                   parallelMs > 0.0 ? serialMs / parallelMs : 0.0);
+        }
+    }
+
+    // Strings: o concat copia o relatório inteiro a cada linha (quadrático),
+    // por isso só corre uma vez e não nos tamanhos maiores
+    printf("\n  %-32s %12s %12s\n", "string building", "concat ms", "builder ms");
+    const int reportLines[] = {1024, 4096, 32768};
+    for (int lines : reportLines)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "report_%zu_KB", reportBytes(lines) / 1024);
+
+        double concatMs = 0.0;
+        bool withConcat = lines <= 4096;
+        if (withConcat)
+            concatMs = measureReport(lines, false, 1, verbose);
+        double builderMs = measureReport(lines, true, runs, verbose);
+        if (concatMs < 0.0 || builderMs < 0.0)
+        {
+            printf("  %-32s " C_RED "%12s" C_RESET "\n", name, "FAIL");
+            failures++;
+            continue;
+        }
+
+        if (withConcat)
+            printf("  %-32s %12.2f %12.2f  " C_GREEN "(%.2fx faster)" C_RESET "\n", name, concatMs, builderMs,
+                   builderMs > 0.0 ? concatMs / builderMs : 0.0);
+        else
+            printf("  %-32s %12s %12.2f\n", name, "-", builderMs);
+    }
+
+    // GC: pausa máxima e pior frame com o heap vivo a crescer
+    printf("\n  %-32s %-14s %12s %12s %10s %8s\n", "gc pauses", "mode", "max pause ms", "worst frame", "total ms",
+           "cycles");
+    const int entityCounts[] = {20000, 100000};
+    for (int entities : entityCounts)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "scene_%d_objects", entities);
+        std::string code = makeGCSceneSource(entities, 300);
+        double stwPause = 0.0;
+        for (int incremental = 0; incremental < 2; incremental++)
+        {
+            PauseResult best = {0.0, 0.0, -1.0, 0};
+            for (int r = 0; r < runs; r++)
+            {
+                PauseResult run = measureGCPauses(code, incremental != 0, verbose);
+                if (run.totalMs < 0.0)
+                {
+                    best.totalMs = -1.0;
+                    break;
+                }
+                if (best.totalMs < 0.0 || run.maxPauseMs < best.maxPauseMs)
+                    best = run;
+            }
+
+            const char *mode = incremental ? "incremental" : "stop-world";
+            if (best.totalMs < 0.0)
+            {
+                printf("  %-32s %-14s " C_RED "%12s" C_RESET "\n", incremental ? "" : name, mode, "FAIL");
+                failures++;
+                continue;
+            }
+            if (!incremental)
+            {
+                stwPause = best.maxPauseMs;
+                printf("  %-32s %-14s %12.3f %12.3f %10.2f %8zu\n", name, mode, best.maxPauseMs, best.worstFrameMs,
+                       best.totalMs, best.cycles);
+            }
+            else
+            {
+                printf("  %-32s %-14s %12.3f %12.3f %10.2f %8zu  " C_GREEN "(%.2fx shorter pauses)" C_RESET "\n", "",
+                       mode, best.maxPauseMs, best.worstFrameMs, best.totalMs, best.cycles,
+                       best.maxPauseMs > 0.0 ? stwPause / best.maxPauseMs : 0.0);
+            }
+        }
+    }
+
+    // Nursery: temporários com um heap vivo grande, com e sem gerações
+    printf("\n  %-32s %-14s %12s %8s %8s %10s\n", "nursery", "mode", "total ms", "majors", "minors", "promoted");
+    const int liveCounts[] = {50000, 200000};
+    for (int live : liveCounts)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "temps_%d_live", live);
+        std::string code = makeNurserySource(live, 500000);
+        double flatMs = 0.0;
+        for (int generational = 0; generational < 2; generational++)
+        {
+            NurseryResult best = {-1.0, 0, 0, 0};
+            for (int r = 0; r < runs; r++)
+            {
+                NurseryResult run = measureNursery(code, generational != 0, verbose);
+                if (run.totalMs < 0.0)
+                {
+                    best.totalMs = -1.0;
+                    break;
+                }
+                if (best.totalMs < 0.0 || run.totalMs < best.totalMs)
+                    best = run;
+            }
+
+            const char *mode = generational ? "generational" : "single-gen";
+            if (best.totalMs < 0.0)
+            {
+                printf("  %-32s %-14s " C_RED "%12s" C_RESET "\n", generational ? "" : name, mode, "FAIL");
+                failures++;
+                continue;
+            }
+            if (!generational)
+            {
+                flatMs = best.totalMs;
+                printf("  %-32s %-14s %12.2f %8zu %8zu %10zu\n", name, mode, best.totalMs, best.majors, best.minors,
+                       best.promoted);
+            }
+            else
+            {
+                printf("  %-32s %-14s %12.2f %8zu %8zu %10zu  " C_GREEN "(%.2fx faster)" C_RESET "\n", "", mode,
+                       best.totalMs, best.majors, best.minors, best.promoted,
+                       best.totalMs > 0.0 ? flatMs / best.totalMs : 0.0);
+            }
+        }
+    }
+
+    // Sweep: throughput dos slabs com 1M vivos e 1M mortos
+    printf("\n  %-32s %12s %12s %10s %14s\n", "sweep", "gc ms", "sweep ms", "freed", "M objs/s swept");
+    const int sweepCounts[] = {100000, 1000000};
+    for (int count : sweepCounts)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "live_%dk_dead_%dk", count / 1000, count / 1000);
+        std::string code = makeSweepSource(count, count);
+        SweepResult best = {-1.0, 0.0, 0};
+        for (int r = 0; r < runs; r++)
+        {
+            SweepResult run = measureSweep(code, verbose);
+            if (run.gcMs < 0.0)
+            {
+                best.gcMs = -1.0;
+                break;
+            }
+            if (best.gcMs < 0.0 || run.sweepMs < best.sweepMs)
+                best = run;
+        }
+        if (best.gcMs < 0.0 || best.freed < (size_t)count)
+        {
+            printf("  %-32s " C_RED "%12s" C_RESET "\n", name, "FAIL");
+            failures++;
+            continue;
+        }
+        // Objetos visitados pelo sweep: vivos + mortos
+        printf("  %-32s %12.2f %12.2f %10zu %14.1f\n", name, best.gcMs, best.sweepMs, best.freed,
+               best.sweepMs > 0.0 ? (2.0 * count) / (best.sweepMs * 1000.0) : 0.0);
+    }
+
+    printf("\n");
+    return failures > 0 ? 1 : 0;
+}
@@ -4,6 +4,7 @@
 #include "array.hpp"
 
 struct Value;
+struct SwitchTable; // value.hpp
 
 struct ValueHasher
 {
@@ -16,6 +17,37 @@ struct ValueEq
     
 };
 
+// Inline cache de OP_GET_PROPERTY / OP_SET_PROPERTY (um por instrução).
+// Chave = ClassDef* ou StructDef* da instância, valor = slot do field.
+#define PROPERTY_CACHE_WAYS 4
+
+struct PropertyCache
+{
+    const void *keys[PROPERTY_CACHE_WAYS];
+    uint8 slots[PROPERTY_CACHE_WAYS];
+    uint8 count;
+
+    FORCE_INLINE int find(const void *key) const
+    {
+        for (uint8 i = 0; i < count; i++)
+        {
+            if (keys[i] == key)
+                return slots[i];
+        }
+        return -1;
+    }
+
+    // Megamorphic: depois de PROPERTY_CACHE_WAYS shapes deixa de aprender
+    FORCE_INLINE void add(const void *key, uint8 slot)
+    {
+        if (count >= PROPERTY_CACHE_WAYS)
+            return;
+        keys[count] = key;
+        slots[count] = slot;
+        count++;
+    }
+};
+
 class Code
 {
     size_t m_capacity;
@@ -43,8 +75,26 @@ public:
 
     int addConstant(Value value);
 
+    // Reserva um inline cache e devolve o índice (operando u16 da instrução)
+    int addPropertyCache();
+
+    // Tabela vazia de um OP_SWITCH_TABLE (índice = operando u16); os arrays
+    // são alocados por allocSwitchTable
+    int addSwitchTable();
+    bool allocSwitchTable(SwitchTable *table, uint8 kind, uint16 caseCount, uint32 size);
+    // Descarta as tabelas a partir de 'first' (switch que não chegou a compilar)
+    void dropSwitchTables(uint16 first);
+
     uint8 *code;
     int *lines;
     size_t count;
     Array constants;
+
+    PropertyCache *propertyCaches;
+    uint16 propertyCacheCount;
+    uint16 propertyCacheCapacity;
+
+    SwitchTable *switchTables;
+    uint16 switchTableCount;
+    uint16 switchTableCapacity;
 };
\ No newline at end of file
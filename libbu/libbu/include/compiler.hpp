@@ -4,10 +4,13 @@
 #include "lexer.hpp"
 #include "token.hpp"
 #include "types.hpp"
+#include "value.hpp"
 #include "vector.hpp"
 #include "set.hpp"
 #include <cstring>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
 #include <memory>
@@ -74,24 +77,39 @@ struct ParseRule
 #define MAX_BREAKS_PER_LOOP 256
 #define MAX_SWITCH_DEPTH 64
 
+// OP_SWITCH_TABLE: a partir de quantos cases, até quantos, e o maior
+// intervalo de ints que ainda vai para uma tabela densa
+#define SWITCH_TABLE_MIN_CASES 4
+#define SWITCH_TABLE_MAX_CASES 4096
+#define SWITCH_TABLE_MAX_DENSE 1024
+
+// Nomes são String* interned (Token::str): comparar é comparar ponteiros
 struct Local
 {
-  std::string name;
+  String *name;
   int depth;
   bool usedInitLocal;
   bool isCaptured;
+  bool isRead;      // houve algum OP_GET_LOCAL (x, x += k, x++...)
+  bool isParam;     // parâmetro, slot 0 ou variável do catch: sem aviso
+  bool isConst;     // 'const': não pode ser atribuída
+  bool hasValue;    // const com valor conhecido no compile: lê-se como OP_CONSTANT
+  Value value;
+  int line;         // declaração, para o aviso de variável não lida
+  int startOffset;  // chunk->count quando o slot passou a ser desta variável
+
+  Local() : name(nullptr), depth(-1), usedInitLocal(false), isCaptured(false),
+            isRead(false), isParam(false), isConst(false), hasValue(false), line(0), startOffset(0) {}
+};
 
-  Local() : depth(-1), usedInitLocal(false), isCaptured(false) {}
-
-  bool equals(const std::string &str) const
-  {
-    return name == str;
-  }
-
-  bool equals(const char *str, size_t len) const
-  {
-    return name.length() == len && std::memcmp(name.c_str(), str, len) == 0;
-  }
+// Slot de uma local nunca lida entre [from, to): os OP_SET_LOCAL a esse slot
+// nesse intervalo são stores mortos (o peephole tira-os)
+struct DeadStoreRange
+{
+  Code *chunk;
+  uint8 slot;
+  int from;
+  int to;
 };
 
 struct UpvalueInfo
@@ -123,13 +141,13 @@ struct LoopContext
 
 struct Label
 {
-  std::string name;
+  String *name;
   int offset;
 };
 
 struct GotoJump
 {
-  std::string target;
+  String *target;
   int jumpOffset;
 };
 
@@ -154,6 +172,19 @@ struct CompilerOptions
   // Validação
   bool validateUnicode = true;
   bool checkIntegerOverflow = true;
+
+  // Otimizações
+  bool superinstructions = true; // OP_INC_LOCAL / OP_INC_PRIVATE / OP_CMP_LOCAL_JUMP
+  bool directCalls = true;       // OP_CALL_DIRECT para funções globais
+  bool constantFolding = true;   // 2 * 3, sin(0.5), -1 avaliados no compile
+  bool peephole = true;          // passagem final sobre o chunk de cada função
+  bool warnUnused = true;        // avisa locals/globals que nunca são lidas
+  bool inlining = true;          // corpo de funções pequenas no sítio da chamada
+  int inlineMaxBytes = 48;       // tamanho máximo do bytecode de uma função inlined
+  bool switchTables = true;      // OP_SWITCH_TABLE quando os labels são constantes
+
+  // Includes: threads para o lexer das unidades novas (0 = uma por core, 1 = sem threads)
+  int compileThreads = 0;
 };
 
 // ============================================
@@ -168,12 +199,25 @@ public:
 
   void setFileLoader(FileLoaderCallback loader, void *userdata = nullptr);
   void setOptions(const CompilerOptions &opts) { options = opts; }
+  const CompilerOptions &getOptions() const { return options; }
 
   ProcessDef *compile(const std::string &source);
   ProcessDef *compileExpression(const std::string &source);
   
   const std::vector<std::string>& getGlobalIndexToName() const { return globalIndexToName_; }
 
+  // Bytecode cache: includes (nome + hash do conteúdo) e plugins pedidos no último compile
+  struct IncludeRecord
+  {
+    std::string name;
+    uint64_t hash;
+    bool reused; // tokens vieram da cache de unidades (conteúdo igual ao último compile)
+  };
+  const std::vector<IncludeRecord> &getIncludes() const { return includes_; }
+  const std::vector<std::string> &getRequiredPlugins() const { return requiredPlugins_; }
+  bool hashInclude(const char *filename, uint64_t *outHash);
+  static uint64_t hashSource(const char *data, size_t size);
+
   void clear();
 
   // Estatísticas para debugging
@@ -183,14 +227,45 @@ public:
     size_t maxScopeDepth = 0;
     size_t totalErrors = 0;
     size_t totalWarnings = 0;
+    size_t peepholeBytesRemoved = 0;
+    size_t deadStoresRemoved = 0;
+    size_t callsInlined = 0;
+    size_t includesReused = 0; // includes sem lexer: unidade em cache com o mesmo hash
     std::chrono::milliseconds compileTime{0};
   };
 
   Stats getStats() const { return stats; }
 
+  // Decisões do inliner no último compile, uma por chamada direta (main.dump)
+  struct InlineDecision
+  {
+    std::string caller;
+    std::string callee;
+    int line;
+    int bytes;          // tamanho do corpo do callee
+    std::string reason; // vazio = inlined
+  };
+  const std::vector<InlineDecision> &getInlineDecisions() const { return inlineDecisions_; }
+
 private:
   Interpreter *vm_;
   Lexer *lexer;
+  // Unidade de um include: a fonte já passada pelo lexer, por nome de ficheiro.
+  // Vive entre compiles (o string pool não é limpo no reset), por isso um
+  // re-compile só volta a fazer o lexer dos ficheiros cujo conteúdo mudou.
+  struct IncludeUnit
+  {
+    uint64_t hash;
+    Lexer *lexer; // dono da cópia da fonte: os tokens apontam para ela
+    std::vector<Token> tokens;
+  };
+  std::unordered_map<std::string, IncludeUnit> includeUnits_;
+  IncludeUnit *loadIncludeUnit(const std::string &filename, const char *source, size_t size, bool *reused);
+  void releaseIncludeUnits();
+
+  // Unidades já carregadas antes do compile deste programa (nome -> reutilizada)
+  std::unordered_map<std::string, bool> preloadedIncludes_;
+  void preloadIncludes();
   Token current;
   Token previous;
   Token next;
@@ -248,18 +323,35 @@ private:
 
   std::vector<std::string> errors;
   std::vector<std::string> warnings;
-  std::set<std::string> declaredGlobals_;  // Track declared global variable names
+  std::unordered_set<String *> declaredGlobals_;  // Track declared global variable names
 
-  // Global variable indexing for optimization
-  std::unordered_map<std::string, uint16> globalIndices_;  // Map global name -> index
+  // Global variable indexing for optimization (nomes interned)
+  std::unordered_map<String *, uint16> globalIndices_;  // Map global name -> index
   std::vector<std::string> globalIndexToName_;  // Map index -> name (for debug messages)
   uint16 nextGlobalIndex_ = 0;  // Next available global index
   
-  uint16 getOrCreateGlobalIndex(const std::string& name);  // Get or assign global index
+  uint16 getOrCreateGlobalIndex(String *name);  // Get or assign global index
+  void importGlobal(String *name, uint16 index);  // Global já existente no VM
+
+  // Funções globais (def top-level sem upvalues) -> índice em vm_->functions
+  std::unordered_map<String *, uint16> directFunctions_;
+  int directCallee_ = -1;     // função do último OP_GET_GLOBAL emitido
+  int directCalleeEnd_ = -1;  // offset logo a seguir a esse OP_GET_GLOBAL
+  Code *directCalleeChunk_ = nullptr;
+
+  // Constant folding: último literal emitido (OP_CONSTANT/TRUE/FALSE/NIL).
+  // Só conta se acabar no fim do chunk; patchJump invalida (alvo de salto)
+  int constStart_ = -1;
+  int constEnd_ = -1;
+  Code *constChunk_ = nullptr;
 
   // Token management
   void advance();
-  Token peek(int offset = 0);
+  const Token &peek(int offset = 0);
+  Token syntheticToken(const char *name);  // token de identificador fora do source
+  const char *spanText(const Token &tok);  // span NUL-terminated (válido até à próxima chamada)
+  std::string spanBuffer_;
+  void releaseLexers();
 
   bool checkNext(TokenType t);
 
@@ -307,12 +399,72 @@ private:
   void emitReturn();
   void emitConstant(Value value);
   uint16 makeConstant(Value value);
+  void emitPropertyOp(uint8 op, uint16 nameIdx); // + slot de inline cache
 
   int emitJump(uint8 instruction);
   void patchJump(int offset);
 
   void emitLoop(int loopStart);
 
+  // Superinstructions: reescrevem o primeiro opcode de uma sequência já emitida
+  bool isFusableOperand(int offset);
+  void fuseVarArith(int start, uint8 getOp, int arg);
+  void fuseCompareJump(int start, int jump);
+
+  // Constant folding (compiler_expressions.cpp)
+  void markConstant(int start);
+  int lastConstantStart();
+  bool readConstant(int start, Value *out);
+  void emitFolded(int start, Value value);
+  void emitUnaryOp(uint8 op);
+  void emitBinaryOp(uint8 op, int leftStart, int rightStart);
+
+  // Peephole sobre o chunk acabado (compiler_peephole.cpp)
+  int instructionLength(const Code *chunk, int off);
+  void peephole(Function *func);
+
+  // Dead stores / variáveis nunca lidas
+  struct GlobalVarDecl
+  {
+    String *name;
+    int line;
+    uint16 index;
+  };
+  std::vector<DeadStoreRange> deadStores_;
+  std::vector<GlobalVarDecl> globalVarDecls_;  // 'var' top-level, para o aviso
+  std::vector<uint8> globalRead_;              // por índice de global
+  void noteUnreadLocals(int depth);
+  void warnUnusedGlobals();
+  bool isDeadStore(const Code *chunk, int off, uint8 slot) const;
+
+  // Inliner (compiler_inline.cpp)
+  struct InlineBody
+  {
+    std::string reason;     // vazio = pode ser inlined
+    std::vector<int> depth; // stack (sem o slot 0) antes de cada instrução, -1 = morta
+  };
+  std::unordered_map<uint16, InlineBody> inlineBodies_; // por índice de função
+  std::vector<InlineDecision> inlineDecisions_;
+  std::unordered_set<String *> assignedNames_;           // 'nome =' algures na fonte
+  void noteAssignedNames(const std::vector<Token> &toks);
+  void analyzeInline(Function *func, String *name);
+  bool inlineCall(uint16 index, int calleeStart);
+  void forgetInline(uint16 index, Token &name);
+
+  // 'const NOME = expr;' (compiler_statements.cpp). Só as de literal se
+  // dobram; as de runtime são globals normais que o compilador não deixa atribuir
+  struct ConstGlobal
+  {
+    bool hasValue;
+    Value value;
+  };
+  std::unordered_map<String *, ConstGlobal> constGlobals_;
+  void constDeclaration();
+  bool literalValue(int start, Value *out);
+  Local *lookupLocal(Token &name);
+  bool resolveConst(Token &name, Value *value, bool *hasValue);
+  bool isAssignmentAhead(bool canAssign);
+
   // Pratt parser
   void expression();
   void parsePrecedence(Precedence precedence);
@@ -355,6 +507,10 @@ private:
   void doWhileStatement();
   void loopStatement();
   void switchStatement();
+  bool switchTableLabels(std::vector<Value> *labels);
+  void switchTableStatement(const std::vector<Value> &labels);
+  bool buildSwitchTable(int index, const std::vector<Value> &labels, const std::vector<uint32> &targets,
+                        uint32 defaultTarget);
   void forStatement();
   void foreachStatement();
   void returnStatement();
@@ -431,6 +587,8 @@ private:
   FileLoaderCallback fileLoader = nullptr;
   void *fileLoaderUserdata = nullptr;
   std::set<std::string> includedFiles;
+  std::vector<IncludeRecord> includes_;
+  std::vector<std::string> requiredPlugins_;
   std::set<std::string> importedModules;
   std::set<std::string> usingModules;
 
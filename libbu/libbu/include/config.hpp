@@ -35,12 +35,36 @@
 // Use computed goto dispatch (comment out to use switch)
 #define USE_COMPUTED_GOTO 1
 
+// Conta pares/triplos de opcodes executados (cmake -DBU_OPCODE_PROFILE=ON)
+// O resultado sai no fim de main.dump
+#ifndef USE_OPCODE_PROFILE
+#define USE_OPCODE_PROFILE 0
+#endif
+
+// Value em 8 bytes com NaN-boxing em vez de tag + union (16 bytes)
+// (cmake -DBU_NAN_BOXING=ON). Ver value.hpp
+#ifndef USE_NAN_BOXING
+#define USE_NAN_BOXING 0
+#endif
+
+// Dispatch por tail calls entre handlers (cmake -DBU_TAIL_CALLS=ON)
+// Opcodes frios continuam no loop computed goto. Ver interpreter_runtime_tail.cpp
+#ifndef USE_TAIL_CALLS
+#define USE_TAIL_CALLS 0
+#endif
+
+// Register tier: funções chamadas REGISTER_TIER_THRESHOLD vezes passam a
+// bytecode de registos; depois de REGISTER_TIER_MAX_DEOPTS deopts voltam à stack
+#define REGISTER_TIER_THRESHOLD 64
+#define REGISTER_TIER_MAX_DEOPTS 32
+
 #define BU_ENABLE_SOCKETS 1
 #define BU_ENABLE_FILE_IO 1
 #define BU_ENABLE_MATH 1
 #define BU_ENABLE_TIME 1
 #define BU_ENABLE_PATH 1
 #define BU_ENABLE_OS 1
+#define BU_ENABLE_STRING_BUILDER 1
 #define BU_ENABLE_TIME 1
 
 typedef signed char int8;
@@ -1,5 +1,6 @@
 #pragma once
 #include "config.hpp"
+#include <cstdio>
 
 struct Function;
 class Code;
@@ -19,6 +20,16 @@ public:
     // Disassemble uma única instrução
     static size_t disassembleInstruction(const Code &chunk, size_t offset);
 
+    // Nome do opcode ("OP_ADD"), "OP_UNKNOWN" se não existir
+    static const char *opcodeName(uint8 op);
+
+#if USE_OPCODE_PROFILE
+    // Perfil de pares/triplos de opcodes executados (acumula entre VMs)
+    static void profileOpcode(uint8 op);
+    static void resetOpcodeProfile();
+    static void dumpOpcodeProfile(FILE *f, int top);
+#endif
+
 private:
     // Helpers por tipo de instrução
     static size_t simpleInstruction(const char *name, size_t offset);
@@ -28,6 +39,12 @@ private:
         const Code &chunk,
         size_t offset);
 
+    // OP_GET_PROPERTY / OP_SET_PROPERTY: nome + slot de inline cache
+    static size_t propertyInstruction(
+        const char *name,
+        const Code &chunk,
+        size_t offset);
+
     // Para globals (imprime nome da variável se for string)
     static size_t constantNameInstruction(
         const char *name,
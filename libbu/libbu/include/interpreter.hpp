@@ -6,6 +6,7 @@
 #include "list.hpp"
 #include "ordermap.hpp"
 #include "pool.hpp"
+#include "slab.hpp"
 #include "string.hpp"
 #include "types.hpp"
 #include "vector.hpp"
@@ -27,6 +28,7 @@
 
 struct Function;
 struct CallFrame;
+class RegCode;
 struct Fiber;
 struct Process;
 class Interpreter;
@@ -134,6 +136,14 @@ enum class StaticNames : uint8 {
   typedef void(*NativeStructCtor)(Interpreter * vm, void *buffer, int argc,
                                   Value *args);
   typedef void(*NativeStructDtor)(Interpreter * vm, void *buffer);
+  // Roots guardadas fora da VM (filas do host, caches): chama markRootValue
+  typedef void(*GCRootMarker)(Interpreter * vm, void *userdata);
+
+  struct GCRootHook
+  {
+      GCRootMarker marker;
+      void *userdata;
+  };
 
   struct NativeProperty{
       NativeGetter getter;
@@ -147,6 +157,11 @@ struct Function
   String *name{nullptr};
   bool hasReturn{false};
   int upvalueCount{0};
+
+  // Register tier (interpreter_register.cpp)
+  RegCode *regCode{nullptr};
+  uint32 callCount{0};
+  bool regTierFailed{false};
   ~Function();
 };
 
@@ -178,6 +193,7 @@ struct StructDef
 
 // Forward declaration para NativeClassDef
 struct NativeClassDef;
+struct ClassShape;
 
 struct ClassDef
 {
@@ -197,6 +213,9 @@ struct ClassDef
   List<String *, uint8> fieldNames;
   Vector<Value> fieldDefaults;    // Default values for fields (nil if no default)
 
+  ClassShape *shape{nullptr};     // Criado na 1ª instância (Interpreter::getClassShape)
+  bool ownsShape{false};          // false = partilha o shape da superclass
+
   Function *canRegisterFunction(String *pName);
   ~ClassDef();
 };
@@ -217,6 +236,39 @@ struct NativeClassDef
   int argCount; // Args do constructor
 };
 
+// ============================================
+// HIDDEN CLASS (shape)
+// ============================================
+// Layout das instâncias de uma ClassDef: fields próprios e herdados e as
+// properties da NativeClass base, tudo resolvido uma vez para um slot.
+// Subclasses que só acrescentam métodos partilham o shape do pai, por isso
+// o inline cache (chave = shape) continua monomórfico na hierarquia.
+enum class ShapeSlotKind : uint8
+{
+  FIELD,  // index em ClassInstance::fields
+  NATIVE, // index em ClassShape::nativeProps
+};
+
+struct ShapeSlot
+{
+  ShapeSlotKind kind;
+  uint8 index;
+};
+
+struct ClassShape
+{
+  ClassDef *owner{nullptr};
+  int fieldCount{0};
+  NativeClassDef *nativeBase{nullptr}; // 1ª NativeClass na cadeia de herança
+  List<String *, ShapeSlot> slots;
+  Vector<NativeProperty> nativeProps;
+
+  FORCE_INLINE bool find(String *name, ShapeSlot *out) const
+  {
+    return slots.get(name, out);
+  }
+};
+
 struct NativeFieldDef
 {
   size_t offset;
@@ -303,14 +355,17 @@ enum class GCObjectType : uint8
   CLOSURE,
   UPVALUE
 };
+const int GC_OBJECT_TYPES = (int)GCObjectType::UPVALUE + 1;
 
+// A marca vive no bitmap do slab (SlabPool::isMarked), não no objeto
 struct GCObject
 {
   GCObjectType type;
-  uint8 marked;
-  GCObject *next;
+  uint8 young;      // na nursery (youngObjects) até sobreviver a um minor
+  uint8 remembered; // objeto velho já no remembered set
+  uint8 pinned;     // native persistente: fora dos pools, nunca coletado
 
-  GCObject(GCObjectType t) : type(t), marked(0), next(nullptr) {}
+  GCObject(GCObjectType t) : type(t), young(0), remembered(0), pinned(0) {}
 };
 
 struct StructInstance : GCObject
@@ -324,6 +379,7 @@ struct StructInstance : GCObject
 struct ClassInstance : GCObject
 {
   ClassDef *klass;
+  ClassShape *shape{nullptr};
   Vector<Value> fields;
   void *nativeUserData{nullptr};  // Dados nativos quando herda de NativeClass
 
@@ -497,7 +553,8 @@ struct FiberResult
     PROCESS_FRAME, // frame(N)
     CALL_RETURN,   // return to native C++ caller boundary
     FIBER_DONE,    // return/end
-    ERROR
+    ERROR,
+    STEP           // USE_TAIL_CALLS: instrução lenta feita, volta aos handlers
   };
 
   Reason reason;
@@ -524,8 +581,7 @@ struct TryHandler
                  stackRestore(nullptr), inFinally(false),
                  hasPendingError(false), pendingReturnCount(0)
   {
-    pendingError.as.byte = 0;
-    pendingError.type = ValueType::NIL;
+    pendingError = Value();
     catchConsumed = false;
     hasPendingReturn = false;
   }
@@ -661,12 +717,69 @@ class Interpreter
   static constexpr double GC_GROWTH_FACTOR = 2.0;
   bool gcInProgress = false;
   bool enbaledGC = true;
-  GCObject *gcObjects = nullptr;
+  // Um SlabPool por GCObjectType (os objetos do GC vivem aí, não na arena)
+  SlabPool gcPools[GC_OBJECT_TYPES];
   int frameCount = 0;
   Vector<GCObject *> grayStack;
 
+  // GC incremental: um ciclo é MARK (fatias da gray stack, remark atómico das
+  // roots no fim) e SWEEP (um slab de cada vez, pool a pool). Durante o ciclo
+  // nextGC passa a ser o gatilho do próximo passo (a cada GC_STEP_BYTES
+  // alocados). Os bitmaps de marcas dos slabs limpam-se no início do ciclo;
+  // gcMark só serve às strings ('marked == gcMark', alterna a cada ciclo).
+  enum class GCPhase : uint8
+  {
+    IDLE,
+    MARK,
+    SWEEP
+  };
+  GCPhase gcPhase = GCPhase::IDLE;
+  uint8 gcMark = 1;
+  int sweepPool = 0;
+  Slab *sweepCursor = nullptr;
+  bool incrementalGC_ = true;
+  static constexpr size_t GC_STEP_BYTES = 64 * 1024;
+  static constexpr size_t GC_STEP_WORK = 4096; // objetos + valores visitados por passo
+  size_t gcCycles = 0;
+  double gcMaxPauseUs = 0.0;
+  double gcSweepStartMs = 0.0;
+  double gcLastSweepUs = 0.0;
+
+  // Nursery: objetos criados fora de um ciclo major ficam em youngObjects.
+  // O minor marca a partir das roots + remembered set (velhos onde se
+  // guardou algo desde o último minor), só entra em objetos young, liberta
+  // os young não marcados e promove o resto (limpa a flag). Não move
+  // memória: natives e o dispatch guardam ponteiros crus
+  bool generationalGC_ = true;
+  bool minorMarking_ = false;
+  Vector<GCObject *> youngObjects;
+  Vector<GCObject *> rememberedSet;
+  Vector<GCRootHook> rootHooks;
+  size_t nextMajorGC = 1024 * 1024; // nextGC é o próximo ponto de verificação
+  static constexpr size_t GC_NURSERY_BYTES = 256 * 1024;
+  static constexpr uint8 GC_MINOR_MARK = 3;
+  size_t totalYoung = 0;
+  size_t totalPromoted = 0;
+  size_t minorCycles = 0;
+
   // gc end
 
+  // Inline caches de OP_GET_PROPERTY / OP_SET_PROPERTY
+  size_t propertyCacheHits = 0;
+  size_t propertyCacheMisses = 0;
+
+  // Quickening de OP_ADD/OP_LESS/... para variantes int/double
+  bool quickeningEnabled_ = true;
+
+  // Register tier para funções quentes
+  bool registerTierEnabled_ = true;
+  size_t registerTierPromotions = 0;
+  size_t registerTierDeopts = 0;
+
+  // Bytecode cache (.buc) usado por run(); vazio = desligado
+  char bytecodeCachePath_[512] = {};
+  bool bytecodeCacheHit_ = false;
+
   HashMap<String *, uint16, StringHasher, StringEq> moduleNames; // Nome  ID
   Vector<ModuleDef *> modules;                                   // Array de módulos!
   HashMap<String *, Value, StringHasher, StringEq> globals;      // For named lookups (debug, reflection)
@@ -674,6 +787,15 @@ class Interpreter
   HashMap<String *, uint16, StringHasher, StringEq> nativeGlobalIndices; // Native name -> globalsArray index
   Vector<String*> globalIndexToName_;                            // For debug: index -> name mapping (VM strings)
 
+  // Vector::resize não inicializa: slots novos a nil (o GC percorre todos)
+  FORCE_INLINE void growGlobals(size_t count)
+  {
+    size_t old = globalsArray.size();
+    globalsArray.resize(count);
+    for (size_t i = old; i < count; i++)
+      globalsArray[i] = Value();
+  }
+
   // Plugin system internals
   static constexpr int MAX_PLUGIN_PATHS = 8;
   static constexpr int MAX_PATH_LEN = 256;
@@ -726,7 +848,63 @@ class Interpreter
   void freeFunctions();
   void freeRunningProcesses();
   void checkGC();
-  void blackenObject(GCObject *obj);
+  void gcSafePoint();
+  void gcBeginCycle();
+  size_t gcWork(size_t budget);
+  void gcRemark();
+  void gcFinishCycle();
+  void gcRecordPause(double startMs);
+  void writeBarrierSlow(const Value &v);
+  void minorGC();
+  void promoteNursery();
+  size_t gcIdleTrigger() const;
+
+  // Objeto novo (já num slot do pool, que nasce branco). Fora de um ciclo vai
+  // para a nursery; durante o SWEEP nasce marcado (o slab pode ainda não ter
+  // sido varrido); no MARK fica branco
+  FORCE_INLINE void linkGCObject(GCObject *obj)
+  {
+    obj->remembered = 0;
+    if (generationalGC_ && gcPhase == GCPhase::IDLE)
+    {
+      obj->young = 1;
+      youngObjects.push(obj);
+      totalYoung++;
+      return;
+    }
+    obj->young = 0;
+    if (gcPhase == GCPhase::SWEEP)
+      SlabPool::setMarked(obj);
+  }
+
+  // Slot para um objeto do GC do tipo dado
+  FORCE_INLINE void *allocGCObject(GCObjectType type)
+  {
+    return gcPools[(int)type].allocate();
+  }
+
+  FORCE_INLINE void releaseGCObject(GCObjectType type, void *obj)
+  {
+    gcPools[(int)type].release(obj);
+  }
+
+  FORCE_INLINE void rememberObject(GCObject *owner)
+  {
+    owner->remembered = 1;
+    rememberedSet.push(owner);
+  }
+
+  // Bytes geridos pelo GC: objetos + strings de runtime
+  FORCE_INLINE size_t heapBytes() const { return totalAllocated + stringPool.getRuntimeBytes(); }
+  // Safe point (OP_LOOP): strings não chamam checkGC ao serem criadas porque
+  // o opcode pode ainda ter os operandos só em locals de C++
+  FORCE_INLINE bool gcPending() const { return enbaledGC && heapBytes() > nextGC; }
+  // Nursery cheia e o heap abaixo do limite do major: minor no próximo safe point
+  FORCE_INLINE bool minorPending() const
+  {
+    return generationalGC_ && gcPhase == GCPhase::IDLE && heapBytes() > nextGC && heapBytes() <= nextMajorGC;
+  }
+  size_t blackenObject(GCObject *obj);
   void traceReferences();
 
   Fiber *get_ready_fiber(Process *proc);
@@ -740,24 +918,28 @@ class Interpreter
 
   friend class Compiler;
   friend class ModuleBuilder;
+  friend struct TailDispatch;
 
   void dumpAllFunctions(FILE *f);
   void dumpAllClasses(FILE *f);
+  void dumpInlining(FILE *f);
 
   size_t countObjects() const;
   void clearAllGCObjects();
+  template <typename T, void (Interpreter::*Release)(T *)>
+  size_t sweepSlabOf(Slab *slab);
+  size_t sweepSlab(int pool, Slab *slab);
 
   FORCE_INLINE ClassInstance *creatClass()
   {
 
     checkGC();
     size_t size = sizeof(ClassInstance);
-    void *mem = (MapInstance *)arena.Allocate(size); // 40kb
+    void *mem = allocGCObject(GCObjectType::CLASS);
     ClassInstance *instance = new (mem) ClassInstance();
 
     totalClasses++;
-    instance->next = gcObjects;
-    gcObjects = instance;
+    linkGCObject(instance);
 
     totalAllocated += size;
 
@@ -768,11 +950,10 @@ class Interpreter
   {
     checkGC();
     size_t size = sizeof(Upvalue);
-    void *mem = arena.Allocate(size);
+    void *mem = allocGCObject(GCObjectType::UPVALUE);
     Upvalue *upvalue = new (mem) Upvalue(loc);
 
-    upvalue->next = (Upvalue *)gcObjects;
-    gcObjects = upvalue;
+    linkGCObject(upvalue);
 
     totalAllocated += size;
     totalUpvalues++;
@@ -784,7 +965,7 @@ class Interpreter
   {
     size_t size = sizeof(Upvalue);
     upvalue->~Upvalue();
-    arena.Free(upvalue, size);
+    releaseGCObject(GCObjectType::UPVALUE, upvalue);
     totalAllocated -= size;
     totalUpvalues--;
   }
@@ -793,13 +974,10 @@ class Interpreter
   {
     checkGC();
     size_t size = sizeof(Closure);
-    void *mem = arena.Allocate(size);
+    void *mem = allocGCObject(GCObjectType::CLOSURE);
     Closure *closure = new (mem) Closure();
     closure->type = GCObjectType::CLOSURE;
-    closure->marked = 0;
-
-    closure->next = gcObjects;
-    gcObjects = closure;
+    linkGCObject(closure);
 
     totalAllocated += size;
     return closure;
@@ -810,7 +988,7 @@ class Interpreter
 
     size_t size = sizeof(Closure);
     c->~Closure();
-    arena.Free(c, size);
+    releaseGCObject(GCObjectType::CLOSURE, c);
     totalAllocated -= size;
   }
 
@@ -833,7 +1011,7 @@ class Interpreter
     c->fields.destroy();
     c->klass = nullptr;
     c->~ClassInstance();
-    arena.Free(c, size);
+    releaseGCObject(GCObjectType::CLASS, c);
     totalAllocated -= size;
     totalClasses--;
   }
@@ -842,14 +1020,12 @@ class Interpreter
   {
     checkGC();
     size_t size = sizeof(StructInstance);
-    void *mem = (StructInstance *)arena.Allocate(size); // 40kb
+    void *mem = allocGCObject(GCObjectType::STRUCT);
     StructInstance *instance = new (mem) StructInstance();
-    instance->marked = 0;
     totalAllocated += size;
     totalStructs++;
 
-    instance->next = gcObjects;
-    gcObjects = instance;
+    linkGCObject(instance);
 
     return instance;
   }
@@ -860,21 +1036,19 @@ class Interpreter
     s->values.destroy();
     s->~StructInstance();
     totalStructs--;
-    arena.Free(s, size);
+    releaseGCObject(GCObjectType::STRUCT, s);
     totalAllocated -= size;
   }
   FORCE_INLINE ArrayInstance *createArray()
   {
     checkGC();
     size_t size = sizeof(ArrayInstance);
-    void *mem = (ArrayInstance *)arena.Allocate(size); // 32kb
+    void *mem = allocGCObject(GCObjectType::ARRAY);
     ArrayInstance *instance = new (mem) ArrayInstance();
 
-    instance->next = gcObjects;
-    gcObjects = instance;
+    linkGCObject(instance);
     totalArrays++;
 
-    instance->marked = 0;
     totalAllocated += size;
 
     return instance;
@@ -888,7 +1062,7 @@ class Interpreter
     // size += a->values.capacity() * sizeof(Value);
     a->values.destroy();
     a->~ArrayInstance();
-    arena.Free(a, size);
+    releaseGCObject(GCObjectType::ARRAY, a);
     totalAllocated -= size;
     totalArrays--;
   }
@@ -900,12 +1074,10 @@ class Interpreter
   {
     checkGC();
     size_t size = sizeof(MapInstance);
-    void *mem = (MapInstance *)arena.Allocate(size); // 40kb
+    void *mem = allocGCObject(GCObjectType::MAP);
     MapInstance *instance = new (mem) MapInstance();
-    instance->marked = 0;
 
-    instance->next = gcObjects;
-    gcObjects = instance;
+    linkGCObject(instance);
     totalMaps++;
     totalAllocated += size;
 
@@ -921,7 +1093,7 @@ class Interpreter
 
     m->table.destroy();
     m->~MapInstance();
-    arena.Free(m, size);
+    releaseGCObject(GCObjectType::MAP, m);
   }
 
   FORCE_INLINE NativeClassInstance *createNativeClass(bool persistent = false)
@@ -929,17 +1101,21 @@ class Interpreter
 
     checkGC();
     size_t size = sizeof(NativeClassInstance);
-    void *mem = (NativeClassInstance *)arena.Allocate(size); // 32kb
+    // Persistent fica na arena, fora dos pools e do GC
+    void *mem = persistent ? arena.Allocate(size) : allocGCObject(GCObjectType::NATIVE_CLASS);
     NativeClassInstance *instance = new (mem) NativeClassInstance();
     instance->persistent = persistent;
 
     // Se não for persistent, adiciona ao GC
     if (!persistent)
     {
-      instance->next = gcObjects;
-      gcObjects = instance;
+      linkGCObject(instance);
       totalNativeClasses++;
     }
+    else
+    {
+      instance->pinned = 1;
+    }
 
     totalAllocated += size;
 
@@ -957,7 +1133,7 @@ class Interpreter
     size_t size = sizeof(NativeClassInstance);
     totalAllocated -= size;
     n->~NativeClassInstance();
-    arena.Free(n, size);
+    releaseGCObject(GCObjectType::NATIVE_CLASS, n);
     totalNativeClasses--;
   }
 
@@ -965,7 +1141,7 @@ class Interpreter
   {
     checkGC();
     size_t size = sizeof(NativeStructInstance);
-    void *mem = (NativeStructInstance *)arena.Allocate(size); // 32kb
+    void *mem = persistent ? arena.Allocate(size) : allocGCObject(GCObjectType::NATIVE_STRUCT);
     NativeStructInstance *instance = new (mem) NativeStructInstance();
     instance->persistent = persistent;
     totalAllocated += size;
@@ -973,10 +1149,13 @@ class Interpreter
     // Se não for persistent, adiciona ao GC
     if (!persistent)
     {
-      instance->next = gcObjects;
-      gcObjects = instance;
+      linkGCObject(instance);
       totalNativeStructs++;
     }
+    else
+    {
+      instance->pinned = 1;
+    }
 
     return instance;
   }
@@ -986,14 +1165,13 @@ class Interpreter
     size_t size = sizeof(NativeStructInstance);
     totalAllocated -= size;
     n->~NativeStructInstance();
-    arena.Free(n, size);
+    releaseGCObject(GCObjectType::NATIVE_STRUCT, n);
     totalNativeStructs--;
   }
 
   FORCE_INLINE void markRoots();
   FORCE_INLINE void markValue(const Value &v);
   void markObject(GCObject *obj);
-  void sweep();
   void freeObject(GCObject *obj);
 
   FORCE_INLINE void markArray(ArrayInstance *a);
@@ -1018,8 +1196,63 @@ public:
   ~Interpreter();
   void update(float deltaTime);
 
+  // Coleta completa (termina o ciclo incremental em curso e faz outro)
   void runGC();
+
+  // Avança o GC incremental até 'microseconds' (chamar uma vez por frame,
+  // depois do update). Sem ciclo em curso só começa um quando o heap passa
+  // de 3/4 do limite, para usar o tempo livre do frame
+  void gcStep(int microseconds);
+
+  // Desligado: cada coleta é stop-the-world (runGC) como antes
+  void setIncrementalGC(bool enabled);
+  bool isIncrementalGC() const { return incrementalGC_; }
+  size_t getGCCycles() const { return gcCycles; }
+  // Pausa mais longa de um passo/coleta desde o início (ou resetGCStats)
+  double getGCMaxPauseUs() const { return gcMaxPauseUs; }
+  // Do remark ao fim do sweep do último ciclo (no runGC é o custo do sweep)
+  double getGCLastSweepUs() const { return gcLastSweepUs; }
+  void resetGCStats()
+  {
+    gcCycles = 0;
+    gcMaxPauseUs = 0.0;
+    minorCycles = 0;
+    totalPromoted = 0;
+  }
+
+  // Values que o host guarda fora da VM (ex.: mensagens em fila) têm de ser
+  // roots: o marker corre em cada mark (major, remark e minor) e chama
+  // markRootValue para cada um
+  void addGCRootMarker(GCRootMarker marker, void *userdata = nullptr);
+  void removeGCRootMarker(GCRootMarker marker, void *userdata = nullptr);
+  void markRootValue(const Value &v);
+
+  // Nursery + minor collections (desligado: tudo nasce na old space)
+  void setGenerationalGC(bool enabled);
+  bool isGenerationalGC() const { return generationalGC_; }
+
+  // Write barrier: quem guarda 'v' dentro de um objeto do heap (campo, índice,
+  // upvalue fechado) chama isto. Com o mark a meio, um objeto já marcado a
+  // apontar para um branco faria o sweep libertar o branco; fora de um ciclo,
+  // um velho que passa a apontar para algo (talvez young) entra no
+  // remembered set do próximo minor
+  FORCE_INLINE void writeBarrier(GCObject *owner, const Value &v)
+  {
+    if (!v.isObject())
+      return;
+    if (gcPhase == GCPhase::MARK)
+    {
+      if (owner->pinned || SlabPool::isMarked(owner))
+        writeBarrierSlow(v);
+    }
+    else if (gcPhase == GCPhase::IDLE && generationalGC_ && !owner->young && !owner->remembered)
+    {
+      rememberObject(owner);
+    }
+  }
+
   int getProcessPrivateIndex(const char *name);
+  int getStaticNameId(String *name) const; // -1 se não for builtin
  
 
   void dumpToFile(const char *filename);
@@ -1056,9 +1289,17 @@ public:
 
   StructDef *registerStruct(String *name);
   ClassDef *registerClass(String *nam);
+  ClassShape *buildClassShape(ClassDef *klass);
+  FORCE_INLINE ClassShape *getClassShape(ClassDef *klass)
+  {
+    return klass->shape ? klass->shape : buildClassShape(klass);
+  }
 
   String *createString(const char *str, uint32 len);
   String *createString(const char *str);
+  // Strings de runtime (resultados de natives, concat...): coletadas pelo GC
+  String *createRuntimeString(const char *str, uint32 len);
+  String *createRuntimeString(const char *str);
 
   bool containsClassDefenition(String *name);
   bool getClassDefenition(String *name, ClassDef *result);
@@ -1095,6 +1336,7 @@ public:
   void registerTime();
   void registerFile();
   void registerSocket();
+  void registerStringBuilder();
   void registerAll();
 
   Function *addFunction(const char *name, int arity = 0);
@@ -1104,6 +1346,14 @@ public:
 
   void run_process_step(Process *proc);
   FiberResult run_fiber(Fiber *fiber, Process *proc);
+#if USE_TAIL_CALLS
+  FiberResult run_fiber_step(Fiber *fiber, Process *proc);
+#endif
+
+  // Register tier: devolvem o ip do bytecode onde a stack VM continua
+  void promoteToRegisterTier(Function *func);
+  uint8 *runRegisterTier(Fiber *fiber, CallFrame *frame, uint32 pc);
+  uint8 *resumeRegisterTier(Fiber *fiber, CallFrame *frame, uint8 *ip);
 
   float getCurrentTime() const;
 
@@ -1132,6 +1382,12 @@ public:
   bool run(const char *source, bool dump = false);
   bool compile(const char *source, bool dump);
 
+  // Bytecode cache (.buc), ver bytecode_cache.cpp
+  void setBytecodeCache(const char *path);                 // run() passa a ler/escrever 'path' (nullptr desliga)
+  bool saveBytecode(const char *path, const char *source); // logo a seguir a compile(), antes de correr
+  bool loadBytecode(const char *path, const char *source); // reset() + estado compilado; false = recompilar
+  bool isBytecodeCacheHit() const { return bytecodeCacheHit_; }
+
   void reset();
 
   void setHooks(const VMHooks &h);
@@ -1139,12 +1395,58 @@ public:
   void render();
 
   size_t getTotalAlocated() { return totalAllocated; }
+  size_t getStringBytes() { return stringPool.getBytesAllocated(); }
   size_t getTotalClasses() { return totalClasses; }
   size_t getTotalStructs() { return totalStructs; }
   size_t getTotalArrays() { return totalArrays; }
   size_t getTotalMaps() { return totalMaps; }
   size_t getTotalNativeClasses() { return totalNativeClasses; }
   size_t getTotalNativeStructs() { return totalNativeStructs; }
+  // Por geração: objetos na nursery agora, promovidos para a old space e
+  // minors feitos (os totais por tipo acima contam as duas gerações)
+  size_t getTotalYoungObjects() { return totalYoung; }
+  size_t getTotalPromoted() { return totalPromoted; }
+  size_t getTotalMinorCollections() { return minorCycles; }
+
+  size_t getPropertyCacheHits() { return propertyCacheHits; }
+  size_t getPropertyCacheMisses() { return propertyCacheMisses; }
+
+  void setQuickening(bool enabled) { quickeningEnabled_ = enabled; }
+  bool isQuickeningEnabled() const { return quickeningEnabled_; }
+
+  // Superinstructions emitidas pelo compilador (afeta os próximos compile/run)
+  void setSuperinstructions(bool enabled);
+
+  // OP_CALL_DIRECT para chamadas a funções globais (afeta os próximos compile/run)
+  void setDirectCalls(bool enabled);
+
+  // Constant folding no compilador (afeta os próximos compile/run)
+  void setConstantFolding(bool enabled);
+
+  // Peephole sobre o bytecode de cada função (afeta os próximos compile/run)
+  // Inclui tirar os stores para locals que nunca são lidas
+  void setPeephole(bool enabled);
+
+  // Avisos de locals/globals que nunca são lidas
+  void setWarnUnused(bool enabled);
+
+  // Inlining de funções pequenas e o tamanho máximo do corpo em bytes
+  // (afeta os próximos compile/run; decisões no main.dump)
+  void setInlining(bool enabled);
+  void setInlineLimit(int maxBytes);
+
+  // Switch com labels constantes por tabela (OP_SWITCH_TABLE) em vez da
+  // cadeia de comparações (afeta os próximos compile/run)
+  void setSwitchTables(bool enabled);
+
+  // Threads para o lexer dos ficheiros incluídos (0 = uma por core, 1 = sem threads)
+  void setCompileThreads(int threads);
+
+  // Register tier para funções quentes (desligar para debug)
+  void setRegisterTier(bool enabled) { registerTierEnabled_ = enabled; }
+  bool isRegisterTierEnabled() const { return registerTierEnabled_; }
+  size_t getRegisterTierPromotions() { return registerTierPromotions; }
+  size_t getRegisterTierDeopts() { return registerTierDeopts; }
 
   void killAliveProcess();
 
@@ -1242,241 +1544,160 @@ public:
   // ====== VALUE ====
   Value makeClosure()
   {
-    Value v;
-    v.type = ValueType::CLOSURE;
-    v.as.closure = createClosure();
-    return v;
+    return Value::fromObject(ValueType::CLOSURE, createClosure());
   }
 
   FORCE_INLINE Value makeClassInstance()
   {
-    Value v;
-    v.type = ValueType::CLASSINSTANCE;
-    v.as.sClass = creatClass();
-    return v;
+    return Value::fromObject(ValueType::CLASSINSTANCE, creatClass());
   }
 
   FORCE_INLINE Value makeNativeClassInstance()
   {
-    Value v;
-    v.type = ValueType::NATIVECLASSINSTANCE;
-    v.as.sClassInstance = createNativeClass(false);  // default: não persistent
-    return v;
+    return Value::fromObject(ValueType::NATIVECLASSINSTANCE, createNativeClass(false));  // default: não persistent
   }
 
   FORCE_INLINE Value makeNativeClassInstance(bool persistent)
   {
-    Value v;
-    v.type = ValueType::NATIVECLASSINSTANCE;
-    v.as.sClassInstance = createNativeClass(persistent);
-    return v;
+    return Value::fromObject(ValueType::NATIVECLASSINSTANCE, createNativeClass(persistent));
   }
 
   FORCE_INLINE Value makeStructInstance()
   {
-    Value v;
-    v.type = ValueType::STRUCTINSTANCE;
-    v.as.sInstance = createStruct();
-    return v;
+    return Value::fromObject(ValueType::STRUCTINSTANCE, createStruct());
   }
   FORCE_INLINE Value makeBuffer(int count, int typeRaw)
   {
-    Value v;
-    v.type = ValueType::BUFFER;
-    v.as.buffer = createBuffer(count, typeRaw);
-    return v;
+    return Value::fromObject(ValueType::BUFFER, createBuffer(count, typeRaw));
   }
 
   FORCE_INLINE Value makeMap()
   {
-    Value v;
-    v.type = ValueType::MAP;
-    v.as.map = createMap();
-    return v;
+    return Value::fromObject(ValueType::MAP, createMap());
   }
 
   FORCE_INLINE Value makeArray()
   {
-    Value v;
-    v.type = ValueType::ARRAY;
-    v.as.array = createArray();
-    return v;
+    return Value::fromObject(ValueType::ARRAY, createArray());
   }
 
   FORCE_INLINE Value makeNativeStructInstance()
   {
-    Value v;
-    v.type = ValueType::NATIVESTRUCTINSTANCE;
-    v.as.sNativeStruct = createNativeStruct(false);  // default: não persistent
-    return v;
+    return Value::fromObject(ValueType::NATIVESTRUCTINSTANCE, createNativeStruct(false));  // default: não persistent
   }
 
   FORCE_INLINE Value makeNativeStructInstance(bool persistent)
   {
-    Value v;
-    v.type = ValueType::NATIVESTRUCTINSTANCE;
-    v.as.sNativeStruct = createNativeStruct(persistent);
-    return v;
+    return Value::fromObject(ValueType::NATIVESTRUCTINSTANCE, createNativeStruct(persistent));
   }
   FORCE_INLINE Value makeString(const char *str)
   {
-    Value v;
-    v.type = ValueType::STRING;
-    v.as.string = createString(str);
-    return v;
+    return Value::fromObject(ValueType::STRING, createString(str));
   }
   FORCE_INLINE Value makeString(String *str)
   {
-    Value v;
-    v.type = ValueType::STRING;
-    v.as.string = str;
-    return v;
+    return Value::fromObject(ValueType::STRING, str);
+  }
+  FORCE_INLINE Value makeRuntimeString(const char *str)
+  {
+    return Value::fromObject(ValueType::STRING, createRuntimeString(str));
+  }
+  FORCE_INLINE Value makeRuntimeString(const char *str, uint32 len)
+  {
+    return Value::fromObject(ValueType::STRING, createRuntimeString(str, len));
   }
 
   FORCE_INLINE Value makeNil()
   {
-    Value v;
-    v.type = ValueType::NIL;
-    return v;
+    return Value();
   }
 
   FORCE_INLINE Value makeInt(int i)
   {
-    Value v;
-    v.type = ValueType::INT;
-    v.as.integer = i;
-    return v;
+    return Value::fromInt(i);
   }
 
   FORCE_INLINE Value makeUInt(uint32 i)
   {
-    Value v;
-    v.type = ValueType::UINT;
-    v.as.unsignedInteger = i;
-    return v;
+    return Value::fromUInt(i);
   }
 
   FORCE_INLINE Value makeDouble(double d)
   {
-    Value v;
-    v.type = ValueType::DOUBLE;
-    v.as.number = d;
-    return v;
+    return Value::fromDouble(d);
   }
 
   FORCE_INLINE Value makeBool(bool b)
   {
-    Value v;
-    v.type = ValueType::BOOL;
-    v.as.boolean = b;
-    return v;
+    return Value::fromBool(b);
   }
 
   FORCE_INLINE Value makeFunction(int idx)
   {
-    Value v;
-    v.type = ValueType::FUNCTION;
-    v.as.integer = idx;
-    return v;
+    return Value::fromId(ValueType::FUNCTION, (uint32)idx);
   }
 
   FORCE_INLINE Value makeNative(int idx)
   {
-    Value v;
-    v.type = ValueType::NATIVE;
-    v.as.integer = idx;
-    return v;
+    return Value::fromId(ValueType::NATIVE, (uint32)idx);
   }
 
   FORCE_INLINE Value makeNativeProcess(int idx)
   {
-    Value v;
-    v.type = ValueType::NATIVEPROCESS;
-    v.as.integer = idx;
-    return v;
+    return Value::fromId(ValueType::NATIVEPROCESS, (uint32)idx);
   }
 
 
   FORCE_INLINE Value makeNativeClass(int idx)
   {
-    Value v;
-    v.type = ValueType::NATIVECLASS;
-    v.as.integer = idx;
-    return v;
+    return Value::fromId(ValueType::NATIVECLASS, (uint32)idx);
   }
 
   FORCE_INLINE Value makeProcess(int idx)
   {
-    Value v;
-    v.type = ValueType::PROCESS;
-    v.as.integer = idx;
-    return v;
+    return Value::fromId(ValueType::PROCESS, (uint32)idx);
   }
 
   FORCE_INLINE Value makeProcessInstance(Process *proc)
   {
-    Value v;
-    v.type = ValueType::PROCESS_INSTANCE;
-    v.as.process = proc;
-    return v;
+    return Value::fromObject(ValueType::PROCESS_INSTANCE, proc);
   }
 
   FORCE_INLINE Value makeStruct(int idx)
   {
-    Value v;
-    v.type = ValueType::STRUCT;
-    v.as.integer = idx;
-    return v;
+    return Value::fromId(ValueType::STRUCT, (uint32)idx);
   }
 
   FORCE_INLINE Value makeClass(int idx)
   {
-    Value v;
-    v.type = ValueType::CLASS;
-    v.as.integer = idx;
-    return v;
+    return Value::fromId(ValueType::CLASS, (uint32)idx);
   }
 
   FORCE_INLINE Value makePointer(void *pointer)
   {
-    Value v;
-    v.type = ValueType::POINTER;
-    v.as.pointer = pointer;
-    return v;
+    return Value::fromObject(ValueType::POINTER, pointer);
   }
 
   FORCE_INLINE Value makeNativeStruct(int idx)
   {
-    Value v;
-    v.type = ValueType::NATIVESTRUCT;
-    v.as.integer = idx;
-    return v;
+    return Value::fromId(ValueType::NATIVESTRUCT, (uint32)idx);
   }
 
   FORCE_INLINE Value makeByte(int idx)
   {
-    Value v;
-    v.type = ValueType::BYTE;
-    v.as.byte = idx;
-    return v;
+    return Value::fromByte((uint8)idx);
   }
 
   FORCE_INLINE Value makeFloat(float idx)
   {
-    Value v;
-    v.type = ValueType::FLOAT;
-    v.as.real = idx;
-    return v;
+    return Value::fromFloat(idx);
   }
   FORCE_INLINE Value makeModuleRef(uint16 moduleId, uint16 funcId)
   {
-    Value v;
-    v.type = ValueType::MODULEREFERENCE;
     uint32 packed = 0;
 
     packed |= (moduleId & 0xFFFF) << 16; // 16 bits
     packed |= (funcId & 0xFFFF);         // 16 bits
-    v.as.unsignedInteger = packed;
-    return v;
+    return Value::fromId(ValueType::MODULEREFERENCE, packed);
   }
 };
@@ -5,25 +5,37 @@
 #include <unordered_map>
 #include <string>
 
+class StringPool;
 
-
+// Os tokens apontam para 'source' e os nomes/strings são interned em 'pool':
+// o Lexer tem de sobreviver aos tokens que produziu.
 class Lexer
 {
 public:
-    Lexer(const std::string &source);
-    Lexer(const char* src, size_t len);
+    Lexer(const std::string &source, StringPool *pool);
+    Lexer(const char* src, size_t len, StringPool *pool);
 
     Token scanToken();
 
     Token nextToken();
 
     std::vector<Token> scanAll();
+
+    // Lexer sem pool (threads dos includes): o texto a internar fica guardado
+    // e o String* de cada token só é criado aqui, numa única thread
+    void internDeferred(StringPool *target, std::vector<Token> &tokens);
     void printTokens(const std::vector<Token> &tokens) const;
     bool isKeyword(const std::string& name);
     void reset();
 
 private:
     std::string source;
+    StringPool *pool;
+    std::string scratch; // texto a internar (reutilizado: sem alocar por token)
+
+    // Sem pool: textos por internar e o índice do token de cada um
+    std::vector<std::string> deferred_;
+    std::vector<uint32_t> deferredTokens_;
 
     size_t start;
     size_t current;
@@ -32,7 +44,7 @@ private:
     int tokenColumn;
 
     bool hasPendingError;
-    std::string pendingErrorMessage;
+    const char *pendingErrorMessage;
     int pendingErrorLine;
     int pendingErrorColumn;
 
@@ -45,12 +57,13 @@ private:
     char peekNext() const;
     bool match(char expected);
 
-    void setPendingError(const std::string &message);
+    void setPendingError(const char *message);
     void skipWhitespace();
 
     int readHexDigit();
-    Token makeToken(TokenType type, const std::string &lexeme);
-    Token errorToken(const std::string &message);
+    Token makeToken(TokenType type, String *interned = nullptr);
+    Token errorToken(const char *message);
+    String *intern();
 
 
     // Token scanners
@@ -133,4 +133,63 @@ enum Opcode : uint8
     OP_PROC = 90,    // Convert process ID (int) to Process value
     OP_GET_ID = 91,  // Get first alive process ID by blueprint index
 
+    // Builtin methods (92): name(u16) argc(u8) StaticNames id(u8)
+    OP_INVOKE_BUILTIN = 92,
+
+    // Quickened (93-102): reescritos em runtime a partir de OP_ADD/OP_LESS/...
+    // quando os operandos observados são int/int (II) ou double/double (DD).
+    // Se o guard falhar voltam ao opcode genérico.
+    OP_ADD_II = 93,
+    OP_ADD_DD = 94,
+    OP_SUBTRACT_II = 95,
+    OP_SUBTRACT_DD = 96,
+    OP_MULTIPLY_II = 97,
+    OP_MULTIPLY_DD = 98,
+    OP_LESS_II = 99,
+    OP_LESS_DD = 100,
+    OP_GREATER_II = 101,
+    OP_GREATER_DD = 102,
+
+    // Superinstructions (103-105): o compilador reescreve só o primeiro opcode
+    // da sequência (GET_LOCAL/GET_PRIVATE); os bytes originais ficam no chunk.
+    // Com operandos numéricos executam a sequência inteira num só dispatch,
+    // senão comportam-se como o GET original e o resto corre normalmente.
+    //   OP_INC_LOCAL      : GET_LOCAL s [DUP] <rhs> ADD|SUBTRACT SET_LOCAL s [POP]
+    //   OP_INC_PRIVATE    : GET_PRIVATE p [DUP] <rhs> ADD|SUBTRACT SET_PRIVATE p [POP]
+    //   OP_CMP_LOCAL_JUMP : GET_LOCAL s <rhs> LESS|GREATER JUMP_IF_FALSE off
+    // <rhs> = CONSTANT numérica | GET_LOCAL | GET_PRIVATE
+    OP_INC_LOCAL = 103,
+    OP_INC_PRIVATE = 104,
+    OP_CMP_LOCAL_JUMP = 105,
+
+    // Chamada direta (106): func(u16), prefixo de um OP_CALL argc normal.
+    // Emitido quando o callee é um 'def' global já declarado e a aridade
+    // bate certo em compile time. Se o global já não aponta para essa
+    // função, segue para o OP_CALL genérico que vem a seguir.
+    OP_CALL_DIRECT = 106,
+
+    // Privates de outro processo (107-108): idx(u8) name(u16) cache(u16).
+    // O nome da propriedade é um private conhecido (x, y, angle, ...): com um
+    // processo vivo é um load/store direto, senão continua como
+    // OP_GET_PROPERTY/OP_SET_PROPERTY a partir de 'name'.
+    OP_GET_PROC_PRIVATE = 107,
+    OP_SET_PROC_PRIVATE = 108,
+
+    // Peephole (109): NOT + JUMP_IF_FALSE quando os dois destinos fazem POP
+    // da condição. Como o JUMP_IF_FALSE, não faz pop.
+    OP_JUMP_IF_TRUE = 109,
+
+    // Inliner (110-111): corpo de uma função pequena no sítio da chamada.
+    // Os argumentos ficam na stack e são lidos com OP_PICK; no fim o
+    // OP_SLIDE tira-os de baixo do resultado.
+    //   OP_PICK d(u8)  : push(stack[top - d])
+    //   OP_SLIDE n(u8) : r = pop(); pop n; push(r)
+    OP_PICK = 110,
+    OP_SLIDE = 111,
+
+    // Switch com labels constantes (112): table(u16), índice em
+    // chunk->switchTables. Faz pop do valor e salta para o corpo do case
+    // (endereço absoluto na tabela) ou para o default / fim do switch.
+    OP_SWITCH_TABLE = 112,
+
 };
\ No newline at end of file
@@ -43,20 +43,60 @@ private:
     String *dummyString = nullptr;
 
     Vector<String *> map;
+
+    // Strings criadas em runtime (concat, substring, natives...): ficam fora
+    // do map de interning e o sweep do GC liberta as que não foram marcadas.
+    Vector<String *> runtime;
+    size_t runtimeBytes = 0;
+
+    // Sweep incremental: lê em sweepRead, compacta as vivas em sweepWrite.
+    // Strings criadas durante o sweep nascem com allocMark (sobrevivem)
+    uint8 allocMark = 0;
+    uint8 sweepMark = 0;
+    bool sweeping = false;
+    size_t sweepRead = 0;
+    size_t sweepWrite = 0;
+
+    // Strings da nursery: as de runtime a partir de youngStart
+    size_t youngStart = 0;
+
     String *allocString();
     void deallocString(String *s);
+    void fillString(String *s, const char *str, uint32 len);
 
 public:
     StringPool();
     ~StringPool();
 
     size_t getBytesAllocated() { return bytesAllocated; }
+    size_t getRuntimeBytes() const { return runtimeBytes; }
+    size_t getRuntimeCount() const { return runtime.size(); }
 
+    // Interned: nomes, literais do compiler, chaves de natives. Vivem até clear()
     String *create(const char *str, uint32 len);
     void destroy(String *s);
 
     String *create(const char *str);
 
+    // String de runtime, coletada pelo GC (str não precisa de terminar em '\0')
+    String *allocate(const char *str, uint32 len);
+    // Versão interned de s (a própria s se já for)
+    String *intern(String *s);
+
+    // Sweep das strings de runtime: liberta as que não têm marked == liveMark.
+    // sweepStep processa até 'budget' strings e devolve quantas processou;
+    // isSweeping() fica false quando chegou ao fim
+    void beginSweep(uint8 liveMark);
+    size_t sweepStep(size_t budget);
+    bool isSweeping() const { return sweeping; }
+    void setAllocMark(uint8 mark) { allocMark = mark; }
+
+    // Minor: liberta as young sem marked == liveMark, as outras passam a velhas
+    size_t sweepYoung(uint8 liveMark);
+    // Todas as strings atuais passam a velhas
+    void promoteYoung() { youngStart = runtime.size(); }
+    void clearRuntime();
+
     String *format(const char *fmt, ...);
 
     String *getString(int index);
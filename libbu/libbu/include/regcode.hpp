@@ -0,0 +1,107 @@
+#pragma once
+
+#include "config.hpp"
+#include "vector.hpp"
+#include "value.hpp"
+
+struct Function;
+
+// ============================================================
+// Register tier: bytecode de três endereços para funções quentes
+// ============================================================
+// Gerado a partir do Code (stack) de uma Function depois de
+// REGISTER_TIER_THRESHOLD chamadas. Os registos são os próprios slots da
+// frame (R[0] = callee, R[1..arity] = args, depois locals/temporários),
+// por isso em qualquer ponto "canónico" o estado é igual ao da stack VM e
+// dá para voltar ao bytecode original (deopt) sem copiar nada.
+//
+// Operandos RK: bit 15 ligado = índice na tabela de constantes.
+#define REG_K 0x8000
+#define REG_IS_K(x) (((x) & REG_K) != 0)
+#define REG_NO_RESUME 0xFFFFFFFFu
+
+enum RegOp : uint8
+{
+    ROP_MOVE,  // R[a] = RK(b)
+    ROP_GETG,  // R[a] = globals[b]
+    ROP_SETG,  // globals[a] = RK(b)
+
+    ROP_ADD, // R[a] = RK(b) op RK(c)
+    ROP_SUB,
+    ROP_MUL,
+    ROP_DIV,
+    ROP_MOD,
+    ROP_NEG, // R[a] = -RK(b)
+    ROP_NOT, // R[a] = !RK(b)
+
+    // R[a] = (RK(b) cmp RK(c)) != flag   (flag = NOT dobrado no compare)
+    ROP_EQ,
+    ROP_NE,
+    ROP_LT,
+    ROP_LE,
+    ROP_GT,
+    ROP_GE,
+
+    // if ((RK(b) cmp RK(c)) == flag) goto a   (compare + JUMP_IF_FALSE fundidos)
+    ROP_JEQ,
+    ROP_JNE,
+    ROP_JLT,
+    ROP_JLE,
+    ROP_JGT,
+    ROP_JGE,
+
+    ROP_JMP,   // goto a
+    ROP_JMPF,  // if (isFalsey(RK(b))) goto a
+
+    ROP_MATH1, // R[a] = f(RK(b)), flag = opcode original (OP_SIN..OP_EXP)
+    ROP_MATH2, // R[a] = f(RK(b), RK(c)), flag = OP_ATAN2 | OP_POW
+
+    ROP_CALL,  // callee em R[a], flag = argc; natives inline, o resto sai para a stack VM
+    ROP_RET,   // resultado RK(b) vai para R[a] e sai para o OP_RETURN original
+};
+
+struct RegInstr
+{
+    uint8 op;
+    uint8 flag;
+    uint16 a;
+    uint16 b;
+    uint16 c;
+};
+
+// Estado para voltar à stack VM antes da instrução: bytecode original e
+// entradas da stack simbólica que ainda não estão no seu slot.
+struct RegDeopt
+{
+    uint32 offset;
+    uint16 depth;
+    uint16 pendingCount;
+    uint32 pendingStart; // pares (slot, RK) em RegCode::pending
+};
+
+// Pontos onde uma chamada volta (OP_RETURN do callee) e o caller pode
+// continuar no register tier.
+struct RegResume
+{
+    uint32 offset; // bytecode logo a seguir ao OP_CALL
+    uint32 index;  // instrução register correspondente
+    uint16 depth;  // profundidade esperada da stack depois do retorno
+};
+
+class RegCode
+{
+public:
+    Vector<RegInstr> code;
+    Vector<RegDeopt> deopts; // paralelo a code
+    Vector<uint16> pending;
+    Vector<Value> constants; // constants do chunk + nil/true/false
+    Vector<RegResume> resumes;
+    uint16 frameSize = 0;
+    uint16 deoptCount = 0;
+    bool disabled = false;
+
+    uint32 findResume(uint32 offset, uint16 depth) const;
+
+    // nullptr se a função usa algo que o tier não suporta
+    static RegCode *translate(Function *func);
+};
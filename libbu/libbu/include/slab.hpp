@@ -0,0 +1,146 @@
+#pragma once
+#include "config.hpp"
+#include <cstdint>
+
+// ============================================
+// SLAB POOLS - um pool por tipo de objeto do GC
+// ============================================
+// Cada pool tem slots de tamanho fixo em slabs de SLAB_SIZE bytes, alinhados
+// a SLAB_SIZE: o slab de um objeto sai mascarando o ponteiro. As marcas e a
+// ocupação vivem em bitmaps no cabeçalho do slab (não no objeto), por isso o
+// sweep é um scan linear de palavras (used & ~marks) e não toca nos vivos.
+// Alocar é tirar da free list do pool.
+
+const size_t SLAB_SIZE = 64UL * 1024UL;
+const size_t SLAB_MIN_SLOT = 32;
+const size_t SLAB_WORDS = SLAB_SIZE / SLAB_MIN_SLOT / 64;
+const size_t SLABS_PER_REGION = 16;
+
+class SlabPool;
+
+// Índice do bit mais baixo (word != 0)
+static FORCE_INLINE int slabLowestBit(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(word);
+#else
+	int bit = 0;
+	while (!(word & 1))
+	{
+		word >>= 1;
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+struct Slab
+{
+	SlabPool *pool;
+	Slab *next;	   // lista de slabs do pool
+	char *slots;   // primeiro slot
+	uint32 slotSize;
+	uint32 slotCount;
+	uint32 slotMagic; // offset * slotMagic >> 32 == offset / slotSize
+	uint32 liveCount;
+	uint64_t used[SLAB_WORDS];
+	uint64_t marks[SLAB_WORDS];
+};
+
+struct SlabFreeSlot
+{
+	SlabFreeSlot *next;
+};
+
+class SlabPool
+{
+public:
+	SlabPool();
+	~SlabPool();
+
+	SlabPool(const SlabPool &) = delete;
+	SlabPool &operator=(const SlabPool &) = delete;
+
+	void init(size_t objectSize);
+
+	FORCE_INLINE void *allocate()
+	{
+		if (!m_freeList)
+			grow();
+		SlabFreeSlot *slot = m_freeList;
+		m_freeList = slot->next;
+
+		Slab *slab = slabOf(slot);
+		size_t index = slotIndex(slab, slot);
+		slab->used[index >> 6] |= 1ULL << (index & 63);
+		slab->marks[index >> 6] &= ~(1ULL << (index & 63));
+		slab->liveCount++;
+		m_live++;
+		return slot;
+	}
+
+	FORCE_INLINE void release(void *p)
+	{
+		Slab *slab = slabOf(p);
+		size_t index = slotIndex(slab, p);
+		slab->used[index >> 6] &= ~(1ULL << (index & 63));
+		slab->liveCount--;
+		m_live--;
+
+		SlabFreeSlot *slot = static_cast<SlabFreeSlot *>(p);
+		slot->next = m_freeList;
+		m_freeList = slot;
+	}
+
+	static FORCE_INLINE Slab *slabOf(const void *p)
+	{
+		return reinterpret_cast<Slab *>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(SLAB_SIZE - 1));
+	}
+
+	static FORCE_INLINE size_t slotIndex(const Slab *slab, const void *p)
+	{
+		uint64_t offset = (uint64_t)(static_cast<const char *>(p) - slab->slots);
+		return (size_t)((offset * slab->slotMagic) >> 32);
+	}
+
+	static FORCE_INLINE bool isMarked(const void *p)
+	{
+		const Slab *slab = slabOf(p);
+		size_t index = slotIndex(slab, p);
+		return (slab->marks[index >> 6] >> (index & 63)) & 1;
+	}
+
+	static FORCE_INLINE void setMarked(const void *p)
+	{
+		Slab *slab = slabOf(p);
+		size_t index = slotIndex(slab, p);
+		slab->marks[index >> 6] |= 1ULL << (index & 63);
+	}
+
+	// Começo de um ciclo: tudo a branco
+	void clearMarks();
+
+	Slab *firstSlab() const { return m_slabs; }
+	size_t liveCount() const { return m_live; }
+	size_t slabCount() const { return m_slabCount; }
+	size_t slotSize() const { return m_slotSize; }
+
+	// Liberta todos os slabs (os objetos já têm de estar destruídos)
+	void clear();
+
+private:
+	void grow();
+
+	size_t m_slotSize;
+	Slab *m_slabs;
+	size_t m_slabCount;
+	SlabFreeSlot *m_freeList;
+	size_t m_live;
+
+	// Slabs saem de regiões de SLABS_PER_REGION + 1 slabs alinhadas à mão
+	char *m_regionNext;
+	size_t m_regionLeft;
+	void **m_regions;
+	size_t m_regionCount;
+	size_t m_regionCapacity;
+};
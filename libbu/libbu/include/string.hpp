@@ -7,7 +7,8 @@ struct String
   static constexpr size_t SMALL_THRESHOLD = 23;
   static constexpr size_t IS_LONG_FLAG = 0x80000000u;
   
-  int index;
+  int index;    // posição no pool de interning; -1 nas strings de runtime (GC)
+  uint8 marked; // mark do GC, só conta nas strings de runtime
   size_t hash;
   size_t length_and_flag;
 
@@ -16,6 +16,7 @@ enum TokenType
 
     // Keywords
     TOKEN_VAR,
+    TOKEN_CONST,
     TOKEN_DEF,
     TOKEN_IF,
     TOKEN_ELIF,
@@ -161,17 +162,31 @@ enum TokenType
     TOKEN_COUNT
 };
 
+struct String;
+
+// Token sem alocações: 'start'/'length' apontam para o source do Lexer que o
+// produziu (o Lexer tem de viver enquanto o token for usado). Identificadores,
+// keywords e strings trazem também o String* interned no StringPool do VM
+// (nas strings já com os escapes resolvidos); números e operadores não.
 struct Token
 {
     TokenType type;
-    std::string lexeme;
+    const char *start;
+    uint32_t length;
+    String *str;
 
     int line;   // Linha (1-indexed)
     int column; // Coluna (1-indexed)
 
     Token();
 
-    Token(TokenType t, const std::string &lex, int l, int c);
+    Token(TokenType t, const char *s, uint32_t len, int l, int c, String *interned = nullptr);
+
+    // Texto interned (NUL-terminated); "" se o token não tem String*
+    const char *chars() const;
+
+    // Cópia do span (só para debug/ferramentas: aloca)
+    std::string text() const;
 
     std::string toString() const;
     std::string locationString() const; // "line 5, column 12"
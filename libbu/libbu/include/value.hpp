@@ -2,6 +2,7 @@
 #include "config.hpp"
 #include "string.hpp"
 #include "pool.hpp"
+#include <cstdint>
 
 struct StructInstance;
 struct ArrayInstance;
@@ -47,8 +48,178 @@ enum class ValueType : uint8
   CLOSURE,
 };
 
+// ============================================
+// Value
+// ============================================
+// Por defeito: tag de 1 byte + union de 8 bytes (16 bytes com padding).
+// Com USE_NAN_BOXING (cmake -DBU_NAN_BOXING=ON) o Value ocupa 8 bytes:
+// os doubles ficam tal e qual e o resto vive no espaço dos quiet NaN.
+//
+//   hi16 (bits 48-63)   conteúdo
+//   0x7FF8 / 0xFFF8     NaN canónico (DOUBLE)
+//   0x7FF9 .. 0x7FFF    objeto, ponteiro nos 48 bits baixos
+//   0xFFF9 .. 0xFFFC    objeto, ponteiro nos 48 bits baixos
+//   0xFFFF              imediato: ValueType em bits 32-39, payload em 0-31
+//   outros              DOUBLE
+//
+// O código fora deste ficheiro usa só getType(), is*(), as*() e from*().
+
 struct Value
 {
+#if USE_NAN_BOXING
+  uint64_t bits;
+
+  enum : uint32
+  {
+    NB_STRING = 0x7FF9,
+    NB_ARRAY = 0x7FFA,
+    NB_MAP = 0x7FFB,
+    NB_BUFFER = 0x7FFC,
+    NB_STRUCTINSTANCE = 0x7FFD,
+    NB_CLASSINSTANCE = 0x7FFE,
+    NB_NATIVECLASSINSTANCE = 0x7FFF,
+    NB_NATIVESTRUCTINSTANCE = 0xFFF9,
+    NB_CLOSURE = 0xFFFA,
+    NB_PROCESS_INSTANCE = 0xFFFB,
+    NB_POINTER = 0xFFFC,
+    NB_IMMEDIATE = 0xFFFF,
+  };
+
+  FORCE_INLINE Value() : bits(immediateBits(ValueType::NIL, 0)) {}
+
+  static FORCE_INLINE uint64_t immediateBits(ValueType t, uint32 payload)
+  {
+    return ((uint64_t)NB_IMMEDIATE << 48) | ((uint64_t)(uint8)t << 32) | payload;
+  }
+
+  static FORCE_INLINE uint32 objectTag(ValueType t)
+  {
+    switch (t)
+    {
+    case ValueType::STRING:               return NB_STRING;
+    case ValueType::ARRAY:                return NB_ARRAY;
+    case ValueType::MAP:                  return NB_MAP;
+    case ValueType::BUFFER:               return NB_BUFFER;
+    case ValueType::STRUCTINSTANCE:       return NB_STRUCTINSTANCE;
+    case ValueType::CLASSINSTANCE:        return NB_CLASSINSTANCE;
+    case ValueType::NATIVECLASSINSTANCE:  return NB_NATIVECLASSINSTANCE;
+    case ValueType::NATIVESTRUCTINSTANCE: return NB_NATIVESTRUCTINSTANCE;
+    case ValueType::CLOSURE:              return NB_CLOSURE;
+    case ValueType::PROCESS_INSTANCE:     return NB_PROCESS_INSTANCE;
+    default:                              return NB_POINTER;
+    }
+  }
+
+  FORCE_INLINE uint32 hi16() const { return (uint32)(bits >> 48); }
+  FORCE_INLINE bool isImmediate(ValueType t) const { return (uint32)(bits >> 32) == ((NB_IMMEDIATE << 16) | (uint32)(uint8)t); }
+
+  FORCE_INLINE ValueType getType() const
+  {
+    uint32 hi = hi16();
+    if ((hi & 0x7FF8) != 0x7FF8 || (hi & 7) == 0)
+      return ValueType::DOUBLE;
+    switch (hi)
+    {
+    case NB_STRING:               return ValueType::STRING;
+    case NB_ARRAY:                return ValueType::ARRAY;
+    case NB_MAP:                  return ValueType::MAP;
+    case NB_BUFFER:               return ValueType::BUFFER;
+    case NB_STRUCTINSTANCE:       return ValueType::STRUCTINSTANCE;
+    case NB_CLASSINSTANCE:        return ValueType::CLASSINSTANCE;
+    case NB_NATIVECLASSINSTANCE:  return ValueType::NATIVECLASSINSTANCE;
+    case NB_NATIVESTRUCTINSTANCE: return ValueType::NATIVESTRUCTINSTANCE;
+    case NB_CLOSURE:              return ValueType::CLOSURE;
+    case NB_PROCESS_INSTANCE:     return ValueType::PROCESS_INSTANCE;
+    case NB_POINTER:              return ValueType::POINTER;
+    default:                      return (ValueType)((bits >> 32) & 0xFF);
+    }
+  }
+
+  // Payload cru (sem conversão)
+  FORCE_INLINE uint32 rawPayload() const { return (uint32)bits; }
+  FORCE_INLINE int rawInt() const { return (int)(uint32)bits; }
+  FORCE_INLINE uint32 rawUInt() const { return (uint32)bits; }
+  FORCE_INLINE uint8 rawByte() const { return (uint8)bits; }
+  FORCE_INLINE bool rawBool() const { return (uint32)bits != 0; }
+  FORCE_INLINE float rawFloat() const
+  {
+    uint32 u = (uint32)bits;
+    float f;
+    memcpy(&f, &u, sizeof(float));
+    return f;
+  }
+  FORCE_INLINE double rawDouble() const
+  {
+    double d;
+    memcpy(&d, &bits, sizeof(double));
+    return d;
+  }
+  FORCE_INLINE void *rawPointer() const { return (void *)(uintptr_t)(bits & 0x0000FFFFFFFFFFFFull); }
+
+  // Construtores
+  static FORCE_INLINE Value fromImmediate(ValueType t, uint32 payload)
+  {
+    Value v;
+    v.bits = immediateBits(t, payload);
+    return v;
+  }
+  static FORCE_INLINE Value fromDouble(double d)
+  {
+    Value v;
+    if (d != d)
+      v.bits = 0x7FF8000000000000ull; // NaN canónico: não colide com as tags
+    else
+      memcpy(&v.bits, &d, sizeof(double));
+    return v;
+  }
+  static FORCE_INLINE Value fromFloat(float f)
+  {
+    uint32 u;
+    memcpy(&u, &f, sizeof(float));
+    return fromImmediate(ValueType::FLOAT, u);
+  }
+  static FORCE_INLINE Value fromObject(ValueType t, const void *ptr)
+  {
+    // Ponteiros de user-space cabem em 48 bits (x86-64 / AArch64)
+    Value v;
+    v.bits = ((uint64_t)objectTag(t) << 48) | ((uint64_t)(uintptr_t)ptr & 0x0000FFFFFFFFFFFFull);
+    return v;
+  }
+
+  // Type checks (imediatos comparam os 32 bits altos, objetos os 16 bits altos)
+  FORCE_INLINE bool isNil() const { return isImmediate(ValueType::NIL); }
+  FORCE_INLINE bool isBool() const { return isImmediate(ValueType::BOOL); }
+  FORCE_INLINE bool isInt() const { return isImmediate(ValueType::INT); }
+  FORCE_INLINE bool isByte() const { return isImmediate(ValueType::BYTE); }
+  FORCE_INLINE bool isDouble() const
+  {
+    uint32 hi = hi16();
+    return (hi & 0x7FF8) != 0x7FF8 || (hi & 7) == 0;
+  }
+  FORCE_INLINE bool isFloat() const { return isImmediate(ValueType::FLOAT); }
+  FORCE_INLINE bool isUInt() const { return isImmediate(ValueType::UINT); }
+  FORCE_INLINE bool isString() const { return hi16() == NB_STRING; }
+  FORCE_INLINE bool isFunction() const { return isImmediate(ValueType::FUNCTION); }
+  FORCE_INLINE bool isNativeProcess() const { return isImmediate(ValueType::NATIVEPROCESS); }
+  FORCE_INLINE bool isNative() const { return isImmediate(ValueType::NATIVE); }
+  FORCE_INLINE bool isNativeClass() const { return isImmediate(ValueType::NATIVECLASS); }
+  FORCE_INLINE bool isProcess() const { return isImmediate(ValueType::PROCESS); }
+  FORCE_INLINE bool isProcessInstance() const { return hi16() == NB_PROCESS_INSTANCE; }
+  FORCE_INLINE bool isStruct() const { return isImmediate(ValueType::STRUCT); }
+  FORCE_INLINE bool isStructInstance() const { return hi16() == NB_STRUCTINSTANCE; }
+  FORCE_INLINE bool isMap() const { return hi16() == NB_MAP; }
+  FORCE_INLINE bool isArray() const { return hi16() == NB_ARRAY; }
+  FORCE_INLINE bool isBuffer() const { return hi16() == NB_BUFFER; }
+  FORCE_INLINE bool isClass() const { return isImmediate(ValueType::CLASS); }
+  FORCE_INLINE bool isClassInstance() const { return hi16() == NB_CLASSINSTANCE; }
+  FORCE_INLINE bool isNativeClassInstance() const { return hi16() == NB_NATIVECLASSINSTANCE; }
+  FORCE_INLINE bool isPointer() const { return hi16() == NB_POINTER; }
+  FORCE_INLINE bool isNativeStruct() const { return isImmediate(ValueType::NATIVESTRUCT); }
+  FORCE_INLINE bool isNativeStructInstance() const { return hi16() == NB_NATIVESTRUCTINSTANCE; }
+  FORCE_INLINE bool isModuleRef() const { return isImmediate(ValueType::MODULEREFERENCE); }
+  FORCE_INLINE bool isClosure() const { return hi16() == NB_CLOSURE; }
+
+#else
   ValueType type;
   union
   {
@@ -74,14 +245,51 @@ struct Value
 
   } as;
 
-  Value();
-  Value(const Value &other) = default;
-  Value(Value &&other) noexcept = default;
-  Value &operator=(const Value &other) = default;
-  Value &operator=(Value &&other) noexcept = default;
+  FORCE_INLINE Value() : type(ValueType::NIL) { as.pointer = nullptr; }
+
+  FORCE_INLINE ValueType getType() const { return type; }
+
+  // Payload cru (sem conversão)
+  FORCE_INLINE uint32 rawPayload() const { return as.unsignedInteger; }
+  FORCE_INLINE int rawInt() const { return as.integer; }
+  FORCE_INLINE uint32 rawUInt() const { return as.unsignedInteger; }
+  FORCE_INLINE uint8 rawByte() const { return as.byte; }
+  FORCE_INLINE bool rawBool() const { return as.boolean; }
+  FORCE_INLINE float rawFloat() const { return as.real; }
+  FORCE_INLINE double rawDouble() const { return as.number; }
+  FORCE_INLINE void *rawPointer() const { return as.pointer; }
+
+  // Construtores
+  static FORCE_INLINE Value fromImmediate(ValueType t, uint32 payload)
+  {
+    Value v;
+    v.type = t;
+    v.as.unsignedInteger = payload;
+    return v;
+  }
+  static FORCE_INLINE Value fromDouble(double d)
+  {
+    Value v;
+    v.type = ValueType::DOUBLE;
+    v.as.number = d;
+    return v;
+  }
+  static FORCE_INLINE Value fromFloat(float f)
+  {
+    Value v;
+    v.type = ValueType::FLOAT;
+    v.as.real = f;
+    return v;
+  }
+  static FORCE_INLINE Value fromObject(ValueType t, const void *ptr)
+  {
+    Value v;
+    v.type = t;
+    v.as.pointer = const_cast<void *>(ptr);
+    return v;
+  }
 
   // Type checks
-  FORCE_INLINE bool isNumber() const { return ((type == ValueType::INT) || (type == ValueType::DOUBLE) || (type == ValueType::BYTE) || (type == ValueType::FLOAT) || (type == ValueType::UINT)); }
   FORCE_INLINE bool isNil() const { return type == ValueType::NIL; }
   FORCE_INLINE bool isBool() const { return type == ValueType::BOOL; }
   FORCE_INLINE bool isInt() const { return type == ValueType::INT; }
@@ -109,110 +317,127 @@ struct Value
   FORCE_INLINE bool isNativeStructInstance() const { return type == ValueType::NATIVESTRUCTINSTANCE; }
   FORCE_INLINE bool isModuleRef() const { return type == ValueType::MODULEREFERENCE; }
   FORCE_INLINE bool isClosure() const { return type == ValueType::CLOSURE; }
+#endif
+
+  Value(const Value &other) = default;
+  Value(Value &&other) noexcept = default;
+  Value &operator=(const Value &other) = default;
+  Value &operator=(Value &&other) noexcept = default;
 
-  FORCE_INLINE bool isObject() const { return (isBuffer() || isMap() || isArray() || isClassInstance() || isStructInstance() || isNativeClassInstance() || isNativeStructInstance() || isClosure()); }
+  static FORCE_INLINE Value fromInt(int i) { return fromImmediate(ValueType::INT, (uint32)i); }
+  static FORCE_INLINE Value fromUInt(uint32 u) { return fromImmediate(ValueType::UINT, u); }
+  static FORCE_INLINE Value fromByte(uint8 b) { return fromImmediate(ValueType::BYTE, b); }
+  static FORCE_INLINE Value fromBool(bool b) { return fromImmediate(ValueType::BOOL, b ? 1u : 0u); }
+  // FUNCTION, NATIVE, CLASS, STRUCT, PROCESS, NATIVE*, MODULEREFERENCE: índice de 32 bits
+  static FORCE_INLINE Value fromId(ValueType t, uint32 id) { return fromImmediate(t, id); }
+
+  FORCE_INLINE bool isNumber() const { return isInt() || isDouble() || isByte() || isFloat() || isUInt(); }
+
+  FORCE_INLINE bool isObject() const { return (isString() || isBuffer() || isMap() || isArray() || isClassInstance() || isStructInstance() || isNativeClassInstance() || isNativeStructInstance() || isClosure()); }
 
   // Conversions
 
-  FORCE_INLINE const char *asStringChars() const { return as.string->chars(); }
-  FORCE_INLINE String *asString() const { return as.string; }
-  FORCE_INLINE int asFunctionId() const { return as.integer; }
-  FORCE_INLINE int asNativeId() const { return as.integer; }
-  FORCE_INLINE int asProcessId() const { return as.integer; }
-  FORCE_INLINE int asNativeProcessId() const { return as.integer; }
-  FORCE_INLINE Process *asProcess() const { return as.process; }
+  FORCE_INLINE const char *asStringChars() const { return asString()->chars(); }
+  FORCE_INLINE String *asString() const { return (String *)rawPointer(); }
+  FORCE_INLINE int asId() const { return rawInt(); }
+  FORCE_INLINE int asFunctionId() const { return rawInt(); }
+  FORCE_INLINE int asNativeId() const { return rawInt(); }
+  FORCE_INLINE int asProcessId() const { return rawInt(); }
+  FORCE_INLINE int asNativeProcessId() const { return rawInt(); }
+  FORCE_INLINE uint32 asModuleRef() const { return rawUInt(); }
+  FORCE_INLINE Process *asProcess() const { return (Process *)rawPointer(); }
 
   FORCE_INLINE Closure * asClosure() const
   {
-    return as.closure;
+    return (Closure *)rawPointer();
   }
   
 
   FORCE_INLINE int asStructId() const
   {
-    return as.integer;
+    return rawInt();
   }
 
   FORCE_INLINE int asClassId() const
   {
-    return as.integer;
+    return rawInt();
   }
 
   FORCE_INLINE int asClassNativeId() const
   {
-    return as.integer;
+    return rawInt();
   }
 
   FORCE_INLINE void *asPointer() const
   {
 #ifdef DEBUG
-    if (type != ValueType::POINTER)
+    if (!isPointer())
     {
       Error("Cannot convert to pointer!");
     }
 #endif
-    return as.pointer;
+    return rawPointer();
   }
 
   FORCE_INLINE int asNativeStructId() const
   {
-    return as.integer;
+    return rawInt();
   }
 
   FORCE_INLINE StructInstance *asStructInstance() const
   {
-    return as.sInstance;
+    return (StructInstance *)rawPointer();
   }
 
   FORCE_INLINE ArrayInstance *asArray() const
   {
-    return as.array;
+    return (ArrayInstance *)rawPointer();
   }
 
   FORCE_INLINE MapInstance *asMap() const
   {
-    return as.map;
+    return (MapInstance *)rawPointer();
   }
 
   FORCE_INLINE BufferInstance *asBuffer() const
   {
-    return as.buffer;
+    return (BufferInstance *)rawPointer();
   }
 
   FORCE_INLINE NativeClassInstance *asNativeClassInstance() const
   {
-    return as.sClassInstance;
+    return (NativeClassInstance *)rawPointer();
   }
 
   FORCE_INLINE ClassInstance *asClassInstance() const
   {
-    return as.sClass;
+    return (ClassInstance *)rawPointer();
   }
 
   FORCE_INLINE NativeStructInstance *asNativeStructInstance() const
   {
-    return as.sNativeStruct;
+    return (NativeStructInstance *)rawPointer();
   }
 
   FORCE_INLINE uint32 asUInt() const
   {
-    if (LIKELY(type == ValueType::UINT))
+    if (LIKELY(isUInt()))
     {
-      return as.unsignedInteger;
+      return rawUInt();
     }
 
-    switch (type)
+    switch (getType())
     {
     case ValueType::INT:
-      return (uint32)as.integer;
+      return (uint32)rawInt();
     case ValueType::BYTE:
-      return (uint32)as.byte;
+      return (uint32)rawByte();
     case ValueType::BOOL:
-      return (uint32)as.boolean;
+      return (uint32)rawBool();
     case ValueType::FLOAT:
-      return (uint32)as.real;
+      return (uint32)rawFloat();
     case ValueType::DOUBLE:
-      return (uint32)as.number;
+      return (uint32)rawDouble();
     default:
 #ifdef DEBUG
       Error("Cannot convert to uint!");
@@ -223,23 +448,23 @@ struct Value
 
   FORCE_INLINE uint8 asByte() const
   {
-    if (LIKELY(type == ValueType::BYTE))
+    if (LIKELY(isByte()))
     {
-      return as.byte;
+      return rawByte();
     }
 
-    switch (type)
+    switch (getType())
     {
     case ValueType::INT:
-      return (uint8)as.integer;
+      return (uint8)rawInt();
     case ValueType::UINT:
-      return (uint8)as.unsignedInteger;
+      return (uint8)rawUInt();
     case ValueType::BOOL:
-      return (uint8)as.boolean;
+      return (uint8)rawBool();
     case ValueType::FLOAT:
-      return (uint8)as.real;
+      return (uint8)rawFloat();
     case ValueType::DOUBLE:
-      return (uint8)as.number;
+      return (uint8)rawDouble();
     default:
 #ifdef DEBUG
       Error("Cannot convert to byte!");
@@ -250,22 +475,22 @@ struct Value
 
   FORCE_INLINE int asInt() const
   {
-    if (LIKELY(type == ValueType::INT))
+    if (LIKELY(isInt()))
     {
-      return as.integer;
+      return rawInt();
     }
-    switch (type)
+    switch (getType())
     {
     case ValueType::DOUBLE:
-      return (int)as.number;
+      return (int)rawDouble();
     case ValueType::FLOAT:
-      return (int)as.real;
+      return (int)rawFloat();
     case ValueType::BYTE:
-      return (int)as.byte;
+      return (int)rawByte();
     case ValueType::UINT:
-      return (int)as.unsignedInteger;
+      return (int)rawUInt();
     case ValueType::BOOL:
-      return (int)as.boolean;
+      return (int)rawBool();
     default:
 #ifdef DEBUG
       Error("Cannot convert to int!");
@@ -276,22 +501,22 @@ struct Value
 
   FORCE_INLINE float asFloat() const
   {
-    if (LIKELY(type == ValueType::FLOAT))
+    if (LIKELY(isFloat()))
     {
-      return as.real;
+      return rawFloat();
     }
-    switch (type)
+    switch (getType())
     {
     case ValueType::DOUBLE:
-      return (float)as.number;
+      return (float)rawDouble();
     case ValueType::INT:
-      return (float)as.integer;
+      return (float)rawInt();
     case ValueType::BYTE:
-      return (float)as.byte;
+      return (float)rawByte();
     case ValueType::UINT:
-      return (float)as.unsignedInteger;
+      return (float)rawUInt();
     case ValueType::BOOL:
-      return (float)as.boolean;
+      return (float)rawBool();
     default:
 #ifdef DEBUG
       Error("Cannot convert to float!");
@@ -303,23 +528,23 @@ struct Value
   FORCE_INLINE double asDouble() const
   {
 
-    if (LIKELY(type == ValueType::DOUBLE))
+    if (LIKELY(isDouble()))
     {
-      return as.number;
+      return rawDouble();
     }
 
-    switch (type)
+    switch (getType())
     {
     case ValueType::FLOAT:
-      return (double)as.real;
+      return (double)rawFloat();
     case ValueType::INT:
-      return (double)as.integer;
+      return (double)rawInt();
     case ValueType::BYTE:
-      return (double)as.byte;
+      return (double)rawByte();
     case ValueType::UINT:
-      return (double)as.unsignedInteger;
+      return (double)rawUInt();
     case ValueType::BOOL:
-      return (double)as.boolean;
+      return (double)rawBool();
     default:
 #ifdef DEBUG
       Error("Cannot convert to double!");
@@ -330,24 +555,24 @@ struct Value
 
   FORCE_INLINE bool asBool() const
   {
-    if (LIKELY(type == ValueType::BOOL))
+    if (LIKELY(isBool()))
     {
-      return as.boolean;
+      return rawBool();
     }
 
     // Qualquer número != 0 é true
-    switch (type)
+    switch (getType())
     {
     case ValueType::INT:
-      return as.integer != 0;
+      return rawInt() != 0;
     case ValueType::UINT:
-      return as.unsignedInteger != 0;
+      return rawUInt() != 0;
     case ValueType::BYTE:
-      return as.byte != 0;
+      return rawByte() != 0;
     case ValueType::FLOAT:
-      return as.real != 0.0f;
+      return rawFloat() != 0.0f;
     case ValueType::DOUBLE:
-      return as.number != 0.0;
+      return rawDouble() != 0.0;
     case ValueType::NIL:
       return false;
     default:
@@ -358,23 +583,23 @@ struct Value
   FORCE_INLINE double asNumber() const
   {
 
-    if (LIKELY(type == ValueType::DOUBLE))
+    if (LIKELY(isDouble()))
     {
-      return as.number;
+      return rawDouble();
     }
 
-    switch (type)
+    switch (getType())
     {
     case ValueType::FLOAT:
-      return (double)as.real;
+      return (double)rawFloat();
     case ValueType::INT:
-      return (double)as.integer;
+      return (double)rawInt();
     case ValueType::BYTE:
-      return (double)as.byte;
+      return (double)rawByte();
     case ValueType::UINT:
-      return (double)as.unsignedInteger;
+      return (double)rawUInt();
     case ValueType::BOOL:
-      return (double)as.boolean;
+      return (double)rawBool();
     default:
 #ifdef DEBUG
       Error("Cannot convert to number!");
@@ -384,6 +609,10 @@ struct Value
   }
 };
 
+#if USE_NAN_BOXING
+static_assert(sizeof(Value) == 8, "NaN-boxed Value must be 8 bytes");
+#endif
+
 void printValue(const Value &value);
 const char *valueTypeToString(ValueType type);
 void printValueNl(const Value &value);
@@ -401,10 +630,10 @@ static FORCE_INLINE bool valuesEqual(const Value &a, const Value &b)
   }
 
   // Rest require exact type match
-  if (a.type != b.type)
+  if (a.getType() != b.getType())
     return false;
 
-  switch (a.type)
+  switch (a.getType())
   {
   case ValueType::BOOL:
     return a.asBool() == b.asBool();
@@ -454,7 +683,7 @@ static FORCE_INLINE bool valuesEqual(const Value &a, const Value &b)
 
 static FORCE_INLINE bool isTruthy(const Value &value)
 {
-  switch (value.type)
+  switch (value.getType())
   {
   case ValueType::NIL:
     return false;
@@ -476,4 +705,83 @@ static FORCE_INLINE bool isTruthy(const Value &value)
 static FORCE_INLINE bool isFalsey(Value value)
 {
   return !isTruthy(value);
+}
+
+// ============================================
+// SWITCH TABLE (OP_SWITCH_TABLE)
+// ============================================
+// Valor -> ordinal do case. Densa para ints próximos (slot = valor - base),
+// hash com linear probing para ints esparsos ou strings. O ordinal
+// caseCount é o default (ou o fim do switch) e marca os slots vazios.
+// Igualdade como no OP_EQUAL: 3.0 encontra o case 3, strings por conteúdo.
+enum SwitchTableKind : uint8
+{
+  SWITCH_DENSE = 0,
+  SWITCH_HASH_INT,
+  SWITCH_HASH_STRING,
+};
+
+struct SwitchTable
+{
+  uint8 kind;
+  uint16 caseCount;
+  int32 base;       // DENSE: valor do slot 0
+  uint32 size;      // DENSE: slots; HASH: capacidade (potência de 2)
+  uint16 *slots;    // ordinal por slot
+  int32 *intKeys;   // HASH_INT
+  String **strKeys; // HASH_STRING
+  uint32 *targets;  // caseCount + 1 endereços absolutos no chunk
+};
+
+static FORCE_INLINE uint32 switchHashInt(int32 key)
+{
+  uint32 h = (uint32)key * 2654435761u;
+  return h ^ (h >> 16);
+}
+
+static FORCE_INLINE uint16 switchTableCase(const SwitchTable *table, const Value &value)
+{
+  const uint16 none = table->caseCount;
+  if (table->kind == SWITCH_HASH_STRING)
+  {
+    if (!value.isString())
+      return none;
+    String *s = value.asString();
+    uint32 mask = table->size - 1;
+    for (uint32 i = (uint32)s->hash & mask;; i = (i + 1) & mask)
+    {
+      uint16 slot = table->slots[i];
+      if (slot == none || compare_strings(table->strKeys[i], s))
+        return slot;
+    }
+  }
+
+  int32 key;
+  if (value.isInt())
+  {
+    key = value.asInt();
+  }
+  else
+  {
+    if (!value.isNumber())
+      return none;
+    double d = value.asNumber();
+    if (!(d >= -2147483648.0 && d <= 2147483647.0) || (double)(int32)d != d)
+      return none;
+    key = (int32)d;
+  }
+
+  if (table->kind == SWITCH_DENSE)
+  {
+    uint32 i = (uint32)key - (uint32)table->base;
+    return i < table->size ? table->slots[i] : none;
+  }
+
+  uint32 mask = table->size - 1;
+  for (uint32 i = switchHashInt(key) & mask;; i = (i + 1) & mask)
+  {
+    uint16 slot = table->slots[i];
+    if (slot == none || table->intKeys[i] == key)
+      return slot;
+  }
 }
\ No newline at end of file
@@ -19,32 +19,32 @@ static void valueToString(const Value &v, std::string &out)
 {
   char buffer[256];
 
-  switch (v.type)
+  switch (v.getType())
   {
   case ValueType::NIL:
     out += "nil";
     break;
   case ValueType::BOOL:
-    out += v.as.boolean ? "true" : "false";
+    out += v.asBool() ? "true" : "false";
     break;
   case ValueType::BYTE:
-    snprintf(buffer, 256, "%u", v.as.byte);
+    snprintf(buffer, 256, "%u", v.asByte());
     out += buffer;
     break;
   case ValueType::INT:
-    snprintf(buffer, 256, "%d", v.as.integer);
+    snprintf(buffer, 256, "%d", v.asInt());
     out += buffer;
     break;
   case ValueType::UINT:
-    snprintf(buffer, 256, "%u", v.as.unsignedInteger);
+    snprintf(buffer, 256, "%u", v.asUInt());
     out += buffer;
     break;
   case ValueType::FLOAT:
-    snprintf(buffer, 256, "%.2f", v.as.real);
+    snprintf(buffer, 256, "%.2f", v.asFloat());
     out += buffer;
     break;
   case ValueType::DOUBLE:
-    snprintf(buffer, 256, "%.2f", v.as.number);
+    snprintf(buffer, 256, "%.2f", v.asDouble());
     out += buffer;
     break;
   case ValueType::STRING:
@@ -53,7 +53,7 @@ static void valueToString(const Value &v, std::string &out)
     break;
   }
   case ValueType::PROCESS:
-    snprintf(buffer, 256, "<process:%u>", v.as.integer);
+    snprintf(buffer, 256, "<process:%u>", v.asId());
     out += buffer;
     break;
   case ValueType::ARRAY:
@@ -95,19 +95,19 @@ int native_int(Interpreter *vm, int argCount, Value *args)
   const Value &arg = args[0];
   int intValue = 0;
 
-  switch (arg.type)
+  switch (arg.getType())
   {
   case ValueType::INT:
-    intValue = arg.as.integer;
+    intValue = arg.asInt();
     break;
   case ValueType::UINT:
-    intValue = static_cast<int>(arg.as.unsignedInteger);
+    intValue = static_cast<int>(arg.asUInt());
     break;
   case ValueType::FLOAT:
-    intValue = static_cast<int>(arg.as.real);
+    intValue = static_cast<int>(arg.asFloat());
     break;
   case ValueType::DOUBLE:
-    intValue = static_cast<int>(arg.as.number);
+    intValue = static_cast<int>(arg.asDouble());
     break;
   case ValueType::STRING:
   {
@@ -135,19 +135,19 @@ int native_real(Interpreter *vm, int argCount, Value *args)
   const Value &arg = args[0];
   double floatValue = 0.0;
 
-  switch (arg.type)
+  switch (arg.getType())
   {
   case ValueType::INT:
-    floatValue = static_cast<double>(arg.as.integer);
+    floatValue = static_cast<double>(arg.asInt());
     break;
   case ValueType::UINT:
-    floatValue = static_cast<double>(arg.as.unsignedInteger);
+    floatValue = static_cast<double>(arg.asUInt());
     break;
   case ValueType::FLOAT:
-    floatValue = arg.as.real;
+    floatValue = arg.asFloat();
     break;
   case ValueType::DOUBLE:
-    floatValue = static_cast<double>(arg.as.number);
+    floatValue = static_cast<double>(arg.asDouble());
     break;
   case ValueType::STRING:
   {
@@ -166,7 +166,7 @@ int native_real(Interpreter *vm, int argCount, Value *args)
 
 int native_format(Interpreter *vm, int argCount, Value *args)
 {
-  if (argCount < 1 || args[0].type != ValueType::STRING)
+  if (argCount < 1 || args[0].getType() != ValueType::STRING)
   {
     vm->runtimeError("format expects string as first argument");
     return 0;
@@ -192,13 +192,13 @@ int native_format(Interpreter *vm, int argCount, Value *args)
     }
   }
 
-  vm->push(vm->makeString(result.c_str()));
+  vm->push(vm->makeRuntimeString(result.c_str()));
   return 1;
 }
 
 int native_write(Interpreter *vm, int argCount, Value *args)
 {
-  if (argCount < 1 || args[0].type != ValueType::STRING)
+  if (argCount < 1 || args[0].getType() != ValueType::STRING)
   {
     vm->runtimeError("write expects string as first argument");
     return 0;
@@ -245,7 +245,7 @@ int native_input(Interpreter *vm, int argCount, Value *args)
     {
       buffer[length - 1] = '\0';
     }
-    vm->push(vm->makeString(buffer));
+    vm->push(vm->makeRuntimeString(buffer));
     return 1;
   }
 
@@ -259,6 +259,13 @@ int native_gc(Interpreter *vm, int argCount, Value *args)
 }
 
 
+// Bytes dos objetos do GC mais todas as strings (interned e de runtime)
+int native_heap(Interpreter *vm, int argCount, Value *args)
+{
+  vm->push(vm->makeInt((int)(vm->getTotalAlocated() + vm->getStringBytes())));
+  return 1;
+}
+
 int native_ticks(Interpreter *vm, int argCount, Value *args)
 {
   if (argCount != 1 || !args[0].isNumber())
@@ -280,6 +287,7 @@ void Interpreter::registerBase()
   registerNative("print_stack", native_print_stack, -1);
   registerNative("ticks", native_ticks, 1);
   registerNative("_gc", native_gc, 0);
+  registerNative("_heap", native_heap, 0);
   registerNative("str", native_string, 1);
   registerNative("int", native_int, 1);
   registerNative("real", native_real, 1);
@@ -319,4 +327,8 @@ void Interpreter::registerAll()
 #ifdef BU_ENABLE_SOCKETS
   registerSocket();
 #endif
+
+#ifdef BU_ENABLE_STRING_BUILDER
+  registerStringBuilder();
+#endif
 }
@@ -659,7 +659,7 @@ int native_file_read_string(Interpreter *vm, int argCount, Value *args)
     std::string str((char *)(fb->data.data() + fb->cursor), len);
     fb->cursor += len;
 
-    vm->push(vm->makeString(str.c_str()));
+    vm->push(vm->makeRuntimeString(str.c_str()));
     return 1;
 }
 
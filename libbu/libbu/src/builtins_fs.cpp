@@ -46,7 +46,7 @@ int native_fs_read(Interpreter *vm, int argCount, Value *args)
     }
 
     buffer[bytesRead] = '\0';
-    vm->push(vm->makeString(buffer));
+    vm->push(vm->makeRuntimeString(buffer));
     free(buffer);
 
     return 1;
@@ -87,7 +87,7 @@ int native_fs_list(Interpreter *vm, int argCount, Value *args)
             if (strcmp(findData.cFileName, ".") != 0 &&
                 strcmp(findData.cFileName, "..") != 0)
             {
-                arr.asArray()->values.push(vm->makeString(findData.cFileName));
+                arr.asArray()->values.push(vm->makeRuntimeString(findData.cFileName));
             }
         } while (FindNextFileA(hFind, &findData));
         FindClose(hFind);
@@ -102,7 +102,7 @@ int native_fs_list(Interpreter *vm, int argCount, Value *args)
             if (strcmp(entry->d_name, ".") != 0 &&
                 strcmp(entry->d_name, "..") != 0)
             {
-                arr.asArray()->values.push(vm->makeString(entry->d_name));
+                arr.asArray()->values.push(vm->makeRuntimeString(entry->d_name));
             }
         }
         closedir(dir);
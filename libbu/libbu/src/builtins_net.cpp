@@ -450,17 +450,17 @@ int native_socket_http_get(Interpreter *vm, int argCount, Value *args)
     MapInstance *map = result.asMap();
 
     map->table.set(vm->makeString("status_code").asString(), vm->makeInt(httpResp.statusCode));
-    map->table.set(vm->makeString("status_text").asString(), vm->makeString(httpResp.statusText.c_str()));
-    map->table.set(vm->makeString("body").asString(), vm->makeString(httpResp.body.c_str()));
+    map->table.set(vm->makeString("status_text").asString(), vm->makeRuntimeString(httpResp.statusText.c_str()));
+    map->table.set(vm->makeString("body").asString(), vm->makeRuntimeString(httpResp.body.c_str()));
     map->table.set(vm->makeString("success").asString(), vm->makeBool(httpResp.success));
-    map->table.set(vm->makeString("url").asString(), vm->makeString(url.c_str()));
+    map->table.set(vm->makeString("url").asString(), vm->makeRuntimeString(url.c_str()));
     map->table.set(vm->makeString("received").asString(), vm->makeInt(response.length()));
 
     Value headersMap = vm->makeMap();
     MapInstance *headers = headersMap.asMap();
     for (const auto &h : httpResp.headers)
     {
-        headers->table.set(vm->makeString(h.first.c_str()).asString(), vm->makeString(h.second.c_str()));
+        headers->table.set(vm->makeRuntimeString(h.first.c_str()).asString(), vm->makeRuntimeString(h.second.c_str()));
     }
     map->table.set(vm->makeString("headers").asString(), headersMap);
 
@@ -718,16 +718,16 @@ int native_socket_http_post(Interpreter *vm, int argCount, Value *args)
     MapInstance *map = result.asMap();
 
     map->table.set(vm->makeString("status_code").asString(), vm->makeInt(httpResp.statusCode));
-    map->table.set(vm->makeString("status_text").asString(), vm->makeString(httpResp.statusText.c_str()));
-    map->table.set(vm->makeString("body").asString(), vm->makeString(httpResp.body.c_str()));
+    map->table.set(vm->makeString("status_text").asString(), vm->makeRuntimeString(httpResp.statusText.c_str()));
+    map->table.set(vm->makeString("body").asString(), vm->makeRuntimeString(httpResp.body.c_str()));
     map->table.set(vm->makeString("success").asString(), vm->makeBool(httpResp.success));
-    map->table.set(vm->makeString("url").asString(), vm->makeString(url.c_str()));
+    map->table.set(vm->makeString("url").asString(), vm->makeRuntimeString(url.c_str()));
 
     Value headersMap = vm->makeMap();
     MapInstance *headers = headersMap.asMap();
     for (const auto &h : httpResp.headers)
     {
-        headers->table.set(vm->makeString(h.first.c_str()).asString(), vm->makeString(h.second.c_str()));
+        headers->table.set(vm->makeRuntimeString(h.first.c_str()).asString(), vm->makeRuntimeString(h.second.c_str()));
     }
     map->table.set(vm->makeString("headers").asString(), headersMap);
 
@@ -915,7 +915,7 @@ int native_socket_resolve(Interpreter *vm, int argCount, Value *args)
 
         memcpy(&addr, he->h_addr_list[0], sizeof(struct in_addr));
 
-        vm->push(vm->makeString(inet_ntoa(addr)));
+        vm->push(vm->makeRuntimeString(inet_ntoa(addr)));
         return 1;
     }
 
@@ -939,7 +939,7 @@ int native_socket_get_local_ip(Interpreter *vm, int argCount, Value *args)
     struct in_addr addr;
     memcpy(&addr, he->h_addr_list[0], sizeof(struct in_addr));
 
-    vm->push(vm->makeString(inet_ntoa(addr)));
+    vm->push(vm->makeRuntimeString(inet_ntoa(addr)));
 
     return 1;
 }
@@ -1361,7 +1361,7 @@ int native_socket_receive(Interpreter *vm, int argCount, Value *args)
         return 1;
     }
 
-    vm->push(vm->makeString(std::string(buffer.data(), received).c_str()));
+    vm->push(vm->makeRuntimeString(buffer.data(), (uint32)received));
     return 1;
 }
 
@@ -1472,8 +1472,8 @@ int native_socket_recvfrom(Interpreter *vm, int argCount, Value *args)
 
     Value result = vm->makeMap();
     MapInstance *map = result.asMap();
-    map->table.set(vm->makeString("data").asString(), vm->makeString(std::string(buffer.data(), received).c_str()));
-    map->table.set(vm->makeString("host").asString(), vm->makeString(inet_ntoa(fromAddr.sin_addr)));
+    map->table.set(vm->makeString("data").asString(), vm->makeRuntimeString(buffer.data(), (uint32)received));
+    map->table.set(vm->makeString("host").asString(), vm->makeRuntimeString(inet_ntoa(fromAddr.sin_addr)));
     map->table.set(vm->makeString("port").asString(), vm->makeInt(ntohs(fromAddr.sin_port)));
 
     vm->push(result);
@@ -1507,13 +1507,13 @@ int native_socket_info(Interpreter *vm, int argCount, Value *args)
     else if (handle->type == SocketType::UDP)
         typeStr = "udp";
 
-    map->table.set(vm->makeString("type").asString(), vm->makeString(typeStr));
+    map->table.set(vm->makeString("type").asString(), vm->makeRuntimeString(typeStr));
     map->table.set(vm->makeString("port").asString(), vm->makeInt(handle->port));
     map->table.set(vm->makeString("blocking").asString(), vm->makeBool(handle->isBlocking));
     map->table.set(vm->makeString("connected").asString(), vm->makeBool(handle->isConnected));
 
     if (!handle->host.empty())
-        map->table.set(vm->makeString("host").asString(), vm->makeString(handle->host.c_str()));
+        map->table.set(vm->makeString("host").asString(), vm->makeRuntimeString(handle->host.c_str()));
 
     vm->push(result);
     return 1;
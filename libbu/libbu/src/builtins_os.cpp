@@ -36,7 +36,7 @@ int native_os_getenv(Interpreter *vm, int argCount, Value *args)
     const char *value = getenv(args[0].asStringChars());
     if (value)
     {
-        vm->push(vm->makeString(value));
+        vm->push(vm->makeRuntimeString(value));
         return 1;
     }
     return 0;
@@ -65,7 +65,7 @@ int native_os_getcwd(Interpreter *vm, int argCount, Value *args)
     char buffer[4096];
     if (getcwd(buffer, sizeof(buffer)))
     {
-        vm->push(vm->makeString(buffer));
+        vm->push(vm->makeRuntimeString(buffer));
         return 1;
     }
     return 0;
@@ -301,7 +301,7 @@ int native_os_spawn_capture(Interpreter *vm, int argCount, Value *args)
     Value result = vm->makeMap();
     MapInstance *map = result.asMap();
 
-    map->table.set(vm->makeString("output").asString(), vm->makeString(output.c_str()));
+    map->table.set(vm->makeString("output").asString(), vm->makeRuntimeString(output.c_str()));
     map->table.set(vm->makeString("code").asString(), vm->makeInt(exitCode));
 
     vm->push(result);
@@ -329,7 +329,7 @@ int native_os_spawn_capture(Interpreter *vm, int argCount, Value *args)
     Value result = vm->makeMap();
     MapInstance *map = result.asMap();
 
-    map->table.set(vm->makeString("output").asString(), vm->makeString(output.c_str()));
+    map->table.set(vm->makeString("output").asString(), vm->makeRuntimeString(output.c_str()));
     map->table.set(vm->makeString("code").asString(), vm->makeInt(exitCode));
     map->table.set(vm->makeString("status").asString(), vm->makeInt(status));
 
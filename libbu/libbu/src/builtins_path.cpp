@@ -36,7 +36,7 @@ int native_path_join(Interpreter *vm, int argCount, Value *args)
         }
         result += args[i].asStringChars();
     }
-    vm->push(vm->makeString(result.c_str()));
+    vm->push(vm->makeRuntimeString(result.c_str()));
     return 1;
 }
 
@@ -76,7 +76,7 @@ int native_path_normalize(Interpreter *vm, int argCount, Value *args)
         result += parts[i];
     }
     
-    vm->push(vm->makeString(result.c_str()));
+    vm->push(vm->makeRuntimeString(result.c_str()));
     return 1;
 }
 
@@ -90,7 +90,7 @@ int native_path_basename(Interpreter *vm, int argCount, Value *args)
     
     if (pos != std::string::npos)
     {
-        vm->push(vm->makeString(path.substr(pos + 1).c_str()));
+        vm->push(vm->makeRuntimeString(path.substr(pos + 1).c_str()));
         return 1;
     }
     
@@ -108,7 +108,7 @@ int native_path_dirname(Interpreter *vm, int argCount, Value *args)
     
     if (pos != std::string::npos)
     {
-        vm->push(vm->makeString(path.substr(0, pos).c_str()));
+        vm->push(vm->makeRuntimeString(path.substr(0, pos).c_str()));
         return 1;
     }
     
@@ -143,7 +143,7 @@ int native_path_extname(Interpreter *vm, int argCount, Value *args)
     if (pos != std::string::npos && 
         (slash == std::string::npos || pos > slash))
     {
-        vm->push(vm->makeString(path.substr(pos).c_str()));
+        vm->push(vm->makeRuntimeString(path.substr(pos).c_str()));
         return 1;
     }
     
@@ -0,0 +1,222 @@
+#include "interpreter.hpp"
+
+#ifdef BU_ENABLE_STRING_BUILDER
+
+// ============================================
+// STRING BUILDER - construção incremental de strings
+// ============================================
+// s = s + linha copia s inteira a cada passo (O(n^2) e uma string de runtime
+// nova por iteração). O builder acumula num buffer nativo que cresce por
+// duplicação e só cria a String no build().
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct StringBuilder
+{
+    char *data;
+    uint32 length;
+    uint32 capacity;
+};
+
+static bool sb_reserve(StringBuilder *sb, size_t needed)
+{
+    if (needed <= sb->capacity)
+        return true;
+    if (needed > 0xFFFFFFFFu)
+        return false;
+
+    size_t capacity = sb->capacity ? sb->capacity : 64;
+    while (capacity < needed)
+        capacity *= 2;
+    if (capacity > 0xFFFFFFFFu)
+        capacity = 0xFFFFFFFFu;
+
+    char *data = (char *)realloc(sb->data, capacity);
+    if (!data)
+        return false;
+    sb->data = data;
+    sb->capacity = (uint32)capacity;
+    return true;
+}
+
+static bool sb_write(StringBuilder *sb, const char *str, size_t len)
+{
+    if (!sb_reserve(sb, (size_t)sb->length + len))
+        return false;
+    std::memcpy(sb->data + sb->length, str, len);
+    sb->length += (uint32)len;
+    return true;
+}
+
+// Mesma forma que o operador + usa para juntar números a uma string
+static bool sb_write_value(Interpreter *vm, StringBuilder *sb, const Value &v)
+{
+    char buffer[64];
+    const char *str = buffer;
+    int len = 0;
+
+    switch (v.getType())
+    {
+    case ValueType::STRING:
+        str = v.asString()->chars();
+        len = (int)v.asString()->length();
+        break;
+    case ValueType::INT:
+        len = snprintf(buffer, sizeof(buffer), "%d", v.asInt());
+        break;
+    case ValueType::UINT:
+        len = snprintf(buffer, sizeof(buffer), "%u", v.asUInt());
+        break;
+    case ValueType::BYTE:
+        len = snprintf(buffer, sizeof(buffer), "%u", v.asByte());
+        break;
+    case ValueType::FLOAT:
+        len = snprintf(buffer, sizeof(buffer), "%.6f", v.asFloat());
+        break;
+    case ValueType::DOUBLE:
+        len = snprintf(buffer, sizeof(buffer), "%.6f", v.asDouble());
+        break;
+    case ValueType::BOOL:
+        str = v.asBool() ? "true" : "false";
+        len = v.asBool() ? 4 : 5;
+        break;
+    case ValueType::NIL:
+        str = "nil";
+        len = 3;
+        break;
+    default:
+        vm->runtimeError("StringBuilder.append expects string, number, bool or nil");
+        return false;
+    }
+
+    if (!sb_write(sb, str, (size_t)len))
+    {
+        vm->runtimeError("StringBuilder.append: out of memory");
+        return false;
+    }
+    return true;
+}
+
+static void *sb_ctor(Interpreter *vm, int argCount, Value *args)
+{
+    StringBuilder *sb = new StringBuilder();
+    sb->data = nullptr;
+    sb->length = 0;
+    sb->capacity = 0;
+    return sb;
+}
+
+static void sb_dtor(Interpreter *vm, void *instance)
+{
+    StringBuilder *sb = static_cast<StringBuilder *>(instance);
+    free(sb->data);
+    delete sb;
+}
+
+// append(v, ...) - junta cada argumento
+static int sb_append(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    StringBuilder *sb = static_cast<StringBuilder *>(instance);
+    for (int i = 0; i < argCount; i++)
+    {
+        if (!sb_write_value(vm, sb, args[i]))
+            return 0;
+    }
+    return 0;
+}
+
+// append_int(n)
+static int sb_append_int(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    StringBuilder *sb = static_cast<StringBuilder *>(instance);
+    if (argCount != 1 || !args[0].isNumber())
+    {
+        vm->runtimeError("StringBuilder.append_int expects a number");
+        return 0;
+    }
+
+    char buffer[32];
+    int len = snprintf(buffer, sizeof(buffer), "%d", (int)args[0].asNumber());
+    if (!sb_write(sb, buffer, (size_t)len))
+        vm->runtimeError("StringBuilder.append_int: out of memory");
+    return 0;
+}
+
+// append_float(n, [decimals]) - por defeito 6 casas, como o operador +
+static int sb_append_float(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    StringBuilder *sb = static_cast<StringBuilder *>(instance);
+    if (argCount < 1 || argCount > 2 || !args[0].isNumber() ||
+        (argCount == 2 && !args[1].isNumber()))
+    {
+        vm->runtimeError("StringBuilder.append_float expects (number, [decimals])");
+        return 0;
+    }
+
+    int decimals = argCount == 2 ? (int)args[1].asNumber() : 6;
+    if (decimals < 0)
+        decimals = 0;
+    if (decimals > 17)
+        decimals = 17;
+
+    char buffer[512];
+    int len = snprintf(buffer, sizeof(buffer), "%.*f", decimals, args[0].asNumber());
+    if (len >= (int)sizeof(buffer))
+        len = (int)sizeof(buffer) - 1;
+    if (!sb_write(sb, buffer, (size_t)len))
+        vm->runtimeError("StringBuilder.append_float: out of memory");
+    return 0;
+}
+
+// build() - cria a string; o builder continua utilizável
+static int sb_build(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    StringBuilder *sb = static_cast<StringBuilder *>(instance);
+    vm->push(vm->makeRuntimeString(sb->data ? sb->data : "", sb->length));
+    return 1;
+}
+
+// clear() - esvazia mas mantém a capacidade
+static int sb_clear(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    StringBuilder *sb = static_cast<StringBuilder *>(instance);
+    sb->length = 0;
+    return 0;
+}
+
+// reserve(n) - evita as realocações quando o tamanho final é conhecido
+static int sb_reserve_method(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    StringBuilder *sb = static_cast<StringBuilder *>(instance);
+    if (argCount != 1 || !args[0].isNumber())
+    {
+        vm->runtimeError("StringBuilder.reserve expects a number");
+        return 0;
+    }
+    double n = args[0].asNumber();
+    if (n > 0 && !sb_reserve(sb, (size_t)n))
+        vm->runtimeError("StringBuilder.reserve: out of memory");
+    return 0;
+}
+
+// property: length (read-only, em bytes)
+static Value sb_get_length(Interpreter *vm, void *instance)
+{
+    StringBuilder *sb = static_cast<StringBuilder *>(instance);
+    return vm->makeInt((int)sb->length);
+}
+
+void Interpreter::registerStringBuilder()
+{
+    NativeClassDef *klass = registerNativeClass("StringBuilder", sb_ctor, sb_dtor, 0);
+    addNativeMethod(klass, "append", sb_append);
+    addNativeMethod(klass, "append_int", sb_append_int);
+    addNativeMethod(klass, "append_float", sb_append_float);
+    addNativeMethod(klass, "build", sb_build);
+    addNativeMethod(klass, "clear", sb_clear);
+    addNativeMethod(klass, "reserve", sb_reserve_method);
+    addNativeProperty(klass, "length", sb_get_length, nullptr);
+}
+
+#endif
@@ -195,7 +195,7 @@ int native_time_format(Interpreter *vm, int argCount, Value *args)
             return 0;
         }
     
-    vm->push(vm->makeString(buffer));
+    vm->push(vm->makeRuntimeString(buffer));
     return 1;
 }
 
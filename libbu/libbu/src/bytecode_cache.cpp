@@ -0,0 +1,854 @@
+#include "interpreter.hpp"
+#include "compiler.hpp"
+#include "code.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================
+// BYTECODE CACHE (.buc)
+// ============================================
+// Guarda o resultado de um compile (funções, métodos, classes, structs,
+// processos, constantes e nomes dos globals) para o próximo arranque não
+// ter de voltar a ler/compilar o .bu e os includes.
+//
+//   header   "BUC\0" | version u32 | options u32 | hash da fonte u64
+//   strings  count u32 | (len u32, bytes)...   -> o resto usa índices u32
+//   plugins  (require) para carregar antes de resolver os natives
+//   includes nome + hash do conteúdo: se algum mudou, recompila
+//   natives  nome + índice no globalsArray: o host tem de registar igual
+//   globals  globalIndexToName do compiler
+//   functions, structs, classes (com os métodos), processes
+//
+// Inteiros em little-endian. Natives, native classes/structs e módulos vão
+// por nome e são resolvidos no load. Qualquer diferença = cache inválida e o
+// run() compila a fonte como sempre. BUC_VERSION sobe sempre que mudam
+// opcodes ou o formato.
+
+#define BUC_VERSION 3
+
+static const uint8 BUC_MAGIC[4] = {'B', 'U', 'C', 0};
+
+enum BucTag : uint8
+{
+  BUC_NIL,
+  BUC_FALSE,
+  BUC_TRUE,
+  BUC_INT,
+  BUC_UINT,
+  BUC_BYTE,
+  BUC_FLOAT,
+  BUC_DOUBLE,
+  BUC_STRING,
+  BUC_FUNCTION,
+  BUC_CLASS,
+  BUC_STRUCT,
+  BUC_PROCESS,
+  BUC_NATIVE,
+  BUC_NATIVE_PROCESS,
+  BUC_NATIVE_CLASS,
+  BUC_NATIVE_STRUCT,
+  BUC_MODULE_REF,
+};
+
+struct BucWriter
+{
+  std::vector<uint8> out;
+  std::vector<std::string> strings;
+  std::unordered_map<std::string, uint32> stringIds;
+
+  void u8(uint8 v) { out.push_back(v); }
+  void u16(uint16 v)
+  {
+    u8((uint8)(v & 0xff));
+    u8((uint8)(v >> 8));
+  }
+  void u32(uint32 v)
+  {
+    for (int i = 0; i < 4; i++)
+      u8((uint8)(v >> (8 * i)));
+  }
+  void u64(uint64_t v)
+  {
+    for (int i = 0; i < 8; i++)
+      u8((uint8)(v >> (8 * i)));
+  }
+  void bytes(const void *data, size_t size)
+  {
+    const uint8 *p = (const uint8 *)data;
+    out.insert(out.end(), p, p + size);
+  }
+
+  void str(const char *s, size_t len)
+  {
+    std::string key(s, len);
+    auto it = stringIds.find(key);
+    if (it != stringIds.end())
+    {
+      u32(it->second);
+      return;
+    }
+    uint32 id = (uint32)strings.size();
+    strings.push_back(key);
+    stringIds[key] = id;
+    u32(id);
+  }
+  void str(const std::string &s) { str(s.data(), s.size()); }
+  void str(String *s) { str(s->chars(), s->length()); }
+};
+
+struct BucReader
+{
+  const uint8 *p;
+  const uint8 *end;
+  bool ok{true};
+  std::vector<String *> strings;
+
+  bool need(size_t n)
+  {
+    if (ok && (size_t)(end - p) < n)
+      ok = false;
+    return ok;
+  }
+  uint8 u8() { return need(1) ? *p++ : 0; }
+  uint16 u16()
+  {
+    if (!need(2))
+      return 0;
+    uint16 v = (uint16)(p[0] | (p[1] << 8));
+    p += 2;
+    return v;
+  }
+  uint32 u32()
+  {
+    if (!need(4))
+      return 0;
+    uint32 v = 0;
+    for (int i = 0; i < 4; i++)
+      v |= (uint32)p[i] << (8 * i);
+    p += 4;
+    return v;
+  }
+  uint64_t u64()
+  {
+    if (!need(8))
+      return 0;
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+      v |= (uint64_t)p[i] << (8 * i);
+    p += 8;
+    return v;
+  }
+  String *str()
+  {
+    uint32 id = u32();
+    if (!ok || id >= strings.size())
+    {
+      ok = false;
+      return nullptr;
+    }
+    return strings[id];
+  }
+};
+
+static uint32 bucOptionFlags(const CompilerOptions &o)
+{
+  return (o.superinstructions ? 1u : 0u) | (o.directCalls ? 2u : 0u) |
+         (o.constantFolding ? 4u : 0u) | (o.peephole ? 8u : 0u) |
+         (o.inlining ? ((uint32)o.inlineMaxBytes << 8) | 16u : 0u) | (o.switchTables ? 32u : 0u);
+}
+
+void Interpreter::setBytecodeCache(const char *path)
+{
+  bytecodeCachePath_[0] = '\0';
+  if (path)
+  {
+    strncpy(bytecodeCachePath_, path, sizeof(bytecodeCachePath_) - 1);
+    bytecodeCachePath_[sizeof(bytecodeCachePath_) - 1] = '\0';
+  }
+}
+
+bool Interpreter::saveBytecode(const char *path, const char *source)
+{
+  if (!path || !source || functions.size() == 0 || processes.size() == 0)
+    return false;
+
+  BucWriter w;
+  bool ok = true;
+
+  auto writeValue = [&](const Value &v)
+  {
+    switch (v.getType())
+    {
+    case ValueType::NIL:
+      w.u8(BUC_NIL);
+      break;
+    case ValueType::BOOL:
+      w.u8(v.asBool() ? BUC_TRUE : BUC_FALSE);
+      break;
+    case ValueType::INT:
+      w.u8(BUC_INT);
+      w.u32((uint32)v.asInt());
+      break;
+    case ValueType::UINT:
+      w.u8(BUC_UINT);
+      w.u32(v.asUInt());
+      break;
+    case ValueType::BYTE:
+      w.u8(BUC_BYTE);
+      w.u8(v.asByte());
+      break;
+    case ValueType::FLOAT:
+    {
+      float f = v.asFloat();
+      uint32 bits;
+      memcpy(&bits, &f, sizeof(bits));
+      w.u8(BUC_FLOAT);
+      w.u32(bits);
+      break;
+    }
+    case ValueType::DOUBLE:
+    {
+      double d = v.asDouble();
+      uint64_t bits;
+      memcpy(&bits, &d, sizeof(bits));
+      w.u8(BUC_DOUBLE);
+      w.u64(bits);
+      break;
+    }
+    case ValueType::STRING:
+      w.u8(BUC_STRING);
+      w.str(v.asString());
+      break;
+    case ValueType::FUNCTION:
+      w.u8(BUC_FUNCTION);
+      w.u32((uint32)v.asFunctionId());
+      break;
+    case ValueType::CLASS:
+      w.u8(BUC_CLASS);
+      w.u32((uint32)v.asClassId());
+      break;
+    case ValueType::STRUCT:
+      w.u8(BUC_STRUCT);
+      w.u32((uint32)v.asStructId());
+      break;
+    case ValueType::PROCESS:
+      w.u8(BUC_PROCESS);
+      w.u32((uint32)v.asProcessId());
+      break;
+    case ValueType::NATIVE:
+      w.u8(BUC_NATIVE);
+      w.str(natives[v.asNativeId()].name);
+      break;
+    case ValueType::NATIVEPROCESS:
+      w.u8(BUC_NATIVE_PROCESS);
+      w.str(nativeProcesses[v.asNativeProcessId()].name);
+      break;
+    case ValueType::NATIVECLASS:
+      w.u8(BUC_NATIVE_CLASS);
+      w.str(nativeClasses[v.asClassNativeId()]->name);
+      break;
+    case ValueType::NATIVESTRUCT:
+      w.u8(BUC_NATIVE_STRUCT);
+      w.str(nativeStructs[v.asNativeStructId()]->name);
+      break;
+    case ValueType::MODULEREFERENCE:
+    {
+      uint32 ref = v.asModuleRef();
+      ModuleDef *mod = getModule((uint16)(ref >> 16));
+      String *funcName = nullptr;
+      if (!mod || !mod->getFunctionName((uint16)(ref & 0xFFFF), &funcName))
+      {
+        ok = false;
+        break;
+      }
+      w.u8(BUC_MODULE_REF);
+      w.str(mod->getName());
+      w.str(funcName);
+      break;
+    }
+    default:
+      // Instâncias/ponteiros não existem no fim de um compile
+      ok = false;
+      break;
+    }
+  };
+
+  auto writeFunction = [&](Function *func)
+  {
+    Code *chunk = func->chunk;
+    w.str(func->name);
+    w.u32((uint32)func->arity);
+    w.u8(func->hasReturn ? 1 : 0);
+    w.u32((uint32)func->upvalueCount);
+    w.u32((uint32)chunk->count);
+    w.bytes(chunk->code, chunk->count);
+    for (size_t i = 0; i < chunk->count; i++)
+      w.u32((uint32)chunk->lines[i]);
+    w.u32((uint32)chunk->constants.size());
+    for (size_t i = 0; i < chunk->constants.size(); i++)
+      writeValue(chunk->constants[i]);
+    w.u16(chunk->propertyCacheCount);
+
+    // Tabelas dos OP_SWITCH_TABLE: os slots das strings dependem só do hash
+    // do conteúdo, a mesma posição serve no load
+    w.u16(chunk->switchTableCount);
+    for (uint16 t = 0; t < chunk->switchTableCount; t++)
+    {
+      const SwitchTable &table = chunk->switchTables[t];
+      // Tabela por construir (switch com erro): o cache não se escreve
+      if (!table.targets)
+      {
+        ok = false;
+        continue;
+      }
+      w.u8(table.kind);
+      w.u16(table.caseCount);
+      w.u32((uint32)table.base);
+      w.u32(table.size);
+      for (uint32 i = 0; i < table.size; i++)
+      {
+        w.u16(table.slots[i]);
+        if (table.slots[i] == table.caseCount)
+          continue;
+        if (table.kind == SWITCH_HASH_INT)
+          w.u32((uint32)table.intKeys[i]);
+        else if (table.kind == SWITCH_HASH_STRING)
+          w.str(table.strKeys[i]);
+      }
+      for (uint32 i = 0; i <= table.caseCount; i++)
+        w.u32(table.targets[i]);
+    }
+  };
+
+  const std::vector<std::string> &plugins = compiler->getRequiredPlugins();
+  w.u32((uint32)plugins.size());
+  for (const std::string &name : plugins)
+    w.str(name);
+
+  const std::vector<Compiler::IncludeRecord> &includes = compiler->getIncludes();
+  w.u32((uint32)includes.size());
+  for (const Compiler::IncludeRecord &inc : includes)
+  {
+    w.str(inc.name);
+    w.u64(inc.hash);
+  }
+
+  uint32 nativeCount = 0;
+  nativeGlobalIndices.forEach([&](String *, uint16) { nativeCount++; });
+  w.u32(nativeCount);
+  nativeGlobalIndices.forEach([&](String *name, uint16 index)
+                              {
+    w.str(name);
+    w.u16(index); });
+
+  const std::vector<std::string> &globalNames = compiler->getGlobalIndexToName();
+  w.u32((uint32)globalNames.size());
+  for (const std::string &name : globalNames)
+    w.str(name);
+
+  w.u32((uint32)functions.size());
+  for (size_t i = 0; i < functions.size(); i++)
+    writeFunction(functions[i]);
+
+  w.u32((uint32)structs.size());
+  for (size_t i = 0; i < structs.size(); i++)
+  {
+    StructDef *def = structs[i];
+    w.str(def->name);
+    w.u8(def->argCount);
+    w.u32((uint32)def->names.count);
+    def->names.forEach([&](String *name, uint8 index)
+                       {
+      w.str(name);
+      w.u8(index); });
+  }
+
+  w.u32((uint32)classes.size());
+  for (size_t i = 0; i < classes.size(); i++)
+  {
+    ClassDef *klass = classes[i];
+    w.str(klass->name);
+    w.u32((uint32)klass->fieldCount);
+    w.u8(klass->inherited ? 1 : 0);
+    w.u32(klass->superclass ? (uint32)klass->superclass->index : UINT32_MAX);
+    w.u8(klass->nativeSuperclass ? 1 : 0);
+    if (klass->nativeSuperclass)
+      w.str(klass->nativeSuperclass->name);
+
+    w.u32((uint32)klass->fieldNames.count);
+    klass->fieldNames.forEach([&](String *name, uint8 index)
+                              {
+      w.str(name);
+      w.u8(index); });
+
+    w.u32((uint32)klass->fieldDefaults.size());
+    for (size_t k = 0; k < klass->fieldDefaults.size(); k++)
+      writeValue(klass->fieldDefaults[k]);
+
+    w.u32((uint32)klass->methods.count);
+    klass->methods.forEach([&](String *, Function *method)
+                           { writeFunction(method); });
+  }
+
+  w.u32((uint32)processes.size());
+  for (size_t i = 0; i < processes.size(); i++)
+  {
+    ProcessDef *proc = processes[i];
+    Function *func = proc->fibers[0].frames[0].func;
+    w.str(proc->name);
+    w.u32(func ? (uint32)func->index : UINT32_MAX);
+    w.u32((uint32)proc->totalFibers);
+    w.u32((uint32)proc->argsNames.size());
+    for (size_t k = 0; k < proc->argsNames.size(); k++)
+      w.u8(proc->argsNames[k]);
+  }
+
+  if (!ok)
+  {
+    Warning("Bytecode cache '%s' not written: unsupported constant or switch table", path);
+    return false;
+  }
+
+  // Header + tabela de strings à frente do corpo
+  BucWriter head;
+  head.bytes(BUC_MAGIC, sizeof(BUC_MAGIC));
+  head.u32(BUC_VERSION);
+  head.u32(bucOptionFlags(compiler->getOptions()));
+  head.u64(Compiler::hashSource(source, strlen(source)));
+  head.u32((uint32)w.strings.size());
+  for (const std::string &s : w.strings)
+  {
+    head.u32((uint32)s.size());
+    head.bytes(s.data(), s.size());
+  }
+
+  FILE *f = fopen(path, "wb");
+  if (!f)
+  {
+    Warning("Bytecode cache '%s' not written: cannot open file", path);
+    return false;
+  }
+  bool written = fwrite(head.out.data(), 1, head.out.size(), f) == head.out.size() &&
+                 fwrite(w.out.data(), 1, w.out.size(), f) == w.out.size();
+  written = (fclose(f) == 0) && written;
+  if (!written)
+  {
+    ::remove(path);
+    Warning("Bytecode cache '%s' not written: write failed", path);
+  }
+  return written;
+}
+
+bool Interpreter::loadBytecode(const char *path, const char *source)
+{
+  bytecodeCacheHit_ = false;
+  if (!path || !source)
+    return false;
+
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if (size <= 0)
+  {
+    fclose(f);
+    return false;
+  }
+  std::vector<uint8> data((size_t)size);
+  bool readOk = fread(data.data(), 1, data.size(), f) == data.size();
+  fclose(f);
+  if (!readOk)
+    return false;
+
+  BucReader r;
+  r.p = data.data();
+  r.end = data.data() + data.size();
+
+  // ---- Validação: nada do programa anterior é tocado até aqui ----
+  if (!r.need(sizeof(BUC_MAGIC)) || memcmp(r.p, BUC_MAGIC, sizeof(BUC_MAGIC)) != 0)
+    return false;
+  r.p += sizeof(BUC_MAGIC);
+  if (r.u32() != BUC_VERSION || r.u32() != bucOptionFlags(compiler->getOptions()))
+    return false;
+  if (r.u64() != Compiler::hashSource(source, strlen(source)) || !r.ok)
+    return false;
+
+  uint32 stringCount = r.u32();
+  r.strings.reserve(stringCount);
+  for (uint32 i = 0; i < stringCount && r.ok; i++)
+  {
+    uint32 len = r.u32();
+    if (!r.need(len))
+      break;
+    // O pool procura por C string: precisa do '\0'
+    std::string chars((const char *)r.p, len);
+    r.strings.push_back(createString(chars.c_str(), len));
+    r.p += len;
+  }
+
+  uint32 pluginCount = r.u32();
+  for (uint32 i = 0; i < pluginCount && r.ok; i++)
+  {
+    String *name = r.str();
+    if (name && !containsModule(name->chars()) && !loadPluginByName(name->chars()))
+      return false;
+  }
+
+  uint32 includeCount = r.u32();
+  for (uint32 i = 0; i < includeCount && r.ok; i++)
+  {
+    String *name = r.str();
+    uint64_t hash = r.u64();
+    uint64_t current = 0;
+    if (!r.ok || !compiler->hashInclude(name->chars(), &current) || current != hash)
+      return false;
+  }
+
+  uint32 nativeCount = r.u32();
+  uint32 hostNatives = 0;
+  nativeGlobalIndices.forEach([&](String *, uint16) { hostNatives++; });
+  if (nativeCount != hostNatives)
+    return false;
+  for (uint32 i = 0; i < nativeCount && r.ok; i++)
+  {
+    String *name = r.str();
+    uint16 index = r.u16();
+    uint16 current = 0;
+    if (!r.ok || !nativeGlobalIndices.get(name, &current) || current != index)
+      return false;
+  }
+
+  uint32 globalCount = r.u32();
+  std::vector<String *> globalNames;
+  globalNames.reserve(globalCount);
+  for (uint32 i = 0; i < globalCount && r.ok; i++)
+    globalNames.push_back(r.str());
+  if (!r.ok)
+    return false;
+
+  // ---- Reconstrução ----
+  reset();
+
+  auto readValue = [&](Value *out) -> bool
+  {
+    uint8 tag = r.u8();
+    switch (tag)
+    {
+    case BUC_NIL:
+      *out = makeNil();
+      break;
+    case BUC_FALSE:
+      *out = makeBool(false);
+      break;
+    case BUC_TRUE:
+      *out = makeBool(true);
+      break;
+    case BUC_INT:
+      *out = makeInt((int)r.u32());
+      break;
+    case BUC_UINT:
+      *out = makeUInt(r.u32());
+      break;
+    case BUC_BYTE:
+      *out = makeByte(r.u8());
+      break;
+    case BUC_FLOAT:
+    {
+      uint32 bits = r.u32();
+      float fv;
+      memcpy(&fv, &bits, sizeof(fv));
+      *out = makeFloat(fv);
+      break;
+    }
+    case BUC_DOUBLE:
+    {
+      uint64_t bits = r.u64();
+      double d;
+      memcpy(&d, &bits, sizeof(d));
+      *out = makeDouble(d);
+      break;
+    }
+    case BUC_STRING:
+    {
+      String *s = r.str();
+      if (!s)
+        return false;
+      *out = makeString(s);
+      break;
+    }
+    case BUC_FUNCTION:
+      *out = makeFunction((int)r.u32());
+      break;
+    case BUC_CLASS:
+      *out = makeClass((int)r.u32());
+      break;
+    case BUC_STRUCT:
+      *out = makeStruct((int)r.u32());
+      break;
+    case BUC_PROCESS:
+      *out = makeProcess((int)r.u32());
+      break;
+    case BUC_NATIVE:
+    {
+      String *name = r.str();
+      NativeDef def;
+      if (!name || !nativesMap.get(name, &def))
+        return false;
+      *out = makeNative((int)def.index);
+      break;
+    }
+    case BUC_NATIVE_PROCESS:
+    {
+      String *name = r.str();
+      NativeProcessDef def;
+      if (!name || !nativeProcessesMap.get(name, &def))
+        return false;
+      *out = makeNativeProcess((int)def.index);
+      break;
+    }
+    case BUC_NATIVE_CLASS:
+    {
+      String *name = r.str();
+      NativeClassDef *def = nullptr;
+      if (!name || !nativeClassesMap.get(name, &def))
+        return false;
+      *out = makeNativeClass(def->index);
+      break;
+    }
+    case BUC_NATIVE_STRUCT:
+    {
+      String *name = r.str();
+      int id = -1;
+      for (size_t i = 0; name && i < nativeStructs.size(); i++)
+      {
+        if (compare_strings(nativeStructs[i]->name, name))
+        {
+          id = nativeStructs[i]->id;
+          break;
+        }
+      }
+      if (id < 0)
+        return false;
+      *out = makeNativeStruct(id);
+      break;
+    }
+    case BUC_MODULE_REF:
+    {
+      String *modName = r.str();
+      String *funcName = r.str();
+      uint16 moduleId = 0;
+      uint16 funcId = 0;
+      if (!modName || !funcName || !getModuleId(modName, &moduleId))
+        return false;
+      ModuleDef *mod = getModule(moduleId);
+      if (!mod || !mod->getFunctionId(funcName, &funcId))
+        return false;
+      *out = makeModuleRef(moduleId, funcId);
+      break;
+    }
+    default:
+      return false;
+    }
+    return r.ok;
+  };
+
+  // O nome já foi lido (addFunction / canRegisterFunction)
+  auto readFunctionBody = [&](Function *func) -> bool
+  {
+    func->arity = (int)r.u32();
+    func->hasReturn = r.u8() != 0;
+    func->upvalueCount = (int)r.u32();
+
+    Code *chunk = func->chunk;
+    uint32 count = r.u32();
+    if (!r.need((size_t)count * 5))
+      return false;
+    chunk->reserve(count > 0 ? count : 1);
+    memcpy(chunk->code, r.p, count);
+    r.p += count;
+    for (uint32 i = 0; i < count; i++)
+      chunk->lines[i] = (int)r.u32();
+    chunk->count = count;
+
+    uint32 constantCount = r.u32();
+    for (uint32 i = 0; i < constantCount && r.ok; i++)
+    {
+      Value v;
+      if (!readValue(&v))
+        return false;
+      chunk->constants.push(v);
+    }
+
+    uint16 caches = r.u16();
+    for (uint16 i = 0; i < caches; i++)
+    {
+      if (chunk->addPropertyCache() < 0)
+        return false;
+    }
+
+    uint16 tables = r.u16();
+    for (uint16 t = 0; t < tables && r.ok; t++)
+    {
+      int index = chunk->addSwitchTable();
+      if (index < 0)
+        return false;
+      SwitchTable *table = &chunk->switchTables[index];
+      uint8 kind = r.u8();
+      uint16 caseCount = r.u16();
+      int32 base = (int32)r.u32();
+      uint32 size = r.u32();
+      if (!r.ok || kind > SWITCH_HASH_STRING || !r.need(size) ||
+          !chunk->allocSwitchTable(table, kind, caseCount, size))
+        return false;
+      table->base = base;
+      for (uint32 i = 0; i < size && r.ok; i++)
+      {
+        uint16 slot = r.u16();
+        if (slot > caseCount)
+          return false;
+        table->slots[i] = slot;
+        if (slot == caseCount)
+          continue;
+        if (kind == SWITCH_HASH_INT)
+          table->intKeys[i] = (int32)r.u32();
+        else if (kind == SWITCH_HASH_STRING && !(table->strKeys[i] = r.str()))
+          return false;
+      }
+      for (uint32 i = 0; i <= caseCount && r.ok; i++)
+      {
+        table->targets[i] = r.u32();
+        if (table->targets[i] > count)
+          return false;
+      }
+    }
+    return r.ok;
+  };
+
+  auto fail = [&]() -> bool
+  {
+    Warning("Bytecode cache '%s' is corrupt, recompiling", path);
+    reset();
+    return false;
+  };
+
+  uint32 functionCount = r.u32();
+  for (uint32 i = 0; i < functionCount && r.ok; i++)
+  {
+    String *name = r.str();
+    Function *func = name ? addFunction(name->chars(), 0) : nullptr;
+    if (!func || func->index != (int)i || !readFunctionBody(func))
+      return fail();
+  }
+
+  uint32 structCount = r.u32();
+  for (uint32 i = 0; i < structCount && r.ok; i++)
+  {
+    String *name = r.str();
+    StructDef *def = name ? registerStruct(name) : nullptr;
+    if (!def)
+      return fail();
+    def->argCount = r.u8();
+    uint32 fieldCount = r.u32();
+    for (uint32 k = 0; k < fieldCount && r.ok; k++)
+    {
+      String *field = r.str();
+      uint8 index = r.u8();
+      if (field)
+        def->names.set(field, index);
+    }
+  }
+
+  uint32 classCount = r.u32();
+  for (uint32 i = 0; i < classCount && r.ok; i++)
+  {
+    String *name = r.str();
+    ClassDef *klass = name ? registerClass(name) : nullptr;
+    if (!klass)
+      return fail();
+    klass->fieldCount = (int)r.u32();
+    klass->inherited = r.u8() != 0;
+
+    uint32 super = r.u32();
+    if (super != UINT32_MAX)
+    {
+      if (super >= i)
+        return fail();
+      klass->superclass = classes[super];
+      klass->parent = klass->superclass->name;
+    }
+    if (r.u8())
+    {
+      String *nativeName = r.str();
+      if (!nativeName || !nativeClassesMap.get(nativeName, &klass->nativeSuperclass))
+        return fail();
+      klass->parent = klass->nativeSuperclass->name;
+    }
+
+    uint32 fieldCount = r.u32();
+    for (uint32 k = 0; k < fieldCount && r.ok; k++)
+    {
+      String *field = r.str();
+      uint8 index = r.u8();
+      if (field)
+        klass->fieldNames.set(field, index);
+    }
+
+    uint32 defaultCount = r.u32();
+    for (uint32 k = 0; k < defaultCount && r.ok; k++)
+    {
+      Value v;
+      if (!readValue(&v))
+        return fail();
+      klass->fieldDefaults.push(v);
+    }
+
+    uint32 methodCount = r.u32();
+    for (uint32 k = 0; k < methodCount && r.ok; k++)
+    {
+      String *methodName = r.str();
+      Function *method = methodName ? klass->canRegisterFunction(methodName) : nullptr;
+      if (!method)
+        return fail();
+      addFunctionsClasses(method);
+      if (strcmp(methodName->chars(), "init") == 0)
+        klass->constructor = method;
+      if (!readFunctionBody(method))
+        return fail();
+    }
+  }
+
+  uint32 processCount = r.u32();
+  for (uint32 i = 0; i < processCount && r.ok; i++)
+  {
+    String *name = r.str();
+    uint32 funcIndex = r.u32();
+    int totalFibers = (int)r.u32();
+    if (!r.ok || !name || funcIndex >= functions.size() || totalFibers < 1)
+      return fail();
+    ProcessDef *proc = addProcess(name->chars(), functions[funcIndex], totalFibers);
+    if (!proc || proc->index != (int)i)
+      return fail();
+    uint32 argCount = r.u32();
+    for (uint32 k = 0; k < argCount && r.ok; k++)
+      proc->argsNames.push(r.u8());
+    proc->finalize();
+  }
+
+  if (!r.ok || r.p != r.end || processes.size() == 0)
+    return fail();
+
+  globalIndexToName_.clear();
+  globalIndexToName_.reserve(globalNames.size());
+  for (size_t i = 0; i < globalNames.size(); i++)
+    globalIndexToName_.push(globalNames[i]);
+  if (globalsArray.size() < globalIndexToName_.size())
+    growGlobals(globalIndexToName_.size());
+
+  bytecodeCacheHit_ = true;
+  return true;
+}
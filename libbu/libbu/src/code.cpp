@@ -13,7 +13,14 @@ Code::Code(size_t capacity)
     nilIndex = -1;
     trueIndex = -1;
     falseIndex = -1;
-  
+
+    propertyCaches = nullptr;
+    propertyCacheCount = 0;
+    propertyCacheCapacity = 0;
+
+    switchTables = nullptr;
+    switchTableCount = 0;
+    switchTableCapacity = 0;
 }
 
 void Code::freeze()
@@ -26,7 +33,7 @@ void Code::freeze()
 int Code::addConstant(Value value)
 {
     // 1. Tipos mutáveis - sempre  novo
-    switch (value.type)
+    switch (value.getType())
     {
         case ValueType::CLASSINSTANCE:
         case ValueType::NATIVECLASSINSTANCE:
@@ -43,7 +50,7 @@ int Code::addConstant(Value value)
     }
     
     // 2. Fast path para valores muito comuns
-    if (value.type == ValueType::NIL)
+    if (value.getType() == ValueType::NIL)
     {
         if (nilIndex == -1)
         {
@@ -53,7 +60,7 @@ int Code::addConstant(Value value)
         return nilIndex;
     }
     
-    if (value.type == ValueType::BOOL)
+    if (value.getType() == ValueType::BOOL)
     {
         if (value.asBool())
         {
@@ -76,12 +83,12 @@ int Code::addConstant(Value value)
     }
     
     // 3. Loop para outros tipos
-    if (value.type == ValueType::STRING)
+    if (value.getType() == ValueType::STRING)
     {
         String *str = value.asString();
         for (int i = 0; i < constants.size(); i++)
         {
-            if (constants[i].type == ValueType::STRING &&
+            if (constants[i].getType() == ValueType::STRING &&
                 constants[i].asString() == str)  
             {
                // Warning("Constant already exists");
@@ -89,11 +96,11 @@ int Code::addConstant(Value value)
             }
         }
     }
-    else if (value.type == ValueType::INT)
+    else if (value.getType() == ValueType::INT)
     {
         for (int i = 0; i < constants.size(); i++)
         {
-            if (constants[i].type == ValueType::INT &&
+            if (constants[i].getType() == ValueType::INT &&
                 constants[i].asInt() == value.asInt())
             {
               //  Warning("Constant already exists");
@@ -101,11 +108,11 @@ int Code::addConstant(Value value)
             }
         }
     }
-    else if (value.type == ValueType::DOUBLE)
+    else if (value.getType() == ValueType::DOUBLE)
     {
         for (int i = 0; i < constants.size(); i++)
         {
-            if (constants[i].type == ValueType::DOUBLE &&
+            if (constants[i].getType() == ValueType::DOUBLE &&
                 constants[i].asDouble() == value.asDouble())
             {
               //  Warning("Constant already exists");
@@ -113,19 +120,19 @@ int Code::addConstant(Value value)
             }
         }
     }
-    else if (value.type == ValueType::CLASS || 
-             value.type == ValueType::STRUCT || 
-             value.type == ValueType::NATIVE  || 
-             value.type == ValueType::FUNCTION ||
-             value.type == ValueType::NATIVECLASS || 
-             value.type == ValueType::PROCESS || 
-             value.type == ValueType::NATIVESTRUCT
+    else if (value.getType() == ValueType::CLASS || 
+             value.getType() == ValueType::STRUCT || 
+             value.getType() == ValueType::NATIVE  || 
+             value.getType() == ValueType::FUNCTION ||
+             value.getType() == ValueType::NATIVECLASS || 
+             value.getType() == ValueType::PROCESS || 
+             value.getType() == ValueType::NATIVESTRUCT
             )
     {
         for (int i = 0; i < constants.size(); i++)
         {
-            if (constants[i].type == value.type &&
-                constants[i].as.integer == value.as.integer)
+            if (constants[i].getType() == value.getType() &&
+                constants[i].asId() == value.asId())
             {
               // Warning("Constant already exists");
                 return i;
@@ -140,6 +147,93 @@ int Code::addConstant(Value value)
 }
 
 
+int Code::addPropertyCache()
+{
+    if (propertyCacheCount == UINT16_MAX)
+        return -1;
+
+    if (propertyCacheCount == propertyCacheCapacity)
+    {
+        uint16 newCapacity = propertyCacheCapacity < 8 ? 8 : propertyCacheCapacity * 2;
+        if (newCapacity < propertyCacheCapacity)
+            newCapacity = UINT16_MAX;
+        PropertyCache *newCaches = (PropertyCache *)aRealloc(propertyCaches, newCapacity * sizeof(PropertyCache));
+        if (!newCaches)
+            return -1;
+        propertyCaches = newCaches;
+        propertyCacheCapacity = newCapacity;
+    }
+
+    PropertyCache *cache = &propertyCaches[propertyCacheCount];
+    std::memset(cache, 0, sizeof(PropertyCache));
+    return propertyCacheCount++;
+}
+
+int Code::addSwitchTable()
+{
+    if (switchTableCount == UINT16_MAX)
+        return -1;
+
+    if (switchTableCount == switchTableCapacity)
+    {
+        uint16 newCapacity = switchTableCapacity < 4 ? 4 : switchTableCapacity * 2;
+        if (newCapacity < switchTableCapacity)
+            newCapacity = UINT16_MAX;
+        SwitchTable *newTables = (SwitchTable *)aRealloc(switchTables, newCapacity * sizeof(SwitchTable));
+        if (!newTables)
+            return -1;
+        switchTables = newTables;
+        switchTableCapacity = newCapacity;
+    }
+
+    SwitchTable *table = &switchTables[switchTableCount];
+    std::memset(table, 0, sizeof(SwitchTable));
+    return switchTableCount++;
+}
+
+// Slots começam todos no default (caseCount); chaves só nas tabelas hash
+bool Code::allocSwitchTable(SwitchTable *table, uint8 kind, uint16 caseCount, uint32 size)
+{
+    if (size == 0 || (kind != SWITCH_DENSE && (size & (size - 1)) != 0))
+        return false;
+
+    table->kind = kind;
+    table->caseCount = caseCount;
+    table->size = size;
+    table->slots = (uint16 *)aAlloc(size * sizeof(uint16));
+    table->targets = (uint32 *)aAlloc((caseCount + 1) * sizeof(uint32));
+    if (kind == SWITCH_HASH_INT)
+        table->intKeys = (int32 *)aAlloc(size * sizeof(int32));
+    else if (kind == SWITCH_HASH_STRING)
+        table->strKeys = (String **)aAlloc(size * sizeof(String *));
+
+    if (!table->slots || !table->targets ||
+        (kind == SWITCH_HASH_INT && !table->intKeys) || (kind == SWITCH_HASH_STRING && !table->strKeys))
+        return false;
+
+    for (uint32 i = 0; i < size; i++)
+        table->slots[i] = caseCount;
+    for (uint32 i = 0; i <= caseCount; i++)
+        table->targets[i] = 0;
+    return true;
+}
+
+void Code::dropSwitchTables(uint16 first)
+{
+    for (uint16 i = first; i < switchTableCount; i++)
+    {
+        SwitchTable &table = switchTables[i];
+        aFree(table.slots);
+        aFree(table.targets);
+        if (table.intKeys)
+            aFree(table.intKeys);
+        if (table.strKeys)
+            aFree(table.strKeys);
+    }
+    if (first < switchTableCount)
+        switchTableCount = first;
+}
+
 void Code::clear()
 {
     if (code)
@@ -152,6 +246,21 @@ void Code::clear()
         aFree(lines);
         lines = nullptr;
     }
+    if (propertyCaches)
+    {
+        aFree(propertyCaches);
+        propertyCaches = nullptr;
+    }
+    propertyCacheCount = 0;
+    propertyCacheCapacity = 0;
+    dropSwitchTables(0);
+    if (switchTables)
+    {
+        aFree(switchTables);
+        switchTables = nullptr;
+    }
+    switchTableCount = 0;
+    switchTableCapacity = 0;
     constants.destroy();
     m_capacity = 0;
     count = 0;
@@ -208,10 +317,10 @@ uint8 Code::operator[](size_t index)
 bool ValueEq::operator()(const Value &a, const Value &b) const
 {
     {
-        if (a.type != b.type)
+        if (a.getType() != b.getType())
             return false;
 
-        switch (a.type)
+        switch (a.getType())
         {
         case ValueType::NIL:
             return true;
@@ -231,7 +340,7 @@ bool ValueEq::operator()(const Value &a, const Value &b) const
         case ValueType::CLASS:
         case ValueType::STRUCT:
         case ValueType::NATIVE:
-            return a.as.integer == b.as.integer;
+            return a.asId() == b.asId();
 
         default:
             return false;
@@ -242,7 +351,7 @@ bool ValueEq::operator()(const Value &a, const Value &b) const
 size_t ValueHasher::operator()(const Value &v) const
 {
     {
-        switch (v.type)
+        switch (v.getType())
         {
         case ValueType::NIL:
             return 0;
@@ -280,7 +389,7 @@ size_t ValueHasher::operator()(const Value &v) const
         case ValueType::CLASS:
         case ValueType::STRUCT:
         case ValueType::NATIVE:
-            return v.as.integer; // Id do objeto
+            return v.asId(); // Id do objeto
         default:
             return 0; // Objetos não vão no cache
         }
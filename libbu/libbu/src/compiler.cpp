@@ -5,9 +5,12 @@
 #include "opcode.hpp"
 #include "pool.hpp"
 #include "value.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
 #include <stdarg.h>
+#include <thread>
 
 // ============================================
 // PARSE RULE TABLE - DEFINIÇÃO
@@ -37,15 +40,22 @@ Compiler::Compiler(Interpreter *vm)
 }
 
 Compiler::~Compiler()
+{
+  releaseLexers();
+  releaseIncludeUnits();
+}
+
+void Compiler::releaseLexers()
 {
   delete lexer;
+  lexer = nullptr;
 }
 
 // ============================================
 // GLOBAL VARIABLE INDEXING
 // ============================================
 
-uint16 Compiler::getOrCreateGlobalIndex(const std::string &name)
+uint16 Compiler::getOrCreateGlobalIndex(String *name)
 {
   auto it = globalIndices_.find(name);
   if (it != globalIndices_.end())
@@ -62,11 +72,24 @@ uint16 Compiler::getOrCreateGlobalIndex(const std::string &name)
   {
     globalIndexToName_.resize(index + 1);
   }
-  globalIndexToName_[index] = name;
+  globalIndexToName_[index] = name->chars();
 
   return index;
 }
 
+void Compiler::importGlobal(String *name, uint16 index)
+{
+  if (globalIndices_.find(name) != globalIndices_.end())
+    return;
+  globalIndices_[name] = index;
+  if (index >= globalIndexToName_.size())
+  {
+    globalIndexToName_.resize(index + 1);
+  }
+  globalIndexToName_[index] = name->chars();
+  declaredGlobals_.insert(name);
+}
+
 // ============================================
 // INICIALIZAÇÃO DA TABELA
 // ============================================
@@ -204,8 +227,8 @@ void Compiler::predeclareProcessGlobals()
       continue;
 
     // Make forward process calls resolvable regardless of declaration order.
-    declaredGlobals_.insert(nameTok.lexeme);
-    getOrCreateGlobalIndex(nameTok.lexeme);
+    declaredGlobals_.insert(nameTok.str);
+    getOrCreateGlobalIndex(nameTok.str);
   }
 }
 
@@ -256,16 +279,203 @@ void Compiler::setFileLoader(FileLoaderCallback loader, void *userdata)
   fileLoaderUserdata = userdata;
 }
 
+// FNV-1a 64 bits: chave do bytecode cache (fonte principal e includes)
+uint64_t Compiler::hashSource(const char *data, size_t size)
+{
+  uint64_t h = 14695981039346656037ull;
+  const uint8 *p = (const uint8 *)data;
+  for (size_t i = 0; i < size; i++)
+  {
+    h ^= p[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+bool Compiler::hashInclude(const char *filename, uint64_t *outHash)
+{
+  if (!fileLoader)
+    return false;
+
+  size_t size = 0;
+  const char *source = fileLoader(filename, &size, fileLoaderUserdata);
+  if (!source || size == 0)
+    return false;
+
+  *outHash = hashSource(source, size);
+  return true;
+}
+
+// Tokens do include: da cache se o conteúdo não mudou, senão lexer novo
+// (a unidade antiga, se existir, é substituída)
+Compiler::IncludeUnit *Compiler::loadIncludeUnit(const std::string &filename, const char *source, size_t size,
+                                                 bool *reused)
+{
+  uint64_t hash = hashSource(source, size);
+  auto it = includeUnits_.find(filename);
+  if (it != includeUnits_.end())
+  {
+    if (it->second.hash == hash)
+    {
+      *reused = true;
+      stats.includesReused++;
+      return &it->second;
+    }
+    delete it->second.lexer;
+    includeUnits_.erase(it);
+  }
+
+  *reused = false;
+  IncludeUnit &unit = includeUnits_[filename];
+  unit.hash = hash;
+  unit.lexer = new Lexer(source, size, &vm_->stringPool);
+  unit.tokens = unit.lexer->scanAll();
+  return &unit;
+}
+
+// include "nome" nos tokens, pela ordem em que aparecem
+static void collectIncludes(const std::vector<Token> &tokens, std::vector<std::string> *out)
+{
+  for (size_t i = 0; i + 1 < tokens.size(); i++)
+  {
+    if (tokens[i].type == TOKEN_INCLUDE && tokens[i + 1].type == TOKEN_STRING)
+      out->push_back(tokens[i + 1].chars());
+  }
+}
+
+// Antes do compile: as unidades de todos os includes do programa ficam
+// prontas. O fileLoader (callback do host) é chamado numa só thread, o lexer
+// das unidades novas corre em paralelo (sem pool) e os String* são criados
+// depois, pela ordem dos ficheiros: o resultado não depende das threads.
+// O codegen continua single-pass no includeStatement. Por ondas, para os
+// includes dentro dos includes. As atribuições de todas as unidades entram
+// já no assignedNames_: uma função trocada num include posterior não é inlined.
+void Compiler::preloadIncludes()
+{
+  preloadedIncludes_.clear();
+  if (!fileLoader)
+    return;
+
+  struct LexJob
+  {
+    std::string name;
+    uint64_t hash;
+    Lexer *lexer;
+    std::vector<Token> tokens;
+  };
+
+  std::vector<std::string> wave;
+  collectIncludes(tokens, &wave);
+
+  while (!wave.empty())
+  {
+    std::vector<LexJob> jobs;
+    std::vector<std::string> next;
+
+    for (const std::string &name : wave)
+    {
+      if (preloadedIncludes_.count(name) > 0)
+        continue;
+
+      // Falhas ficam para o includeStatement (mensagem de erro no sítio)
+      size_t size = 0;
+      const char *source = fileLoader(name.c_str(), &size, fileLoaderUserdata);
+      if (!source || size == 0)
+        continue;
+
+      uint64_t hash = hashSource(source, size);
+      auto it = includeUnits_.find(name);
+      if (it != includeUnits_.end() && it->second.hash == hash)
+      {
+        preloadedIncludes_[name] = true;
+        stats.includesReused++;
+        noteAssignedNames(it->second.tokens);
+        collectIncludes(it->second.tokens, &next);
+        continue;
+      }
+
+      preloadedIncludes_[name] = false;
+      // O buffer do loader pode ser reutilizado: o Lexer copia a fonte já
+      jobs.push_back({name, hash, new Lexer(source, size, nullptr), {}});
+    }
+
+    int threads = options.compileThreads > 0 ? options.compileThreads : (int)std::thread::hardware_concurrency();
+    threads = std::min(threads, (int)jobs.size());
+    if (threads <= 1)
+    {
+      for (LexJob &job : jobs)
+        job.tokens = job.lexer->scanAll();
+    }
+    else
+    {
+      std::atomic<size_t> nextJob{0};
+      auto worker = [&]()
+      {
+        for (size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+          jobs[i].tokens = jobs[i].lexer->scanAll();
+      };
+      std::vector<std::thread> workers;
+      workers.reserve((size_t)threads - 1);
+      for (int t = 1; t < threads; t++)
+        workers.emplace_back(worker);
+      worker();
+      for (std::thread &t : workers)
+        t.join();
+    }
+
+    for (LexJob &job : jobs)
+    {
+      job.lexer->internDeferred(&vm_->stringPool, job.tokens);
+
+      auto it = includeUnits_.find(job.name);
+      if (it != includeUnits_.end())
+        delete it->second.lexer;
+      IncludeUnit &unit = includeUnits_[job.name];
+      unit.hash = job.hash;
+      unit.lexer = job.lexer;
+      unit.tokens = std::move(job.tokens);
+      noteAssignedNames(unit.tokens);
+      collectIncludes(unit.tokens, &next);
+    }
+
+    wave.swap(next);
+  }
+}
+
+void Compiler::releaseIncludeUnits()
+{
+  for (auto &entry : includeUnits_)
+    delete entry.second.lexer;
+  includeUnits_.clear();
+}
+
 ProcessDef *Compiler::compile(const std::string &source)
 {
-  delete lexer;
-  lexer = new Lexer(source);
+  releaseLexers();
+  lexer = new Lexer(source, &vm_->stringPool);
   stats.maxExpressionDepth = 0;
   stats.maxScopeDepth = 0;
   stats.totalErrors = 0;
   stats.totalWarnings = 0;
+  stats.peepholeBytesRemoved = 0;
+  stats.deadStoresRemoved = 0;
+  stats.callsInlined = 0;
+  stats.includesReused = 0;
+  deadStores_.clear();
+  globalVarDecls_.clear();
+  globalRead_.clear();
+  constGlobals_.clear();
   enclosingStack_.clear();
   declaredGlobals_.clear();
+  directFunctions_.clear();
+  inlineBodies_.clear();
+  assignedNames_.clear();
+  inlineDecisions_.clear();
+  directCallee_ = -1;
+  directCalleeChunk_ = nullptr;
+  constChunk_ = nullptr;
+  includes_.clear();
+  requiredPlugins_.clear();
   upvalueCount_ = 0;
   isProcess_ = true; // Top-level code IS a process
   switchDepth_ = 0;
@@ -277,15 +487,7 @@ ProcessDef *Compiler::compile(const std::string &source)
   // Copy actual indices from VM's nativeGlobalIndices map
   // This ensures compiler uses the same indices as runtime
   vm_->nativeGlobalIndices.forEach([this](String *nameStr, uint16 index)
-                                   {
-    const std::string name = nameStr->chars();
-    globalIndices_[name] = index;
-    if (index >= globalIndexToName_.size())
-    {
-      globalIndexToName_.resize(index + 1);
-    }
-    globalIndexToName_[index] = name;
-    declaredGlobals_.insert(name); });
+                                   { importGlobal(nameStr, index); });
 
   // Também importar globals registados via addGlobal()
   for (size_t i = 0; i < vm_->globalIndexToName_.size(); i++)
@@ -293,17 +495,7 @@ ProcessDef *Compiler::compile(const std::string &source)
     String *nameStr = vm_->globalIndexToName_[i];
     if (!nameStr)
       continue;
-    const std::string name = nameStr->chars();
-    if (globalIndices_.find(name) == globalIndices_.end())
-    {
-      globalIndices_[name] = (uint16)i;
-      if (i >= globalIndexToName_.size())
-      {
-        globalIndexToName_.resize(i + 1);
-      }
-      globalIndexToName_[i] = name;
-      declaredGlobals_.insert(name);
-    }
+    importGlobal(nameStr, (uint16)i);
   }
 
 
@@ -312,6 +504,8 @@ ProcessDef *Compiler::compile(const std::string &source)
   compileStartTime = std::chrono::steady_clock::now();
 
   tokens = lexer->scanAll();
+  noteAssignedNames(tokens);
+  preloadIncludes();
 
   if (tokens.empty())
   {
@@ -356,6 +550,8 @@ ProcessDef *Compiler::compile(const std::string &source)
     return nullptr;
   }
 
+  peephole(function);
+  warnUnusedGlobals();
   currentProcess->finalize();
 
   importedModules.clear();
@@ -377,18 +573,28 @@ ProcessDef *Compiler::compile(const std::string &source)
 ProcessDef *Compiler::compileExpression(const std::string &source)
 {
   numFibers_ = 1;
-  delete lexer;
+  releaseLexers();
   stats.maxExpressionDepth = 0;
   stats.maxScopeDepth = 0;
   stats.totalErrors = 0;
   stats.totalWarnings = 0;
+  stats.peepholeBytesRemoved = 0;
+  stats.deadStoresRemoved = 0;
+  stats.callsInlined = 0;
+  stats.includesReused = 0;
+  deadStores_.clear();
+  globalVarDecls_.clear();
+  globalRead_.clear();
+  constGlobals_.clear();
   isProcess_ = true; // Expression compilation IS a process
   upvalueCount_ = 0;
   switchDepth_ = 0;
-  lexer = new Lexer(source);
+  lexer = new Lexer(source, &vm_->stringPool);
 
   compileStartTime = std::chrono::steady_clock::now();
   tokens = lexer->scanAll();
+  noteAssignedNames(tokens);
+  preloadedIncludes_.clear();
 
   function = vm_->addFunction("__expr__", 0);
   currentChunk = function->chunk;
@@ -398,20 +604,19 @@ ProcessDef *Compiler::compileExpression(const std::string &source)
   currentClass = nullptr;
   enclosingStack_.clear();
   declaredGlobals_.clear();
+  directFunctions_.clear();
+  inlineBodies_.clear();
+  assignedNames_.clear();
+  inlineDecisions_.clear();
+  directCallee_ = -1;
+  directCalleeChunk_ = nullptr;
+  constChunk_ = nullptr;
   globalIndices_.clear();
   globalIndexToName_.clear();
 
   // Use actual indices from VM's nativeGlobalIndices map
   vm_->nativeGlobalIndices.forEach([this](String *nameStr, uint16 index)
-                                   {
-    const std::string name = nameStr->chars();
-    globalIndices_[name] = index;
-    if (index >= globalIndexToName_.size())
-    {
-      globalIndexToName_.resize(index + 1);
-    }
-    globalIndexToName_[index] = name;
-    declaredGlobals_.insert(name); });
+                                   { importGlobal(nameStr, index); });
 
   // Também importar globals registados via addGlobal()
   for (size_t i = 0; i < vm_->globalIndexToName_.size(); i++)
@@ -419,17 +624,7 @@ ProcessDef *Compiler::compileExpression(const std::string &source)
     String *nameStr = vm_->globalIndexToName_[i];
     if (!nameStr)
       continue;
-    const std::string name = nameStr->chars();
-    if (globalIndices_.find(name) == globalIndices_.end())
-    {
-      globalIndices_[name] = (uint16)i;
-      if (i >= globalIndexToName_.size())
-      {
-        globalIndexToName_.resize(i + 1);
-      }
-      globalIndexToName_[i] = name;
-      declaredGlobals_.insert(name);
-    }
+    importGlobal(nameStr, (uint16)i);
   }
 
   // Next global index starts after all registered natives
@@ -454,6 +649,7 @@ ProcessDef *Compiler::compileExpression(const std::string &source)
     return nullptr;
   }
 
+  peephole(function);
 
   currentProcess->finalize();
 
@@ -469,8 +665,7 @@ void Compiler::clear()
 {
 
   tokens.clear();
-  delete lexer;
-  lexer = nullptr;
+  releaseLexers();
   function = nullptr;
   currentChunk = nullptr;
 
@@ -504,7 +699,7 @@ void Compiler::warningAt(Token &token, const char *message)
   }
   else if (token.type != TOKEN_ERROR)
   {
-    OsPrintf(" at '%s'", token.lexeme.c_str());
+    OsPrintf(" at '%.*s'", (int)token.length, token.start);
   }
 
   OsPrintf(": %s\n", message);
@@ -523,7 +718,7 @@ int Compiler::resolveUpvalue(Token &name)
     // Procura nos locals desse nível
     for (int i = enclosingStack_[level].locals.size() - 1; i >= 0; i--)
     {
-      if (enclosingStack_[level].locals[i].name == name.lexeme)
+      if (enclosingStack_[level].locals[i].name == name.str)
       {
         // Marca como capturado
         enclosingStack_[level].locals[i].isCaptured = true;
@@ -577,14 +772,11 @@ void Compiler::advance()
   current = tokens[cursor++];
 }
 
-Token Compiler::peek(int offset)
+const Token &Compiler::peek(int offset)
 {
   if (tokens.empty())
   {
-    Token eof;
-    eof.type = TOKEN_EOF;
-    eof.lexeme = "";
-    eof.line = 1;
+    static Token eof(TOKEN_EOF, "", 0, 1, 0);
     return eof;
   }
 
@@ -596,6 +788,20 @@ Token Compiler::peek(int offset)
   return tokens[index];
 }
 
+// Identificador criado pelo compilador ("self", temporários do foreach...)
+Token Compiler::syntheticToken(const char *name)
+{
+  String *str = vm_->createString(name);
+  return Token(TOKEN_IDENTIFIER, str->chars(), (uint32_t)str->length(), previous.line, previous.column, str);
+}
+
+// Números e afins não são interned: copia o span para um buffer reutilizado
+const char *Compiler::spanText(const Token &tok)
+{
+  spanBuffer_.assign(tok.start, tok.length);
+  return spanBuffer_.c_str();
+}
+
 bool Compiler::checkNext(TokenType t) { return peek(0).type == t; }
 
 bool Compiler::check(TokenType type) { return current.type == type; }
@@ -626,6 +832,7 @@ bool Compiler::isKeywordToken(TokenType type)
   {
   // Control flow
   case TOKEN_VAR:
+  case TOKEN_CONST:
   case TOKEN_DEF:
   case TOKEN_IF:
   case TOKEN_ELIF:
@@ -751,7 +958,7 @@ void Compiler::errorAt(Token &token, const char *message)
   }
   else
   {
-    OsPrintf(" at '%s'", token.lexeme.c_str());
+    OsPrintf(" at '%.*s'", (int)token.length, token.start);
   }
 
   OsPrintf(": %s\n", message);
@@ -784,6 +991,7 @@ void Compiler::synchronize()
     case TOKEN_CLASS:
     case TOKEN_STRUCT:
     case TOKEN_VAR:
+    case TOKEN_CONST:
 
     //  CONTROL FLOW STATEMENTS
     case TOKEN_IF:
@@ -871,6 +1079,126 @@ void Compiler::emitConstant(Value value)
     return;
   emitByte(OP_CONSTANT);
   emitShort(constant);
+  markConstant(currentChunk->count - 3);
+}
+
+void Compiler::emitPropertyOp(uint8 op, uint16 nameIdx)
+{
+  int cache = currentChunk->addPropertyCache();
+  if (cache < 0)
+  {
+    error("Function too large (>65535 property accesses)");
+    return;
+  }
+
+  // proc.x / proc.angle / ...: índice do private resolvido já aqui
+  int privateIdx = -1;
+  if (!hadError && (op == OP_GET_PROPERTY || op == OP_SET_PROPERTY))
+  {
+    privateIdx = vm_->getProcessPrivateIndex(currentChunk->constants[nameIdx].asStringChars());
+    if (op == OP_SET_PROPERTY &&
+        (privateIdx == (int)PrivateIndex::ID || privateIdx == (int)PrivateIndex::FATHER))
+      privateIdx = -1; // readonly: o erro fica no caminho genérico
+  }
+
+  if (privateIdx >= 0)
+  {
+    emitByte(op == OP_GET_PROPERTY ? OP_GET_PROC_PRIVATE : OP_SET_PROC_PRIVATE);
+    emitByte((uint8)privateIdx);
+  }
+  else
+    emitByte(op);
+  emitShort(nameIdx);
+  emitShort((uint16)cache);
+}
+
+// ============================================
+// SUPERINSTRUCTIONS
+// ============================================
+// Só o primeiro opcode é reescrito: os bytes originais ficam no chunk, por
+// isso saltos, disassembly e o fallback do runtime continuam válidos.
+
+bool Compiler::isFusableOperand(int offset)
+{
+  const uint8 *code = currentChunk->code;
+  int end = currentChunk->count;
+
+  if (offset + 2 < end && code[offset] == OP_CONSTANT)
+  {
+    const Value &k = currentChunk->constants[(uint16)((code[offset + 1] << 8) | code[offset + 2])];
+    return k.isInt() || k.isDouble();
+  }
+  return offset + 1 < end && (code[offset] == OP_GET_LOCAL || code[offset] == OP_GET_PRIVATE);
+}
+
+// [GET s] [DUP] <rhs> ADD|SUBTRACT [SET s] [POP], a terminar no fim do chunk
+void Compiler::fuseVarArith(int start, uint8 getOp, int arg)
+{
+  if (!options.superinstructions || hadError)
+    return;
+  if (getOp != OP_GET_LOCAL && getOp != OP_GET_PRIVATE)
+    return;
+
+  uint8 setOp = (getOp == OP_GET_LOCAL) ? OP_SET_LOCAL : OP_SET_PRIVATE;
+  uint8 *code = currentChunk->code;
+  int end = currentChunk->count;
+  int p = start;
+
+  if (p + 1 >= end || code[p] != getOp || code[p + 1] != (uint8)arg)
+    return;
+  p += 2;
+
+  bool postfix = (p < end && code[p] == OP_DUP);
+  p += postfix;
+
+  if (!isFusableOperand(p))
+    return;
+  p += (code[p] == OP_CONSTANT) ? 3 : 2;
+
+  if (p >= end || (code[p] != OP_ADD && code[p] != OP_SUBTRACT))
+    return;
+  p++;
+
+  if (p + 1 >= end || code[p] != setOp || code[p + 1] != (uint8)arg)
+    return;
+  p += 2;
+
+  if (postfix)
+  {
+    if (p >= end || code[p] != OP_POP)
+      return;
+    p++;
+  }
+
+  if (p != end)
+    return;
+
+  code[start] = (getOp == OP_GET_LOCAL) ? OP_INC_LOCAL : OP_INC_PRIVATE;
+}
+
+// Condição [GET_LOCAL s] <rhs> LESS|GREATER seguida do OP_JUMP_IF_FALSE em 'jump'
+void Compiler::fuseCompareJump(int start, int jump)
+{
+  if (!options.superinstructions || hadError)
+    return;
+
+  uint8 *code = currentChunk->code;
+  int p = start;
+
+  if (p + 1 >= jump || code[p] != OP_GET_LOCAL)
+    return;
+  p += 2;
+
+  if (!isFusableOperand(p))
+    return;
+  p += (code[p] == OP_CONSTANT) ? 3 : 2;
+
+  if (p != jump - 2 || (code[p] != OP_LESS && code[p] != OP_GREATER))
+    return;
+  if (code[jump - 1] != OP_JUMP_IF_FALSE)
+    return;
+
+  code[start] = OP_CMP_LOCAL_JUMP;
 }
 
 // ============================================
@@ -896,6 +1224,7 @@ void Compiler::patchJump(int offset)
 
   currentChunk->code[offset] = (jump >> 8) & 0xff;
   currentChunk->code[offset + 1] = jump & 0xff;
+  constChunk_ = nullptr; // o literal anterior é alvo de salto: não dobrar
 }
 
 void Compiler::emitLoop(int loopStart)
@@ -928,6 +1257,7 @@ void Compiler::patchJumpTo(int operandOffset, int targetOffset)
 
   currentChunk->code[operandOffset] = (jump >> 8) & 0xff;
   currentChunk->code[operandOffset + 1] = jump & 0xff;
+  constChunk_ = nullptr;
 }
 
 void Compiler::emitGosubTo(int targetOffset)
@@ -1090,7 +1420,8 @@ void Compiler::resolveGosubs()
 
 void Compiler::validateIdentifierName(const Token &nameToken)
 {
-  const std::string &name = nameToken.lexeme;
+  const char *name = nameToken.chars();
+  const size_t nameLength = std::strlen(name);
 
   if (!lexer)
     return;
@@ -1098,40 +1429,41 @@ void Compiler::validateIdentifierName(const Token &nameToken)
   // 1. Verifica se é keyword
   if (lexer->isKeyword(name))
   {
-    fail("Cannot use keyword '%s' as identifier name", name.c_str());
+    fail("Cannot use keyword '%s' as identifier name", name);
     return;
   }
 
   // 2. Verifica se começa com número
-  if (!name.empty() && std::isdigit(name[0]))
+  if (nameLength > 0 && std::isdigit(name[0]))
   {
-    fail("Identifier '%s' cannot start with a digit", name.c_str());
+    fail("Identifier '%s' cannot start with a digit", name);
     return;
   }
 
   // 3. Verifica se contém caracteres inválidos
-  for (char c : name)
+  for (size_t i = 0; i < nameLength; i++)
   {
+    char c = name[i];
     if (!std::isalnum(c) && c != '_')
     {
       fail("Identifier '%s' contains invalid character '%c'",
-           name.c_str(), c);
+           name, c);
       return;
     }
   }
 
   // 4. Verifica se é muito longo
-  if (name.length() >= MAX_IDENTIFIER_LENGTH)
+  if (nameLength >= MAX_IDENTIFIER_LENGTH)
   {
     fail("Identifier '%s' is too long (max %d characters)",
-         name.c_str(), MAX_IDENTIFIER_LENGTH);
+         name, MAX_IDENTIFIER_LENGTH);
     return;
   }
 
-  if (name.length() >= 2 && name[0] == '_' && name[1] == '_')
+  if (nameLength >= 2 && name[0] == '_' && name[1] == '_')
   {
     Warning("Identifier '%s' starts with '__' which is typically "
             "reserved for internal use",
-            name.c_str());
+            name);
   }
 }
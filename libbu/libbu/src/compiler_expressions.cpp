@@ -50,46 +50,46 @@ void Compiler::mathUnary(bool canAssign)
     switch (type)
     {
     case TOKEN_SIN:
-        emitByte(OP_SIN);
+        emitUnaryOp(OP_SIN);
         break;
     case TOKEN_COS:
-        emitByte(OP_COS);
+        emitUnaryOp(OP_COS);
         break;
     case TOKEN_TAN:
-        emitByte(OP_TAN);
+        emitUnaryOp(OP_TAN);
         break;
     case TOKEN_ASIN:
-        emitByte(OP_ASIN);
+        emitUnaryOp(OP_ASIN);
         break;
     case TOKEN_ACOS:
-        emitByte(OP_ACOS);
+        emitUnaryOp(OP_ACOS);
         break;
     case TOKEN_ATAN:
-        emitByte(OP_ATAN);
+        emitUnaryOp(OP_ATAN);
         break;
     case TOKEN_SQRT:
-        emitByte(OP_SQRT);
+        emitUnaryOp(OP_SQRT);
         break;
     case TOKEN_ABS:
-        emitByte(OP_ABS);
+        emitUnaryOp(OP_ABS);
         break;
     case TOKEN_FLOOR:
-        emitByte(OP_FLOOR);
+        emitUnaryOp(OP_FLOOR);
         break;
     case TOKEN_CEIL:
-        emitByte(OP_CEIL);
+        emitUnaryOp(OP_CEIL);
         break;
     case TOKEN_DEG:
-        emitByte(OP_DEG);
+        emitUnaryOp(OP_DEG);
         break;
     case TOKEN_RAD:
-        emitByte(OP_RAD);
+        emitUnaryOp(OP_RAD);
         break;
     case TOKEN_LOG:
-        emitByte(OP_LOG);
+        emitUnaryOp(OP_LOG);
         break;
     case TOKEN_EXP:
-        emitByte(OP_EXP);
+        emitUnaryOp(OP_EXP);
         break;
     default:
         return; // Erro
@@ -105,6 +105,8 @@ void Compiler::mathBinary(bool canAssign)
     expression(); // Arg 1
     if (hadError)
         return;
+    int leftStart = lastConstantStart();
+    int rightStart = currentChunk->count;
     consume(TOKEN_COMMA, "Expect ','");
     expression(); // Arg 2
     if (hadError)
@@ -114,10 +116,10 @@ void Compiler::mathBinary(bool canAssign)
     switch (type)
     {
     case TOKEN_ATAN2:
-        emitByte(OP_ATAN2);
+        emitBinaryOp(OP_ATAN2, leftStart, rightStart);
         break;
     case TOKEN_POW:
-        emitByte(OP_POW);
+        emitBinaryOp(OP_POW, leftStart, rightStart);
         break;
     default:
         return;
@@ -138,7 +140,7 @@ void Compiler::typeExpression(bool canAssign)
 {
     (void)canAssign;
     consume(TOKEN_IDENTIFIER, "Expect process name after 'type'");
-    emitConstant(vm_->makeString(previous.lexeme.c_str()));
+    emitConstant(vm_->makeString(previous.str));
     emitByte(OP_TYPE);
 }
 
@@ -165,7 +167,7 @@ void Compiler::getIdExpression(bool canAssign)
 void Compiler::number(bool canAssign)
 {
     (void)canAssign;
-    const char *str = previous.lexeme.c_str();
+    const char *str = spanText(previous);
 
     if (previous.type == TOKEN_INT)
     {
@@ -286,7 +288,7 @@ void Compiler::number(bool canAssign)
 void Compiler::string(bool canAssign)
 {
     (void)canAssign;
-    emitConstant(vm_->makeString(previous.lexeme.c_str()));
+    emitConstant(vm_->makeString(previous.str));
 }
 
 void Compiler::literal(bool canAssign)
@@ -306,6 +308,7 @@ void Compiler::literal(bool canAssign)
     default:
         return;
     }
+    markConstant(currentChunk->count - 1);
 }
 
 void Compiler::grouping(bool canAssign)
@@ -327,13 +330,13 @@ void Compiler::unary(bool canAssign)
     switch (operatorType)
     {
     case TOKEN_MINUS:
-        emitByte(OP_NEGATE);
+        emitUnaryOp(OP_NEGATE);
         break;
     case TOKEN_BANG:
-        emitByte(OP_NOT);
+        emitUnaryOp(OP_NOT);
         break;
     case TOKEN_TILDE:
-        emitByte(OP_BITWISE_NOT);
+        emitUnaryOp(OP_BITWISE_NOT);
         break;
     default:
         return;
@@ -345,67 +348,367 @@ void Compiler::binary(bool canAssign)
     TokenType operatorType = previous.type;
     ParseRule *rule = getRule(operatorType);
 
+    int leftStart = lastConstantStart();
+    int rightStart = currentChunk->count;
+
     parsePrecedence((Precedence)(rule->prec + 1));
 
     switch (operatorType)
     {
     case TOKEN_PLUS:
-        emitByte(OP_ADD);
+        emitBinaryOp(OP_ADD, leftStart, rightStart);
         break;
     case TOKEN_MINUS:
-        emitByte(OP_SUBTRACT);
+        emitBinaryOp(OP_SUBTRACT, leftStart, rightStart);
         break;
     case TOKEN_STAR:
-        emitByte(OP_MULTIPLY);
+        emitBinaryOp(OP_MULTIPLY, leftStart, rightStart);
         break;
     case TOKEN_SLASH:
-        emitByte(OP_DIVIDE);
+        emitBinaryOp(OP_DIVIDE, leftStart, rightStart);
         break;
     case TOKEN_PERCENT:
-        emitByte(OP_MODULO);
+        emitBinaryOp(OP_MODULO, leftStart, rightStart);
         break;
     case TOKEN_EQUAL_EQUAL:
-        emitByte(OP_EQUAL);
+        emitBinaryOp(OP_EQUAL, leftStart, rightStart);
         break;
     case TOKEN_BANG_EQUAL:
-        emitByte(OP_EQUAL);
-        emitByte(OP_NOT);
+        emitBinaryOp(OP_EQUAL, leftStart, rightStart);
+        emitUnaryOp(OP_NOT);
         break;
 
     case TOKEN_LESS:
-        emitByte(OP_LESS);
+        emitBinaryOp(OP_LESS, leftStart, rightStart);
         break;
     case TOKEN_LESS_EQUAL:
-        emitByte(OP_GREATER);
-        emitByte(OP_NOT);
+        emitBinaryOp(OP_GREATER, leftStart, rightStart);
+        emitUnaryOp(OP_NOT);
         break;
     case TOKEN_GREATER:
-        emitByte(OP_GREATER);
+        emitBinaryOp(OP_GREATER, leftStart, rightStart);
         break;
     case TOKEN_GREATER_EQUAL:
-        emitByte(OP_LESS);
-        emitByte(OP_NOT);
+        emitBinaryOp(OP_LESS, leftStart, rightStart);
+        emitUnaryOp(OP_NOT);
         break;
     case TOKEN_PIPE:
-        emitByte(OP_BITWISE_OR);
+        emitBinaryOp(OP_BITWISE_OR, leftStart, rightStart);
         break;
     case TOKEN_AMPERSAND:
-        emitByte(OP_BITWISE_AND);
+        emitBinaryOp(OP_BITWISE_AND, leftStart, rightStart);
         break;
     case TOKEN_CARET:
-        emitByte(OP_BITWISE_XOR);
+        emitBinaryOp(OP_BITWISE_XOR, leftStart, rightStart);
         break;
     case TOKEN_LEFT_SHIFT:
-        emitByte(OP_SHIFT_LEFT);
+        emitBinaryOp(OP_SHIFT_LEFT, leftStart, rightStart);
         break;
     case TOKEN_RIGHT_SHIFT:
-        emitByte(OP_SHIFT_RIGHT);
+        emitBinaryOp(OP_SHIFT_RIGHT, leftStart, rightStart);
         break;
     default:
         return;
     }
 }
 
+// ============================================
+// CONSTANT FOLDING
+// ============================================
+// Operandos literais (ou já dobrados) no fim do chunk são avaliados aqui com
+// a mesma semântica do runtime. Tudo o que no runtime dá erro (tipos errados,
+// divisão por zero, sqrt(-1), overflow de int...) não é dobrado: o erro
+// continua a acontecer na mesma linha.
+
+void Compiler::markConstant(int start)
+{
+    constStart_ = start;
+    constEnd_ = (int)currentChunk->count;
+    constChunk_ = currentChunk;
+}
+
+// Início do literal que acaba no fim do chunk, ou -1
+int Compiler::lastConstantStart()
+{
+    if (!options.constantFolding || hadError || constChunk_ != currentChunk ||
+        constEnd_ != (int)currentChunk->count)
+        return -1;
+    return constStart_;
+}
+
+bool Compiler::readConstant(int start, Value *out)
+{
+    const uint8 *code = currentChunk->code;
+    switch (code[start])
+    {
+    case OP_CONSTANT:
+        *out = currentChunk->constants[(uint16)((code[start + 1] << 8) | code[start + 2])];
+        return out->isInt() || out->isDouble() || out->isBool() || out->isNil();
+    case OP_TRUE:
+        *out = vm_->makeBool(true);
+        return true;
+    case OP_FALSE:
+        *out = vm_->makeBool(false);
+        return true;
+    case OP_NIL:
+        *out = vm_->makeNil();
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Substitui tudo desde 'start' pelo valor dobrado
+void Compiler::emitFolded(int start, Value value)
+{
+    currentChunk->count = start;
+    if (value.isBool())
+    {
+        emitByte(value.asBool() ? OP_TRUE : OP_FALSE);
+        markConstant(start);
+    }
+    else
+        emitConstant(value);
+}
+
+static FORCE_INLINE bool isNum(const Value &v) { return v.isInt() || v.isDouble(); }
+static FORCE_INLINE double toNum(const Value &v) { return v.isInt() ? (double)v.asInt() : v.asDouble(); }
+
+static bool fitsInt(long long v) { return v >= INT32_MIN && v <= INT32_MAX; }
+
+static bool foldUnaryValue(Interpreter *vm, uint8 op, const Value &v, Value *out)
+{
+    switch (op)
+    {
+    case OP_NOT:
+        *out = vm->makeBool(!isTruthy(v));
+        return true;
+    case OP_NEGATE:
+        if (v.isInt() && v.asInt() != INT32_MIN)
+            *out = vm->makeInt(-v.asInt());
+        else if (v.isDouble())
+            *out = vm->makeDouble(-v.asDouble());
+        else if (v.isBool())
+            *out = vm->makeBool(!v.asBool());
+        else
+            return false;
+        return true;
+    case OP_BITWISE_NOT:
+        if (!v.isInt())
+            return false;
+        *out = vm->makeInt(~v.asInt());
+        return true;
+    case OP_ABS:
+        if (v.isInt() && v.asInt() != INT32_MIN)
+            *out = vm->makeInt(std::abs(v.asInt()));
+        else if (v.isDouble())
+            *out = vm->makeDouble(std::abs(v.asDouble()));
+        else
+            return false;
+        return true;
+    default:
+        break;
+    }
+
+    if (!isNum(v))
+        return false;
+    double d = toNum(v);
+    double r;
+    switch (op)
+    {
+    case OP_SIN: r = std::sin(d); break;
+    case OP_COS: r = std::cos(d); break;
+    case OP_TAN: r = std::tan(d); break;
+    case OP_ASIN: r = std::asin(d); break;
+    case OP_ACOS: r = std::acos(d); break;
+    case OP_ATAN: r = std::atan(d); break;
+    case OP_SQRT:
+        if (d < 0)
+            return false;
+        r = std::sqrt(d);
+        break;
+    case OP_LOG:
+        if (d <= 0)
+            return false;
+        r = std::log(d);
+        break;
+    case OP_EXP: r = std::exp(d); break;
+    case OP_DEG: r = d * 57.29577951308232; break;
+    case OP_RAD: r = d * 0.017453292519943295; break;
+    case OP_FLOOR:
+    case OP_CEIL:
+    {
+        double rounded = (op == OP_FLOOR) ? std::floor(d) : std::ceil(d);
+        if (!(rounded >= INT32_MIN && rounded <= INT32_MAX))
+            return false;
+        *out = vm->makeInt((int)rounded);
+        return true;
+    }
+    default:
+        return false;
+    }
+    if (!std::isfinite(r))
+        return false;
+    *out = vm->makeDouble(r);
+    return true;
+}
+
+static bool foldBinaryValue(Interpreter *vm, uint8 op, const Value &a, const Value &b, Value *out)
+{
+    switch (op)
+    {
+    case OP_EQUAL:
+        *out = vm->makeBool(valuesEqual(a, b));
+        return true;
+    case OP_BITWISE_AND:
+    case OP_BITWISE_OR:
+    case OP_BITWISE_XOR:
+    case OP_SHIFT_LEFT:
+    case OP_SHIFT_RIGHT:
+    {
+        if (!a.isInt() || !b.isInt())
+            return false;
+        int ia = a.asInt(), ib = b.asInt();
+        if (op == OP_BITWISE_AND)
+            *out = vm->makeInt(ia & ib);
+        else if (op == OP_BITWISE_OR)
+            *out = vm->makeInt(ia | ib);
+        else if (op == OP_BITWISE_XOR)
+            *out = vm->makeInt(ia ^ ib);
+        else if (ib < 0 || ib > 31 || (op == OP_SHIFT_LEFT && ia < 0))
+            return false;
+        else
+            *out = vm->makeInt(op == OP_SHIFT_LEFT ? (int)((uint32)ia << ib) : ia >> ib);
+        return true;
+    }
+    default:
+        break;
+    }
+
+    if (!isNum(a) || !isNum(b))
+        return false;
+
+    if (a.isInt() && b.isInt())
+    {
+        long long ia = a.asInt(), ib = b.asInt();
+        long long r;
+        switch (op)
+        {
+        case OP_ADD: r = ia + ib; break;
+        case OP_SUBTRACT: r = ia - ib; break;
+        case OP_MULTIPLY: r = ia * ib; break;
+        case OP_DIVIDE:
+            if (ib == 0)
+                return false;
+            if (ia % ib != 0)
+            {
+                *out = vm->makeDouble((double)ia / ib);
+                return true;
+            }
+            r = ia / ib;
+            break;
+        case OP_MODULO:
+            if (ib == 0)
+                return false;
+            r = ia % ib;
+            break;
+        case OP_LESS:
+            *out = vm->makeBool(ia < ib);
+            return true;
+        case OP_GREATER:
+            *out = vm->makeBool(ia > ib);
+            return true;
+        default:
+            goto doubles; // atan2/pow
+        }
+        if (!fitsInt(r))
+            return false;
+        *out = vm->makeInt((int)r);
+        return true;
+    }
+
+doubles:
+    double da = toNum(a), db = toNum(b);
+    double r;
+    switch (op)
+    {
+    case OP_ADD: r = da + db; break;
+    case OP_SUBTRACT: r = da - db; break;
+    case OP_MULTIPLY: r = da * db; break;
+    case OP_DIVIDE:
+        if (db == 0.0)
+            return false;
+        // int / double exato fica int (como no runtime)
+        if (a.isInt() && std::fmod(da, db) == 0)
+        {
+            double q = da / db;
+            if (!(q >= INT32_MIN && q <= INT32_MAX))
+                return false;
+            *out = vm->makeInt((int)q);
+            return true;
+        }
+        r = da / db;
+        break;
+    case OP_MODULO:
+        if (db == 0.0)
+            return false;
+        r = std::fmod(da, db);
+        break;
+    case OP_LESS:
+        *out = vm->makeBool(da < db);
+        return true;
+    case OP_GREATER:
+        *out = vm->makeBool(da > db);
+        return true;
+    case OP_ATAN2: r = std::atan2(da, db); break;
+    case OP_POW: r = std::pow(da, db); break;
+    default:
+        return false;
+    }
+    if (!std::isfinite(r))
+        return false;
+    *out = vm->makeDouble(r);
+    return true;
+}
+
+void Compiler::emitUnaryOp(uint8 op)
+{
+    int start = lastConstantStart();
+    Value v, result;
+    if (start >= 0 && readConstant(start, &v) && foldUnaryValue(vm_, op, v, &result))
+    {
+        emitFolded(start, result);
+        return;
+    }
+    emitByte(op);
+}
+
+// leftStart = lastConstantStart() antes do operando da direita (-1 = não literal)
+void Compiler::emitBinaryOp(uint8 op, int leftStart, int rightStart)
+{
+    if (lastConstantStart() != rightStart || rightStart < 0)
+    {
+        emitByte(op);
+        return;
+    }
+
+    Value b, result;
+    if (!readConstant(rightStart, &b))
+    {
+        emitByte(op);
+        return;
+    }
+
+    Value a;
+    if (leftStart >= 0 && readConstant(leftStart, &a) && foldBinaryValue(vm_, op, a, b, &result))
+    {
+        emitFolded(leftStart, result);
+        return;
+    }
+
+    emitByte(op);
+}
+
 void Compiler::bufferLiteral(bool canAssign)
 {
     (void)canAssign; // Buffers não podem ser l-values
@@ -491,7 +794,7 @@ void Compiler::mapLiteral(bool canAssign)
             if (match(TOKEN_IDENTIFIER))
             {
                 Token key = previous;
-                emitConstant(vm_->makeString(key.lexeme.c_str()));
+                emitConstant(vm_->makeString(key.str));
                 consume(TOKEN_COLON, "Expect ':' after map key");
                 expression();
                 if (hadError)
@@ -500,7 +803,7 @@ void Compiler::mapLiteral(bool canAssign)
             else if (match(TOKEN_STRING))
             {
                 Token key = previous;
-                emitConstant(vm_->makeString(key.lexeme.c_str()));
+                emitConstant(vm_->makeString(key.str));
                 consume(TOKEN_COLON, "Expect ':' after map key");
                 expression();
                 if (hadError)
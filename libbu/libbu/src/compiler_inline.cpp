@@ -0,0 +1,449 @@
+#include "compiler.hpp"
+#include "interpreter.hpp"
+#include "opcode.hpp"
+#include "code.hpp"
+#include "debug.hpp"
+#include <cstring>
+#include <vector>
+
+// ============================================
+// INLINER
+// ============================================
+// Funções globais pequenas (clamp, lerp, sign, ...) chamadas por
+// OP_CALL_DIRECT passam a ter o corpo copiado para o sítio da chamada:
+//
+//   GET_GLOBAL f; <args>; CALL_DIRECT f; CALL n
+//     ->  <args>; <corpo>; SLIDE n
+//
+// Os argumentos ficam na stack do chamador, onde o callee os teria no
+// frame; GET_LOCAL s do corpo vira OP_PICK com a distância ao topo nesse
+// ponto, e cada RETURN vira SLIDE (tira args e locals de baixo do
+// resultado) + JUMP para o fim. O corpo é analisado uma vez no fim do
+// 'def' (analyzeInline); só entra se for:
+//   - sem upvalues, sem chamadas (logo não recursiva), sem loops
+//   - sem escritas em variáveis, só leituras, aritmética, compares,
+//     propriedades, índices e saltos para a frente
+//   - com no máximo options.inlineMaxBytes de bytecode
+// O código inlined fica com a linha da chamada: os erros em runtime
+// apontam para onde está a chamada, que é o frame que existe.
+
+static uint8 inlineBaseOpcode(uint8 op)
+{
+  switch (op)
+  {
+  case OP_ADD_II:
+  case OP_ADD_DD:
+    return OP_ADD;
+  case OP_SUBTRACT_II:
+  case OP_SUBTRACT_DD:
+    return OP_SUBTRACT;
+  case OP_MULTIPLY_II:
+  case OP_MULTIPLY_DD:
+    return OP_MULTIPLY;
+  case OP_LESS_II:
+  case OP_LESS_DD:
+    return OP_LESS;
+  case OP_GREATER_II:
+  case OP_GREATER_DD:
+    return OP_GREATER;
+  case OP_INC_LOCAL:
+  case OP_CMP_LOCAL_JUMP:
+    return OP_GET_LOCAL;
+  default:
+    return op;
+  }
+}
+
+static bool isInlineBinary(uint8 op)
+{
+  switch (op)
+  {
+  case OP_ADD:
+  case OP_SUBTRACT:
+  case OP_MULTIPLY:
+  case OP_DIVIDE:
+  case OP_MODULO:
+  case OP_BITWISE_AND:
+  case OP_BITWISE_OR:
+  case OP_BITWISE_XOR:
+  case OP_SHIFT_LEFT:
+  case OP_SHIFT_RIGHT:
+  case OP_EQUAL:
+  case OP_NOT_EQUAL:
+  case OP_GREATER:
+  case OP_GREATER_EQUAL:
+  case OP_LESS:
+  case OP_LESS_EQUAL:
+  case OP_GET_INDEX:
+  case OP_ATAN2:
+  case OP_POW:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool isInlineUnary(uint8 op)
+{
+  return op == OP_NOT || op == OP_NEGATE || op == OP_BITWISE_NOT ||
+         (op >= OP_SIN && op <= OP_EXP) ||
+         op == OP_GET_PROPERTY || op == OP_GET_PROC_PRIVATE;
+}
+
+// Nomes que levam '=', '+=', '++', ... em algum sítio da fonte (fora de
+// 'obj.nome'). Uma função global com um desses nomes pode ser trocada em
+// runtime, e aí só o OP_CALL_DIRECT (que verifica o global) dá o resultado
+// certo. Por excesso: um parâmetro com o mesmo nome também conta.
+void Compiler::noteAssignedNames(const std::vector<Token> &toks)
+{
+  for (size_t i = 0; i < toks.size(); i++)
+  {
+    if (toks[i].type != TOKEN_IDENTIFIER || !toks[i].str)
+      continue;
+    if (i > 0 && toks[i - 1].type == TOKEN_DOT)
+      continue;
+
+    bool assigned = false;
+    if (i > 0 && (toks[i - 1].type == TOKEN_PLUS_PLUS || toks[i - 1].type == TOKEN_MINUS_MINUS))
+      assigned = true;
+    if (i + 1 < toks.size())
+    {
+      switch (toks[i + 1].type)
+      {
+      case TOKEN_EQUAL:
+      case TOKEN_PLUS_EQUAL:
+      case TOKEN_MINUS_EQUAL:
+      case TOKEN_STAR_EQUAL:
+      case TOKEN_SLASH_EQUAL:
+      case TOKEN_PERCENT_EQUAL:
+      case TOKEN_PLUS_PLUS:
+      case TOKEN_MINUS_MINUS:
+        assigned = true;
+        break;
+      default:
+        break;
+      }
+    }
+    if (assigned)
+      assignedNames_.insert(toks[i].str);
+  }
+}
+
+void Compiler::analyzeInline(Function *func, String *name)
+{
+  InlineBody &body = inlineBodies_[(uint16)func->index];
+  body.reason.clear();
+  body.depth.clear();
+
+  if (assignedNames_.count(name) > 0)
+  {
+    body.reason = "global is reassigned";
+    return;
+  }
+
+  const Code *chunk = func->chunk;
+  if (hadError || !chunk || chunk->count == 0)
+  {
+    body.reason = "not compiled";
+    return;
+  }
+  const int count = (int)chunk->count;
+  if (count > options.inlineMaxBytes)
+  {
+    body.reason = "too large";
+    return;
+  }
+
+  std::vector<int> &depth = body.depth;
+  std::vector<int> targetDepth(count + 1, -1);
+  depth.assign(count + 1, -1);
+
+  int cur = func->arity; // slot 0 (a própria função) não conta
+  bool reachable = true;
+  for (int off = 0; off < count;)
+  {
+    int len = instructionLength(chunk, off);
+    if (len < 0 || off + len > count)
+    {
+      body.reason = "cannot decode";
+      return;
+    }
+
+    if (targetDepth[off] != -1)
+    {
+      if (reachable && cur != targetDepth[off])
+      {
+        body.reason = "stack shape";
+        return;
+      }
+      cur = targetDepth[off];
+      reachable = true;
+    }
+    if (!reachable)
+    {
+      off += len;
+      continue;
+    }
+
+    depth[off] = cur;
+    const uint8 *code = chunk->code + off;
+    uint8 op = inlineBaseOpcode(code[0]);
+    int need = 0; // valores que a instrução lê da stack
+    int effect = 0;
+
+    switch (op)
+    {
+    case OP_CONSTANT:
+    case OP_NIL:
+    case OP_TRUE:
+    case OP_FALSE:
+    case OP_GET_GLOBAL:
+      effect = 1;
+      break;
+    case OP_DUP:
+      need = 1;
+      effect = 1;
+      break;
+    case OP_GET_LOCAL:
+      if (code[1] == 0 || code[1] > cur)
+      {
+        body.reason = "reads slot 0";
+        return;
+      }
+      effect = 1;
+      break;
+    case OP_PICK:
+      need = code[1] + 1;
+      effect = 1;
+      break;
+    case OP_POP:
+      need = 1;
+      effect = -1;
+      break;
+    case OP_DISCARD:
+      need = code[1];
+      effect = -code[1];
+      break;
+    case OP_SLIDE:
+      need = code[1] + 1;
+      effect = -code[1];
+      break;
+
+    case OP_JUMP:
+    case OP_JUMP_IF_FALSE:
+    case OP_JUMP_IF_TRUE:
+    {
+      need = (op == OP_JUMP) ? 0 : 1;
+      int target = off + 3 + (uint16)((code[1] << 8) | code[2]);
+      if (target > count || cur < need)
+      {
+        body.reason = "bad jump";
+        return;
+      }
+      if (targetDepth[target] != -1 && targetDepth[target] != cur)
+      {
+        body.reason = "stack shape";
+        return;
+      }
+      targetDepth[target] = cur;
+      if (op == OP_JUMP)
+        reachable = false;
+      break;
+    }
+
+    case OP_RETURN:
+      need = 1;
+      reachable = false;
+      break;
+
+    case OP_LOOP:
+      body.reason = "has a loop";
+      return;
+    case OP_CALL:
+    case OP_CALL_DIRECT:
+    case OP_INVOKE:
+    case OP_SUPER_INVOKE:
+    case OP_INVOKE_BUILTIN:
+    case OP_SPAWN:
+      body.reason = "calls another function";
+      return;
+    case OP_SET_LOCAL:
+    case OP_SET_GLOBAL:
+    case OP_SET_PROPERTY:
+    case OP_SET_PROC_PRIVATE:
+    case OP_SET_INDEX:
+      body.reason = "assigns a variable";
+      return;
+
+    default:
+      if (isInlineBinary(op))
+      {
+        need = 2;
+        effect = -1;
+      }
+      else if (isInlineUnary(op))
+        need = 1;
+      else
+      {
+        body.reason = "uses ";
+        body.reason += Debug::opcodeName(op);
+        return;
+      }
+      break;
+    }
+
+    if (cur < need || cur + effect > 255)
+    {
+      body.reason = "stack shape";
+      return;
+    }
+    cur += effect;
+    off += len;
+  }
+
+  // O último caminho tem de acabar num RETURN (o compilador garante-o)
+  if (reachable)
+    body.reason = "no return";
+}
+
+bool Compiler::inlineCall(uint16 index, int calleeStart)
+{
+  if (!options.inlining || hadError)
+    return false;
+
+  Function *callee = vm_->functions[index];
+  InlineDecision decision;
+  decision.caller = function && function->name ? function->name->chars() : "";
+  decision.callee = callee->name ? callee->name->chars() : "";
+  decision.line = previous.line;
+  decision.bytes = callee->chunk ? (int)callee->chunk->count : 0;
+
+  auto found = inlineBodies_.find(index);
+  if (found == inlineBodies_.end())
+    decision.reason = "recursive";
+  else
+    decision.reason = found->second.reason;
+  if (decision.reason.empty() && (calleeStart < 0 || currentChunk->code[calleeStart] != OP_GET_GLOBAL))
+    decision.reason = "callee not on the stack";
+  inlineDecisions_.push_back(decision);
+  if (!decision.reason.empty())
+    return false;
+
+  const InlineBody &body = found->second;
+  const Code *src = callee->chunk;
+  Code *chunk = currentChunk;
+
+  // O callee não vai para a stack: os argumentos descem por cima do GET_GLOBAL
+  int argsStart = calleeStart + 3;
+  int argsSize = (int)chunk->count - argsStart;
+  memmove(chunk->code + calleeStart, chunk->code + argsStart, argsSize);
+  memmove(chunk->lines + calleeStart, chunk->lines + argsStart, argsSize * sizeof(int));
+  chunk->count -= 3;
+  constChunk_ = nullptr;
+
+  struct Fixup
+  {
+    int at;     // offset do operando do salto no chamador
+    int target; // offset no corpo original
+  };
+  std::vector<Fixup> fixups;
+  std::vector<int> newOffset(src->count + 1, -1);
+  const int last = (int)src->count;
+
+  for (int off = 0; off < last;)
+  {
+    int len = instructionLength(src, off);
+    newOffset[off] = (int)chunk->count;
+    int cur = body.depth[off];
+    if (cur < 0)
+    {
+      off += len; // morta
+      continue;
+    }
+
+    const uint8 *code = src->code + off;
+    uint8 op = inlineBaseOpcode(code[0]);
+    switch (op)
+    {
+    case OP_GET_LOCAL:
+      emitBytes(OP_PICK, (uint8)(cur - code[1]));
+      break;
+
+    case OP_CONSTANT:
+      emitConstant(src->constants[(uint16)((code[1] << 8) | code[2])]);
+      break;
+
+    case OP_GET_PROPERTY:
+    case OP_GET_PROC_PRIVATE:
+    {
+      // Cache e nome passam para o chunk do chamador
+      int nameAt = (op == OP_GET_PROC_PRIVATE) ? 2 : 1;
+      uint16 name = (uint16)((code[nameAt] << 8) | code[nameAt + 1]);
+      emitPropertyOp(OP_GET_PROPERTY, makeConstant(src->constants[name]));
+      break;
+    }
+
+    case OP_JUMP:
+    case OP_JUMP_IF_FALSE:
+    case OP_JUMP_IF_TRUE:
+      emitByte(op);
+      fixups.push_back({(int)chunk->count, off + 3 + (uint16)((code[1] << 8) | code[2])});
+      emitShort(0xffff);
+      break;
+
+    case OP_RETURN:
+      if (cur > 1)
+        emitBytes(OP_SLIDE, (uint8)(cur - 1));
+      if (off + len < last)
+      {
+        emitByte(OP_JUMP);
+        fixups.push_back({(int)chunk->count, last});
+        emitShort(0xffff);
+      }
+      break;
+
+    default:
+      emitByte(op);
+      for (int k = 1; k < len; k++)
+        emitByte(code[k]);
+      break;
+    }
+    off += len;
+  }
+  newOffset[last] = (int)chunk->count;
+
+  for (const Fixup &fix : fixups)
+  {
+    int jump = newOffset[fix.target] - (fix.at + 2);
+    if (jump < 0 || jump > UINT16_MAX)
+    {
+      error("Inlined function too large to jump over");
+      return true;
+    }
+    chunk->code[fix.at] = (uint8)((jump >> 8) & 0xff);
+    chunk->code[fix.at + 1] = (uint8)(jump & 0xff);
+  }
+
+  stats.callsInlined++;
+  return true;
+}
+
+// Atribuição a um global que guardava uma função: as chamadas que vierem
+// depois vão pelo OP_CALL_DIRECT normal (que verifica o global em runtime)
+void Compiler::forgetInline(uint16 index, Token &name)
+{
+  auto found = inlineBodies_.find(index);
+  if (found == inlineBodies_.end() || !found->second.reason.empty())
+    return;
+  found->second.reason = "global is reassigned";
+
+  for (const InlineDecision &d : inlineDecisions_)
+  {
+    if (d.reason.empty() && d.callee == name.chars())
+    {
+      Warning("[line %d] Function '%s' is reassigned after calls to it were inlined",
+              name.line, name.chars());
+      break;
+    }
+  }
+}
@@ -0,0 +1,447 @@
+#include "compiler.hpp"
+#include "interpreter.hpp"
+#include "opcode.hpp"
+#include "code.hpp"
+#include <vector>
+
+// ============================================
+// PEEPHOLE
+// ============================================
+// Corre sobre o chunk acabado de cada função, antes de executar:
+//   - OP_JUMP para a instrução seguinte sai
+//   - JUMP/LOOP que aterram noutro JUMP/LOOP saltam logo para o destino final
+//   - NOT; JUMP_IF_FALSE vira JUMP_IF_TRUE quando os dois destinos fazem POP
+//   - DUP; POP sai
+//   - código morto depois de RETURN/EXIT/THROW/JUMP/LOOP até ao próximo alvo
+//   - OP_SET_LOCAL para uma local que nunca é lida (DeadStoreRange)
+// No fim compacta code + lines e corrige os saltos (relativos e os endereços
+// absolutos do OP_TRY e das tabelas do OP_SWITCH_TABLE). Nunca se remove nada do meio de uma superinstruction
+// nem o OP_CALL a seguir a um OP_CALL_DIRECT: os bytes originais ficam.
+
+#define PEEPHOLE_MAX_PASSES 8
+#define PEEPHOLE_MAX_HOPS 16
+
+static bool isJumpOp(uint8 op)
+{
+  return op == OP_JUMP || op == OP_JUMP_IF_FALSE || op == OP_JUMP_IF_TRUE ||
+         op == OP_LOOP || op == OP_GOSUB;
+}
+
+static bool isTerminator(uint8 op)
+{
+  return op == OP_RETURN || op == OP_RETURN_N || op == OP_EXIT || op == OP_HALT ||
+         op == OP_THROW || op == OP_JUMP || op == OP_LOOP || op == OP_SWITCH_TABLE;
+}
+
+static int readJumpTarget(const uint8 *code, int off)
+{
+  uint16 d = (uint16)((code[off + 1] << 8) | code[off + 2]);
+  switch (code[off])
+  {
+  case OP_LOOP:
+    return off + 3 - d;
+  case OP_GOSUB:
+    return off + 3 + (int16)d;
+  default:
+    return off + 3 + d;
+  }
+}
+
+// Tamanho da instrução em 'off', ou -1 se desconhecida
+int Compiler::instructionLength(const Code *chunk, int off)
+{
+  uint8 op = chunk->code[off];
+  switch (op)
+  {
+  case OP_GET_LOCAL:
+  case OP_SET_LOCAL:
+  case OP_GET_PRIVATE:
+  case OP_SET_PRIVATE:
+  case OP_CALL:
+  case OP_RETURN_N:
+  case OP_SPAWN:
+  case OP_PRINT:
+  case OP_DISCARD:
+  case OP_GET_UPVALUE:
+  case OP_SET_UPVALUE:
+  case OP_INC_LOCAL:
+  case OP_INC_PRIVATE:
+  case OP_CMP_LOCAL_JUMP:
+  case OP_PICK:
+  case OP_SLIDE:
+    return 2;
+
+  case OP_CONSTANT:
+  case OP_GET_GLOBAL:
+  case OP_SET_GLOBAL:
+  case OP_DEFINE_GLOBAL:
+  case OP_JUMP:
+  case OP_JUMP_IF_FALSE:
+  case OP_JUMP_IF_TRUE:
+  case OP_LOOP:
+  case OP_GOSUB:
+  case OP_DEFINE_ARRAY:
+  case OP_DEFINE_MAP:
+  case OP_CALL_DIRECT:
+  case OP_SWITCH_TABLE:
+    return 3;
+
+  case OP_INVOKE:
+    return 4;
+
+  case OP_GET_PROPERTY:
+  case OP_SET_PROPERTY:
+  case OP_SUPER_INVOKE:
+  case OP_INVOKE_BUILTIN:
+  case OP_TRY:
+    return 5;
+
+  case OP_GET_PROC_PRIVATE:
+  case OP_SET_PROC_PRIVATE:
+    return 6;
+
+  case OP_CLOSURE:
+  {
+    // constant(u16) + (isLocal, index) por upvalue
+    if (off + 2 >= (int)chunk->count)
+      return -1;
+    const Value &k = chunk->constants[(uint16)((chunk->code[off + 1] << 8) | chunk->code[off + 2])];
+    if (!k.isFunction())
+      return -1;
+    int index = k.asFunctionId();
+    if (index < 0 || index >= (int)vm_->functions.size() || !vm_->functions[index])
+      return -1;
+    return 3 + 2 * vm_->functions[index]->upvalueCount;
+  }
+
+  default:
+    if (op <= OP_GREATER_DD)
+      return 1;
+    return -1;
+  }
+}
+
+void Compiler::peephole(Function *func)
+{
+  if (!options.peephole || hadError || !func || !func->chunk)
+    return;
+
+  Code *chunk = func->chunk;
+  uint8 *code = chunk->code;
+  const int count = (int)chunk->count;
+  if (count == 0)
+    return;
+
+  // ---- Decode: tamanhos e destinos (offsets originais) ----
+  std::vector<int> len(count + 1, 0);
+  std::vector<int> target(count + 1, -1);
+  std::vector<uint8> dead(count + 1, 0);
+  std::vector<uint8> isTarget(count + 1, 0);
+
+  for (int off = 0; off < count;)
+  {
+    int n = instructionLength(chunk, off);
+    if (n <= 0 || off + n > count)
+      return; // não sabemos ler o chunk: fica como está
+    len[off] = n;
+    if (isJumpOp(code[off]))
+    {
+      int t = readJumpTarget(code, off);
+      if (t < 0 || t > count)
+        return;
+      target[off] = t;
+    }
+    off += n;
+  }
+
+  for (int off = 0; off < count; off += len[off])
+  {
+    if (target[off] >= 0 && target[off] < count && len[target[off]] == 0)
+      return; // salto para o meio de uma instrução
+    if (code[off] == OP_TRY)
+    {
+      for (int k = 1; k <= 3; k += 2)
+      {
+        uint16 addr = (uint16)((code[off + k] << 8) | code[off + k + 1]);
+        if (addr != 0xFFFF && (addr >= count || len[addr] == 0))
+          return;
+      }
+    }
+  }
+  for (uint16 t = 0; t < chunk->switchTableCount; t++)
+  {
+    const SwitchTable &table = chunk->switchTables[t];
+    if (!table.targets)
+      return;
+    for (uint32 k = 0; k <= table.caseCount; k++)
+    {
+      int addr = (int)table.targets[k];
+      if (addr > count || (addr < count && len[addr] == 0))
+        return;
+    }
+  }
+
+  // Primeira instrução viva a partir de 'off' (alvos de instruções removidas
+  // passam para a seguinte)
+  auto live = [&](int off)
+  {
+    while (off < count && dead[off])
+      off += len[off];
+    return off;
+  };
+
+  bool changedAny = false;
+  for (int pass = 0; pass < PEEPHOLE_MAX_PASSES; pass++)
+  {
+    bool changed = false;
+
+    for (int off = 0; off <= count; off++)
+      isTarget[off] = 0;
+    for (int off = 0; off < count; off += len[off])
+    {
+      if (dead[off])
+        continue;
+      if (target[off] >= 0)
+        isTarget[live(target[off])] = 1;
+      if (code[off] == OP_TRY)
+      {
+        for (int k = 1; k <= 3; k += 2)
+        {
+          uint16 addr = (uint16)((code[off + k] << 8) | code[off + k + 1]);
+          if (addr != 0xFFFF)
+            isTarget[live(addr)] = 1;
+        }
+      }
+      if (code[off] == OP_SWITCH_TABLE)
+      {
+        const SwitchTable &table = chunk->switchTables[(uint16)((code[off + 1] << 8) | code[off + 2])];
+        for (uint32 k = 0; k <= table.caseCount; k++)
+          isTarget[live((int)table.targets[k])] = 1;
+      }
+    }
+
+    for (int off = 0; off < count; off += len[off])
+    {
+      if (dead[off])
+        continue;
+      uint8 op = code[off];
+
+      // JUMP -> JUMP -> X  =>  JUMP -> X
+      if (op == OP_JUMP || op == OP_LOOP || op == OP_JUMP_IF_FALSE || op == OP_JUMP_IF_TRUE)
+      {
+        bool conditional = (op == OP_JUMP_IF_FALSE || op == OP_JUMP_IF_TRUE);
+        int t = live(target[off]);
+        for (int hops = 0; hops < PEEPHOLE_MAX_HOPS && t < count && t != off; hops++)
+        {
+          if (code[t] != OP_JUMP && code[t] != OP_LOOP)
+            break;
+          int t2 = live(target[t]);
+          if (conditional && t2 <= off)
+            break; // JUMP_IF_* só salta para a frente
+          int dist = t2 - (off + 3);
+          if (dist > UINT16_MAX || -dist > UINT16_MAX)
+            break;
+          t = t2;
+        }
+        if (t != live(target[off]))
+        {
+          target[off] = t;
+          changed = true;
+        }
+      }
+
+      // JUMP para a instrução seguinte
+      if (op == OP_JUMP && live(target[off]) == live(off + len[off]))
+      {
+        dead[off] = 1;
+        changed = true;
+        continue;
+      }
+
+      // NOT; JUMP_IF_FALSE L; POP ... L: POP  =>  JUMP_IF_TRUE L
+      // A condição fica por negar, mas os dois caminhos deitam-na fora
+      if (op == OP_NOT)
+      {
+        int j = live(off + 1);
+        if (j < count && code[j] == OP_JUMP_IF_FALSE && !isTarget[j])
+        {
+          int fall = live(j + 3);
+          int t = live(target[j]);
+          if (fall < count && code[fall] == OP_POP && t < count && code[t] == OP_POP)
+          {
+            dead[off] = 1;
+            code[j] = OP_JUMP_IF_TRUE;
+            changed = true;
+            continue;
+          }
+        }
+      }
+
+      // DUP; POP
+      if (op == OP_DUP)
+      {
+        int p = live(off + 1);
+        if (p < count && code[p] == OP_POP && !isTarget[p])
+        {
+          dead[off] = 1;
+          dead[p] = 1;
+          changed = true;
+          continue;
+        }
+      }
+
+      // Store para uma local nunca lida: SET_LOCAL só copia o topo para o
+      // slot, o valor continua na stack para quem vem a seguir
+      if (op == OP_SET_LOCAL && isDeadStore(chunk, off, code[off + 1]))
+      {
+        dead[off] = 1;
+        stats.deadStoresRemoved++;
+        changed = true;
+        continue;
+      }
+
+      // Código morto até ao próximo alvo de salto
+      if (isTerminator(op))
+      {
+        for (int q = off + len[off]; q < count && !isTarget[q]; q += len[q])
+        {
+          if (!dead[q])
+          {
+            dead[q] = 1;
+            changed = true;
+          }
+        }
+      }
+    }
+
+    changedAny |= changed;
+    if (!changed)
+      break;
+  }
+
+  if (!changedAny)
+    return;
+
+  // ---- Compacta: novos offsets e cópia (w <= off, pode ser in-place) ----
+  std::vector<int> newOff(count + 1, 0);
+  int w = 0;
+  for (int off = 0; off < count; off += len[off])
+  {
+    newOff[off] = w;
+    if (!dead[off])
+      w += len[off];
+  }
+  newOff[count] = w;
+
+  int *lines = chunk->lines;
+  w = 0;
+  for (int off = 0; off < count; off += len[off])
+  {
+    if (dead[off])
+      continue;
+
+    int n = len[off];
+    for (int k = 0; k < n; k++)
+    {
+      code[w + k] = code[off + k];
+      lines[w + k] = lines[off + k];
+    }
+
+    uint8 op = code[w];
+    if (target[off] >= 0)
+    {
+      int from = w + 3;
+      int to = newOff[live(target[off])];
+      int d = to - from;
+      if (op == OP_JUMP || op == OP_LOOP)
+      {
+        code[w] = d >= 0 ? OP_JUMP : OP_LOOP;
+        if (d < 0)
+          d = -d;
+      }
+      code[w + 1] = (uint8)((d >> 8) & 0xff);
+      code[w + 2] = (uint8)(d & 0xff);
+    }
+    else if (op == OP_TRY)
+    {
+      for (int k = 1; k <= 3; k += 2)
+      {
+        uint16 addr = (uint16)((code[w + k] << 8) | code[w + k + 1]);
+        if (addr == 0xFFFF)
+          continue;
+        int to = newOff[live(addr)];
+        code[w + k] = (uint8)((to >> 8) & 0xff);
+        code[w + k + 1] = (uint8)(to & 0xff);
+      }
+    }
+    w += n;
+  }
+
+  for (uint16 t = 0; t < chunk->switchTableCount; t++)
+  {
+    SwitchTable &table = chunk->switchTables[t];
+    if (!table.targets)
+      continue;
+    for (uint32 k = 0; k <= table.caseCount; k++)
+      table.targets[k] = (uint32)newOff[live((int)table.targets[k])];
+  }
+
+  stats.peepholeBytesRemoved += (size_t)(count - w);
+  chunk->count = (size_t)w;
+}
+
+// ============================================
+// DEAD STORES / VARIÁVEIS NUNCA LIDAS
+// ============================================
+// No endScope cada local que nunca teve um OP_GET_LOCAL (nem foi capturada por
+// uma closure) deixa o intervalo de bytecode em que o slot foi dela. Os
+// OP_SET_LOCAL a esse slot nesse intervalo são mortos. O slot em si fica (tirá-lo
+// obrigava a renumerar as outras locals); o valor inicial do 'var' também.
+
+void Compiler::noteUnreadLocals(int depth)
+{
+  if (!currentChunk)
+    return;
+
+  for (int i = localCount_ - 1; i >= 0 && locals_[i].depth >= depth; i--)
+  {
+    const Local &local = locals_[i];
+    if (local.isRead || local.isCaptured || !local.name)
+      continue;
+
+    deadStores_.push_back({currentChunk, (uint8)i, local.startOffset, (int)currentChunk->count});
+
+    if (options.warnUnused && !hadError && !local.isParam && local.name->chars()[0] != '_')
+    {
+      Warning("[line %d] Local variable '%s' is never read", local.line, local.name->chars());
+      stats.totalWarnings++;
+    }
+  }
+}
+
+bool Compiler::isDeadStore(const Code *chunk, int off, uint8 slot) const
+{
+  for (const DeadStoreRange &r : deadStores_)
+  {
+    if (r.chunk == chunk && r.slot == slot && off >= r.from && off < r.to)
+      return true;
+  }
+  return false;
+}
+
+// Globais não se tiram (o host pode lê-las): só o aviso
+void Compiler::warnUnusedGlobals()
+{
+  if (!options.warnUnused || hadError)
+    return;
+
+  for (const GlobalVarDecl &g : globalVarDecls_)
+  {
+    if (g.index < globalRead_.size() && globalRead_[g.index])
+      continue;
+    if (g.name->chars()[0] == '_')
+      continue;
+    Warning("[line %d] Global variable '%s' is never read", g.line, g.name->chars());
+    stats.totalWarnings++;
+  }
+}
@@ -4,6 +4,9 @@
 #include "opcode.hpp"
 #include "pool.hpp"
 #include "debug.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 
 // ============================================
 // STATEMENTS
@@ -31,6 +34,10 @@ void Compiler::declaration()
     {
         varDeclaration();
     }
+    else if (match(TOKEN_CONST))
+    {
+        constDeclaration();
+    }
     else if (match(TOKEN_IMPORT))
     {
         parseImport();
@@ -246,7 +253,7 @@ void Compiler::varDeclaration()
             names.push_back(previous);
 
             // OPTIMIZATION: Use global index instead of constant pool
-            uint16_t global = (scopeDepth == 0) ? getOrCreateGlobalIndex(previous.lexeme) : identifierConstant(previous);
+            uint16_t global = (scopeDepth == 0) ? getOrCreateGlobalIndex(previous.str) : identifierConstant(previous);
             globals.push_back(global);
 
             if (scopeDepth > 0)
@@ -285,13 +292,14 @@ void Compiler::varDeclaration()
             // Globais: define e consome valores da stack (LIFO)
             for (int i = (int)names.size() - 1; i >= 0; i--)
             {
-                int privateIdx = vm_->getProcessPrivateIndex(names[i].lexeme.c_str());
+                int privateIdx = vm_->getProcessPrivateIndex(names[i].chars());
                 if (privateIdx != -1)
                 {
                     Warning("Global variable '%s' shadows process private variable.",
-                            names[i].lexeme.c_str());
+                            names[i].chars());
                 }
-                declaredGlobals_.insert(names[i].lexeme);
+                declaredGlobals_.insert(names[i].str);
+                globalVarDecls_.push_back({names[i].str, names[i].line, globals[i]});
 
                 defineVariable(globals[i]);
             }
@@ -309,8 +317,14 @@ void Compiler::varDeclaration()
         consume(TOKEN_IDENTIFIER, "Expect variable name");
         Token nameToken = previous;
 
+        if (scopeDepth == 0 && constGlobals_.count(nameToken.str) > 0)
+        {
+            fail("Cannot redeclare constant '%s'", nameToken.chars());
+            return;
+        }
+
         // OPTIMIZATION: Use global index instead of constant pool for globals
-        uint16_t global = (scopeDepth == 0) ? getOrCreateGlobalIndex(nameToken.lexeme) : identifierConstant(nameToken);
+        uint16_t global = (scopeDepth == 0) ? getOrCreateGlobalIndex(nameToken.str) : identifierConstant(nameToken);
 
         if (scopeDepth > 0)
         {
@@ -323,7 +337,7 @@ void Compiler::varDeclaration()
 
             if (currentClass != nullptr && loopDepth_ > 1 && scopeDepth > 1)
             {
-                Warning("Variable '%s' is declared inside loops in class methods.", nameToken.lexeme.c_str());
+                Warning("Variable '%s' is declared inside loops in class methods.", nameToken.chars());
             }
         }
 
@@ -343,14 +357,15 @@ void Compiler::varDeclaration()
         if (scopeDepth == 0)
         {
             // Avisa se a variável global tem o mesmo nome de uma private de processo
-            int privateIdx = vm_->getProcessPrivateIndex(nameToken.lexeme.c_str());
+            int privateIdx = vm_->getProcessPrivateIndex(nameToken.chars());
             if (privateIdx != -1)
             {
                 Warning("Global variable '%s' shadows process private variable. "
                         "Inside processes, use a different name or the global will be used instead of the private.",
-                        nameToken.lexeme.c_str());
+                        nameToken.chars());
             }
-            declaredGlobals_.insert(nameToken.lexeme);
+            declaredGlobals_.insert(nameToken.str);
+            globalVarDecls_.push_back({nameToken.str, nameToken.line, global});
         }
 
         defineVariable(global);
@@ -360,10 +375,156 @@ void Compiler::varDeclaration()
     consume(TOKEN_SEMICOLON, "Expect ';' after variable declaration");
 }
 
+// =========================================
+// CONST: const NOME = expr, NOME = expr;
+// =========================================
+// Um literal (número, bool, nil, string, ou expressão já dobrada para um) fica
+// conhecido no compile: cada leitura é um OP_CONSTANT e segue para o folding
+// (const W = 800; W / 2 -> 400). Com valor de runtime é só uma variável que
+// não pode ser atribuída: um global (ou slot local) normal, lido com
+// OP_GET_GLOBAL em cada acesso e sem hoisting. A proteção é só do compilador
+// (=, op=, ++/--, também em funções); o host ainda a muda com setGlobal.
+void Compiler::constDeclaration()
+{
+    do
+    {
+        consume(TOKEN_IDENTIFIER, "Expect constant name");
+        Token nameToken = previous;
+
+        uint16_t global = 0;
+        if (scopeDepth > 0)
+        {
+            declareVariable();
+            validateIdentifierName(nameToken);
+            if (hadError)
+                return;
+            locals_[localCount_ - 1].isConst = true;
+        }
+        else
+        {
+            if (declaredGlobals_.count(nameToken.str) > 0)
+            {
+                fail("Constant '%s' already declared", nameToken.chars());
+                return;
+            }
+            global = getOrCreateGlobalIndex(nameToken.str);
+        }
+
+        consume(TOKEN_EQUAL, "Constant must be initialized");
+
+        int start = currentChunk->count;
+        expression();
+        if (hadError)
+            return;
+
+        Value value;
+        bool hasValue = literalValue(start, &value);
+
+        if (scopeDepth > 0)
+        {
+            markInitialized();
+            Local &local = locals_[localCount_ - 1];
+            local.hasValue = hasValue;
+            if (hasValue)
+                local.value = value;
+        }
+        else
+        {
+            declaredGlobals_.insert(nameToken.str);
+            constGlobals_[nameToken.str] = {hasValue, value};
+            globalVarDecls_.push_back({nameToken.str, nameToken.line, global});
+            defineVariable(global);
+        }
+
+    } while (match(TOKEN_COMMA));
+
+    consume(TOKEN_SEMICOLON, "Expect ';' after constant declaration");
+}
+
+// A expressão desde 'start' é uma única instrução com valor imutável?
+bool Compiler::literalValue(int start, Value *out)
+{
+    const uint8 *code = currentChunk->code;
+    int size = currentChunk->count - start;
+    if (size == 3 && code[start] == OP_CONSTANT)
+    {
+        *out = currentChunk->constants[(uint16)((code[start + 1] << 8) | code[start + 2])];
+        return out->isInt() || out->isDouble() || out->isFloat() || out->isUInt() ||
+               out->isByte() || out->isBool() || out->isNil() || out->isString();
+    }
+    if (size == 1)
+        return readConstant(start, out);
+    return false;
+}
+
+// Local com este nome na função actual ou numa envolvente (a mais interior ganha)
+Local *Compiler::lookupLocal(Token &name)
+{
+    for (int i = localCount_ - 1; i >= 0; i--)
+    {
+        if (locals_[i].name == name.str)
+            return &locals_[i];
+    }
+    for (int level = (int)enclosingStack_.size() - 1; level >= 0; level--)
+    {
+        std::vector<Local> &outer = enclosingStack_[level].locals;
+        for (int i = (int)outer.size() - 1; i >= 0; i--)
+        {
+            if (outer[i].name == name.str)
+                return &outer[i];
+        }
+    }
+    return nullptr;
+}
+
+// O nome resolve para uma const? Se o valor é conhecido devolve-o e conta
+// como leitura, já que o slot/global deixa de aparecer no bytecode.
+bool Compiler::resolveConst(Token &name, Value *value, bool *hasValue)
+{
+    *hasValue = false;
+    Local *local = lookupLocal(name);
+    if (local)
+    {
+        if (!local->isConst)
+            return false;
+        if (local->hasValue && local->depth != -1)
+        {
+            *hasValue = true;
+            *value = local->value;
+            local->isRead = true;
+        }
+        return true;
+    }
+
+    auto it = constGlobals_.find(name.str);
+    if (it == constGlobals_.end())
+        return false;
+    if (it->second.hasValue)
+    {
+        *hasValue = true;
+        *value = it->second.value;
+        uint16 index = getOrCreateGlobalIndex(name.str);
+        if (index >= globalRead_.size())
+            globalRead_.resize((size_t)index + 1, 0);
+        globalRead_[index] = 1;
+    }
+    return true;
+}
+
+bool Compiler::isAssignmentAhead(bool canAssign)
+{
+    if (check(TOKEN_PLUS_PLUS) || check(TOKEN_MINUS_MINUS))
+        return true;
+    if (!canAssign)
+        return false;
+    return check(TOKEN_EQUAL) || check(TOKEN_PLUS_EQUAL) || check(TOKEN_MINUS_EQUAL) ||
+           check(TOKEN_STAR_EQUAL) || check(TOKEN_SLASH_EQUAL) || check(TOKEN_PERCENT_EQUAL);
+}
+
 void Compiler::variable(bool canAssign)
 {
     Token name = previous;
-    std::string nameStr = name.lexeme;
+    const char *nameStr = name.chars();
 
     // =====================================================
     // PASSO 1: Procura em módulos USING (flat access)
@@ -395,14 +556,14 @@ void Compiler::variable(bool canAssign)
 
         // Tenta como função
         uint16 funcId;
-        if (mod->getFunctionId(nameStr.c_str(), &funcId))
+        if (mod->getFunctionId(nameStr, &funcId))
         {
             matches.push_back({moduleId, funcId, modName, true});
         }
 
         // Tenta como constante
         uint16 constId;
-        if (mod->getConstantId(nameStr.c_str(), &constId))
+        if (mod->getConstantId(nameStr, &constId))
         {
             matches.push_back({moduleId, constId, modName, false});
         }
@@ -417,7 +578,7 @@ void Compiler::variable(bool canAssign)
             modules += ", " + matches[i].moduleName;
         }
         fail("Ambiguous: '%s' found in multiple modules: %s. Use qualified name (module.%s)",
-             nameStr.c_str(), modules.c_str(), nameStr.c_str());
+             nameStr, modules.c_str(), nameStr);
         return;
     }
 
@@ -462,7 +623,7 @@ void Compiler::variable(bool canAssign)
     if (check(TOKEN_DOT))
     {
         // Verifica se é módulo importado
-        if (importedModules.find(nameStr) != importedModules.end())
+        if (!importedModules.empty() && importedModules.find(nameStr) != importedModules.end())
         {
             // É módulo! Processa module.member
             advance(); // Consome DOT
@@ -470,21 +631,21 @@ void Compiler::variable(bool canAssign)
             Token member = previous;
 
             uint16 moduleId;
-            if (!vm_->getModuleId(nameStr.c_str(), &moduleId))
+            if (!vm_->getModuleId(nameStr, &moduleId))
             {
-                fail("Module '%s' not found", nameStr.c_str());
+                fail("Module '%s' not found", nameStr);
                 return;
             }
 
             ModuleDef *mod = vm_->getModule(moduleId);
             if (!mod)
             {
-                fail("Module '%s' not found", nameStr.c_str());
+                fail("Module '%s' not found", nameStr);
                 return;
             }
             // Tenta como função
             uint16 funcId;
-            if (mod->getFunctionId(member.lexeme.c_str(), &funcId))
+            if (mod->getFunctionId(member.chars(), &funcId))
             {
                 // É função! Deve ser chamada
                 if (!match(TOKEN_LPAREN))
@@ -504,7 +665,7 @@ void Compiler::variable(bool canAssign)
 
             // Tenta como constante
             uint16 constId;
-            if (mod->getConstantId(member.lexeme.c_str(), &constId))
+            if (mod->getConstantId(member.chars(), &constId))
             {
                 // É constante! Emite valor direto
                 Value *value = mod->getConstant(constId);
@@ -517,8 +678,8 @@ void Compiler::variable(bool canAssign)
 
             // Não encontrou
             fail("'%s' not found in module '%s'",
-                 member.lexeme.c_str(),
-                 nameStr.c_str());
+                 member.chars(),
+                 nameStr);
             return;
         }
     }
@@ -555,13 +716,23 @@ void Compiler::or_(bool canAssign)
 uint16 Compiler::identifierConstant(Token &name)
 {
 
-    return makeConstant(vm_->makeString(name.lexeme.c_str()));
+    return makeConstant(vm_->makeString(name.str));
 }
 
 // Helper para emitir opcode de variável - usa emitShort para globais (índice de constante)
 void Compiler::emitVarOp(uint8 op, int arg)
 {
     bool isGlobal = (op == OP_GET_GLOBAL || op == OP_SET_GLOBAL);
+    if (op == OP_GET_LOCAL && arg < localCount_)
+    {
+        locals_[arg].isRead = true;
+    }
+    else if (op == OP_GET_GLOBAL)
+    {
+        if ((size_t)arg >= globalRead_.size())
+            globalRead_.resize((size_t)arg + 1, 0);
+        globalRead_[arg] = 1;
+    }
     emitByte(op);
     if (isGlobal)
         emitShort((uint16)arg);
@@ -571,6 +742,7 @@ void Compiler::emitVarOp(uint8 op, int arg)
 
 void Compiler::handle_assignment(uint8 getOp, uint8 setOp, int arg, bool canAssign)
 {
+    int start = currentChunk->count;
 
     if (match(TOKEN_PLUS_PLUS))
     {
@@ -636,6 +808,9 @@ void Compiler::handle_assignment(uint8 getOp, uint8 setOp, int arg, bool canAssi
     {
         emitVarOp(getOp, arg);
     }
+
+    // i++, i += k, i = i + k, x -= speed ...
+    fuseVarArith(start, getOp, arg);
 }
 
 void Compiler::namedVariable(Token &name, bool canAssign)
@@ -643,6 +818,23 @@ void Compiler::namedVariable(Token &name, bool canAssign)
     uint8 getOp, setOp;
     int arg;
 
+    // === 0. CONST: nunca atribuída; com valor conhecido é um OP_CONSTANT ===
+    Value constValue;
+    bool hasConstValue;
+    if (resolveConst(name, &constValue, &hasConstValue))
+    {
+        if (isAssignmentAhead(canAssign))
+        {
+            fail("Cannot assign to constant '%s'", name.chars());
+            return;
+        }
+        if (hasConstValue)
+        {
+            emitConstant(constValue);
+            return;
+        }
+    }
+
     // === 1. Tenta LOCAL (prioridade máxima - declaração explícita) ===
     arg = resolveLocal(name);
     if (arg != -1)
@@ -665,20 +857,37 @@ void Compiler::namedVariable(Token &name, bool canAssign)
 
     // === 3. Tenta GLOBAL (declaração explícita) ===
     // Verifica se foi declarado como global antes de usar PRIVATE
-    if (declaredGlobals_.count(name.lexeme) > 0)
+    if (declaredGlobals_.count(name.str) > 0)
     {
         // OPTIMIZATION: Use direct index instead of hash lookup
-        arg = getOrCreateGlobalIndex(name.lexeme);
+        arg = getOrCreateGlobalIndex(name.str);
         getOp = OP_GET_GLOBAL;
         setOp = OP_SET_GLOBAL;
+
+        // Nova função neste global: as chamadas daqui para a frente não são inlined
+        auto assigned = directFunctions_.find(name.str);
+        if (assigned != directFunctions_.end() && isAssignmentAhead(canAssign))
+            forgetInline(assigned->second, name);
+
+        int start = currentChunk->count;
         handle_assignment(getOp, setOp, arg, canAssign);
+
+        // Leitura simples de uma função global: call() pode emitir OP_CALL_DIRECT
+        auto fn = directFunctions_.find(name.str);
+        if (fn != directFunctions_.end() && currentChunk->count == start + 3 &&
+            currentChunk->code[start] == OP_GET_GLOBAL)
+        {
+            directCallee_ = fn->second;
+            directCalleeEnd_ = currentChunk->count;
+            directCalleeChunk_ = currentChunk;
+        }
         return;
     }
 
     // === 4. PRIVATE (fallback para variáveis de processo) ===
     if (isProcess_)
     {
-        arg = (int)vm_->getProcessPrivateIndex(name.lexeme.c_str());
+        arg = (int)vm_->getProcessPrivateIndex(name.chars());
         if (arg != -1)
         {
             getOp = OP_GET_PRIVATE;
@@ -691,7 +900,7 @@ void Compiler::namedVariable(Token &name, bool canAssign)
     // === 5. Fallback final: ERRO - variável não declarada ===
     // Se chegou aqui, a variável não foi declarada com 'var'
 
-    String *nameStr = vm_->createString(name.lexeme.c_str());
+    String *nameStr = name.str;
     if (vm_->globals.exist(nameStr))
     {
         // É uma classe/struct nativo - permite acesso
@@ -705,7 +914,7 @@ void Compiler::namedVariable(Token &name, bool canAssign)
     // Variável não foi declarada com 'var' - ERRO!
     // Mesmo em scope local, não permitimos criar globais implicitamente
     fail("Undefined variable '%s'!",
-          name.lexeme.c_str(), name.lexeme.c_str());
+          name.chars(), name.chars());
     
     // Emite código dummy para continuar compilação
     emitByte(OP_NIL);
@@ -740,9 +949,9 @@ void Compiler::declareVariable()
             break;
         }
 
-        if (local.name == name.lexeme)
+        if (local.name == name.str)
         {
-            fail("Variable '%s' already declared in this scope", name.lexeme.c_str());
+            fail("Variable '%s' already declared in this scope", name.chars());
             return;
         }
     }
@@ -758,17 +967,23 @@ void Compiler::addLocal(Token &name)
         return;
     }
 
-    size_t len = name.lexeme.length();
+    size_t len = name.str ? name.str->length() : name.length;
     if (len >= MAX_IDENTIFIER_LENGTH)
     {
         fail("Identifier name too long (max %d characters)", MAX_IDENTIFIER_LENGTH - 1);
         return;
     }
 
-    locals_[localCount_].name = name.lexeme;
+    locals_[localCount_].name = name.str;
     locals_[localCount_].depth = -1;
     locals_[localCount_].usedInitLocal = false;
     locals_[localCount_].isCaptured = false;
+    locals_[localCount_].isRead = false;
+    locals_[localCount_].isParam = false;
+    locals_[localCount_].isConst = false;
+    locals_[localCount_].hasValue = false;
+    locals_[localCount_].line = name.line;
+    locals_[localCount_].startOffset = currentChunk ? (int)currentChunk->count : 0;
 
     localCount_++;
 }
@@ -802,7 +1017,7 @@ void Compiler::beginScope()
 
 void Compiler::endScope()
 {
-
+    noteUnreadLocals(scopeDepth);
     int popped = discardLocals(scopeDepth);
     localCount_ -= popped;
     scopeDepth--;
@@ -812,7 +1027,7 @@ int Compiler::resolveLocal(Token &name)
 {
     for (int i = localCount_ - 1; i >= 0; i--)
     {
-        if (locals_[i].name == name.lexeme)
+        if (locals_[i].name == name.str)
         {
             if (locals_[i].depth == -1)
             {
@@ -856,6 +1071,7 @@ void Compiler::ifStatement()
 {
     // if (condition)
     consume(TOKEN_LPAREN, "Expect '(' after 'if'");
+    int condStart = currentChunk->count;
     expression();
     if (hadError)
         return;
@@ -863,6 +1079,7 @@ void Compiler::ifStatement()
 
     // Jump para próximo bloco se condição for falsa
     int thenJump = emitJump(OP_JUMP_IF_FALSE);
+    fuseCompareJump(condStart, thenJump);
     emitByte(OP_POP); // Pop da condição se for true
 
     // Then branch
@@ -883,6 +1100,7 @@ void Compiler::ifStatement()
     {
         // elif (condition)
         consume(TOKEN_LPAREN, "Expect '(' after 'elif'");
+        int elifStart = currentChunk->count;
         expression();
         if (hadError)
             return;
@@ -890,6 +1108,7 @@ void Compiler::ifStatement()
 
         // Jump para próximo bloco se condição for falsa
         int elifJump = emitJump(OP_JUMP_IF_FALSE);
+        fuseCompareJump(elifStart, elifJump);
         emitByte(OP_POP); // Pop se elif for true
 
         // Elif body
@@ -1027,6 +1246,7 @@ void Compiler::whileStatement()
 
     // 1. Se for falso, salta para 'exitJump'
     int exitJump = emitJump(OP_JUMP_IF_FALSE);
+    fuseCompareJump(loopStart, exitJump);
 
     // 2. Se for verdadeiro, faz POP do 'true' e entra no corpo
     emitByte(OP_POP);
@@ -1131,6 +1351,15 @@ void Compiler::switchStatement()
     consume(TOKEN_RPAREN, "Expect ')' after switch expression");
     consume(TOKEN_LBRACE, "Expect '{' before switch body");
 
+    // Labels constantes: salto por tabela em vez da cadeia de comparações
+    std::vector<Value> labels;
+    if (switchTableLabels(&labels))
+    {
+        switchTableStatement(labels);
+        leaveSwitchContext();
+        return;
+    }
+
     std::vector<int> endJumps;
     std::vector<int> caseFailJumps;
 
@@ -1206,6 +1435,260 @@ void Compiler::switchStatement()
     leaveSwitchContext();
 }
 
+// =========================================
+// SWITCH TABLE
+// =========================================
+// Antes de compilar o corpo, só pelos tokens: os labels deste switch (os
+// 'case' fora de chavetas interiores) são todos inteiros de 32 bits (com '-'
+// opcional), todos strings, ou consts com um desses valores? Devolve os
+// valores pela ordem dos cases.
+bool Compiler::switchTableLabels(std::vector<Value> *labels)
+{
+    if (!options.switchTables)
+        return false;
+
+    int depth = 0;
+    bool seenDefault = false;
+    bool strings = false;
+    for (size_t i = (size_t)cursor - 1; i < tokens.size(); i++)
+    {
+        const Token &tok = tokens[i];
+        if (tok.type == TOKEN_EOF)
+            return false;
+        if (tok.type == TOKEN_LBRACE)
+        {
+            depth++;
+            continue;
+        }
+        if (tok.type == TOKEN_RBRACE)
+        {
+            if (depth == 0)
+                return labels->size() >= SWITCH_TABLE_MIN_CASES;
+            depth--;
+            continue;
+        }
+        if (depth > 0)
+            continue;
+        if (tok.type == TOKEN_DEFAULT)
+        {
+            seenDefault = true;
+            continue;
+        }
+        if (tok.type != TOKEN_CASE)
+            continue;
+        if (seenDefault || labels->size() >= SWITCH_TABLE_MAX_CASES)
+            return false;
+
+        size_t j = i + 1;
+        bool negative = false;
+        if (j < tokens.size() && tokens[j].type == TOKEN_MINUS)
+        {
+            negative = true;
+            j++;
+        }
+        if (j + 1 >= tokens.size() || tokens[j + 1].type != TOKEN_COLON)
+            return false;
+
+        Token label = tokens[j];
+        Value value;
+        if (label.type == TOKEN_INT)
+        {
+            // Mesma leitura que o number(): hex ou decimal
+            const char *text = spanText(label);
+            char *end = nullptr;
+            errno = 0;
+            long long n = (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) ? std::strtoll(text, &end, 16)
+                                                                                 : std::strtoll(text, &end, 10);
+            if (errno == ERANGE || end == text || *end != '\0' || n > INT32_MAX)
+                return false;
+            value = vm_->makeInt((int)(negative ? -n : n));
+        }
+        else if (label.type == TOKEN_STRING && !negative)
+        {
+            value = vm_->makeString(label.str);
+        }
+        else if (label.type == TOKEN_IDENTIFIER && !negative)
+        {
+            bool hasValue = false;
+            if (!resolveConst(label, &value, &hasValue) || !hasValue || !(value.isInt() || value.isString()))
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (labels->empty())
+            strings = value.isString();
+        else if (value.isString() != strings)
+            return false;
+        labels->push_back(value);
+        i = j + 1;
+    }
+    return false;
+}
+
+//   <valor> OP_SWITCH_TABLE t   (pop; salta para o case, o default ou o fim)
+//   case 0: corpo; JUMP fim
+//   ...
+//   default: corpo
+// fim:
+void Compiler::switchTableStatement(const std::vector<Value> &labels)
+{
+    int index = currentChunk->addSwitchTable();
+    if (index < 0)
+    {
+        fail("Too many switch tables in one function");
+        recoverToCurrentSwitchEnd();
+        return;
+    }
+    emitByte(OP_SWITCH_TABLE);
+    emitShort((uint16)index);
+
+    std::vector<uint32> targets;
+    std::vector<int> endJumps;
+
+    while (match(TOKEN_CASE))
+    {
+        // O label já foi lido pelo switchTableLabels
+        while (!check(TOKEN_COLON) && !check(TOKEN_EOF))
+            advance();
+        consume(TOKEN_COLON, "Expect ':' after case value");
+        targets.push_back((uint32)currentChunk->count);
+
+        while (!check(TOKEN_CASE) && !check(TOKEN_DEFAULT) &&
+               !check(TOKEN_RBRACE) && !check(TOKEN_EOF))
+        {
+            statement();
+            if (hadError)
+            {
+                // A tabela (e as dos switches encaixados) fica por construir
+                currentChunk->dropSwitchTables((uint16)index);
+                recoverToCurrentSwitchEnd();
+                return;
+            }
+        }
+
+        endJumps.push_back(emitJump(OP_JUMP));
+    }
+
+    int defaultTarget = -1;
+    if (match(TOKEN_DEFAULT))
+    {
+        consume(TOKEN_COLON, "Expect ':' after 'default'");
+        defaultTarget = (int)currentChunk->count;
+
+        while (!check(TOKEN_CASE) && !check(TOKEN_RBRACE) && !check(TOKEN_EOF))
+        {
+            statement();
+            if (hadError)
+            {
+                // A tabela (e as dos switches encaixados) fica por construir
+                currentChunk->dropSwitchTables((uint16)index);
+                recoverToCurrentSwitchEnd();
+                return;
+            }
+        }
+    }
+
+    consume(TOKEN_RBRACE, "Expect '}' after switch body");
+
+    for (int jump : endJumps)
+    {
+        patchJump(jump);
+    }
+
+    if (defaultTarget < 0)
+        defaultTarget = (int)currentChunk->count;
+    if (hadError)
+    {
+        currentChunk->dropSwitchTables((uint16)index);
+        return;
+    }
+    if (!buildSwitchTable(index, labels, targets, (uint32)defaultTarget))
+    {
+        currentChunk->dropSwitchTables((uint16)index);
+        fail("Cannot build switch table");
+    }
+}
+
+// O primeiro case com um dado valor ganha (como na cadeia de comparações)
+bool Compiler::buildSwitchTable(int index, const std::vector<Value> &labels, const std::vector<uint32> &targets,
+                                uint32 defaultTarget)
+{
+    if (labels.size() != targets.size())
+        return false;
+
+    const uint16 caseCount = (uint16)labels.size();
+    uint8 kind = SWITCH_HASH_STRING;
+    int64_t minKey = 0, maxKey = 0;
+    if (!labels[0].isString())
+    {
+        minKey = maxKey = labels[0].asInt();
+        for (const Value &v : labels)
+        {
+            minKey = std::min<int64_t>(minKey, v.asInt());
+            maxKey = std::max<int64_t>(maxKey, v.asInt());
+        }
+        int64_t range = maxKey - minKey + 1;
+        kind = (range <= SWITCH_TABLE_MAX_DENSE && range <= 4 * (int64_t)caseCount) ? SWITCH_DENSE : SWITCH_HASH_INT;
+    }
+
+    uint32 size = 0;
+    if (kind == SWITCH_DENSE)
+    {
+        size = (uint32)(maxKey - minKey + 1);
+    }
+    else
+    {
+        size = 8;
+        while (size < 2u * caseCount)
+            size *= 2;
+    }
+
+    // O chunk pode ter crescido a lista de tabelas (switches encaixados)
+    SwitchTable *table = &currentChunk->switchTables[index];
+    if (!currentChunk->allocSwitchTable(table, kind, caseCount, size))
+        return false;
+    table->base = (int32)minKey;
+
+    for (uint16 i = 0; i < caseCount; i++)
+        table->targets[i] = targets[i];
+    table->targets[caseCount] = defaultTarget;
+
+    for (uint16 i = 0; i < caseCount; i++)
+    {
+        const Value &v = labels[i];
+        if (kind == SWITCH_DENSE)
+        {
+            uint32 slot = (uint32)(v.asInt() - table->base);
+            if (table->slots[slot] == caseCount)
+                table->slots[slot] = i;
+            continue;
+        }
+
+        uint32 mask = size - 1;
+        uint32 slot = (kind == SWITCH_HASH_STRING) ? (uint32)v.asString()->hash & mask : switchHashInt(v.asInt()) & mask;
+        for (;; slot = (slot + 1) & mask)
+        {
+            if (table->slots[slot] == caseCount)
+            {
+                table->slots[slot] = i;
+                if (kind == SWITCH_HASH_STRING)
+                    table->strKeys[slot] = v.asString();
+                else
+                    table->intKeys[slot] = v.asInt();
+                break;
+            }
+            bool same = (kind == SWITCH_HASH_STRING) ? compare_strings(table->strKeys[slot], v.asString())
+                                                     : table->intKeys[slot] == v.asInt();
+            if (same)
+                break;
+        }
+    }
+    return true;
+}
+
 void Compiler::breakStatement()
 {
     if (switchDepth_ > 0)
@@ -1269,6 +1752,7 @@ void Compiler::forStatement()
 
         // salta para fora se condição for falsa
         exitJump = emitJump(OP_JUMP_IF_FALSE);
+        fuseCompareJump(loopStart, exitJump);
         emitByte(OP_POP); // Pop da condição
     }
     else
@@ -1333,14 +1817,11 @@ void Compiler::foreachStatement()
     expression();
     consume(TOKEN_RPAREN, "Expect ')'");
 
-    Token tmp;
-    tmp.lexeme = "__seq___";
-    tmp.type = TOKEN_IDENTIFIER;
-    tmp.column = previous.column;
+    Token tmp = syntheticToken("__seq___");
     addLocal(tmp);
     markInitialized();
     emitByte(OP_NIL);
-    tmp.lexeme = "__iter__";
+    tmp = syntheticToken("__iter__");
     addLocal(tmp);
     markInitialized();
     int loopStart = currentChunk->count;
@@ -1505,8 +1986,26 @@ void Compiler::call(bool canAssign)
         return;
     }
 
+    // Callee acabado de emitir como OP_GET_GLOBAL de uma função conhecida?
+    int direct = -1;
+    int calleeStart = currentChunk->count - 3;
+    if (options.directCalls && directCallee_ != -1 && directCalleeChunk_ == currentChunk &&
+        directCalleeEnd_ == currentChunk->count)
+        direct = directCallee_;
+    directCallee_ = -1;
+
     callDepth++;
     uint8 argCount = argumentList();
+    if (direct != -1 && vm_->functions[direct]->arity == argCount)
+    {
+        if (inlineCall((uint16)direct, calleeStart))
+        {
+            callDepth--;
+            return;
+        }
+        emitByte(OP_CALL_DIRECT);
+        emitShort((uint16)direct);
+    }
     emitBytes(OP_CALL, argCount);
     callDepth--;
 }
@@ -1529,12 +2028,12 @@ void Compiler::funDeclaration()
         actualName = function->name->chars();
 
         actualName += "$";
-        actualName += nameToken.lexeme;
+        actualName += nameToken.chars();
     }
     else
     {
         // Top-level function: nome normal
-        actualName = nameToken.lexeme;
+        actualName = nameToken.chars();
     }
 
     Function *func = vm_->addFunction(actualName.c_str(), 0);
@@ -1552,11 +2051,16 @@ void Compiler::funDeclaration()
     else
     {
         // Register global name BEFORE compiling body so recursion works
-        declaredGlobals_.insert(nameToken.lexeme);
+        declaredGlobals_.insert(nameToken.str);
+        directFunctions_[nameToken.str] = (uint16)func->index;
     }
 
     // Compila função
     compileFunction(func, false); // false = não é process
+    if (func->upvalueCount > 0)
+        directFunctions_.erase(nameToken.str);
+    else if (scopeDepth == 0)
+        analyzeInline(func, nameToken.str);
 
     // Verifica se tem upvalues
     if (func->upvalueCount > 0)
@@ -1586,7 +2090,7 @@ void Compiler::funDeclaration()
     else
     {
         // OPTIMIZATION: Use global index instead of constant pool
-        uint16 globalIndex = getOrCreateGlobalIndex(nameToken.lexeme);
+        uint16 globalIndex = getOrCreateGlobalIndex(nameToken.str);
         defineVariable(globalIndex); // Global
     }
 }
@@ -1606,7 +2110,7 @@ void Compiler::processDeclaration()
 
     // Cria função para o process
 
-    Function *func = vm_->addFunction(nameToken.lexeme.c_str(), 0);
+    Function *func = vm_->addFunction(nameToken.chars(), 0);
 
     if (!func)
     {
@@ -1619,7 +2123,7 @@ void Compiler::processDeclaration()
     compileFunction(func, true); // true = É PROCESS!
 
     // Cria blueprint (process não vai para globals como callable)
-    ProcessDef *proc = vm_->addProcess(nameToken.lexeme.c_str(), func, numFibers_);
+    ProcessDef *proc = vm_->addProcess(nameToken.chars(), func, numFibers_);
     currentProcess = proc;
 
     for (uint32 i = 0; i < argNames.size(); i++)
@@ -1651,8 +2155,8 @@ void Compiler::processDeclaration()
 
     emitConstant(vm_->makeProcess(proc->index));
     // OPTIMIZATION: Use global index instead of constant pool
-    declaredGlobals_.insert(nameToken.lexeme);
-    uint16 globalIndex = getOrCreateGlobalIndex(nameToken.lexeme);
+    declaredGlobals_.insert(nameToken.str);
+    uint16 globalIndex = getOrCreateGlobalIndex(nameToken.str);
     defineVariable(globalIndex);
 
     proc->finalize();
@@ -1720,10 +2224,10 @@ void Compiler::compileFunction(Function *func, bool isProcess)
 
     if (!isProcess)
     {
-        Token dummyToken;
-        dummyToken.lexeme = func->name->chars();
+        Token dummyToken = syntheticToken(func->name->chars());
         addLocal(dummyToken);
         markInitialized();
+        locals_[localCount_ - 1].isParam = true;
     }
 
     if (!check(TOKEN_RPAREN))
@@ -1740,9 +2244,9 @@ void Compiler::compileFunction(Function *func, bool isProcess)
             consume(TOKEN_IDENTIFIER, "Expect parameter name");
             if (isProcess)
             {
-                argNames.push(vm_->createString(previous.lexeme.c_str()));
+                argNames.push(previous.str);
 
-                int privateIndex = vm_->getProcessPrivateIndex(previous.lexeme.c_str());
+                int privateIndex = vm_->getProcessPrivateIndex(previous.chars());
                 if (privateIndex >= 0 &&
                     privateIndex != (int)PrivateIndex::ID &&
                     privateIndex != (int)PrivateIndex::FATHER)
@@ -1754,12 +2258,14 @@ void Compiler::compileFunction(Function *func, bool isProcess)
                 {
                     addLocal(previous);
                     markInitialized();
+                    locals_[localCount_ - 1].isParam = true;
                 }
             }
             else
             {
                 addLocal(previous);
                 markInitialized();
+                locals_[localCount_ - 1].isParam = true;
             }
 
         } while (match(TOKEN_COMMA));
@@ -1791,6 +2297,7 @@ void Compiler::compileFunction(Function *func, bool isProcess)
     // GUARDA UPVALUE COUNT
     // ========================================
     func->upvalueCount = this->upvalueCount_;
+    peephole(func);
 
     // ========================================
     // RESTAURA ESTADO (POP da stack)
@@ -1847,29 +2354,34 @@ void Compiler::prefixIncrement(bool canAssign)
         int arg = resolveLocal(name);
         if (arg != -1)
         {
-            emitBytes(OP_GET_LOCAL, (uint8)arg);
+            emitVarOp(OP_GET_LOCAL, arg);
         }
         else
         {
             // OPTIMIZATION: Use global index instead of constant pool
-            arg = getOrCreateGlobalIndex(name.lexeme);
-            emitByte(OP_GET_GLOBAL);
-            emitShort((uint16)arg);
+            arg = getOrCreateGlobalIndex(name.str);
+            emitVarOp(OP_GET_GLOBAL, arg);
         }
 
         emitByte(OP_DUP);
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx);
         emitConstant(vm_->makeInt(1));
         emitByte(OP_ADD);
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx);
     }
     // -----------------------------------------------------------
     // CENÁRIO B: É uma VARIÁVEL (++i, ++upvalue, ++private)
     // -----------------------------------------------------------
     else
     {
+        Value constValue;
+        bool hasConstValue;
+        if (resolveConst(name, &constValue, &hasConstValue))
+        {
+            fail("Cannot assign to constant '%s'", name.chars());
+            return;
+        }
+
         uint8 getOp = OP_GET_GLOBAL, setOp = OP_SET_GLOBAL;
         int arg = -1;
 
@@ -1893,10 +2405,10 @@ void Compiler::prefixIncrement(bool canAssign)
         }
 
         // 3. Tenta GLOBAL (se foi declarado como global)
-        if (arg == -1 && declaredGlobals_.count(name.lexeme) > 0)
+        if (arg == -1 && declaredGlobals_.count(name.str) > 0)
         {
             // OPTIMIZATION: Use global index instead of constant pool
-            arg = getOrCreateGlobalIndex(name.lexeme);
+            arg = getOrCreateGlobalIndex(name.str);
             getOp = OP_GET_GLOBAL;
             setOp = OP_SET_GLOBAL;
         }
@@ -1904,7 +2416,7 @@ void Compiler::prefixIncrement(bool canAssign)
         // 4. Tenta PRIVATE (só se for Process e não achou global)
         if (arg == -1 && isProcess_)
         {
-            int index = (int)vm_->getProcessPrivateIndex(name.lexeme.c_str());
+            int index = (int)vm_->getProcessPrivateIndex(name.chars());
             if (index != -1)
             {
                 arg = index;
@@ -1917,17 +2429,19 @@ void Compiler::prefixIncrement(bool canAssign)
         if (arg == -1)
         {
             // OPTIMIZATION: Use global index instead of constant pool
-            arg = getOrCreateGlobalIndex(name.lexeme);
+            arg = getOrCreateGlobalIndex(name.str);
             getOp = OP_GET_GLOBAL;
             setOp = OP_SET_GLOBAL;
         }
 
         // Agora sim, emite o código correto para QUALQUER tipo de variável
         // ++i retorna o valor NOVO
+        int start = currentChunk->count;
         emitVarOp(getOp, arg);         // [old_value]
         emitConstant(vm_->makeInt(1)); // [old_value, 1]
         emitByte(OP_ADD);              // [new_value]
         emitVarOp(setOp, arg);         // [new_value] (SET usa PEEK, não remove!)
+        fuseVarArith(start, getOp, arg);
         // SET já deixa o new_value na stack, não precisa de DUP
     }
 }
@@ -1958,29 +2472,34 @@ void Compiler::prefixDecrement(bool canAssign)
         int arg = resolveLocal(name);
         if (arg != -1)
         {
-            emitBytes(OP_GET_LOCAL, (uint8)arg);
+            emitVarOp(OP_GET_LOCAL, arg);
         }
         else
         {
             // OPTIMIZATION: Use global index instead of constant pool
-            arg = getOrCreateGlobalIndex(name.lexeme);
-            emitByte(OP_GET_GLOBAL);
-            emitShort((uint16)arg);
+            arg = getOrCreateGlobalIndex(name.str);
+            emitVarOp(OP_GET_GLOBAL, arg);
         }
 
         emitByte(OP_DUP); // [obj, obj]
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx);            // [obj, val_antigo]
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx); // [obj, val_antigo]
         emitConstant(vm_->makeInt(1)); // [obj, val_antigo, 1]
         emitByte(OP_SUBTRACT);         // [obj, val_novo]
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx); // [val_novo]
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx); // [val_novo]
     }
     // -----------------------------------------------------------
     // CENÁRIO B: É uma VARIÁVEL (Locais, Upvalues, Globais, Privates)
     // -----------------------------------------------------------
     else
     {
+        Value constValue;
+        bool hasConstValue;
+        if (resolveConst(name, &constValue, &hasConstValue))
+        {
+            fail("Cannot assign to constant '%s'", name.chars());
+            return;
+        }
+
         uint8 getOp = OP_GET_GLOBAL, setOp = OP_SET_GLOBAL;
         int arg = -1;
 
@@ -2004,10 +2523,10 @@ void Compiler::prefixDecrement(bool canAssign)
         }
 
         // 3. Tenta GLOBAL (se foi declarado como global)
-        if (arg == -1 && declaredGlobals_.count(name.lexeme) > 0)
+        if (arg == -1 && declaredGlobals_.count(name.str) > 0)
         {
             // OPTIMIZATION: Use global index instead of constant pool
-            arg = getOrCreateGlobalIndex(name.lexeme);
+            arg = getOrCreateGlobalIndex(name.str);
             getOp = OP_GET_GLOBAL;
             setOp = OP_SET_GLOBAL;
         }
@@ -2015,7 +2534,7 @@ void Compiler::prefixDecrement(bool canAssign)
         // 4. Tenta PRIVATE (só se for Process e não achou global)
         if (arg == -1 && isProcess_)
         {
-            int index = (int)vm_->getProcessPrivateIndex(name.lexeme.c_str());
+            int index = (int)vm_->getProcessPrivateIndex(name.chars());
             if (index != -1)
             {
                 arg = index;
@@ -2028,16 +2547,18 @@ void Compiler::prefixDecrement(bool canAssign)
         if (arg == -1)
         {
             // OPTIMIZATION: Use global index instead of constant pool
-            arg = getOrCreateGlobalIndex(name.lexeme);
+            arg = getOrCreateGlobalIndex(name.str);
             getOp = OP_GET_GLOBAL;
             setOp = OP_SET_GLOBAL;
         }
 
         // --i retorna o valor NOVO
+        int start = currentChunk->count;
         emitVarOp(getOp, arg);         // [old_value]
         emitConstant(vm_->makeInt(1)); // [old_value, 1]
         emitByte(OP_SUBTRACT);         // [new_value]
         emitVarOp(setOp, arg);         // [new_value] (SET usa PEEK, não remove!)
+        fuseVarArith(start, getOp, arg);
         // SET já deixa o new_value na stack
     }
 }
@@ -2094,7 +2615,7 @@ void Compiler::includeStatement()
 {
     consume(TOKEN_STRING, "Expect filename after include");
 
-    std::string filename = previous.lexeme.c_str();
+    std::string filename = previous.chars();
 
     // std::set para proteção circular
     if (includedFiles.find(filename) != includedFiles.end())
@@ -2109,29 +2630,46 @@ void Compiler::includeStatement()
         return;
     }
 
-    // CALLBACK retorna C-style
-    size_t sourceSize = 0;
-    const char *source = fileLoader(filename.c_str(), &sourceSize, fileLoaderUserdata);
-
-    if (!source || sourceSize == 0)
+    // Unidade em cache: só passa pelo lexer se o conteúdo mudou. Os includes
+    // vistos antes do compile já foram carregados (preloadIncludes)
+    bool reused = false;
+    IncludeUnit *unit = nullptr;
+    auto preloaded = preloadedIncludes_.find(filename);
+    if (preloaded != preloadedIncludes_.end())
     {
-        fail("Cannot load %s %d", filename.c_str(), sourceSize);
-        return;
+        unit = &includeUnits_[filename];
+        reused = preloaded->second;
+    }
+    else
+    {
+        // CALLBACK retorna C-style
+        size_t sourceSize = 0;
+        const char *source = fileLoader(filename.c_str(), &sourceSize, fileLoaderUserdata);
+
+        if (!source || sourceSize == 0)
+        {
+            fail("Cannot load %s %d", filename.c_str(), sourceSize);
+            return;
+        }
+        unit = loadIncludeUnit(filename, source, sourceSize, &reused);
     }
 
     // Adiciona ao set
     includedFiles.insert(filename);
+    includes_.push_back({filename, unit->hash, reused});
 
     // SALVA estado
     Lexer *oldLexer = this->lexer;
-    std::vector<Token> oldTokens = this->tokens;
+    std::vector<Token> oldTokens = std::move(this->tokens);
     Token oldCurrent = this->current;
     Token oldPrevious = this->previous;
     int oldCursor = this->cursor;
 
-    // COMPILA inline
-    this->lexer = new Lexer(source, sourceSize);
-    this->tokens = lexer->scanAll();
+    // COMPILA inline (os tokens são emprestados pela unidade, sem cópia: os
+    // includes circulares são recusados, nunca está activa duas vezes)
+    this->lexer = unit->lexer;
+    this->tokens = std::move(unit->tokens);
+    noteAssignedNames(this->tokens);
     predeclareProcessGlobals();
     this->cursor = 0;
     advance();
@@ -2142,9 +2680,11 @@ void Compiler::includeStatement()
     }
 
     // RESTAURA
-    delete this->lexer;
+    // O lexer do include é da unidade e fica vivo depois do compile: labels,
+    // gotos e mensagens de erro ainda podem apontar para os seus tokens
+    unit->tokens = std::move(this->tokens);
     this->lexer = oldLexer;
-    this->tokens = oldTokens;
+    this->tokens = std::move(oldTokens);
     this->current = oldCurrent;
     this->previous = oldPrevious;
     this->cursor = oldCursor;
@@ -2163,19 +2703,19 @@ void Compiler::parseUsing()
     {
         consume(TOKEN_IDENTIFIER, "Expect module name");
         Token moduleName = previous;
-        std::string modName = moduleName.lexeme;
+        std::string modName = moduleName.chars();
 
         if (importedModules.find(modName) == importedModules.end())
         {
             fail("Module '%s' not imported. Use 'import %s;' first",
-                 moduleName.lexeme.c_str(),
-                 moduleName.lexeme.c_str());
+                 moduleName.chars(),
+                 moduleName.chars());
             return;
         }
 
         if (usingModules.find(modName) != usingModules.end())
         {
-            Warning("Module '%s' already using", moduleName.lexeme.c_str());
+            Warning("Module '%s' already using", moduleName.chars());
         }
         else
         {
@@ -2207,12 +2747,12 @@ void Compiler::parseImport()
     {
         consume(TOKEN_IDENTIFIER, "Expect module name");
         Token moduleName = previous;
-        std::string modName = moduleName.lexeme;
+        std::string modName = moduleName.chars();
 
         // Verifica se módulo existe
         if (!vm_->containsModule(modName.c_str()))
         {
-            fail("Module '%s' not defined", moduleName.lexeme.c_str());
+            fail("Module '%s' not defined", moduleName.chars());
             return;
         }
 
@@ -2223,7 +2763,7 @@ void Compiler::parseImport()
         }
         else
         {
-            Warning("Module '%s' already imported", moduleName.lexeme.c_str());
+            Warning("Module '%s' already imported", moduleName.chars());
         }
 
     } while (match(TOKEN_COMMA));
@@ -2238,7 +2778,7 @@ void Compiler::parseRequire()
     // require "glfw;rlgl;gtk";  // múltiplos separados por ponto e vírgula
 
     consume(TOKEN_STRING, "Expect plugin name as string after 'require'");
-    std::string pluginList = previous.lexeme;
+    std::string pluginList = previous.chars();
 
     // Remove quotes from string literal
     if (pluginList.size() >= 2 && pluginList.front() == '"' && pluginList.back() == '"')
@@ -2273,6 +2813,8 @@ void Compiler::parseRequire()
         // Ignorar strings vazias
         if (!pluginName.empty())
         {
+            requiredPlugins_.push_back(pluginName);
+
             // Check if module is already loaded
             if (!vm_->containsModule(pluginName.c_str()))
             {
@@ -2290,18 +2832,8 @@ void Compiler::parseRequire()
                 // that need to be available to the compiler
                 vm_->nativeGlobalIndices.forEach([this](String *nameStr, uint16 index)
                                                  {
-                    const std::string name = nameStr->chars();
-                    if (globalIndices_.find(name) == globalIndices_.end())
-                    {
-                        // New native from the plugin - add to compiler indices
-                        globalIndices_[name] = index;
-                        if (index >= globalIndexToName_.size())
-                        {
-                            globalIndexToName_.resize(index + 1);
-                        }
-                        globalIndexToName_[index] = name;
-                        declaredGlobals_.insert(name);
-                    } });
+                    // New native from the plugin - add to compiler indices
+                    importGlobal(nameStr, index); });
                 // Update nextGlobalIndex to be after all registered natives
                 nextGlobalIndex_ = static_cast<uint16>(vm_->globalsArray.size());
             }
@@ -2384,16 +2916,28 @@ void Compiler::dot(bool canAssign)
     {
 
         uint8_t argCount = argumentList();
-        emitByte(OP_INVOKE);
-        emitShort(nameIdx);
-        emitByte(argCount);
+
+        // Métodos de string/array/map/buffer: id resolvido já aqui
+        int methodId = hadError ? -1 : vm_->getStaticNameId(currentChunk->constants[nameIdx].asString());
+        if (methodId >= 0)
+        {
+            emitByte(OP_INVOKE_BUILTIN);
+            emitShort(nameIdx);
+            emitByte(argCount);
+            emitByte((uint8)methodId);
+        }
+        else
+        {
+            emitByte(OP_INVOKE);
+            emitShort(nameIdx);
+            emitByte(argCount);
+        }
     }
     // SIMPLE ASSIGNMENT
     else if (canAssign && match(TOKEN_EQUAL))
     {
         expression();
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx);
     }
     //  COMPOUND ASSIGNMENTS
     else if (canAssign && match(TOKEN_PLUS_EQUAL))
@@ -2401,52 +2945,42 @@ void Compiler::dot(bool canAssign)
         // self.x += value
         // Stack antes: [self]
         emitByte(OP_DUP); // [self, self]
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx); // [self, old_x]
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx); // [self, old_x]
         expression();       // [self, old_x, value]
         emitByte(OP_ADD);   // [self, new_x]
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx); // []
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx); // []
     }
     else if (canAssign && match(TOKEN_MINUS_EQUAL))
     {
         emitByte(OP_DUP);
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx);
         expression();
         emitByte(OP_SUBTRACT);
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx);
     }
     else if (canAssign && match(TOKEN_STAR_EQUAL))
     {
         emitByte(OP_DUP);
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx);
         expression();
         emitByte(OP_MULTIPLY);
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx);
     }
     else if (canAssign && match(TOKEN_SLASH_EQUAL))
     {
         emitByte(OP_DUP);
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx);
         expression();
         emitByte(OP_DIVIDE);
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx);
     }
     else if (canAssign && match(TOKEN_PERCENT_EQUAL))
     {
         emitByte(OP_DUP);
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx);
         expression();
         emitByte(OP_MODULO);
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx);
     }
     //  INCREMENT/DECREMENT
     else if (canAssign && match(TOKEN_PLUS_PLUS))
@@ -2454,16 +2988,13 @@ void Compiler::dot(bool canAssign)
         // self.x++ (postfix) - retorna valor ANTIGO
         // Stack: [self]
         emitByte(OP_DUP); // [self, self]
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx); // [self, old_x]
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx); // [self, old_x]
         emitByte(OP_SWAP);  // [old_x, self]
         emitByte(OP_DUP);   // [old_x, self, self]
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx);            // [old_x, self, old_x]
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx); // [old_x, self, old_x]
         emitConstant(vm_->makeInt(1)); // [old_x, self, old_x, 1]
         emitByte(OP_ADD);              // [old_x, self, new_x]
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx); // [old_x, new_x]
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx); // [old_x, new_x]
         emitByte(OP_POP);   // [old_x] ← resultado correto!
     }
     else if (canAssign && match(TOKEN_MINUS_MINUS))
@@ -2471,23 +3002,19 @@ void Compiler::dot(bool canAssign)
         // self.x-- (postfix) - retorna valor ANTIGO
         // Stack: [self]
         emitByte(OP_DUP); // [self, self]
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx); // [self, old_x]
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx); // [self, old_x]
         emitByte(OP_SWAP);  // [old_x, self]
         emitByte(OP_DUP);   // [old_x, self, self]
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx);            // [old_x, self, old_x]
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx); // [old_x, self, old_x]
         emitConstant(vm_->makeInt(1)); // [old_x, self, old_x, 1]
         emitByte(OP_SUBTRACT);         // [old_x, self, new_x]
-        emitByte(OP_SET_PROPERTY);
-        emitShort(nameIdx); // [old_x, new_x]
+        emitPropertyOp(OP_SET_PROPERTY, nameIdx); // [old_x, new_x]
         emitByte(OP_POP);   // [old_x] ← resultado correto!
     }
     //  GET ONLY
     else
     {
-        emitByte(OP_GET_PROPERTY);
-        emitShort(nameIdx);
+        emitPropertyOp(OP_GET_PROPERTY, nameIdx);
     }
 }
 
@@ -2527,15 +3054,15 @@ void Compiler::labelStatement()
 
     for (const Label &l : labels)
     {
-        if (l.name == labelName.lexeme)
+        if (l.name == labelName.str)
         {
-            fail("Label '%s' already defined", labelName.lexeme.c_str());
+            fail("Label '%s' already defined", labelName.chars());
             return;
         }
     }
 
     Label newLabel;
-    newLabel.name = labelName.lexeme;
+    newLabel.name = labelName.str;
     newLabel.offset = currentChunk->count;
 
     labels.push_back(newLabel);
@@ -2558,7 +3085,7 @@ void Compiler::gotoStatement()
     emitByte(OP_JUMP);
 
     GotoJump jump;
-    jump.target = target.lexeme;
+    jump.target = target.str;
     jump.jumpOffset = currentChunk->count;
 
     emitByte(0xFF);
@@ -2584,7 +3111,7 @@ void Compiler::gosubStatement()
     emitByte(OP_GOSUB);
 
     GotoJump jump;
-    jump.target = target.lexeme;
+    jump.target = target.str;
     jump.jumpOffset = currentChunk->count;
 
     emitByte(0xFF);
@@ -2607,11 +3134,11 @@ void Compiler::structDeclaration()
     }
     consume(TOKEN_LBRACE, "Expect '{' before struct body");
 
-    StructDef *structDef = vm_->registerStruct(vm_->createString(structName.lexeme.c_str()));
+    StructDef *structDef = vm_->registerStruct(structName.str);
 
     if (!structDef)
     {
-        fail("Struct with name '%s' already exists", structName.lexeme.c_str());
+        fail("Struct with name '%s' already exists", structName.chars());
         return;
     }
 
@@ -2635,13 +3162,13 @@ void Compiler::structDeclaration()
         {
             consumeIdentifierLike("Expect field name");
 
-            String *fieldName = vm_->createString(previous.lexeme.c_str());
+            String *fieldName = previous.str;
             // Não validar keywords - campos podem ter nomes como "loop", "break", etc.
             bool wasReplaced = structDef->names.set(fieldName, structDef->argCount);
             if (!wasReplaced)
             {
                 Warning("Field '%s' redefined in struct '%s' (previous value replaced)",
-                        fieldName->chars(), structName.lexeme.c_str());
+                        fieldName->chars(), structName.chars());
             }
             structDef->argCount++;
 
@@ -2671,8 +3198,8 @@ void Compiler::structDeclaration()
     // OPTIMIZATION: Use global index for struct name instead of constant pool
     if (scopeDepth == 0)
     {
-        uint16_t global = getOrCreateGlobalIndex(structName.lexeme);
-        declaredGlobals_.insert(structName.lexeme);
+        uint16_t global = getOrCreateGlobalIndex(structName.str);
+        declaredGlobals_.insert(structName.str);
         defineVariable(global);
     }
     else
@@ -2690,8 +3217,8 @@ void Compiler::self(bool canAssign)
         error("Cannot use 'self' outside of a class");
         return;
     }
-    Token selfToken;
-    selfToken.lexeme = "self";
+    // 'previous' é a keyword self: já traz o "self" interned
+    Token selfToken = previous;
     selfToken.type = TOKEN_IDENTIFIER;
     namedVariable(selfToken, canAssign);
 }
@@ -2745,19 +3272,19 @@ void Compiler::classDeclaration()
     //  Regista class blueprint na VM
 
     ClassDef *classDef = vm_->registerClass(
-        vm_->createString(className.lexeme.c_str()));
+        className.str);
 
     if (!classDef)
     {
-        fail("Class with name '%s' already exists", className.lexeme.c_str());
+        fail("Class with name '%s' already exists", className.chars());
         return;
     }
 
     // Emite class ID como constante
     emitConstant(vm_->makeClass(classDef->index));
     // OPTIMIZATION: Use global index instead of constant pool
-    declaredGlobals_.insert(className.lexeme);
-    uint16_t globalIndex = getOrCreateGlobalIndex(className.lexeme);
+    declaredGlobals_.insert(className.str);
+    uint16_t globalIndex = getOrCreateGlobalIndex(className.str);
     defineVariable(globalIndex);
 
     // Herança?
@@ -2766,7 +3293,7 @@ void Compiler::classDeclaration()
         consume(TOKEN_IDENTIFIER, "Expect superclass name");
         Token superName = previous;
 
-        const char *name = superName.lexeme.c_str();
+        const char *name = superName.chars();
 
         // Primeiro tenta ClassDef (script class)
         ClassDef *classSuper = nullptr;
@@ -2799,7 +3326,7 @@ void Compiler::classDeclaration()
             }
             else
             {
-                fail("Undefined superclass '%s'", superName.lexeme.c_str());
+                fail("Undefined superclass '%s'", superName.chars());
                 return;
             }
         }
@@ -2814,14 +3341,14 @@ void Compiler::classDeclaration()
             consumeIdentifierLike("Expect field name");
             Token fieldName = previous;
             // Não validar keywords - campos podem ter nomes como "loop", "break", etc.
-            String *name = vm_->createString(fieldName.lexeme.c_str());
+            String *name = fieldName.str;
             // classDef->fieldNames.set(name, classDef->fieldCount);
 
             bool wasReplaced = classDef->fieldNames.set(name, classDef->fieldCount);
             if (!wasReplaced)
             {
                 Warning("Field '%s' redefined in class '%s' (previous value replaced)",
-                        fieldName.lexeme.c_str(), className.lexeme.c_str());
+                        fieldName.chars(), className.chars());
             }
 
             classDef->fieldCount++;
@@ -2833,13 +3360,13 @@ void Compiler::classDeclaration()
                 if (match(TOKEN_INT))
                 {
                     // Parse integer literal
-                    int64_t value = std::strtoll(previous.lexeme.c_str(), nullptr, 10);
+                    int64_t value = std::strtoll(spanText(previous), nullptr, 10);
                     classDef->fieldDefaults.push(vm_->makeInt(value));
                 }
                 else if (match(TOKEN_FLOAT))
                 {
                     // Parse float literal
-                    double value = std::strtod(previous.lexeme.c_str(), nullptr);
+                    double value = std::strtod(spanText(previous), nullptr);
                     classDef->fieldDefaults.push(vm_->makeDouble(value));
                 }
                 else if (match(TOKEN_MINUS))
@@ -2847,19 +3374,19 @@ void Compiler::classDeclaration()
                     // Support negative numeric literals: -123 / -3.14
                     if (match(TOKEN_INT))
                     {
-                        int64_t value = -std::strtoll(previous.lexeme.c_str(), nullptr, 10);
+                        int64_t value = -std::strtoll(spanText(previous), nullptr, 10);
                         classDef->fieldDefaults.push(vm_->makeInt(value));
                     }
                     else if (match(TOKEN_FLOAT))
                     {
-                        double value = -std::strtod(previous.lexeme.c_str(), nullptr);
+                        double value = -std::strtod(spanText(previous), nullptr);
                         classDef->fieldDefaults.push(vm_->makeDouble(value));
                     }
                     else
                     {
                         // Non-literal expression - compile and discard, use nil
                         Warning("Field '%s' in class '%s': complex default not supported, using nil (set it in init())",
-                                fieldName.lexeme.c_str(), className.lexeme.c_str());
+                                fieldName.chars(), className.chars());
                         expression();
                         emitByte(OP_POP);
                         classDef->fieldDefaults.push(vm_->makeNil());
@@ -2870,19 +3397,19 @@ void Compiler::classDeclaration()
                     // Support positive numeric literals: +123 / +3.14
                     if (match(TOKEN_INT))
                     {
-                        int64_t value = std::strtoll(previous.lexeme.c_str(), nullptr, 10);
+                        int64_t value = std::strtoll(spanText(previous), nullptr, 10);
                         classDef->fieldDefaults.push(vm_->makeInt(value));
                     }
                     else if (match(TOKEN_FLOAT))
                     {
-                        double value = std::strtod(previous.lexeme.c_str(), nullptr);
+                        double value = std::strtod(spanText(previous), nullptr);
                         classDef->fieldDefaults.push(vm_->makeDouble(value));
                     }
                     else
                     {
                         // Non-literal expression - compile and discard, use nil
                         Warning("Field '%s' in class '%s': complex default not supported, using nil (set it in init())",
-                                fieldName.lexeme.c_str(), className.lexeme.c_str());
+                                fieldName.chars(), className.chars());
                         expression();
                         emitByte(OP_POP);
                         classDef->fieldDefaults.push(vm_->makeNil());
@@ -2891,7 +3418,7 @@ void Compiler::classDeclaration()
                 else if (match(TOKEN_STRING))
                 {
                     // Parse string literal
-                    String *str = vm_->createString(previous.lexeme.c_str());
+                    String *str = previous.str;
                     classDef->fieldDefaults.push(vm_->makeString(str));
                 }
                 else if (match(TOKEN_TRUE))
@@ -2910,7 +3437,7 @@ void Compiler::classDeclaration()
                 {
                     // Non-literal expression - compile and discard, use nil
                     Warning("Field '%s' in class '%s': complex default not supported, using nil (set it in init())",
-                            fieldName.lexeme.c_str(), className.lexeme.c_str());
+                            fieldName.chars(), className.chars());
                     expression();
                     emitByte(OP_POP);
                     classDef->fieldDefaults.push(vm_->makeNil());
@@ -2937,7 +3464,7 @@ void Compiler::classDeclaration()
     if (classDef->constructor == nullptr)
     {
         Warning("Class '%s' has no init() method - fields will be uninitialized (nil)",
-                className.lexeme.c_str());
+                className.chars());
     }
 }
 
@@ -2951,7 +3478,7 @@ void Compiler::method(ClassDef *classDef)
     this->currentFunctionType = FunctionType::TYPE_METHOD;
     // Registra função
     //    std::string funcName = classDef->name->chars() +std::string("::") + methodName.lexeme;
-    std::string funcName = methodName.lexeme;
+    std::string funcName = methodName.chars();
     Function *func = classDef->canRegisterFunction(vm_->createString(funcName.c_str()));
     if (!func)
     {
@@ -2985,12 +3512,11 @@ void Compiler::method(ClassDef *classDef)
     beginScope(); // scopeDepth = 1
 
     // ===== SELF = LOCAL[0] =====
-    Token selfToken;
-    selfToken.lexeme = "self";
-    selfToken.type = TOKEN_IDENTIFIER;
+    Token selfToken = syntheticToken("self");
 
     addLocal(selfToken);
     markInitialized();
+    locals_[localCount_ - 1].isParam = true;
 
     // ===== PARAMS =====
     consume(TOKEN_LPAREN, "Expect '('");
@@ -3009,6 +3535,7 @@ void Compiler::method(ClassDef *classDef)
             consume(TOKEN_IDENTIFIER, "Expect parameter name");
             addLocal(previous);
             markInitialized();
+            locals_[localCount_ - 1].isParam = true;
 
         } while (match(TOKEN_COMMA));
     }
@@ -3040,6 +3567,7 @@ void Compiler::method(ClassDef *classDef)
     }
 
     endScope();
+    peephole(func);
 
     // ===== RESTAURA ESTADO =====
     this->function = enclosing;
@@ -3108,6 +3636,7 @@ void Compiler::tryStatement()
         beginScope();
         addLocal(errorVar);
         markInitialized();
+        locals_[localCount_ - 1].isParam = true; // preenchida pelo runtime, como um parâmetro
 
         block();
         endScope();
@@ -3,6 +3,8 @@
 #include "interpreter.hpp"
 #include "opcode.hpp"
 #include <cstdio>
+#include <vector>
+#include <algorithm>
 
 // Global names para disassembly
 static const char** g_globalNames = nullptr;
@@ -30,6 +32,335 @@ void Debug::disassembleChunk(const Code &chunk, const char *name)
   }
 }
 
+const char *Debug::opcodeName(uint8 op)
+{
+  switch (op)
+  {
+  case OP_CONSTANT:
+    return "OP_CONSTANT";
+  case OP_NIL:
+    return "OP_NIL";
+  case OP_TRUE:
+    return "OP_TRUE";
+  case OP_FALSE:
+    return "OP_FALSE";
+  case OP_POP:
+    return "OP_POP";
+  case OP_HALT:
+    return "OP_HALT";
+  case OP_NOT:
+    return "OP_NOT";
+  case OP_DUP:
+    return "OP_DUP";
+  case OP_ADD:
+    return "OP_ADD";
+  case OP_SUBTRACT:
+    return "OP_SUBTRACT";
+  case OP_MULTIPLY:
+    return "OP_MULTIPLY";
+  case OP_DIVIDE:
+    return "OP_DIVIDE";
+  case OP_NEGATE:
+    return "OP_NEGATE";
+  case OP_MODULO:
+    return "OP_MODULO";
+  case OP_BITWISE_AND:
+    return "OP_BITWISE_AND";
+  case OP_BITWISE_OR:
+    return "OP_BITWISE_OR";
+  case OP_BITWISE_XOR:
+    return "OP_BITWISE_XOR";
+  case OP_BITWISE_NOT:
+    return "OP_BITWISE_NOT";
+  case OP_SHIFT_LEFT:
+    return "OP_SHIFT_LEFT";
+  case OP_SHIFT_RIGHT:
+    return "OP_SHIFT_RIGHT";
+  case OP_EQUAL:
+    return "OP_EQUAL";
+  case OP_NOT_EQUAL:
+    return "OP_NOT_EQUAL";
+  case OP_GREATER:
+    return "OP_GREATER";
+  case OP_GREATER_EQUAL:
+    return "OP_GREATER_EQUAL";
+  case OP_LESS:
+    return "OP_LESS";
+  case OP_LESS_EQUAL:
+    return "OP_LESS_EQUAL";
+  case OP_GET_LOCAL:
+    return "OP_GET_LOCAL";
+  case OP_SET_LOCAL:
+    return "OP_SET_LOCAL";
+  case OP_GET_GLOBAL:
+    return "OP_GET_GLOBAL";
+  case OP_SET_GLOBAL:
+    return "OP_SET_GLOBAL";
+  case OP_DEFINE_GLOBAL:
+    return "OP_DEFINE_GLOBAL";
+  case OP_GET_PRIVATE:
+    return "OP_GET_PRIVATE";
+  case OP_SET_PRIVATE:
+    return "OP_SET_PRIVATE";
+  case OP_JUMP:
+    return "OP_JUMP";
+  case OP_JUMP_IF_FALSE:
+    return "OP_JUMP_IF_FALSE";
+  case OP_LOOP:
+    return "OP_LOOP";
+  case OP_GOSUB:
+    return "OP_GOSUB";
+  case OP_RETURN_SUB:
+    return "OP_RETURN_SUB";
+  case OP_CALL:
+    return "OP_CALL";
+  case OP_RETURN:
+    return "OP_RETURN";
+  case OP_SPAWN:
+    return "OP_SPAWN";
+  case OP_YIELD:
+    return "OP_YIELD";
+  case OP_FRAME:
+    return "OP_FRAME";
+  case OP_EXIT:
+    return "OP_EXIT";
+  case OP_DEFINE_ARRAY:
+    return "OP_DEFINE_ARRAY";
+  case OP_DEFINE_MAP:
+    return "OP_DEFINE_MAP";
+  case OP_GET_PROPERTY:
+    return "OP_GET_PROPERTY";
+  case OP_SET_PROPERTY:
+    return "OP_SET_PROPERTY";
+  case OP_GET_INDEX:
+    return "OP_GET_INDEX";
+  case OP_SET_INDEX:
+    return "OP_SET_INDEX";
+  case OP_INVOKE:
+    return "OP_INVOKE";
+  case OP_SUPER_INVOKE:
+    return "OP_SUPER_INVOKE";
+  case OP_PRINT:
+    return "OP_PRINT";
+  case OP_FUNC_LEN:
+    return "OP_FUNC_LEN";
+  case OP_ITER_NEXT:
+    return "OP_ITER_NEXT";
+  case OP_ITER_VALUE:
+    return "OP_ITER_VALUE";
+  case OP_COPY2:
+    return "OP_COPY2";
+  case OP_SWAP:
+    return "OP_SWAP";
+  case OP_DISCARD:
+    return "OP_DISCARD";
+  case OP_TRY:
+    return "OP_TRY";
+  case OP_POP_TRY:
+    return "OP_POP_TRY";
+  case OP_THROW:
+    return "OP_THROW";
+  case OP_ENTER_CATCH:
+    return "OP_ENTER_CATCH";
+  case OP_ENTER_FINALLY:
+    return "OP_ENTER_FINALLY";
+  case OP_EXIT_FINALLY:
+    return "OP_EXIT_FINALLY";
+  case OP_SIN:
+    return "OP_SIN";
+  case OP_COS:
+    return "OP_COS";
+  case OP_TAN:
+    return "OP_TAN";
+  case OP_ASIN:
+    return "OP_ASIN";
+  case OP_ACOS:
+    return "OP_ACOS";
+  case OP_ATAN:
+    return "OP_ATAN";
+  case OP_SQRT:
+    return "OP_SQRT";
+  case OP_ABS:
+    return "OP_ABS";
+  case OP_LOG:
+    return "OP_LOG";
+  case OP_FLOOR:
+    return "OP_FLOOR";
+  case OP_CEIL:
+    return "OP_CEIL";
+  case OP_DEG:
+    return "OP_DEG";
+  case OP_RAD:
+    return "OP_RAD";
+  case OP_EXP:
+    return "OP_EXP";
+  case OP_ATAN2:
+    return "OP_ATAN2";
+  case OP_POW:
+    return "OP_POW";
+  case OP_CLOCK:
+    return "OP_CLOCK";
+  case OP_NEW_BUFFER:
+    return "OP_NEW_BUFFER";
+  case OP_FREE:
+    return "OP_FREE";
+  case OP_CLOSURE:
+    return "OP_CLOSURE";
+  case OP_GET_UPVALUE:
+    return "OP_GET_UPVALUE";
+  case OP_SET_UPVALUE:
+    return "OP_SET_UPVALUE";
+  case OP_CLOSE_UPVALUE:
+    return "OP_CLOSE_UPVALUE";
+  case OP_RETURN_N:
+    return "OP_RETURN_N";
+  case OP_TYPE:
+    return "OP_TYPE";
+  case OP_PROC:
+    return "OP_PROC";
+  case OP_GET_ID:
+    return "OP_GET_ID";
+  case OP_INVOKE_BUILTIN:
+    return "OP_INVOKE_BUILTIN";
+  case OP_ADD_II:
+    return "OP_ADD_II";
+  case OP_ADD_DD:
+    return "OP_ADD_DD";
+  case OP_SUBTRACT_II:
+    return "OP_SUBTRACT_II";
+  case OP_SUBTRACT_DD:
+    return "OP_SUBTRACT_DD";
+  case OP_MULTIPLY_II:
+    return "OP_MULTIPLY_II";
+  case OP_MULTIPLY_DD:
+    return "OP_MULTIPLY_DD";
+  case OP_LESS_II:
+    return "OP_LESS_II";
+  case OP_LESS_DD:
+    return "OP_LESS_DD";
+  case OP_GREATER_II:
+    return "OP_GREATER_II";
+  case OP_GREATER_DD:
+    return "OP_GREATER_DD";
+  case OP_INC_LOCAL:
+    return "OP_INC_LOCAL";
+  case OP_INC_PRIVATE:
+    return "OP_INC_PRIVATE";
+  case OP_CMP_LOCAL_JUMP:
+    return "OP_CMP_LOCAL_JUMP";
+  case OP_CALL_DIRECT:
+    return "OP_CALL_DIRECT";
+  case OP_GET_PROC_PRIVATE:
+    return "OP_GET_PROC_PRIVATE";
+  case OP_SET_PROC_PRIVATE:
+    return "OP_SET_PROC_PRIVATE";
+  case OP_JUMP_IF_TRUE:
+    return "OP_JUMP_IF_TRUE";
+  case OP_PICK:
+    return "OP_PICK";
+  case OP_SLIDE:
+    return "OP_SLIDE";
+  case OP_SWITCH_TABLE:
+    return "OP_SWITCH_TABLE";
+  default:
+    return "OP_UNKNOWN";
+  }
+}
+
+#if USE_OPCODE_PROFILE
+
+// ============================================
+// OPCODE PROFILE (pares / triplos)
+// ============================================
+// Sequências podem atravessar chamadas e trocas de fiber: é ruído baixo
+// comparado com os loops quentes que interessam.
+
+struct OpcodeSeqHasher
+{
+  size_t operator()(uint32 k) const { return (size_t)(k * 2654435761u); }
+};
+struct OpcodeSeqEq
+{
+  bool operator()(uint32 a, uint32 b) const { return a == b; }
+};
+
+static size_t g_opcodePairs[256 * 256];
+static HashMap<uint32, size_t, OpcodeSeqHasher, OpcodeSeqEq> g_opcodeTriples;
+static int g_profilePrev1 = -1;
+static int g_profilePrev2 = -1;
+static size_t g_profileTotal = 0;
+
+void Debug::profileOpcode(uint8 op)
+{
+  g_profileTotal++;
+  if (g_profilePrev1 >= 0)
+  {
+    g_opcodePairs[(g_profilePrev1 << 8) | op]++;
+    if (g_profilePrev2 >= 0)
+    {
+      uint32 key = ((uint32)g_profilePrev2 << 16) | ((uint32)g_profilePrev1 << 8) | op;
+      size_t *count = g_opcodeTriples.getPtr(key);
+      if (count)
+        (*count)++;
+      else
+        g_opcodeTriples.set(key, 1);
+    }
+  }
+  g_profilePrev2 = g_profilePrev1;
+  g_profilePrev1 = op;
+}
+
+void Debug::resetOpcodeProfile()
+{
+  for (size_t i = 0; i < 256 * 256; i++)
+    g_opcodePairs[i] = 0;
+  g_opcodeTriples.destroy();
+  g_profilePrev1 = g_profilePrev2 = -1;
+  g_profileTotal = 0;
+}
+
+void Debug::dumpOpcodeProfile(FILE *f, int top)
+{
+  typedef std::pair<uint32, size_t> Entry;
+  auto byCount = [](const Entry &a, const Entry &b) { return a.second > b.second; };
+
+  std::vector<Entry> pairs;
+  for (uint32 i = 0; i < 256 * 256; i++)
+    if (g_opcodePairs[i])
+      pairs.push_back(Entry(i, g_opcodePairs[i]));
+  std::sort(pairs.begin(), pairs.end(), byCount);
+
+  std::vector<Entry> triples;
+  g_opcodeTriples.forEach([&](uint32 key, size_t count)
+                          { triples.push_back(Entry(key, count)); });
+  std::sort(triples.begin(), triples.end(), byCount);
+
+  fprintf(f, "========================================\n");
+  fprintf(f, "OPCODE PROFILE (%zu instructions)\n", g_profileTotal);
+  fprintf(f, "========================================\n\n");
+
+  fprintf(f, "Top pairs:\n");
+  for (size_t i = 0; i < pairs.size() && (int)i < top; i++)
+  {
+    uint32 k = pairs[i].first;
+    fprintf(f, "  %10zu  %5.2f%%  %s -> %s\n", pairs[i].second,
+            g_profileTotal ? 100.0 * pairs[i].second / g_profileTotal : 0.0,
+            opcodeName((uint8)(k >> 8)), opcodeName((uint8)k));
+  }
+
+  fprintf(f, "\nTop triples:\n");
+  for (size_t i = 0; i < triples.size() && (int)i < top; i++)
+  {
+    uint32 k = triples[i].first;
+    fprintf(f, "  %10zu  %5.2f%%  %s -> %s -> %s\n", triples[i].second,
+            g_profileTotal ? 100.0 * triples[i].second / g_profileTotal : 0.0,
+            opcodeName((uint8)(k >> 16)), opcodeName((uint8)(k >> 8)), opcodeName((uint8)k));
+  }
+  fprintf(f, "\n");
+}
+
+#endif // USE_OPCODE_PROFILE
+
 static bool hasBytes(const Code &chunk, size_t offset, size_t n)
 {
   return offset + n < chunk.count;
@@ -148,6 +479,38 @@ size_t Debug::disassembleInstruction(const Code &chunk, size_t offset)
     return jumpInstruction("OP_JUMP", +1, chunk, offset);
   case OP_JUMP_IF_FALSE:
     return jumpInstruction("OP_JUMP_IF_FALSE", +1, chunk, offset);
+  case OP_JUMP_IF_TRUE:
+    return jumpInstruction("OP_JUMP_IF_TRUE", +1, chunk, offset);
+  case OP_PICK:
+    return byteInstruction("OP_PICK", chunk, offset);
+  case OP_SLIDE:
+    return byteInstruction("OP_SLIDE", chunk, offset);
+  case OP_SWITCH_TABLE:
+  {
+    if (!hasBytes(chunk, offset, 2))
+    {
+      printf("OP_SWITCH_TABLE <truncated>\n");
+      return chunk.count;
+    }
+
+    uint16_t index = (uint16_t)(chunk.code[offset + 1] << 8) | chunk.code[offset + 2];
+    if (index >= chunk.switchTableCount)
+    {
+      printf("%-20s %4u <bad table>\n", "OP_SWITCH_TABLE", (unsigned)index);
+      return offset + 3;
+    }
+
+    static const char *kinds[] = {"dense", "hash-int", "hash-string"};
+    const SwitchTable &table = chunk.switchTables[index];
+    if (!table.targets)
+    {
+      printf("%-20s %4u <empty table>\n", "OP_SWITCH_TABLE", (unsigned)index);
+      return offset + 3;
+    }
+    printf("%-20s %4u %s cases=%u default=%04x\n", "OP_SWITCH_TABLE", (unsigned)index, kinds[table.kind],
+           (unsigned)table.caseCount, (unsigned)table.targets[table.caseCount]);
+    return offset + 3;
+  }
   case OP_LOOP:
     return jumpInstruction("OP_LOOP", -1, chunk, offset);
   case OP_GOSUB:
@@ -230,9 +593,13 @@ size_t Debug::disassembleInstruction(const Code &chunk, size_t offset)
 
     // ========== PROPERTIES (46-49) ==========
   case OP_GET_PROPERTY:
-    return constantInstruction("OP_GET_PROPERTY", chunk, offset);
+    return propertyInstruction("OP_GET_PROPERTY", chunk, offset);
   case OP_SET_PROPERTY:
-    return constantInstruction("OP_SET_PROPERTY", chunk, offset);
+    return propertyInstruction("OP_SET_PROPERTY", chunk, offset);
+  case OP_GET_PROC_PRIVATE: // idx(u8) + operandos do GET/SET_PROPERTY
+    return propertyInstruction("OP_GET_PROC_PRIVATE", chunk, offset + 1);
+  case OP_SET_PROC_PRIVATE:
+    return propertyInstruction("OP_SET_PROC_PRIVATE", chunk, offset + 1);
   case OP_GET_INDEX:
     return simpleInstruction("OP_GET_INDEX", offset);
   case OP_SET_INDEX:
@@ -259,6 +626,59 @@ size_t Debug::disassembleInstruction(const Code &chunk, size_t offset)
     return offset + 4;
   }
 
+    // ========== QUICKENED (93-102) ==========
+  case OP_ADD_II:
+    return simpleInstruction("OP_ADD_II", offset);
+  case OP_ADD_DD:
+    return simpleInstruction("OP_ADD_DD", offset);
+  case OP_SUBTRACT_II:
+    return simpleInstruction("OP_SUBTRACT_II", offset);
+  case OP_SUBTRACT_DD:
+    return simpleInstruction("OP_SUBTRACT_DD", offset);
+  case OP_MULTIPLY_II:
+    return simpleInstruction("OP_MULTIPLY_II", offset);
+  case OP_MULTIPLY_DD:
+    return simpleInstruction("OP_MULTIPLY_DD", offset);
+  case OP_LESS_II:
+    return simpleInstruction("OP_LESS_II", offset);
+  case OP_LESS_DD:
+    return simpleInstruction("OP_LESS_DD", offset);
+  case OP_GREATER_II:
+    return simpleInstruction("OP_GREATER_II", offset);
+  case OP_GREATER_DD:
+    return simpleInstruction("OP_GREATER_DD", offset);
+
+    // Superinstructions: só o opcode foi reescrito, a sequência original segue
+  case OP_INC_LOCAL:
+    return byteInstruction("OP_INC_LOCAL", chunk, offset);
+  case OP_INC_PRIVATE:
+    return byteInstruction("OP_INC_PRIVATE", chunk, offset);
+  case OP_CMP_LOCAL_JUMP:
+    return byteInstruction("OP_CMP_LOCAL_JUMP", chunk, offset);
+  case OP_CALL_DIRECT:
+    return shortInstruction("OP_CALL_DIRECT", chunk, offset);
+
+  case OP_INVOKE_BUILTIN:
+  {
+    if (!hasBytes(chunk, offset, 4))
+    {
+      printf("OP_INVOKE_BUILTIN <truncated>\n");
+      return chunk.count;
+    }
+
+    uint16_t nameIdx = (uint16_t)(chunk.code[offset + 1] << 8) | chunk.code[offset + 2];
+    uint8_t argCount = chunk.code[offset + 3];
+    uint8_t methodId = chunk.code[offset + 4];
+
+    Value c = chunk.constants[nameIdx];
+    const char *nm = (c.isString() ? c.asString()->chars() : "<non-string>");
+
+    printf("%-20s %4u '%s' (%u args) #%u\n", "OP_INVOKE_BUILTIN", (unsigned)nameIdx, nm,
+           (unsigned)argCount, (unsigned)methodId);
+
+    return offset + 5;
+  }
+
   case OP_SUPER_INVOKE:
   {
     if (!hasBytes(chunk, offset, 4))
@@ -398,6 +818,26 @@ size_t Debug::constantInstruction(const char *name, const Code &chunk,
   return offset + 3;
 }
 
+size_t Debug::propertyInstruction(const char *name, const Code &chunk,
+                                  size_t offset)
+{
+  if (!hasBytes(chunk, offset, 4))
+  {
+    printf("%s <truncated>\n", name);
+    return chunk.count;
+  }
+
+  uint16 constantIdx = (uint16)(chunk.code[offset + 1] << 8) | chunk.code[offset + 2];
+  uint16 cacheIdx = (uint16)(chunk.code[offset + 3] << 8) | chunk.code[offset + 4];
+  printf("%-20s %4u '", name, (unsigned)constantIdx);
+  printValue(chunk.constants[constantIdx]);
+  printf("' ic#%u", (unsigned)cacheIdx);
+  if (cacheIdx < chunk.propertyCacheCount)
+    printf(" (%u shapes)", (unsigned)chunk.propertyCaches[cacheIdx].count);
+  printf("\n");
+  return offset + 5;
+}
+
 size_t Debug::constantNameInstruction(const char *name, const Code &chunk,
                                       size_t offset)
 {
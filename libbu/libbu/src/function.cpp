@@ -1,10 +1,12 @@
 #include "config.hpp"
 #include "interpreter.hpp"
 #include "pool.hpp"
+#include "regcode.hpp"
 
 Function::~Function()
 {
-   
+    delete regCode;
+
     if (chunk)
     {
         chunk->clear();
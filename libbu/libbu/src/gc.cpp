@@ -3,16 +3,21 @@
  * @brief Garbage Collection implementation for the BuLang VM interpreter
  * 
  * This module implements a tri-color mark-and-sweep garbage collector with support for:
- * - Root marking from global variables, process privates, fiber stacks, and call frames
+ * - Root marking from global variables, process privates, fiber stacks, call frames
+ *   and host root markers (addGCRootMarker)
  * - Gray stack-based reference tracing to avoid stack overflow
  * - Object blackening based on type-specific reference patterns
  * - Automatic threshold adjustment based on allocation growth
+ * - Incremental mode: mark and sweep run in bounded slices, driven by allocation
+ *   and by gcStep() each frame; write barriers keep marked objects from
+ *   pointing at unmarked ones while the mark is in progress
  * 
  * The GC manages lifetime of the following object types:
  * - Struct and Class instances (user-defined types)
  * - Collections: Arrays, Maps, Buffers
  * - Native bindings: Native class and struct instances
  * - Function closures and their captured upvalues
+ * - Runtime strings (StringPool::allocate); interned strings live until shutdown
  * 
  * Key Functions:
  * - markRoots(): Identifies all reachable objects from VM state
@@ -20,11 +25,25 @@
  * - markValue(): Determines object type and marks accordingly
  * - traceReferences(): Processes gray stack to find all transitive references
  * - blackenObject(): Exposes references within an object for tracing
- * - sweep(): Reclaims unmarked objects and resets marks for next cycle
- * - runGC(): Orchestrates the complete GC cycle with threshold management
- * - checkGC(): Triggers collection when allocation exceeds threshold
+ * - gcWork(): One bounded slice of mark or sweep work; the sweep walks the
+ *   per-type slab pools one slab at a time, freeing used & ~marked slots
+ *   straight from the side bitmaps (strings: mark != gcMark, flipped per cycle)
+ * - runGC(): Full stop-the-world collection with threshold management
+ * - checkGC(): Triggers a collection (or the next slice) when allocation exceeds threshold
+ * - gcSafePoint(): Loop back-edge check; the only place (with gcStep) that runs minors
+ * - gcStep(): Time-budgeted slice for the host's main loop
+ * - minorGC(): Generational collection of the nursery (roots + remembered set),
+ *   promoting survivors to the old generation
  */
 #include "interpreter.hpp"
+#include <chrono>
+
+static double gcNowMs()
+{
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
 
 void Interpreter::markRoots()
 {
@@ -75,6 +94,19 @@ void Interpreter::markRoots()
                             markObject((GCObject *)frame->closure);
                         }
                     }
+
+                    // Erro/returns guardados enquanto corre um finally
+                    for (int t = 0; t < fiber->tryDepth; t++)
+                    {
+                        TryHandler &handler = fiber->tryHandlers[t];
+                        if (handler.hasPendingError)
+                            markValue(handler.pendingError);
+                        if (handler.hasPendingReturn)
+                        {
+                            for (int r = 0; r < handler.pendingReturnCount; r++)
+                                markValue(handler.pendingReturns[r]);
+                        }
+                    }
                    
                 }
             }
@@ -86,79 +118,97 @@ void Interpreter::markRoots()
         markObject((GCObject *)upvalue);
         upvalue = upvalue->nextOpen;
     }
+
+    for (size_t i = 0; i < rootHooks.size(); i++)
+        rootHooks[i].marker(this, rootHooks[i].userdata);
+}
+
+void Interpreter::addGCRootMarker(GCRootMarker marker, void *userdata)
+{
+    GCRootHook hook;
+    hook.marker = marker;
+    hook.userdata = userdata;
+    rootHooks.push(hook);
+}
+
+void Interpreter::removeGCRootMarker(GCRootMarker marker, void *userdata)
+{
+    for (size_t i = 0; i < rootHooks.size(); i++)
+    {
+        if (rootHooks[i].marker == marker && rootHooks[i].userdata == userdata)
+        {
+            rootHooks[i] = rootHooks.back();
+            rootHooks.pop();
+            return;
+        }
+    }
+}
+
+void Interpreter::markRootValue(const Value &v)
+{
+    if (v.isObject())
+        markValue(v);
 }
 
 void Interpreter::markObject(GCObject *obj)
 {
-    if (obj == nullptr || obj->marked)
+    if (obj == nullptr || obj->pinned)
         return;
-    obj->marked = 1;
+    // Minor: os velhos contam como vivos e não são percorridos
+    if (minorMarking_ && !obj->young)
+        return;
+    if (SlabPool::isMarked(obj))
+        return;
+    SlabPool::setMarked(obj);
     grayStack.push(obj);
 }
 
+void Interpreter::writeBarrierSlow(const Value &v)
+{
+    markValue(v);
+}
+
 void Interpreter::markValue(const Value &v)
 {
-    if (v.isStructInstance())
+    if (v.isString())
+    {
+        // Sem filhos: não passa pela gray stack
+        v.asString()->marked = gcMark;
+    }
+    else if (v.isStructInstance())
     {
         // printValueNl(v);
-        markObject(v.as.sInstance);
+        markObject(v.asStructInstance());
     }
     else if (v.isClassInstance())
     {
-        markObject(v.as.sClass);
+        markObject(v.asClassInstance());
     }
     else if (v.isArray())
     {
         // printValueNl(v);
-        markObject(v.as.array);
+        markObject(v.asArray());
     }
     else if (v.isMap())
     {
-        markObject(v.as.map);
+        markObject(v.asMap());
     }
     else if (v.isBuffer())
     {
-        markObject(v.as.buffer);
+        markObject(v.asBuffer());
     }
     else if (v.isNativeClassInstance())
     {
-        markObject(v.as.sClassInstance);
+        markObject(v.asNativeClassInstance());
     }
     else if (v.isNativeStructInstance())
     {
-        markObject(v.as.sNativeStruct);
+        markObject(v.asNativeStructInstance());
     }
     else if (v.isClosure())
     {
-        markObject((GCObject *)v.as.closure);
-    }
-}
-
-void Interpreter::sweep()
-{
-    //  Info("GC Sweep start");
-
-    GCObject **obj = &gcObjects;
-    size_t freed = 0;
-
-    while (*obj)
-    {
-        if ((*obj)->marked == 0)
-        {
-            GCObject *unreached = *obj;
-            *obj = unreached->next;
-            freeObject(unreached);
-            freed++;
-        }
-        else
-        {
-            //  Desmarca para próximo ciclo
-            (*obj)->marked = 0;
-            obj = &(*obj)->next;
-        }
+        markObject((GCObject *)v.asClosure());
     }
-
-    //   Info("GC Sweep freed %zu objects", freed);
 }
 
 void Interpreter::freeObject(GCObject *obj)
@@ -237,16 +287,320 @@ void Interpreter::freeObject(GCObject *obj)
 
 void Interpreter::checkGC()
 {
-    if (!enbaledGC)
+    if (!enbaledGC || gcInProgress)
+        return;
+
+    if (heapBytes() <= nextGC)
         return;
 
-    if (totalAllocated > nextGC)
+    // Nursery cheia mas o heap ainda abaixo do limite do major: o minor fica
+    // para o próximo safe point (aqui o objeto acabado de criar pode ainda
+    // não estar em nenhuma root)
+    if (minorPending())
+        return;
+
+    if (!incrementalGC_)
     {
         runGC();
+        return;
     }
+
+    // Passo pago pela alocação: começa um ciclo ou avança o que está a meio
+    double start = gcNowMs();
+    gcInProgress = true;
+    if (gcPhase == GCPhase::IDLE)
+        gcBeginCycle();
+    gcWork(GC_STEP_WORK);
+    if (gcPhase != GCPhase::IDLE)
+        nextGC = heapBytes() + GC_STEP_BYTES;
+    gcInProgress = false;
+    gcRecordPause(start);
 }
 
-void Interpreter::blackenObject(GCObject *obj)
+// Safe point (back-edge dos loops): tudo o que está vivo está na stack
+void Interpreter::gcSafePoint()
+{
+    if (!enbaledGC || gcInProgress)
+        return;
+    if (minorPending())
+    {
+        minorGC();
+        return;
+    }
+    checkGC();
+}
+
+void Interpreter::gcStep(int microseconds)
+{
+    if (!enbaledGC || gcInProgress)
+        return;
+    if (minorPending())
+    {
+        minorGC();
+        return;
+    }
+    if (!incrementalGC_)
+        return;
+    if (gcPhase == GCPhase::IDLE && heapBytes() < nextMajorGC / 4 * 3)
+        return;
+
+    double start = gcNowMs();
+    double deadline = start + microseconds / 1000.0;
+    gcInProgress = true;
+    if (gcPhase == GCPhase::IDLE)
+        gcBeginCycle();
+    do
+    {
+        gcWork(GC_STEP_WORK / 16);
+    } while (gcPhase != GCPhase::IDLE && gcNowMs() < deadline);
+    if (gcPhase != GCPhase::IDLE)
+        nextGC = heapBytes() + GC_STEP_BYTES;
+    gcInProgress = false;
+    gcRecordPause(start);
+}
+
+void Interpreter::setIncrementalGC(bool enabled)
+{
+    // A meio de um ciclo termina-o já: o modo stop-the-world não tem barriers
+    if (!enabled && gcPhase != GCPhase::IDLE && !gcInProgress)
+    {
+        gcInProgress = true;
+        while (gcPhase != GCPhase::IDLE)
+            gcWork((size_t)-1);
+        gcInProgress = false;
+    }
+    incrementalGC_ = enabled;
+}
+
+void Interpreter::setGenerationalGC(bool enabled)
+{
+    if (!enabled)
+        promoteNursery();
+    generationalGC_ = enabled;
+    if (gcPhase == GCPhase::IDLE)
+        nextGC = gcIdleTrigger();
+}
+
+// Fora de um ciclo: o limite do major ou o fim da nursery, o que vier antes
+size_t Interpreter::gcIdleTrigger() const
+{
+    if (!generationalGC_)
+        return nextMajorGC;
+    size_t nursery = heapBytes() + GC_NURSERY_BYTES;
+    return nursery < nextMajorGC ? nursery : nextMajorGC;
+}
+
+// Toda a nursery passa a velha (antes de um major e ao desligar)
+void Interpreter::promoteNursery()
+{
+    for (size_t i = 0; i < youngObjects.size(); i++)
+        youngObjects[i]->young = 0;
+    youngObjects.clear();
+    totalYoung = 0;
+
+    for (size_t i = 0; i < rememberedSet.size(); i++)
+        rememberedSet[i]->remembered = 0;
+    rememberedSet.clear();
+    stringPool.promoteYoung();
+}
+
+// Minor collection (stop-the-world, mas só custa roots + remembered set +
+// young vivos). Os young nascem brancos no bitmap e os bits que ficam ligados
+// nos promovidos só são limpos no próximo major. As strings usam
+// GC_MINOR_MARK para não mexer na época do major
+void Interpreter::minorGC()
+{
+    double start = gcNowMs();
+    gcInProgress = true;
+
+    uint8 majorMark = gcMark;
+    gcMark = GC_MINOR_MARK;
+    minorMarking_ = true;
+
+    grayStack.clear();
+    markRoots();
+    for (size_t i = 0; i < rememberedSet.size(); i++)
+    {
+        GCObject *owner = rememberedSet[i];
+        owner->remembered = 0;
+        blackenObject(owner);
+    }
+    rememberedSet.clear();
+    traceReferences();
+
+    minorMarking_ = false;
+    gcMark = majorMark;
+
+    for (size_t i = 0; i < youngObjects.size(); i++)
+    {
+        GCObject *obj = youngObjects[i];
+        if (SlabPool::isMarked(obj))
+        {
+            obj->young = 0;
+            totalPromoted++;
+        }
+        else
+        {
+            freeObject(obj);
+        }
+    }
+    youngObjects.clear();
+    totalYoung = 0;
+    stringPool.sweepYoung(GC_MINOR_MARK);
+
+    minorCycles++;
+    nextGC = gcIdleTrigger();
+    gcInProgress = false;
+    gcRecordPause(start);
+}
+
+void Interpreter::gcRecordPause(double startMs)
+{
+    double us = (gcNowMs() - startMs) * 1000.0;
+    if (us > gcMaxPauseUs)
+        gcMaxPauseUs = us;
+}
+
+// Novo ciclo: bitmaps dos slabs a zero e nova época das strings, sem tocar
+// nos objetos
+void Interpreter::gcBeginCycle()
+{
+    promoteNursery();
+    for (int i = 0; i < GC_OBJECT_TYPES; i++)
+        gcPools[i].clearMarks();
+    gcMark = gcMark == 1 ? 2 : 1;
+    grayStack.clear();
+    markRoots();
+    gcPhase = GCPhase::MARK;
+}
+
+// Stacks, globals e privates não têm barriers: volta a marcá-los de uma vez
+// e acaba o trace antes de passar ao sweep
+void Interpreter::gcRemark()
+{
+    markRoots();
+    traceReferences();
+
+    gcPhase = GCPhase::SWEEP;
+    gcSweepStartMs = gcNowMs();
+    sweepPool = 0;
+    sweepCursor = gcPools[0].firstSlab();
+    stringPool.beginSweep(gcMark);
+    stringPool.setAllocMark(gcMark);
+}
+
+void Interpreter::gcFinishCycle()
+{
+    gcPhase = GCPhase::IDLE;
+    sweepPool = 0;
+    sweepCursor = nullptr;
+    stringPool.setAllocMark(0);
+    gcCycles++;
+    gcLastSweepUs = (gcNowMs() - gcSweepStartMs) * 1000.0;
+
+    nextMajorGC = static_cast<size_t>(heapBytes() * GC_GROWTH_FACTOR);
+    if (nextMajorGC < MIN_GC_THRESHOLD)
+    {
+        nextMajorGC = MIN_GC_THRESHOLD;
+    }
+    if (nextMajorGC > MAX_GC_THRESHOLD)
+    {
+        nextMajorGC = MAX_GC_THRESHOLD;
+    }
+    stringPool.promoteYoung();
+    nextGC = gcIdleTrigger();
+}
+
+// Liberta os slots ocupados e não marcados de um slab. Uma instância por
+// tipo: o free de cada objeto é direto, sem o switch do freeObject
+template <typename T, void (Interpreter::*Release)(T *)>
+size_t Interpreter::sweepSlabOf(Slab *slab)
+{
+    size_t words = (slab->slotCount + 63) / 64;
+    size_t freed = 0;
+    for (size_t w = 0; w < words; w++)
+    {
+        uint64_t dead = slab->used[w] & ~slab->marks[w];
+        while (dead)
+        {
+            size_t index = w * 64 + slabLowestBit(dead);
+            dead &= dead - 1;
+            (this->*Release)(reinterpret_cast<T *>(slab->slots + index * slab->slotSize));
+            freed++;
+        }
+    }
+    return words + freed;
+}
+
+size_t Interpreter::sweepSlab(int pool, Slab *slab)
+{
+    switch ((GCObjectType)pool)
+    {
+    case GCObjectType::STRUCT:
+        return sweepSlabOf<StructInstance, &Interpreter::freeStruct>(slab);
+    case GCObjectType::CLASS:
+        return sweepSlabOf<ClassInstance, &Interpreter::freeClass>(slab);
+    case GCObjectType::ARRAY:
+        return sweepSlabOf<ArrayInstance, &Interpreter::freeArray>(slab);
+    case GCObjectType::MAP:
+        return sweepSlabOf<MapInstance, &Interpreter::freeMap>(slab);
+    case GCObjectType::BUFFER:
+        return sweepSlabOf<BufferInstance, &Interpreter::freeBuffer>(slab);
+    case GCObjectType::NATIVE_CLASS:
+        return sweepSlabOf<NativeClassInstance, &Interpreter::freeNativeClass>(slab);
+    case GCObjectType::NATIVE_STRUCT:
+        return sweepSlabOf<NativeStructInstance, &Interpreter::freeNativeStruct>(slab);
+    case GCObjectType::CLOSURE:
+        return sweepSlabOf<Closure, &Interpreter::freeClosure>(slab);
+    case GCObjectType::UPVALUE:
+        return sweepSlabOf<Upvalue, &Interpreter::freeUpvalue>(slab);
+    }
+    return 0;
+}
+
+// Uma fatia de trabalho: objetos blackened + valores visitados no mark,
+// palavras de bitmap + objetos libertados no sweep (um slab inteiro de cada
+// vez), strings visitadas. Devolve o trabalho feito
+size_t Interpreter::gcWork(size_t budget)
+{
+    size_t done = 0;
+    while (done < budget && gcPhase != GCPhase::IDLE)
+    {
+        if (gcPhase == GCPhase::MARK)
+        {
+            if (grayStack.empty())
+            {
+                gcRemark();
+                continue;
+            }
+            GCObject *obj = grayStack.back();
+            grayStack.pop();
+            done += 1 + blackenObject(obj);
+        }
+        else
+        {
+            while (done < budget && sweepPool < GC_OBJECT_TYPES)
+            {
+                if (!sweepCursor)
+                {
+                    if (++sweepPool < GC_OBJECT_TYPES)
+                        sweepCursor = gcPools[sweepPool].firstSlab();
+                    continue;
+                }
+                Slab *slab = sweepCursor;
+                sweepCursor = slab->next;
+                done += sweepSlab(sweepPool, slab);
+            }
+            if (done < budget)
+                done += stringPool.sweepStep(budget - done);
+            if (sweepPool >= GC_OBJECT_TYPES && !stringPool.isSweeping())
+                gcFinishCycle();
+        }
+    }
+    return done;
+}
+
+size_t Interpreter::blackenObject(GCObject *obj)
 {
     switch (obj->type)
     {
@@ -259,7 +613,7 @@ void Interpreter::blackenObject(GCObject *obj)
                 continue;
             markValue(s->values[i]);
         }
-        break;
+        return s->values.size();
     }
 
     case GCObjectType::CLASS:
@@ -271,7 +625,7 @@ void Interpreter::blackenObject(GCObject *obj)
                 continue;
             markValue(c->fields[i]);
         }
-        break;
+        return c->fields.size();
     }
 
     case GCObjectType::ARRAY:
@@ -283,18 +637,21 @@ void Interpreter::blackenObject(GCObject *obj)
                 continue;
             markValue(a->values[i]);
         }
-        break;
+        return a->values.size();
     }
 
     case GCObjectType::MAP:
     {
         MapInstance *m = static_cast<MapInstance *>(obj);
-        // Marcamos apenas os VALORES. As chaves (Strings) são ignoradas como pediste.
-        m->table.forEach([this](String *key, Value val)
+        size_t count = 0;
+        // Chaves criadas em runtime ("k" + i) também são strings do GC
+        m->table.forEach([this, &count](String *key, Value val)
                          { 
+                            key->marked = gcMark;
+                            count++;
                             if(val.isObject())
                                 markValue(val); });
-        break;
+        return count;
     }
 
     case GCObjectType::CLOSURE:
@@ -305,7 +662,7 @@ void Interpreter::blackenObject(GCObject *obj)
         {
             markObject((GCObject *)c->upvalues[i]);
         }
-        break;
+        return c->upvalues.size();
     }
     case GCObjectType::UPVALUE:
     {
@@ -324,6 +681,7 @@ void Interpreter::blackenObject(GCObject *obj)
     case GCObjectType::NATIVE_STRUCT:
         break;
     }
+    return 0;
 }
 
 void Interpreter::traceReferences()
@@ -344,70 +702,51 @@ void Interpreter::runGC()
     if (gcInProgress)
         return;
     gcInProgress = true;
+    double start = gcNowMs();
 
-    size_t bytesBefore = totalAllocated;
-    size_t objectsBefore = totalArrays + totalClasses + totalStructs + totalMaps + totalBuffers + totalNativeClasses + totalNativeStructs + totalClosures + totalUpvalues;
-
-    grayStack.clear();
-
-    markRoots();
-
-    traceReferences();
-
-    sweep();
-
-    size_t objectCount = totalArrays + totalClasses + totalStructs + totalMaps + totalBuffers + totalNativeClasses + totalNativeStructs + totalClosures + totalUpvalues;
-
-    size_t bytesFreed = bytesBefore - totalAllocated;
-    size_t objectsFreed = objectsBefore - objectCount;
+    // Um ciclo incremental a meio acaba primeiro (o que nasceu durante o
+    // sweep dele ainda conta como vivo); depois um ciclo completo
+    while (gcPhase != GCPhase::IDLE)
+        gcWork((size_t)-1);
 
-    nextGC = static_cast<size_t>(totalAllocated * GC_GROWTH_FACTOR);
-    if (nextGC < MIN_GC_THRESHOLD)
-    {
-        nextGC = MIN_GC_THRESHOLD;
-    }
-    if (nextGC > MAX_GC_THRESHOLD)
-    {
-        nextGC = MAX_GC_THRESHOLD;
-    }
+    gcBeginCycle();
+    while (gcPhase != GCPhase::IDLE)
+        gcWork((size_t)-1);
 
-    // Info("GC: End - Freed %zu objects (%.2f KB). Remaining: %zu objects (%.2f KB). Next GC: %.2f KB",
-    //          objectsFreed, bytesFreed / 1024.0,
-    //          objectCount, totalAllocated / 1024.0,
-    //          nextGC / 1024.0);
+    // Info("GC: End - Remaining: %zu objects (%.2f KB). Next GC: %.2f KB",
+    //          countObjects(), heapBytes() / 1024.0, nextGC / 1024.0);
 
     gcInProgress = false;
-
-    // gcInProgress = false;
+    gcRecordPause(start);
 }
 
 size_t Interpreter::countObjects() const
 {
     size_t count = 0;
-    GCObject *obj = gcObjects;
-    while (obj)
-    {
-        count++;
-        obj = obj->next;
-    }
+    for (int i = 0; i < GC_OBJECT_TYPES; i++)
+        count += gcPools[i].liveCount();
     return count;
 }
 
 void Interpreter::clearAllGCObjects()
 {
 
-    if (!gcObjects)
-        return;
+    gcPhase = GCPhase::IDLE;
+    sweepPool = 0;
+    sweepCursor = nullptr;
+    grayStack.clear();
+    promoteNursery();
 
-    size_t freed = 0;
+    size_t freed = countObjects();
+    if (freed == 0)
+        return;
 
-    while (gcObjects)
+    // Sem marcas, um sweep de cada slab liberta tudo
+    for (int i = 0; i < GC_OBJECT_TYPES; i++)
     {
-        GCObject *toFree = gcObjects;
-        gcObjects = gcObjects->next;
-
-        freeObject(toFree);
-        freed++;
+        gcPools[i].clearMarks();
+        for (Slab *slab = gcPools[i].firstSlab(); slab; slab = slab->next)
+            sweepSlab(i, slab);
     }
 
     Info("Arena cleared (%zu objects freed)", freed);
@@ -11,6 +11,16 @@ Interpreter::Interpreter()
   debugMode_ = false;
   hasFatalError_ = false;
 
+  gcPools[(int)GCObjectType::STRUCT].init(sizeof(StructInstance));
+  gcPools[(int)GCObjectType::CLASS].init(sizeof(ClassInstance));
+  gcPools[(int)GCObjectType::ARRAY].init(sizeof(ArrayInstance));
+  gcPools[(int)GCObjectType::MAP].init(sizeof(MapInstance));
+  gcPools[(int)GCObjectType::BUFFER].init(sizeof(BufferInstance));
+  gcPools[(int)GCObjectType::NATIVE_CLASS].init(sizeof(NativeClassInstance));
+  gcPools[(int)GCObjectType::NATIVE_STRUCT].init(sizeof(NativeStructInstance));
+  gcPools[(int)GCObjectType::CLOSURE].init(sizeof(Closure));
+  gcPools[(int)GCObjectType::UPVALUE].init(sizeof(Upvalue));
+
   setPrivateTable();
   staticNames.resize((int)StaticNames::TOTAL_COUNT);
   staticNames[(int)StaticNames::PUSH] = createString("push");
@@ -88,6 +98,80 @@ Interpreter::Interpreter()
   // globals.set(createString("TYPE_DOUBLE"), makeInt(6));
 }
 
+int Interpreter::getStaticNameId(String *name) const
+{
+  // Strings são internadas: comparar ponteiros chega
+  for (size_t i = 0; i < staticNames.size(); i++)
+  {
+    if (staticNames[i] == name)
+      return (int)i;
+  }
+  return -1;
+}
+
+void Interpreter::setSuperinstructions(bool enabled)
+{
+  CompilerOptions opts = compiler->getOptions();
+  opts.superinstructions = enabled;
+  compiler->setOptions(opts);
+}
+
+void Interpreter::setDirectCalls(bool enabled)
+{
+  CompilerOptions opts = compiler->getOptions();
+  opts.directCalls = enabled;
+  compiler->setOptions(opts);
+}
+
+void Interpreter::setConstantFolding(bool enabled)
+{
+  CompilerOptions opts = compiler->getOptions();
+  opts.constantFolding = enabled;
+  compiler->setOptions(opts);
+}
+
+void Interpreter::setPeephole(bool enabled)
+{
+  CompilerOptions opts = compiler->getOptions();
+  opts.peephole = enabled;
+  compiler->setOptions(opts);
+}
+
+void Interpreter::setWarnUnused(bool enabled)
+{
+  CompilerOptions opts = compiler->getOptions();
+  opts.warnUnused = enabled;
+  compiler->setOptions(opts);
+}
+
+void Interpreter::setInlining(bool enabled)
+{
+  CompilerOptions opts = compiler->getOptions();
+  opts.inlining = enabled;
+  compiler->setOptions(opts);
+}
+
+void Interpreter::setInlineLimit(int maxBytes)
+{
+  CompilerOptions opts = compiler->getOptions();
+  opts.inlineMaxBytes = maxBytes;
+  compiler->setOptions(opts);
+}
+
+void Interpreter::setSwitchTables(bool enabled)
+{
+  CompilerOptions opts = compiler->getOptions();
+  opts.switchTables = enabled;
+  compiler->setOptions(opts);
+}
+
+void Interpreter::setCompileThreads(int threads)
+{
+  CompilerOptions opts = compiler->getOptions();
+  opts.compileThreads = threads;
+  compiler->setOptions(opts);
+}
+
 void Interpreter::freeInstances()
 {
 }
@@ -205,8 +289,8 @@ void Interpreter::reset()
   structsMap.destroy();
 
   clearAllGCObjects();
+  stringPool.clearRuntime();
 
-  gcObjects = nullptr;
   totalAllocated = 0;
   totalArrays = 0;
   totalStructs = 0;
@@ -215,7 +299,12 @@ void Interpreter::reset()
   totalNativeClasses = 0;
   totalNativeStructs = 0;
   nextGC = 1024 * 4;
+  nextMajorGC = 1024 * 4;
   gcInProgress = false;
+  propertyCacheHits = 0;
+  propertyCacheMisses = 0;
+  registerTierPromotions = 0;
+  registerTierDeopts = 0;
 
   frameCount = 0;
 
@@ -253,6 +342,11 @@ Interpreter::~Interpreter()
   Info("Buffers          : %zu", totalBuffers);
   Info("Processes        : %zu", aliveProcesses.size());
   Info("Globals          : %zu", globalsArray.size());
+  Info("Property IC      : %zu hits / %zu misses", propertyCacheHits, propertyCacheMisses);
+  Info("Register tier    : %zu functions / %zu deopts", registerTierPromotions, registerTierDeopts);
+  Info("GC               : %zu cycles / max pause %.3f ms (%s)", gcCycles, gcMaxPauseUs / 1000.0,
+       incrementalGC_ ? "incremental" : "stop-the-world");
+  Info("Nursery          : %zu minors / %zu promoted / %zu young", minorCycles, totalPromoted, totalYoung);
   
   unloadAllPlugins();
   for (size_t i = 0; i < modules.size(); i++)
@@ -283,13 +377,10 @@ BufferInstance *Interpreter::createBuffer(int count, int typeRaw)
 {
   checkGC();
   size_t size = sizeof(BufferInstance);
-  void *mem = (BufferInstance *)arena.Allocate(size);
+  void *mem = allocGCObject(GCObjectType::BUFFER);
 
   BufferInstance *instance = new (mem) BufferInstance(count, (BufferType)typeRaw);
-  instance->marked = 0;
-
-  instance->next = gcObjects;
-  gcObjects = instance;
+  linkGCObject(instance);
   totalBuffers++;
 
   totalAllocated += size;
@@ -304,7 +395,7 @@ void Interpreter::freeBuffer(BufferInstance *b)
   size_t dataSize = b->count * b->elementSize;
 
   b->~BufferInstance();
-  arena.Free(b, size);
+  releaseGCObject(GCObjectType::BUFFER, b);
 
   totalBuffers--;
 
@@ -554,7 +645,7 @@ int Interpreter::addGlobal(const char *name, Value value)
     // Já existe: só atualiza o valor
     if (index >= globalsArray.size())
     {
-      globalsArray.resize(index + 1);
+      growGlobals(index + 1);
     }
     if (globalsArray[index].isNative() || globalsArray[index].isNativeProcess() ||
         globalsArray[index].isNativeClass() || globalsArray[index].isNativeStruct())
@@ -604,7 +695,7 @@ bool Interpreter::setGlobal(const char *name, Value value)
 
   if (index >= globalsArray.size())
   {
-    globalsArray.resize(index + 1);
+    growGlobals(index + 1);
   }
 
   if (globalsArray[index].isNative() || globalsArray[index].isNativeProcess() ||
@@ -878,7 +969,7 @@ Function *Interpreter::compile(const char *source)
 
   if (globalsArray.size() < globalIndexToName_.size())
   {
-    globalsArray.resize(globalIndexToName_.size());
+    growGlobals(globalIndexToName_.size());
   }
   
   Function *mainFunc = proc->fibers[0].frames[0].func;
@@ -901,7 +992,7 @@ Function *Interpreter::compileExpression(const char *source)
 
   if (globalsArray.size() < globalIndexToName_.size())
   {
-    globalsArray.resize(globalIndexToName_.size());
+    growGlobals(globalIndexToName_.size());
   }
   
   Function *mainFunc = proc->fibers[0].frames[0].func;
@@ -910,27 +1001,43 @@ Function *Interpreter::compileExpression(const char *source)
 
 bool Interpreter::run(const char *source, bool _dump)
 {
-  reset();
+  ProcessDef *proc = nullptr;
 
-  ProcessDef *proc = compiler->compile(source);
-  if (!proc)
+  // .buc válido: salta lexer/compiler (o main process é sempre o último)
+  if (bytecodeCachePath_[0] && loadBytecode(bytecodeCachePath_, source))
   {
-    return false;
+    proc = processes[processes.size() - 1];
   }
-  
-  // Copy global name mapping for debug messages
-  const auto& compilerMapping = compiler->getGlobalIndexToName();
-  globalIndexToName_.clear();
-  globalIndexToName_.reserve(compilerMapping.size());
-  for (const auto& name : compilerMapping)
+  else
   {
-    String* str = createString(name.c_str());
-    globalIndexToName_.push(str);
-  }
+    reset();
 
-  if (globalsArray.size() < globalIndexToName_.size())
-  {
-    globalsArray.resize(globalIndexToName_.size());
+    proc = compiler->compile(source);
+    if (!proc)
+    {
+      return false;
+    }
+
+    // Copy global name mapping for debug messages
+    const auto& compilerMapping = compiler->getGlobalIndexToName();
+    globalIndexToName_.clear();
+    globalIndexToName_.reserve(compilerMapping.size());
+    for (const auto& name : compilerMapping)
+    {
+      String* str = createString(name.c_str());
+      globalIndexToName_.push(str);
+    }
+
+    if (globalsArray.size() < globalIndexToName_.size())
+    {
+      growGlobals(globalIndexToName_.size());
+    }
+
+    // Antes de correr: o quickening reescreve o bytecode
+    if (bytecodeCachePath_[0])
+    {
+      saveBytecode(bytecodeCachePath_, source);
+    }
   }
 
   if (_dump)
@@ -973,7 +1080,7 @@ bool Interpreter::compile(const char *source, bool dump)
 
   if (globalsArray.size() < globalIndexToName_.size())
   {
-    globalsArray.resize(globalIndexToName_.size());
+    growGlobals(globalIndexToName_.size());
   }
 
   if (dump)
@@ -1088,6 +1195,16 @@ String *Interpreter::createString(const char *str)
   return stringPool.create(str);
 }
 
+String *Interpreter::createRuntimeString(const char *str, uint32 len)
+{
+  return stringPool.allocate(str, len);
+}
+
+String *Interpreter::createRuntimeString(const char *str)
+{
+  return stringPool.allocate(str, (uint32)std::strlen(str));
+}
+
 bool Interpreter::containsClassDefenition(String *name)
 {
   return classesMap.exist(name);
@@ -1138,6 +1255,7 @@ Value Interpreter::createClassInstance(ClassDef *klass, int argCount, Value *arg
   Value value = makeClassInstance();
   ClassInstance *instance = value.asClassInstance();
   instance->klass = klass;
+  instance->shape = getClassShape(klass);
   instance->fields.reserve(klass->fieldCount);
 
   // Inicializa fields com valores default ou nil
@@ -1154,17 +1272,7 @@ Value Interpreter::createClassInstance(ClassDef *klass, int argCount, Value *arg
   }
 
   // Se herda de NativeClass, cria os dados nativos
-  NativeClassDef *nativeDef = nullptr;
-  ClassDef *current = klass;
-  while (current)
-  {
-    if (current->nativeSuperclass)
-    {
-      nativeDef = current->nativeSuperclass;
-      break;
-    }
-    current = current->superclass;
-  }
+  NativeClassDef *nativeDef = instance->shape->nativeBase;
 
   if (nativeDef)
   {
@@ -1253,6 +1361,7 @@ Value Interpreter::createClassInstanceRaw(ClassDef *klass)
   Value value = makeClassInstance();
   ClassInstance *instance = value.asClassInstance();
   instance->klass = klass;
+  instance->shape = getClassShape(klass);
   instance->fields.reserve(klass->fieldCount);
 
   for (int i = 0; i < klass->fieldCount; i++)
@@ -1268,17 +1377,7 @@ Value Interpreter::createClassInstanceRaw(ClassDef *klass)
   }
 
   // Se herda de NativeClass, cria os dados nativos
-  NativeClassDef *nativeDef = nullptr;
-  ClassDef *current = klass;
-  while (current)
-  {
-    if (current->nativeSuperclass)
-    {
-      nativeDef = current->nativeSuperclass;
-      break;
-    }
-    current = current->superclass;
-  }
+  NativeClassDef *nativeDef = instance->shape->nativeBase;
 
   if (nativeDef)
   {
@@ -1459,9 +1558,68 @@ ClassDef::~ClassDef()
 {
   fieldNames.destroy();
   methods.destroy();
+  if (ownsShape)
+    delete shape;
+  shape = nullptr;
   superclass = nullptr;
 }
 
+// Mesmos fields nos mesmos slots que a superclass (só acrescenta métodos)
+static bool sameFieldLayout(ClassDef *klass, ClassDef *super)
+{
+  if (klass->fieldCount != super->fieldCount || klass->fieldNames.count != super->fieldNames.count)
+    return false;
+  bool same = true;
+  klass->fieldNames.forEachWhile([&](String *name, uint8 index)
+                                 {
+    uint8 superIndex;
+    same = super->fieldNames.get(name, &superIndex) && superIndex == index;
+    return same; });
+  return same;
+}
+
+ClassShape *Interpreter::buildClassShape(ClassDef *klass)
+{
+  NativeClassDef *nativeBase = nullptr;
+  for (ClassDef *current = klass; current && !nativeBase; current = current->superclass)
+    nativeBase = current->nativeSuperclass;
+
+  ClassDef *super = klass->superclass;
+  if (super && sameFieldLayout(klass, super))
+  {
+    ClassShape *parentShape = getClassShape(super);
+    if (parentShape->nativeBase == nativeBase)
+    {
+      klass->shape = parentShape;
+      klass->ownsShape = false;
+      return parentShape;
+    }
+  }
+
+  ClassShape *shape = new ClassShape();
+  shape->owner = klass;
+  shape->fieldCount = klass->fieldCount;
+  shape->nativeBase = nativeBase;
+
+  klass->fieldNames.forEach([&](String *name, uint8 index)
+                            { shape->slots.set(name, {ShapeSlotKind::FIELD, index}); });
+
+  // Fields escondem properties nativas com o mesmo nome
+  if (nativeBase)
+  {
+    nativeBase->properties.forEach([&](String *name, const NativeProperty &prop)
+                                   {
+      if (shape->slots.exist(name) || shape->nativeProps.size() > 255)
+        return;
+      shape->slots.set(name, {ShapeSlotKind::NATIVE, (uint8)shape->nativeProps.size()});
+      shape->nativeProps.push(prop); });
+  }
+
+  klass->shape = shape;
+  klass->ownsShape = true;
+  return shape;
+}
+
 NativeClassDef::~NativeClassDef()
 {
   methods.destroy();
@@ -1490,6 +1648,14 @@ void Interpreter::dumpToFile(const char *filename)
   // Dump classes e métodos
   dumpAllClasses(f);
 
+  // Chamadas diretas: inlined ou porque não
+  dumpInlining(f);
+
+#if USE_OPCODE_PROFILE
+  fprintf(f, "\n");
+  Debug::dumpOpcodeProfile(f, 32);
+#endif
+
   fprintf(f, "\n========================================\n");
   fprintf(f, "END OF DUMP\n");
   fprintf(f, "========================================\n");
@@ -1530,23 +1696,23 @@ void Interpreter::dumpAllFunctions(FILE *f)
                 fprintf(f, "%s", v.asBool() ? "true" : "false");
             } else if (v.isNil()) {
                 fprintf(f, "nil");
-            } else if (v.type == ValueType::CLASS) {
+            } else if (v.getType() == ValueType::CLASS) {
                 int classId = v.asClassId();
                 if (classId < (int)classes.size() && classes[classId]) {
                     fprintf(f, "<class '%s'>", classes[classId]->name->chars());
                 } else {
                     fprintf(f, "<class %d>", classId);
                 }
-            } else if (v.type == ValueType::FUNCTION) {
+            } else if (v.getType() == ValueType::FUNCTION) {
                 fprintf(f, "<function %d>", v.asFunctionId());
-            } else if (v.type == ValueType::MODULEREFERENCE) {
-                uint32_t packed = v.as.unsignedInteger;
+            } else if (v.getType() == ValueType::MODULEREFERENCE) {
+                uint32_t packed = v.asModuleRef();
                 fprintf(f, "<module_reference %d %d %d>", 
                     packed >> 24, (packed >> 12) & 0xFFF, packed & 0xFFF);
-            } else if (v.type == ValueType::STRUCT) {
+            } else if (v.getType() == ValueType::STRUCT) {
                 fprintf(f, "<struct %d>", v.asStructId());
             } else {
-                fprintf(f, "<value type %d>", (int)v.type);
+                fprintf(f, "<value type %d>", (int)v.getType());
             }
             fprintf(f, "\n");
         }
@@ -1568,6 +1734,32 @@ void Interpreter::dumpAllFunctions(FILE *f)
 #endif
 }
 
+void Interpreter::dumpInlining(FILE *f)
+{
+#ifdef __linux__
+  const std::vector<Compiler::InlineDecision> &decisions = compiler->getInlineDecisions();
+  fprintf(f, "\n========================================\n");
+  fprintf(f, "INLINING\n");
+  fprintf(f, "========================================\n\n");
+
+  size_t inlined = 0;
+  for (const Compiler::InlineDecision &d : decisions)
+  {
+    if (d.reason.empty())
+    {
+      inlined++;
+      fprintf(f, "  [line %d] %s -> %s: inlined (%d bytes)\n",
+              d.line, d.caller.c_str(), d.callee.c_str(), d.bytes);
+    }
+    else
+      fprintf(f, "  [line %d] %s -> %s: not inlined, %s (%d bytes)\n",
+              d.line, d.caller.c_str(), d.callee.c_str(), d.reason.c_str(), d.bytes);
+  }
+  fprintf(f, "\n  %zu of %zu direct calls inlined (limit %d bytes)\n",
+          inlined, decisions.size(), compiler->getOptions().inlineMaxBytes);
+#endif
+}
+
 void Interpreter::dumpAllClasses(FILE *f)
 {
 #ifdef __linux__
@@ -1717,7 +1909,7 @@ Upvalue::Upvalue(Value *loc) : GCObject(GCObjectType::UPVALUE)
 {
   location = loc;
   nextOpen = nullptr;
-  closed.type = ValueType::NIL;
+  closed = Value();
 }
 
 // ============================================
@@ -0,0 +1,396 @@
+/**
+ * @file interpreter_register.cpp
+ * @brief Register tier: dispatch loop for hot functions
+ *
+ * Functions called REGISTER_TIER_THRESHOLD times through OP_CALL are
+ * translated to the three-address format in regcode.hpp. Registers are the
+ * frame slots themselves, so every exit simply resumes the stack VM at the
+ * original bytecode:
+ * - ROP_RET hands the result to the original OP_RETURN
+ * - ROP_CALL runs natives inline; script calls go through the stack VM and
+ *   the caller comes back here when the callee returns (RegCode::resumes)
+ * - guards that fail (non-numeric operands, division by zero, ...) deopt
+ *   and the stack VM runs the generic opcode, errors included
+ * - backward ROP_JMP (OP_LOOP) is a GC safe point, as in the stack VM
+ *
+ * @note Disabled with Interpreter::setRegisterTier(false) for debugging
+ */
+#include "interpreter.hpp"
+#include "regcode.hpp"
+#include "opcode.hpp"
+#include <cmath>
+
+void Interpreter::promoteToRegisterTier(Function *func)
+{
+    func->regCode = RegCode::translate(func);
+    if (func->regCode)
+        registerTierPromotions++;
+    else
+        func->regTierFailed = true;
+}
+
+uint8 *Interpreter::resumeRegisterTier(Fiber *fiber, CallFrame *frame, uint8 *ip)
+{
+    RegCode *rc = frame->func->regCode;
+    if (rc->disabled)
+        return ip;
+
+    uint32 offset = (uint32)(ip - frame->func->chunk->code);
+    uint32 pc = rc->findResume(offset, (uint16)(fiber->stackTop - frame->slots));
+    if (pc == REG_NO_RESUME)
+        return ip;
+
+    return runRegisterTier(fiber, frame, pc);
+}
+
+uint8 *Interpreter::runRegisterTier(Fiber *fiber, CallFrame *frame, uint32 pc)
+{
+    Function *func = frame->func;
+    RegCode *rc = func->regCode;
+    uint8 *bytecode = func->chunk->code;
+
+    if (rc->disabled || frame->slots + rc->frameSize > fiber->stack + STACK_MAX)
+        return pc == 0 ? bytecode : frame->ip;
+
+    const RegInstr *code = rc->code.data();
+    const RegInstr *ip = code + pc;
+    const Value *K = rc->constants.data();
+    Value *R = frame->slots;
+
+#define RK(x) (REG_IS_K(x) ? K[(x) & ~REG_K] : R[x])
+#define NUM(v) ((v).isInt() ? (double)(v).rawInt() : (v).rawDouble())
+#define IS_NUM(v) ((v).isInt() || (v).isDouble())
+#define DEOPT() goto deopt
+
+// int/int fica int, o resto com números passa a double
+#define REG_ARITH(OPER)                                             \
+    Value a = RK(in.b);                                             \
+    Value b = RK(in.c);                                             \
+    if (a.isInt() && b.isInt())                                     \
+        R[in.a] = makeInt(a.rawInt() OPER b.rawInt());              \
+    else if (a.isDouble() && b.isDouble())                          \
+        R[in.a] = makeDouble(a.rawDouble() OPER b.rawDouble());     \
+    else if (IS_NUM(a) && IS_NUM(b))                                \
+        R[in.a] = makeDouble(NUM(a) OPER NUM(b));                   \
+    else                                                            \
+        DEOPT()
+
+#define REG_COMPARE(OPER)                                           \
+    Value a = RK(in.b);                                             \
+    Value b = RK(in.c);                                             \
+    bool result;                                                    \
+    if (a.isInt() && b.isInt())                                     \
+        result = a.rawInt() OPER b.rawInt();                        \
+    else if (IS_NUM(a) && IS_NUM(b))                                \
+        result = NUM(a) OPER NUM(b);                                \
+    else                                                            \
+        DEOPT()
+
+    for (;;)
+    {
+        const RegInstr &in = *ip++;
+
+        switch (in.op)
+        {
+        case ROP_MOVE:
+            R[in.a] = RK(in.b);
+            break;
+
+        case ROP_GETG:
+            R[in.a] = globalsArray[in.b];
+            break;
+
+        case ROP_SETG:
+            globalsArray[in.a] = RK(in.b);
+            break;
+
+        case ROP_ADD:
+        {
+            REG_ARITH(+);
+            break;
+        }
+        case ROP_SUB:
+        {
+            REG_ARITH(-);
+            break;
+        }
+        case ROP_MUL:
+        {
+            REG_ARITH(*);
+            break;
+        }
+
+        case ROP_DIV:
+        {
+            Value a = RK(in.b);
+            Value b = RK(in.c);
+            if (a.isInt() && b.isInt())
+            {
+                int ia = a.asInt(), ib = b.asInt();
+                if (ib == 0)
+                    DEOPT();
+                R[in.a] = (ia % ib == 0) ? makeInt(ia / ib) : makeDouble((double)ia / ib);
+            }
+            else if (a.isInt() && b.isDouble())
+            {
+                int ia = a.asInt();
+                double db = b.asDouble();
+                if (db == 0.0)
+                    DEOPT();
+                R[in.a] = (fmod(ia, db) == 0) ? makeInt(ia / db) : makeDouble((double)ia / db);
+            }
+            else if (a.isDouble() && IS_NUM(b))
+            {
+                double db = NUM(b);
+                if (db == 0.0)
+                    DEOPT();
+                R[in.a] = makeDouble(a.asDouble() / db);
+            }
+            else
+                DEOPT();
+            break;
+        }
+
+        case ROP_MOD:
+        {
+            Value a = RK(in.b);
+            Value b = RK(in.c);
+            if (a.isInt() && b.isInt())
+            {
+                if (b.asInt() == 0)
+                    DEOPT();
+                R[in.a] = makeInt(a.asInt() % b.asInt());
+            }
+            else if (IS_NUM(a) && IS_NUM(b))
+            {
+                double db = NUM(b);
+                if (db == 0.0)
+                    DEOPT();
+                R[in.a] = makeDouble(fmod(NUM(a), db));
+            }
+            else
+                DEOPT();
+            break;
+        }
+
+        case ROP_NEG:
+        {
+            Value v = RK(in.b);
+            if (v.isInt())
+                R[in.a] = makeInt(-v.asInt());
+            else if (v.isDouble())
+                R[in.a] = makeDouble(-v.asDouble());
+            else
+                DEOPT();
+            break;
+        }
+
+        case ROP_NOT:
+            R[in.a] = makeBool(!isTruthy(RK(in.b)));
+            break;
+
+        case ROP_EQ:
+            R[in.a] = makeBool(valuesEqual(RK(in.b), RK(in.c)) != (bool)in.flag);
+            break;
+        case ROP_NE:
+            R[in.a] = makeBool(!valuesEqual(RK(in.b), RK(in.c)) != (bool)in.flag);
+            break;
+
+        case ROP_LT:
+        {
+            REG_COMPARE(<);
+            R[in.a] = makeBool(result != (bool)in.flag);
+            break;
+        }
+        case ROP_LE:
+        {
+            REG_COMPARE(<=);
+            R[in.a] = makeBool(result != (bool)in.flag);
+            break;
+        }
+        case ROP_GT:
+        {
+            REG_COMPARE(>);
+            R[in.a] = makeBool(result != (bool)in.flag);
+            break;
+        }
+        case ROP_GE:
+        {
+            REG_COMPARE(>=);
+            R[in.a] = makeBool(result != (bool)in.flag);
+            break;
+        }
+
+        case ROP_JLT:
+        {
+            REG_COMPARE(<);
+            if (result == (bool)in.flag)
+                ip = code + in.a;
+            break;
+        }
+        case ROP_JLE:
+        {
+            REG_COMPARE(<=);
+            if (result == (bool)in.flag)
+                ip = code + in.a;
+            break;
+        }
+        case ROP_JGT:
+        {
+            REG_COMPARE(>);
+            if (result == (bool)in.flag)
+                ip = code + in.a;
+            break;
+        }
+        case ROP_JGE:
+        {
+            REG_COMPARE(>=);
+            if (result == (bool)in.flag)
+                ip = code + in.a;
+            break;
+        }
+
+        case ROP_JEQ:
+            if (valuesEqual(RK(in.b), RK(in.c)) == (bool)in.flag)
+                ip = code + in.a;
+            break;
+        case ROP_JNE:
+            if (!valuesEqual(RK(in.b), RK(in.c)) == (bool)in.flag)
+                ip = code + in.a;
+            break;
+
+        case ROP_JMP:
+            ip = code + in.a;
+            // Back-edge (OP_LOOP): o mesmo safe point da stack VM. O jumpTo
+            // materializou tudo, os vivos são R[0..depth)
+            if (ip <= &in && gcPending())
+            {
+                fiber->stackTop = R + rc->deopts[(size_t)(&in - code)].depth;
+                gcSafePoint();
+            }
+            break;
+
+        case ROP_JMPF:
+            if (isFalsey(RK(in.b)))
+                ip = code + in.a;
+            break;
+
+        case ROP_MATH1:
+        {
+            Value v = RK(in.b);
+            if (!IS_NUM(v))
+                DEOPT();
+            double d = NUM(v);
+            switch (in.flag)
+            {
+            case OP_SIN: R[in.a] = makeDouble(std::sin(d)); break;
+            case OP_COS: R[in.a] = makeDouble(std::cos(d)); break;
+            case OP_TAN: R[in.a] = makeDouble(std::tan(d)); break;
+            case OP_ASIN: R[in.a] = makeDouble(std::asin(d)); break;
+            case OP_ACOS: R[in.a] = makeDouble(std::acos(d)); break;
+            case OP_ATAN: R[in.a] = makeDouble(std::atan(d)); break;
+            case OP_SQRT:
+                if (d < 0)
+                    DEOPT();
+                R[in.a] = makeDouble(std::sqrt(d));
+                break;
+            case OP_ABS:
+                R[in.a] = v.isInt() ? makeInt(std::abs(v.asInt())) : makeDouble(std::abs(d));
+                break;
+            case OP_LOG:
+                if (d <= 0)
+                    DEOPT();
+                R[in.a] = makeDouble(std::log(d));
+                break;
+            case OP_FLOOR: R[in.a] = makeInt((int)std::floor(d)); break;
+            case OP_CEIL: R[in.a] = makeInt((int)std::ceil(d)); break;
+            case OP_DEG: R[in.a] = makeDouble(d * 57.29577951308232); break;
+            case OP_RAD: R[in.a] = makeDouble(d * 0.017453292519943295); break;
+            default: R[in.a] = makeDouble(std::exp(d)); break;
+            }
+            break;
+        }
+
+        case ROP_MATH2:
+        {
+            Value a = RK(in.b);
+            Value b = RK(in.c);
+            if (!IS_NUM(a) || !IS_NUM(b))
+                DEOPT();
+            if (in.flag == OP_ATAN2)
+                R[in.a] = makeDouble(std::atan2(NUM(a), NUM(b)));
+            else
+                R[in.a] = makeDouble(std::pow(NUM(a), NUM(b)));
+            break;
+        }
+
+        case ROP_CALL:
+        {
+            // Tudo está no slot canónico: a stack VM pode continuar daqui
+            const RegDeopt &d = rc->deopts[(size_t)(&in - code)];
+            uint32 after = d.offset + (bytecode[d.offset] == OP_CALL_DIRECT ? 5 : 2);
+            int argc = in.flag;
+            Value callee = R[in.a];
+            fiber->stackTop = R + in.a + argc + 1;
+
+            if (!callee.isNative())
+                return bytecode + d.offset;
+
+            NativeDef &native = natives[callee.asNativeId()];
+            if (native.arity != -1 && argc != native.arity)
+                return bytecode + d.offset;
+
+            int rets = native.func(this, argc, R + in.a + 1);
+            if (rets == 1)
+                R[in.a] = fiber->stackTop[-1];
+            else if (rets == 0)
+                R[in.a] = makeNil();
+            else
+            {
+                // Multi-retorno muda a profundidade: o resto corre na stack VM
+                Value *src = fiber->stackTop - rets;
+                std::memmove(R + in.a, src, rets * sizeof(Value));
+                fiber->stackTop = R + in.a + rets;
+                rc->disabled = true;
+                return bytecode + after;
+            }
+            fiber->stackTop = R + in.a + 1;
+
+            if (hasFatalError_)
+                return bytecode + after;
+            break;
+        }
+
+        case ROP_RET:
+        {
+            const RegDeopt &d = rc->deopts[(size_t)(&in - code)];
+            R[in.a] = RK(in.b);
+            fiber->stackTop = R + in.a + 1;
+            return bytecode + d.offset;
+        }
+        }
+        continue;
+
+    deopt:
+    {
+        // Repõe a stack como a stack VM a teria antes desta instrução
+        const RegDeopt &d = rc->deopts[(size_t)(ip - 1 - code)];
+        const uint16 *pending = rc->pending.data() + d.pendingStart;
+        for (uint16 i = 0; i < d.pendingCount; i++)
+            R[pending[i * 2]] = RK(pending[i * 2 + 1]);
+        fiber->stackTop = R + d.depth;
+
+        registerTierDeopts++;
+        if (++rc->deoptCount >= REGISTER_TIER_MAX_DEOPTS)
+            rc->disabled = true;
+        return bytecode + d.offset;
+    }
+    }
+
+#undef RK
+#undef NUM
+#undef IS_NUM
+#undef DEOPT
+#undef REG_ARITH
+#undef REG_COMPARE
+}
@@ -63,7 +63,7 @@ bool toNumberPair(const Value &a, const Value &b, double &da, double &db)
 
 static const char *getValueTypeName(const Value &v)
 {
-    switch (v.type)
+    switch (v.getType())
     {
     case ValueType::NIL:
         return "nil";
@@ -126,7 +126,12 @@ static const char *getValueTypeName(const Value &v)
     }
 }
 
+#if USE_TAIL_CALLS
+// Só uma instrução: os handlers de interpreter_runtime_tail.cpp continuam
+FiberResult Interpreter::run_fiber_step(Fiber *fiber, Process *process)
+#else
 FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
+#endif
 {
 
     currentFiber = fiber;
@@ -163,7 +168,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         char msgBuffer[256];                                         \
         snprintf(msgBuffer, sizeof(msgBuffer), fmt, ##__VA_ARGS__);  \
                                                                      \
-        Value errorVal = makeString(msgBuffer);                      \
+        Value errorVal = makeRuntimeString(msgBuffer);               \
                                                                      \
         if (throwException(errorVal))                                \
         {                                                            \
@@ -317,6 +322,43 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         // Process utilities (90-91)
         &&op_proc,
         &&op_get_id,
+
+        // Builtin methods (92)
+        &&op_invoke_builtin,
+
+        // Quickened (93-102)
+        &&op_add_ii,
+        &&op_add_dd,
+        &&op_subtract_ii,
+        &&op_subtract_dd,
+        &&op_multiply_ii,
+        &&op_multiply_dd,
+        &&op_less_ii,
+        &&op_less_dd,
+        &&op_greater_ii,
+        &&op_greater_dd,
+
+        // Superinstructions (103-105)
+        &&op_inc_local,
+        &&op_inc_private,
+        &&op_cmp_local_jump,
+
+        // Chamada direta (106)
+        &&op_call_direct,
+
+        // Privates de outro processo (107-108)
+        &&op_get_proc_private,
+        &&op_set_proc_private,
+
+        // Peephole (109)
+        &&op_jump_if_true,
+
+        // Inliner (110-111)
+        &&op_pick,
+        &&op_slide,
+
+        // Switch com labels constantes (112)
+        &&op_switch_table,
     };
 
 #define SAFE_CALL_NATIVE(fiber, argCount, callFunc)                                    \
@@ -353,16 +395,100 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         }                                                                              \
     } while (0)
 
+#if USE_OPCODE_PROFILE
+#define PROFILE_OPCODE(op) Debug::profileOpcode(op)
+#else
+#define PROFILE_OPCODE(op) ((void)0)
+#endif
+
+#if USE_TAIL_CALLS
+    // Todas as entradas saem do loop; o opcode seguinte já é contado no tail
+    static const void *step_table[256];
+    if (!step_table[0])
+    {
+        for (int i = 0; i < 256; i++)
+            step_table[i] = &&op_step_exit;
+    }
+
 #define DISPATCH()                         \
     do                                     \
     {                                      \
         instructionsRun++;                 \
+        goto *step_table[*ip];             \
+    } while (0)
+#else
+#define DISPATCH()                         \
+    do                                     \
+    {                                      \
+        instructionsRun++;                 \
+        PROFILE_OPCODE(*ip);               \
         goto *dispatch_table[READ_BYTE()]; \
     } while (0)
+#endif
+
+// Quickened: guard nos dois operandos, senão volta ao opcode genérico
+#define QUICK_BINARY_OP(IS, AS, MAKE, OPER, GENERIC_OP, GENERIC_LABEL) \
+    do                                                             \
+    {                                                              \
+        Value *_top = fiber->stackTop;                             \
+        if (_top[-2].IS() && _top[-1].IS())                        \
+        {                                                          \
+            _top[-2] = MAKE(_top[-2].AS() OPER _top[-1].AS());     \
+            fiber->stackTop--;                                     \
+            DISPATCH();                                            \
+        }                                                          \
+        ip[-1] = GENERIC_OP;                                       \
+        goto GENERIC_LABEL;                                        \
+    } while (0)
+
+// Superinstructions: operando da direita (CONSTANT/GET_LOCAL/GET_PRIVATE), avança SEQ
+#define SUPER_OPERAND(SEQ, OUT)                                             \
+    do                                                                      \
+    {                                                                       \
+        if ((SEQ)[0] == OP_CONSTANT)                                        \
+        {                                                                   \
+            OUT = func->chunk->constants[(uint16)(((SEQ)[1] << 8) | (SEQ)[2])]; \
+            SEQ += 3;                                                       \
+        }                                                                   \
+        else                                                                \
+        {                                                                   \
+            OUT = ((SEQ)[0] == OP_GET_LOCAL) ? stackStart[(SEQ)[1]]         \
+                                             : process->privates[(SEQ)[1]]; \
+            SEQ += 2;                                                       \
+        }                                                                   \
+    } while (0)
+
+// O opcode aritmético/comparação original pode já ter sido quickened
+#define SUPER_IS_SUB(OP) ((OP) == OP_SUBTRACT || (OP) == OP_SUBTRACT_II || (OP) == OP_SUBTRACT_DD)
+#define SUPER_IS_LESS(OP) ((OP) == OP_LESS || (OP) == OP_LESS_II || (OP) == OP_LESS_DD)
+
+// A +/- B só para int/double; OK = false pede o fallback
+#define SUPER_ARITH(A, B, SUB, OUT, OK)                                                   \
+    do                                                                                    \
+    {                                                                                     \
+        double _da, _db;                                                                  \
+        OK = true;                                                                        \
+        if ((A).isInt() && (B).isInt())                                                   \
+            OUT = makeInt((SUB) ? (A).asInt() - (B).asInt() : (A).asInt() + (B).asInt()); \
+        else if (toNumberPair(A, B, _da, _db))                                            \
+            OUT = makeDouble((SUB) ? _da - _db : _da + _db);                              \
+        else                                                                              \
+            OK = false;                                                                   \
+    } while (0)
 
     LOAD_FRAME();
 
+#if USE_TAIL_CALLS
+    goto *dispatch_table[READ_BYTE()];
+
+op_step_exit:
+{
+    fiber->frames[fiber->frameCount - 1].ip = ip;
+    return {FiberResult::STEP, instructionsRun, 0, 0};
+}
+#else
     DISPATCH();
+#endif
 
 op_constant:
 {
@@ -474,6 +600,14 @@ op_add:
 {
     BINARY_OP_PREP();
 
+    if (quickeningEnabled_)
+    {
+        if (a.isInt() && b.isInt())
+            ip[-1] = OP_ADD_II;
+        else if (a.isDouble() && b.isDouble())
+            ip[-1] = OP_ADD_DD;
+    }
+
     // ---------------------------------------------------------
     // 1. CONCATENAÇÃO (String à Esquerda)
     // Ex: "Pontos: " + 100
@@ -594,6 +728,14 @@ op_subtract:
 {
     BINARY_OP_PREP();
 
+    if (quickeningEnabled_)
+    {
+        if (a.isInt() && b.isInt())
+            ip[-1] = OP_SUBTRACT_II;
+        else if (a.isDouble() && b.isDouble())
+            ip[-1] = OP_SUBTRACT_DD;
+    }
+
     if (a.isNumber() && b.isNumber())
     {
         if (a.isInt() && b.isInt())
@@ -640,6 +782,14 @@ op_multiply:
 {
     BINARY_OP_PREP();
 
+    if (quickeningEnabled_)
+    {
+        if (a.isInt() && b.isInt())
+            ip[-1] = OP_MULTIPLY_II;
+        else if (a.isDouble() && b.isDouble())
+            ip[-1] = OP_MULTIPLY_DD;
+    }
+
     if (a.isNumber() && b.isNumber())
     {
         if (a.isInt() && b.isInt())
@@ -850,6 +1000,14 @@ op_greater:
 {
     BINARY_OP_PREP();
 
+    if (quickeningEnabled_)
+    {
+        if (a.isInt() && b.isInt())
+            ip[-1] = OP_GREATER_II;
+        else if (a.isDouble() && b.isDouble())
+            ip[-1] = OP_GREATER_DD;
+    }
+
     double da, db;
     if (!toNumberPair(a, b, da, db))
     {
@@ -877,6 +1035,14 @@ op_less:
 {
     BINARY_OP_PREP();
 
+    if (quickeningEnabled_)
+    {
+        if (a.isInt() && b.isInt())
+            ip[-1] = OP_LESS_II;
+        else if (a.isDouble() && b.isDouble())
+            ip[-1] = OP_LESS_DD;
+    }
+
     double da, db;
     if (!toNumberPair(a, b, da, db))
     {
@@ -986,12 +1152,24 @@ op_jump_if_false:
     DISPATCH();
 }
 
+op_jump_if_true:
+{
+    uint16 offset = READ_SHORT();
+    if (!isFalsey(PEEK()))
+        ip += offset;
+    DISPATCH();
+}
+
 op_loop:
 {
     uint16 offset = READ_SHORT();
 
     ip -= offset;
 
+    // Safe point: loops que só criam strings também chegam ao GC
+    if (gcPending())
+        gcSafePoint();
+
     DISPATCH();
 }
 
@@ -1040,6 +1218,16 @@ op_call:
 
         //  Criou frame! Reload!
         LOAD_FRAME();
+
+        // Register tier: promove depois de REGISTER_TIER_THRESHOLD chamadas
+        if (registerTierEnabled_)
+        {
+            if (!targetFunc->regCode && !targetFunc->regTierFailed &&
+                ++targetFunc->callCount >= REGISTER_TIER_THRESHOLD)
+                promoteToRegisterTier(targetFunc);
+            if (targetFunc->regCode)
+                ip = runRegisterTier(fiber, frame, 0);
+        }
         DISPATCH();
     }
 
@@ -1156,7 +1344,7 @@ op_call:
     // ========================================
     else if (callee.isStruct())
     {
-        int index = callee.as.integer;
+        int index = callee.asId();
         StructDef *def = structs[index];
 
         if (argCount > def->argCount)
@@ -1167,7 +1355,7 @@ op_call:
         }
 
         Value value = makeStructInstance();
-        StructInstance *instance = value.as.sInstance;
+        StructInstance *instance = value.asStructInstance();
         instance->def = def;
 
         instance->values.reserve(def->argCount);
@@ -1197,6 +1385,7 @@ op_call:
         Value value = makeClassInstance();
         ClassInstance *instance = value.asClassInstance();
         instance->klass = klass;
+        instance->shape = getClassShape(klass);
         instance->fields.reserve(klass->fieldCount);
 
         // Inicializa fields com valores default ou nil
@@ -1213,7 +1402,7 @@ op_call:
         }
 
         // Verifica se há NativeClass na cadeia de herança (direta ou indireta)
-        NativeClassDef *nativeKlass = instance->getNativeSuperclass();
+        NativeClassDef *nativeKlass = instance->shape->nativeBase;
         if (nativeKlass)
         {
             // Chama constructor nativo se existir (retorna userData)
@@ -1294,7 +1483,7 @@ op_call:
         }
 
         Value literal = makeNativeClassInstance(klass->persistent);
-        NativeClassInstance *instance = literal.as.sClassInstance;
+        NativeClassInstance *instance = literal.asNativeClassInstance();
 
         instance->klass = klass;
         instance->userData = userData;
@@ -1325,7 +1514,7 @@ op_call:
         }
 
         Value literal = makeNativeStructInstance(def->persistent);
-        NativeStructInstance *instance = literal.as.sNativeStruct;
+        NativeStructInstance *instance = literal.asNativeStructInstance();
 
         instance->def = def;
         instance->data = data;
@@ -1343,8 +1532,8 @@ op_call:
     // ========================================
     else if (callee.isModuleRef())
     {
-        uint16 moduleId = (callee.as.unsignedInteger >> 16) & 0xFFFF;
-        uint16 funcId = callee.as.unsignedInteger & 0xFFFF;
+        uint16 moduleId = (callee.asModuleRef() >> 16) & 0xFFFF;
+        uint16 funcId = callee.asModuleRef() & 0xFFFF;
 
         if (moduleId >= modules.size())
         {
@@ -1428,6 +1617,47 @@ op_call:
     LOAD_FRAME();
 }
 
+// Callee e aridade resolvidos pelo compilador; o OP_CALL argc vem a seguir
+op_call_direct:
+{
+    uint16 index = READ_SHORT();
+    uint8 argCount = ip[1];
+    Value callee = NPEEK(argCount);
+
+    // O global foi reatribuído: corre o OP_CALL genérico
+    if (!callee.isFunction() || callee.asFunctionId() != index)
+        DISPATCH();
+
+    Function *targetFunc = functions[index];
+    ip += 2;
+    STORE_FRAME();
+
+    // Como no OP_CALL: o erro sai com o ip/linha desta chamada
+    if (fiber->frameCount >= FRAMES_MAX)
+    {
+        runtimeError("Stack overflow");
+        return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
+    }
+
+    CallFrame *newFrame = &fiber->frames[fiber->frameCount++];
+    newFrame->func = targetFunc;
+    newFrame->closure = nullptr;
+    newFrame->ip = targetFunc->chunk->code;
+    newFrame->slots = fiber->stackTop - argCount - 1;
+
+    LOAD_FRAME();
+
+    if (registerTierEnabled_)
+    {
+        if (!targetFunc->regCode && !targetFunc->regTierFailed &&
+            ++targetFunc->callCount >= REGISTER_TIER_THRESHOLD)
+            promoteToRegisterTier(targetFunc);
+        if (targetFunc->regCode)
+            ip = runRegisterTier(fiber, frame, 0);
+    }
+    DISPATCH();
+}
+
 op_return:
 {
     Value result = POP();
@@ -1446,6 +1676,7 @@ op_return:
         {
             Upvalue *upvalue = openUpvalues;
             upvalue->closed = *upvalue->location;
+            writeBarrier(upvalue, upvalue->closed);
             upvalue->location = &upvalue->closed;
             openUpvalues = upvalue->nextOpen;
         }
@@ -1516,6 +1747,10 @@ op_return:
     *fiber->stackTop++ = result;
 
     LOAD_FRAME();
+
+    // Caller no register tier: continua lá depois do OP_CALL
+    if (func->regCode && registerTierEnabled_)
+        ip = resumeRegisterTier(fiber, frame, ip);
     DISPATCH();
     // printf("end");
 }
@@ -1682,10 +1917,142 @@ op_len:
 
     // ========== PROPERTY ACCESS ==========
 
+// Private de outro processo com índice resolvido pelo compilador. O IC de
+// class/struct vem primeiro, no mesmo handler: um p.x num struct não paga
+// nada a mais do que no OP_GET_PROPERTY. Falhando tudo, segue para o
+// OP_GET_PROPERTY com ip no nome
+op_get_proc_private:
+{
+    uint8 privateIdx = READ_BYTE();
+    Value object = PEEK();
+    PropertyCache *cache = &func->chunk->propertyCaches[(uint16)((ip[2] << 8) | ip[3])];
+    if (object.isClassInstance())
+    {
+        ClassInstance *instance = object.asClassInstance();
+        int slot = cache->find(instance->shape);
+        if (slot >= 0)
+        {
+            propertyCacheHits++;
+            ip += 4; // name, cache
+            DROP();
+            PUSH(instance->fields[slot]);
+            DISPATCH();
+        }
+    }
+    else if (object.isStructInstance())
+    {
+        StructInstance *inst = object.asStructInstance();
+        int slot = inst ? cache->find(inst->def) : -1;
+        if (slot >= 0)
+        {
+            propertyCacheHits++;
+            ip += 4;
+            DROP();
+            PUSH(inst->values[slot]);
+            DISPATCH();
+        }
+    }
+    else if (object.isProcessInstance())
+    {
+        Process *proc = object.asProcess();
+        if (proc && proc->state != FiberState::DEAD)
+        {
+            ip += 4;
+            DROP();
+            PUSH(proc->privates[privateIdx]);
+            DISPATCH();
+        }
+    }
+    goto op_get_property;
+}
+
+op_set_proc_private:
+{
+    uint8 privateIdx = READ_BYTE();
+    Value value = PEEK();
+    Value object = PEEK2();
+    PropertyCache *cache = &func->chunk->propertyCaches[(uint16)((ip[2] << 8) | ip[3])];
+    if (object.isClassInstance())
+    {
+        ClassInstance *instance = object.asClassInstance();
+        int slot = cache->find(instance->shape);
+        if (slot >= 0)
+        {
+            propertyCacheHits++;
+            ip += 4; // name, cache
+            instance->fields[slot] = value;
+            writeBarrier(instance, value);
+            DROP();
+            DROP();
+            PUSH(value);
+            DISPATCH();
+        }
+    }
+    else if (object.isStructInstance())
+    {
+        StructInstance *inst = object.asStructInstance();
+        int slot = inst ? cache->find(inst->def) : -1;
+        if (slot >= 0)
+        {
+            propertyCacheHits++;
+            ip += 4;
+            inst->values[slot] = value;
+            writeBarrier(inst, value);
+            DROP();
+            DROP();
+            PUSH(value);
+            DISPATCH();
+        }
+    }
+    else if (object.isProcessInstance())
+    {
+        Process *proc = object.asProcess();
+        if (proc && proc->state != FiberState::DEAD)
+        {
+            ip += 4;
+            proc->privates[privateIdx] = value;
+            DROP();
+            DROP();
+            PUSH(value);
+            DISPATCH();
+        }
+    }
+    goto op_set_property;
+}
+
 op_get_property:
 {
     Value object = PEEK();
     Value nameValue = READ_CONSTANT();
+    PropertyCache *cache = &func->chunk->propertyCaches[READ_SHORT()];
+
+    // === INLINE CACHE (class/struct já vistos nesta instrução) ===
+    if (object.isClassInstance())
+    {
+        ClassInstance *instance = object.asClassInstance();
+        int slot = cache->find(instance->shape);
+        if (slot >= 0)
+        {
+            propertyCacheHits++;
+            DROP();
+            PUSH(instance->fields[slot]);
+            DISPATCH();
+        }
+        propertyCacheMisses++;
+    }
+    else if (object.isStructInstance())
+    {
+        StructInstance *inst = object.asStructInstance();
+        int slot = inst ? cache->find(inst->def) : -1;
+        if (slot >= 0)
+        {
+            propertyCacheHits++;
+            DROP();
+            PUSH(inst->values[slot]);
+            DISPATCH();
+        }
+        propertyCacheMisses++;
+    }
 
     // printf("\nGet Object: '");
     // printValue(object);
@@ -1761,6 +2128,7 @@ op_get_property:
             uint8 value = 0;
             if (inst->def->names.get(nameValue.asString(), &value))
             {
+                cache->add(inst->def, value);
 
                 DROP();
                 PUSH(inst->values[value]);
@@ -1779,24 +2147,22 @@ op_get_property:
         {
             ClassInstance *instance = object.asClassInstance();
 
-            // bool inherited = instance->klass->inherited;
-
-            uint8_t fieldIdx;
-            if (instance->klass->fieldNames.get(nameValue.asString(), &fieldIdx))
+            // Shape: fields (próprios/herdados) e properties nativas num só lookup
+            ShapeSlot shapeSlot;
+            if (instance->shape->find(nameValue.asString(), &shapeSlot))
             {
                 DROP();
-                PUSH(instance->fields[fieldIdx]);
-                DISPATCH();
-            }
-
-            // Verifica propriedades herdadas da NativeClass
-            NativeProperty nativeProp;
-            if (instance->getNativeProperty(nameValue.asString(), &nativeProp))
-            {
-                DROP(); // Remove object
-                // Chama getter nativo com userData do híbrido
-                Value result = nativeProp.getter(this, instance->nativeUserData);
-                PUSH(result);
+                if (shapeSlot.kind == ShapeSlotKind::FIELD)
+                {
+                    cache->add(instance->shape, shapeSlot.index);
+                    PUSH(instance->fields[shapeSlot.index]);
+                }
+                else
+                {
+                    // Chama getter nativo com userData do híbrido
+                    const NativeProperty &nativeProp = instance->shape->nativeProps[shapeSlot.index];
+                    PUSH(nativeProp.getter(this, instance->nativeUserData));
+                }
                 DISPATCH();
             }
 
@@ -1929,6 +2295,41 @@ op_set_property:
     Value value = PEEK();
     Value object = PEEK2();
     Value nameValue = READ_CONSTANT();
+    PropertyCache *cache = &func->chunk->propertyCaches[READ_SHORT()];
+
+    // === INLINE CACHE (class/struct já vistos nesta instrução) ===
+    if (object.isClassInstance())
+    {
+        ClassInstance *instance = object.asClassInstance();
+        int slot = cache->find(instance->shape);
+        if (slot >= 0)
+        {
+            propertyCacheHits++;
+            instance->fields[slot] = value;
+            writeBarrier(instance, value);
+            DROP();      // Remove value
+            DROP();      // Remove object
+            PUSH(value); // Push value back
+            DISPATCH();
+        }
+        propertyCacheMisses++;
+    }
+    else if (object.isStructInstance())
+    {
+        StructInstance *inst = object.asStructInstance();
+        int slot = inst ? cache->find(inst->def) : -1;
+        if (slot >= 0)
+        {
+            propertyCacheHits++;
+            inst->values[slot] = value;
+            writeBarrier(inst, value);
+            DROP();      // Remove value
+            DROP();      // Remove object
+            PUSH(value); // Push value back
+            DISPATCH();
+        }
+        propertyCacheMisses++;
+    }
 
     // printf("Set Value: '");
     // printValue(value);
@@ -2002,7 +2403,9 @@ op_set_property:
         uint8 valueIndex = 0;
         if (inst->def->names.get(nameValue.asString(), &valueIndex))
         {
+            cache->add(inst->def, valueIndex);
             inst->values[valueIndex] = value;
+            writeBarrier(inst, value);
         }
         else
         {
@@ -2022,10 +2425,13 @@ op_set_property:
     {
         ClassInstance *instance = object.asClassInstance();
 
-        uint8_t fieldIdx;
-        if (instance->klass->fieldNames.get(nameValue.asString(), &fieldIdx))
+        ShapeSlot shapeSlot;
+        bool found = instance->shape->find(nameValue.asString(), &shapeSlot);
+        if (found && shapeSlot.kind == ShapeSlotKind::FIELD)
         {
-            instance->fields[fieldIdx] = value;
+            cache->add(instance->shape, shapeSlot.index);
+            instance->fields[shapeSlot.index] = value;
+            writeBarrier(instance, value);
             // Stack: [obj, value] -> queremos [value]
             DROP();      // Remove value
             DROP();      // Remove object
@@ -2033,10 +2439,10 @@ op_set_property:
             DISPATCH();
         }
 
-        // Verifica propriedades herdadas da NativeClass
-        NativeProperty nativeProp;
-        if (instance->getNativeProperty(nameValue.asString(), &nativeProp))
+        // Property herdada da NativeClass
+        if (found)
         {
+            const NativeProperty &nativeProp = instance->shape->nativeProps[shapeSlot.index];
             if (!nativeProp.setter)
             {
                 runtimeError("Property '%s' is read-only", name);
@@ -2185,7 +2591,8 @@ op_set_property:
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
             String **fieldPtr = (String **)ptr;
-            *fieldPtr = value.asString();
+            // A struct nativa guarda o ponteiro fora do alcance do GC
+            *fieldPtr = stringPool.intern(value.asString());
             break;
         }
         }
@@ -2209,10 +2616,14 @@ op_set_property:
 
     DISPATCH();
 }
+op_invoke_builtin:
 op_invoke:
 {
+    // OP_INVOKE_BUILTIN traz o id de StaticNames resolvido pelo compilador
+    bool builtinCall = (ip[-1] == OP_INVOKE_BUILTIN);
     Value nameValue = READ_CONSTANT();
     uint8_t argCount = READ_BYTE();
+    int methodId = builtinCall ? (int)READ_BYTE() : -1;
 
     if (!nameValue.isString())
     {
@@ -2223,6 +2634,10 @@ op_invoke:
     const char *name = nameValue.asStringChars();
     Value receiver = NPEEK(argCount);
 
+    // OP_INVOKE genérico: resolve o id em runtime
+    if (methodId < 0 && (receiver.isString() || receiver.isArray() || receiver.isMap() || receiver.isBuffer()))
+        methodId = getStaticNameId(nameValue.asString());
+
 #define ARGS_CLEANUP() fiber->stackTop -= (argCount + 1)
 
     // === STRING METHODS ===
@@ -2230,23 +2645,23 @@ op_invoke:
     {
         String *str = receiver.asString();
 
-        if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LENGTH]))
+        if (methodId == (int)StaticNames::LENGTH)
         {
             int len = str->length();
             ARGS_CLEANUP();
             PUSH(makeInt(len));
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::UPPER]))
+        else if (methodId == (int)StaticNames::UPPER)
         {
             ARGS_CLEANUP();
             PUSH(makeString(stringPool.upper(str)));
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LOWER]))
+        else if (methodId == (int)StaticNames::LOWER)
         {
             ARGS_CLEANUP();
             PUSH(makeString(stringPool.lower(str)));
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CONCAT]))
+        else if (methodId == (int)StaticNames::CONCAT)
         {
             if (argCount != 1)
             {
@@ -2265,7 +2680,7 @@ op_invoke:
             ARGS_CLEANUP();
             PUSH(makeString(result));
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SUB]))
+        else if (methodId == (int)StaticNames::SUB)
         {
             if (argCount != 2)
             {
@@ -2289,7 +2704,7 @@ op_invoke:
             ARGS_CLEANUP();
             PUSH(makeString(result));
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REPLACE]))
+        else if (methodId == (int)StaticNames::REPLACE)
         {
             if (argCount != 2)
             {
@@ -2313,7 +2728,7 @@ op_invoke:
             ARGS_CLEANUP();
             PUSH(makeString(result));
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::AT]))
+        else if (methodId == (int)StaticNames::AT)
         {
             if (argCount != 1)
             {
@@ -2333,7 +2748,7 @@ op_invoke:
             PUSH(makeString(result));
         }
 
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CONTAINS]))
+        else if (methodId == (int)StaticNames::CONTAINS)
         {
             if (argCount != 1)
             {
@@ -2353,14 +2768,14 @@ op_invoke:
             PUSH(makeBool(result));
         }
 
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::TRIM]))
+        else if (methodId == (int)StaticNames::TRIM)
         {
             String *result = stringPool.trim(str);
             ARGS_CLEANUP();
             PUSH(makeString(result));
         }
 
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::STARTWITH]))
+        else if (methodId == (int)StaticNames::STARTWITH)
         {
             if (argCount != 1)
             {
@@ -2380,7 +2795,7 @@ op_invoke:
             PUSH(makeBool(result));
         }
 
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::ENDWITH]))
+        else if (methodId == (int)StaticNames::ENDWITH)
         {
             if (argCount != 1)
             {
@@ -2400,7 +2815,7 @@ op_invoke:
             PUSH(makeBool(result));
         }
 
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::INDEXOF]))
+        else if (methodId == (int)StaticNames::INDEXOF)
         {
             if (argCount < 1 || argCount > 2)
             {
@@ -2444,7 +2859,7 @@ op_invoke:
             ARGS_CLEANUP();
             PUSH(makeInt(result));
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REPEAT]))
+        else if (methodId == (int)StaticNames::REPEAT)
         {
             if (argCount != 1)
             {
@@ -2463,7 +2878,7 @@ op_invoke:
             ARGS_CLEANUP();
             PUSH(makeString(result));
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SPLIT]))
+        else if (methodId == (int)StaticNames::SPLIT)
         {
             if (argCount != 1)
             {
@@ -2495,7 +2910,7 @@ op_invoke:
                     // Cria string de 1 char
                     char buf[2] = {strChars[i], '\0'};
 
-                    ptr->values.push(makeString(createString(buf, 1)));
+                    ptr->values.push(makeString(createRuntimeString(buf, 1)));
                 }
             }
             else
@@ -2511,7 +2926,7 @@ op_invoke:
                 {
                     int partLen = found - current;
 
-                    ptr->values.push(makeString(createString(current, partLen)));
+                    ptr->values.push(makeString(createRuntimeString(current, partLen)));
 
                     // Avança ponteiro
                     current = found + sepLen;
@@ -2522,7 +2937,7 @@ op_invoke:
                 int remaining = end - current;
                 if (remaining >= 0)
                 {
-                    ptr->values.push(makeString(createString(current, remaining)));
+                    ptr->values.push(makeString(createRuntimeString(current, remaining)));
                 }
             }
 
@@ -2543,7 +2958,7 @@ op_invoke:
     {
         ArrayInstance *arr = receiver.asArray();
         uint32 size = arr->values.size();
-        if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::PUSH]))
+        if (methodId == (int)StaticNames::PUSH)
         {
             if (argCount != 1)
             {
@@ -2552,13 +2967,14 @@ op_invoke:
             }
             Value item = PEEK();
             arr->values.push(item);
+            writeBarrier(arr, item);
 
             ARGS_CLEANUP();
 
             PUSH(receiver);
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::POP]))
+        else if (methodId == (int)StaticNames::POP)
         {
             if (argCount != 0)
             {
@@ -2582,7 +2998,7 @@ op_invoke:
             }
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::BACK]))
+        else if (methodId == (int)StaticNames::BACK)
         {
             if (argCount != 0)
             {
@@ -2605,7 +3021,7 @@ op_invoke:
             }
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LENGTH]))
+        else if (methodId == (int)StaticNames::LENGTH)
         {
             if (argCount != 0)
             {
@@ -2617,7 +3033,7 @@ op_invoke:
             PUSH(makeInt(size));
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CLEAR]))
+        else if (methodId == (int)StaticNames::CLEAR)
         {
             if (argCount != 0)
             {
@@ -2629,7 +3045,7 @@ op_invoke:
             PUSH(receiver);
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REMOVE]))
+        else if (methodId == (int)StaticNames::REMOVE)
         {
             if (argCount != 1)
             {
@@ -2649,7 +3065,7 @@ op_invoke:
             PUSH(receiver);
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::INSERT]))
+        else if (methodId == (int)StaticNames::INSERT)
         {
             if (argCount != 2)
             {
@@ -2670,11 +3086,12 @@ op_invoke:
             }
             Value item = NPEEK(0);
             arr->values.insert(valueindex, item);
+            writeBarrier(arr, item);
             ARGS_CLEANUP();
             PUSH(receiver);
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::FIND]))
+        else if (methodId == (int)StaticNames::FIND)
         {
             if (argCount != 1)
             {
@@ -2696,7 +3113,7 @@ op_invoke:
             PUSH(makeInt(foundIndex));
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CONTAINS]))
+        else if (methodId == (int)StaticNames::CONTAINS)
         {
             if (argCount != 1)
             {
@@ -2717,7 +3134,7 @@ op_invoke:
             PUSH(makeBool(found));
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REVERSE]))
+        else if (methodId == (int)StaticNames::REVERSE)
         {
             if (argCount != 0)
             {
@@ -2731,7 +3148,7 @@ op_invoke:
             PUSH(receiver);
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SLICE]))
+        else if (methodId == (int)StaticNames::SLICE)
         {
             if (argCount < 1 || argCount > 2)
             {
@@ -2774,7 +3191,7 @@ op_invoke:
             PUSH(newArray);
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CONCAT]))
+        else if (methodId == (int)StaticNames::CONCAT)
         {
             if (argCount != 1)
             {
@@ -2805,7 +3222,7 @@ op_invoke:
             PUSH(newArray);
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::FIRST]))
+        else if (methodId == (int)StaticNames::FIRST)
         {
             if (argCount != 0)
             {
@@ -2825,7 +3242,7 @@ op_invoke:
             }
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LAST]))
+        else if (methodId == (int)StaticNames::LAST)
         {
             if (argCount != 0)
             {
@@ -2845,7 +3262,7 @@ op_invoke:
             }
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::FILL]))
+        else if (methodId == (int)StaticNames::FILL)
         {
             if (argCount != 1)
             {
@@ -2854,6 +3271,7 @@ op_invoke:
             }
 
             Value fillValue = PEEK();
+            writeBarrier(arr, fillValue);
 
             for (uint32 i = 0; i < size; i++)
             {
@@ -2877,7 +3295,7 @@ op_invoke:
     {
         MapInstance *map = receiver.asMap();
 
-        if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::HAS]))
+        if (methodId == (int)StaticNames::HAS)
         {
             if (argCount != 1)
             {
@@ -2898,7 +3316,7 @@ op_invoke:
             PUSH(makeBool(exists));
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REMOVE]))
+        else if (methodId == (int)StaticNames::REMOVE)
         {
             if (argCount != 1)
             {
@@ -2917,11 +3335,12 @@ op_invoke:
             }
 
             map->table.set(key.asString(), makeNil());
+            writeBarrier(map, key);
             ARGS_CLEANUP();
             PUSH(makeNil());
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CLEAR]))
+        else if (methodId == (int)StaticNames::CLEAR)
         {
             if (argCount != 0)
             {
@@ -2934,7 +3353,7 @@ op_invoke:
             PUSH(makeNil());
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LENGTH]))
+        else if (methodId == (int)StaticNames::LENGTH)
         {
             if (argCount != 0)
             {
@@ -2945,7 +3364,7 @@ op_invoke:
             PUSH(makeInt(map->table.count));
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::KEYS]))
+        else if (methodId == (int)StaticNames::KEYS)
         {
             if (argCount != 0)
             {
@@ -2964,7 +3383,7 @@ op_invoke:
             PUSH(keys);
             DISPATCH();
         }
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::VALUES]))
+        else if (methodId == (int)StaticNames::VALUES)
         {
             if (argCount != 0)
             {
@@ -3107,7 +3526,7 @@ op_invoke:
         size_t totalSize = buf->count * buf->elementSize;
 
         // buf.fill(value)
-        if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::FILL]))
+        if (methodId == (int)StaticNames::FILL)
         {
             if (argCount != 1)
             {
@@ -3261,7 +3680,7 @@ op_invoke:
         }
 
         //   copy(dstOffset, srcBuffer, srcOffset, count)
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::COPY]))
+        else if (methodId == (int)StaticNames::COPY)
         {
             if (argCount != 4)
             {
@@ -3339,7 +3758,7 @@ op_invoke:
         }
 
         // buf.slice(start, end)
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SLICE]))
+        else if (methodId == (int)StaticNames::SLICE)
         {
             if (argCount != 2)
             {
@@ -3397,7 +3816,7 @@ op_invoke:
         }
 
         // buf.clear()
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CLEAR]))
+        else if (methodId == (int)StaticNames::CLEAR)
         {
             if (argCount != 0)
             {
@@ -3414,7 +3833,7 @@ op_invoke:
         }
 
         // buf.length()
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LENGTH]))
+        else if (methodId == (int)StaticNames::LENGTH)
         {
             if (argCount != 0)
             {
@@ -3426,7 +3845,7 @@ op_invoke:
             PUSH(makeInt(buf->count));
             DISPATCH();
         } // buf.save(filename) - Salva dados RAW
-        else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SAVE]))
+        else if (methodId == (int)StaticNames::SAVE)
         {
             if (argCount != 1)
             {
@@ -3463,7 +3882,7 @@ op_invoke:
             // ========================================
 
             // buf.writeByte(value)
-            if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_BYTE]))
+            if (methodId == (int)StaticNames::WRITE_BYTE)
             {
                 if (argCount != 1)
                 {
@@ -3486,7 +3905,7 @@ op_invoke:
             }
 
             // buf.writeShort(value) - int16
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_SHORT]))
+            else if (methodId == (int)StaticNames::WRITE_SHORT)
             {
                 if (argCount != 1)
                 {
@@ -3510,7 +3929,7 @@ op_invoke:
             }
 
             // buf.writeUShort(value) - uint16
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_USHORT]))
+            else if (methodId == (int)StaticNames::WRITE_USHORT)
             {
                 if (argCount != 1)
                 {
@@ -3534,7 +3953,7 @@ op_invoke:
             }
 
             // buf.writeInt(value) - int32
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_INT]))
+            else if (methodId == (int)StaticNames::WRITE_INT)
             {
                 if (argCount != 1)
                 {
@@ -3558,7 +3977,7 @@ op_invoke:
             }
 
             // buf.writeUInt(value) - uint32 (aceita double para valores > 2^31)
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_UINT]))
+            else if (methodId == (int)StaticNames::WRITE_UINT)
             {
                 if (argCount != 1)
                 {
@@ -3583,7 +4002,7 @@ op_invoke:
             }
 
             // buf.writeFloat(value)
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_FLOAT]))
+            else if (methodId == (int)StaticNames::WRITE_FLOAT)
             {
                 if (argCount != 1)
                 {
@@ -3607,7 +4026,7 @@ op_invoke:
             }
 
             // buf.writeDouble(value)
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_DOUBLE]))
+            else if (methodId == (int)StaticNames::WRITE_DOUBLE)
             {
                 if (argCount != 1)
                 {
@@ -3631,7 +4050,7 @@ op_invoke:
             }
 
             // buf.writeString(str) - Escreve bytes da string (UTF-8)
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_STRING]))
+            else if (methodId == (int)StaticNames::WRITE_STRING)
             {
                 if (argCount != 1)
                 {
@@ -3668,7 +4087,7 @@ op_invoke:
             // ========================================
 
             // buf.readByte()
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_BYTE]))
+            else if (methodId == (int)StaticNames::READ_BYTE)
             {
                 if (argCount != 0)
                 {
@@ -3691,7 +4110,7 @@ op_invoke:
             }
 
             // buf.readShort()
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_SHORT]))
+            else if (methodId == (int)StaticNames::READ_SHORT)
             {
                 if (argCount != 0)
                 {
@@ -3715,7 +4134,7 @@ op_invoke:
             }
 
             // buf.readUShort()
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_USHORT]))
+            else if (methodId == (int)StaticNames::READ_USHORT)
             {
                 if (argCount != 0)
                 {
@@ -3739,7 +4158,7 @@ op_invoke:
             }
 
             // buf.readInt()
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_INT]))
+            else if (methodId == (int)StaticNames::READ_INT)
             {
                 if (argCount != 0)
                 {
@@ -3763,7 +4182,7 @@ op_invoke:
             }
 
             // buf.readUInt() - Retorna como double (para valores > 2^31)
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_UINT]))
+            else if (methodId == (int)StaticNames::READ_UINT)
             {
                 if (argCount != 0)
                 {
@@ -3787,7 +4206,7 @@ op_invoke:
             }
 
             // buf.readFloat()
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_FLOAT]))
+            else if (methodId == (int)StaticNames::READ_FLOAT)
             {
                 if (argCount != 0)
                 {
@@ -3811,7 +4230,7 @@ op_invoke:
             }
 
             // buf.readDouble()
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_DOUBLE]))
+            else if (methodId == (int)StaticNames::READ_DOUBLE)
             {
                 if (argCount != 0)
                 {
@@ -3835,7 +4254,7 @@ op_invoke:
             }
 
             // buf.readString(length)
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_STRING]))
+            else if (methodId == (int)StaticNames::READ_STRING)
             {
                 if (argCount != 1)
                 {
@@ -3868,7 +4287,7 @@ op_invoke:
                 memcpy(temp, buf->data + buf->cursor, length);
                 temp[length] = 0;
 
-                String *str = createString(temp);
+                String *str = createRuntimeString(temp);
                 free(temp);
 
                 buf->cursor += length;
@@ -3883,7 +4302,7 @@ op_invoke:
             // ========================================
 
             // buf.seek(position)
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SEEK]))
+            else if (methodId == (int)StaticNames::SEEK)
             {
                 if (argCount != 1)
                 {
@@ -3914,7 +4333,7 @@ op_invoke:
             }
 
             // buf.tell()
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::TELL]))
+            else if (methodId == (int)StaticNames::TELL)
             {
                 if (argCount != 0)
                 {
@@ -3928,7 +4347,7 @@ op_invoke:
             }
 
             // buf.rewind()
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REWIND]))
+            else if (methodId == (int)StaticNames::REWIND)
             {
                 if (argCount != 0)
                 {
@@ -3944,7 +4363,7 @@ op_invoke:
             }
 
             // buf.skip(bytes)
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SKIP]))
+            else if (methodId == (int)StaticNames::SKIP)
             {
                 if (argCount != 1)
                 {
@@ -3974,7 +4393,7 @@ op_invoke:
             }
 
             // buf.remaining()
-            else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REMAINING]))
+            else if (methodId == (int)StaticNames::REMAINING)
             {
                 if (argCount != 0)
                 {
@@ -4183,6 +4602,7 @@ op_set_index:
         else
         {
             arr->values[i] = value;
+            writeBarrier(arr, value);
         }
 
         PUSH(value); // Assignment returns value
@@ -4200,6 +4620,8 @@ op_set_index:
 
         MapInstance *map = container.asMap();
         map->table.set(index.asString(), value);
+        writeBarrier(map, index);
+        writeBarrier(map, value);
 
         PUSH(value); // Assignment returns value
         DISPATCH();
@@ -4468,8 +4890,8 @@ op_iter_next:
         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
     }
 
-    ArrayInstance *array = seq.as.array;
-    int index = iter.isNil() ? 0 : iter.as.integer + 1;
+    ArrayInstance *array = seq.asArray();
+    int index = iter.isNil() ? 0 : iter.asInt() + 1;
 
     if (index < (int)array->values.size())
     {
@@ -4496,8 +4918,8 @@ op_iter_value:
         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
     }
 
-    ArrayInstance *array = seq.as.array;
-    int index = iter.as.integer;
+    ArrayInstance *array = seq.asArray();
+    int index = iter.asInt();
 
     if (index < 0 || index >= (int)array->values.size())
     {
@@ -4536,6 +4958,31 @@ op_discard:
     DISPATCH();
 }
 
+op_pick:
+{
+    uint8_t depth = READ_BYTE();
+    Value v = NPEEK(depth);
+    PUSH(v);
+    DISPATCH();
+}
+
+op_slide:
+{
+    uint8_t count = READ_BYTE();
+    Value result = POP();
+    fiber->stackTop -= count;
+    PUSH(result);
+    DISPATCH();
+}
+
+op_switch_table:
+{
+    const SwitchTable *table = &func->chunk->switchTables[READ_SHORT()];
+    Value value = POP();
+    ip = func->chunk->code + table->targets[switchTableCase(table, value)];
+    DISPATCH();
+}
+
 op_try:
 {
     uint16_t catchAddr = READ_SHORT();
@@ -4555,6 +5002,8 @@ op_try:
     handler.pendingError = makeNil();
     handler.hasPendingError = false;
     handler.catchConsumed = false;
+    handler.hasPendingReturn = false;
+    handler.pendingReturnCount = 0;
 
     fiber->tryDepth++;
     DISPATCH();
@@ -5118,7 +5567,6 @@ op_free:
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
         // Info("Free  Struct address: %p", (void*)instance);
-        instance->marked = 1;
         freed = true;
     }
     else if (object.isClassInstance())
@@ -5129,7 +5577,6 @@ op_free:
             runtimeError("Class instance is nil");
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
-        instance->marked = 1;
         freed = true;
     }
     else if (object.isNativeClassInstance())
@@ -5140,7 +5587,6 @@ op_free:
             runtimeError("Native class instance is nil");
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
-        instance->marked = 1;
         freed = true;
     }
     else if (object.isNativeStructInstance())
@@ -5152,7 +5598,6 @@ op_free:
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
         // Info("Free  Native Struct address: %p", (void*)instance);
-        instance->marked = 1;
         freed = true;
     }
     else if (object.isBuffer())
@@ -5163,7 +5608,6 @@ op_free:
             runtimeError("Buffer instance is nil");
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
-        instance->marked = 1;
         freed = true;
     }
     else if (object.isMap())
@@ -5175,7 +5619,6 @@ op_free:
             runtimeError("Map instance is nil");
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
-        instance->marked = 1;
         freed = true;
     }
     else if (object.isArray())
@@ -5186,7 +5629,6 @@ op_free:
             runtimeError("Array instance is nil");
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
-        instance->marked = 1;
         freed = true;
     }
 
@@ -5203,7 +5645,7 @@ op_closure:
     int funcID = funcVal.asFunctionId();
     Function *function = functions[funcID];
     Value closure = makeClosure();
-    Closure *closurePtr = closure.as.closure;
+    Closure *closurePtr = closure.asClosure();
     closurePtr->functionId = funcID;
     closurePtr->upvalueCount = function->upvalueCount;
 
@@ -5303,7 +5745,9 @@ op_set_upvalue:
         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
     }
 
-    *frame->closure->upvalues[slot]->location = PEEK();
+    Upvalue *upvalue = frame->closure->upvalues[slot];
+    *upvalue->location = PEEK();
+    writeBarrier(upvalue, PEEK());
     DISPATCH();
 }
 
@@ -5314,6 +5758,7 @@ op_close_upvalue:
     {
         Upvalue *upvalue = openUpvalues;
         upvalue->closed = *upvalue->location;
+        writeBarrier(upvalue, upvalue->closed);
         upvalue->location = &upvalue->closed;
         openUpvalues = upvalue->nextOpen;
     }
@@ -5347,6 +5792,7 @@ op_return_n:
         {
             Upvalue *upvalue = openUpvalues;
             upvalue->closed = *upvalue->location;
+            writeBarrier(upvalue, upvalue->closed);
             upvalue->location = &upvalue->closed;
             openUpvalues = upvalue->nextOpen;
         }
@@ -5498,6 +5944,125 @@ op_get_id:
     DISPATCH();
 }
 
+// ============================================
+// QUICKENED ARITHMETIC / COMPARISON
+// ============================================
+
+op_add_ii:
+    QUICK_BINARY_OP(isInt, asInt, makeInt, +, OP_ADD, op_add);
+
+op_add_dd:
+    QUICK_BINARY_OP(isDouble, asDouble, makeDouble, +, OP_ADD, op_add);
+
+op_subtract_ii:
+    QUICK_BINARY_OP(isInt, asInt, makeInt, -, OP_SUBTRACT, op_subtract);
+
+op_subtract_dd:
+    QUICK_BINARY_OP(isDouble, asDouble, makeDouble, -, OP_SUBTRACT, op_subtract);
+
+op_multiply_ii:
+    QUICK_BINARY_OP(isInt, asInt, makeInt, *, OP_MULTIPLY, op_multiply);
+
+op_multiply_dd:
+    QUICK_BINARY_OP(isDouble, asDouble, makeDouble, *, OP_MULTIPLY, op_multiply);
+
+op_less_ii:
+    QUICK_BINARY_OP(isInt, asInt, makeBool, <, OP_LESS, op_less);
+
+op_less_dd:
+    QUICK_BINARY_OP(isDouble, asDouble, makeBool, <, OP_LESS, op_less);
+
+op_greater_ii:
+    QUICK_BINARY_OP(isInt, asInt, makeBool, >, OP_GREATER, op_greater);
+
+op_greater_dd:
+    QUICK_BINARY_OP(isDouble, asDouble, makeBool, >, OP_GREATER, op_greater);
+
+#undef QUICK_BINARY_OP
+
+    // ========== SUPERINSTRUCTIONS ==========
+    // ip aponta para o operando do GET original; seq percorre os bytes que
+    // o compilador deixou no chunk. Fallback = executar como o GET.
+
+op_inc_local:
+{
+    uint8 *seq = ip + 1;
+    Value old = stackStart[ip[0]];
+    bool postfix = (seq[0] == OP_DUP);
+    seq += postfix;
+    Value rhs, result;
+    bool ok;
+    SUPER_OPERAND(seq, rhs);
+    SUPER_ARITH(old, rhs, SUPER_IS_SUB(seq[0]), result, ok);
+    if (!ok)
+    {
+        PUSH(old);
+        ip++;
+        DISPATCH();
+    }
+    stackStart[ip[0]] = result;
+    PUSH(postfix ? old : result);
+    ip = seq + 3 + postfix; // ADD|SUBTRACT, SET_LOCAL s [, POP]
+    DISPATCH();
+}
+
+op_inc_private:
+{
+    uint8 *seq = ip + 1;
+    Value old = process->privates[ip[0]];
+    bool postfix = (seq[0] == OP_DUP);
+    seq += postfix;
+    Value rhs, result;
+    bool ok;
+    SUPER_OPERAND(seq, rhs);
+    SUPER_ARITH(old, rhs, SUPER_IS_SUB(seq[0]), result, ok);
+    if (!ok)
+    {
+        PUSH(old);
+        ip++;
+        DISPATCH();
+    }
+    process->privates[ip[0]] = result;
+    PUSH(postfix ? old : result);
+    ip = seq + 3 + postfix; // ADD|SUBTRACT, SET_PRIVATE p [, POP]
+    DISPATCH();
+}
+
+op_cmp_local_jump:
+{
+    uint8 *seq = ip + 1;
+    Value lhs = stackStart[ip[0]];
+    Value rhs;
+    SUPER_OPERAND(seq, rhs);
+    bool less = SUPER_IS_LESS(seq[0]);
+    bool result;
+    double da, db;
+    if (lhs.isInt() && rhs.isInt())
+        result = less ? lhs.asInt() < rhs.asInt() : lhs.asInt() > rhs.asInt();
+    else if (toNumberPair(lhs, rhs, da, db))
+        result = less ? da < db : da > db;
+    else
+    {
+        PUSH(lhs);
+        ip++;
+        DISPATCH();
+    }
+    ip = seq + 4; // LESS|GREATER, JUMP_IF_FALSE hi lo
+    if (!result)
+        ip += (uint16)((seq[2] << 8) | seq[3]);
+    // if/while/for fazem OP_POP da condição nos dois destinos: nem chega a ser empilhada
+    if (*ip == OP_POP)
+        ip++;
+    else
+        PUSH(makeBool(result));
+    DISPATCH();
+}
+
+#undef SUPER_OPERAND
+#undef SUPER_IS_SUB
+#undef SUPER_IS_LESS
+#undef SUPER_ARITH
+
 // Cleanup macros
 
 #undef READ_BYTE
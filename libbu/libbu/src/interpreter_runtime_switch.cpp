@@ -57,7 +57,7 @@ bool toNumberPair(const Value &a, const Value &b, double &da, double &db)
 
 static const char* getValueTypeName(const Value &v)
 {
-    switch (v.type)
+    switch (v.getType())
     {
         case ValueType::NIL:                 return "nil";
         case ValueType::BOOL:                return "bool";
@@ -120,6 +120,57 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
     Value a = fiber->stackTop[-2]; \
     fiber->stackTop -= 2
 
+// Quickened: guard nos dois operandos, senão volta ao opcode genérico
+// (reescreve o byte e re-executa a instrução)
+#define QUICK_BINARY_OP(IS, AS, MAKE, OPER, GENERIC_OP)        \
+    do                                                         \
+    {                                                          \
+        Value *_top = fiber->stackTop;                         \
+        if (_top[-2].IS() && _top[-1].IS())                    \
+        {                                                      \
+            _top[-2] = MAKE(_top[-2].AS() OPER _top[-1].AS()); \
+            fiber->stackTop--;                                 \
+            break;                                             \
+        }                                                      \
+        ip[-1] = GENERIC_OP;                                   \
+        ip--;                                                  \
+    } while (0)
+
+// Superinstructions: operando da direita (CONSTANT/GET_LOCAL/GET_PRIVATE), avança SEQ
+#define SUPER_OPERAND(SEQ, OUT)                                             \
+    do                                                                      \
+    {                                                                       \
+        if ((SEQ)[0] == OP_CONSTANT)                                        \
+        {                                                                   \
+            OUT = func->chunk->constants[(uint16)(((SEQ)[1] << 8) | (SEQ)[2])]; \
+            SEQ += 3;                                                       \
+        }                                                                   \
+        else                                                                \
+        {                                                                   \
+            OUT = ((SEQ)[0] == OP_GET_LOCAL) ? stackStart[(SEQ)[1]]         \
+                                             : process->privates[(SEQ)[1]]; \
+            SEQ += 2;                                                       \
+        }                                                                   \
+    } while (0)
+
+// O opcode aritmético/comparação original pode já ter sido quickened
+#define SUPER_IS_SUB(OP) ((OP) == OP_SUBTRACT || (OP) == OP_SUBTRACT_II || (OP) == OP_SUBTRACT_DD)
+#define SUPER_IS_LESS(OP) ((OP) == OP_LESS || (OP) == OP_LESS_II || (OP) == OP_LESS_DD)
+
+// A +/- B só para int/double; OK = false pede o fallback
+#define SUPER_ARITH(A, B, SUB, OUT, OK)                                                   \
+    do                                                                                    \
+    {                                                                                     \
+        double _da, _db;                                                                  \
+        OK = true;                                                                        \
+        if ((A).isInt() && (B).isInt())                                                   \
+            OUT = makeInt((SUB) ? (A).asInt() - (B).asInt() : (A).asInt() + (B).asInt()); \
+        else if (toNumberPair(A, B, _da, _db))                                            \
+            OUT = makeDouble((SUB) ? _da - _db : _da + _db);                              \
+        else                                                                              \
+            OK = false;                                                                   \
+    } while (0)
+
 #define STORE_FRAME() frame->ip = ip
 
 #define LOAD_FRAME()                                   \
@@ -139,7 +190,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         char msgBuffer[256];                                         \
         snprintf(msgBuffer, sizeof(msgBuffer), fmt, ##__VA_ARGS__);  \
                                                                      \
-        Value errorVal = makeString(msgBuffer);                      \
+        Value errorVal = makeRuntimeString(msgBuffer);               \
                                                                      \
         if (throwException(errorVal))                                \
         {                                                            \
@@ -219,6 +270,9 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         //    printf("[EXEC] opcode: %d at offset %ld\n", *ip, (long)(ip - func->chunk->code));
 
         uint8 instruction = READ_BYTE();
+#if USE_OPCODE_PROFILE
+        Debug::profileOpcode(instruction);
+#endif
 
         // if (instruction > 57)
         // {  // Opcode inválido
@@ -349,6 +403,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         {
             BINARY_OP_PREP();
 
+            if (quickeningEnabled_)
+            {
+                if (a.isInt() && b.isInt())
+                    ip[-1] = OP_ADD_II;
+                else if (a.isDouble() && b.isDouble())
+                    ip[-1] = OP_ADD_DD;
+            }
+
             // ---------------------------------------------------------
             // 1. CONCATENAÇÃO (String à Esquerda)
             // Ex: "Pontos: " + 100
@@ -471,6 +533,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         {
             BINARY_OP_PREP();
 
+            if (quickeningEnabled_)
+            {
+                if (a.isInt() && b.isInt())
+                    ip[-1] = OP_SUBTRACT_II;
+                else if (a.isDouble() && b.isDouble())
+                    ip[-1] = OP_SUBTRACT_DD;
+            }
+
             if (a.isNumber() && b.isNumber())
             {
                 if (a.isInt() && b.isInt())
@@ -516,6 +586,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         {
             BINARY_OP_PREP();
 
+            if (quickeningEnabled_)
+            {
+                if (a.isInt() && b.isInt())
+                    ip[-1] = OP_MULTIPLY_II;
+                else if (a.isDouble() && b.isDouble())
+                    ip[-1] = OP_MULTIPLY_DD;
+            }
+
             if (a.isNumber() && b.isNumber())
             {
                 if (a.isInt() && b.isInt())
@@ -706,6 +784,15 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         case OP_GREATER:
         {
             BINARY_OP_PREP();
+
+            if (quickeningEnabled_)
+            {
+                if (a.isInt() && b.isInt())
+                    ip[-1] = OP_GREATER_II;
+                else if (a.isDouble() && b.isDouble())
+                    ip[-1] = OP_GREATER_DD;
+            }
+
             double da, db;
             if (!toNumberPair(a, b, da, db))
             {
@@ -730,6 +817,15 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         case OP_LESS:
         {
             BINARY_OP_PREP();
+
+            if (quickeningEnabled_)
+            {
+                if (a.isInt() && b.isInt())
+                    ip[-1] = OP_LESS_II;
+                else if (a.isDouble() && b.isDouble())
+                    ip[-1] = OP_LESS_DD;
+            }
+
             double da, db;
             if (!toNumberPair(a, b, da, db))
             {
@@ -836,12 +932,24 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             break;
         }
 
+        case OP_JUMP_IF_TRUE:
+        {
+            uint16 offset = READ_SHORT();
+            if (!isFalsey(PEEK()))
+                ip += offset;
+            break;
+        }
+
         case OP_LOOP:
         {
 
             uint16 offset = READ_SHORT();
             ip -= offset;
 
+            // Safe point: loops que só criam strings também chegam ao GC
+            if (gcPending())
+                gcSafePoint();
+
             break;
         }
 
@@ -894,6 +1002,16 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 newFrame->closure = nullptr;
                 newFrame->ip = func->chunk->code;
                 newFrame->slots = fiber->stackTop - argCount - 1; // Argumentos começam aqui
+
+                // Register tier: promove depois de REGISTER_TIER_THRESHOLD chamadas
+                if (registerTierEnabled_)
+                {
+                    if (!func->regCode && !func->regTierFailed &&
+                        ++func->callCount >= REGISTER_TIER_THRESHOLD)
+                        promoteToRegisterTier(func);
+                    if (func->regCode)
+                        newFrame->ip = runRegisterTier(fiber, newFrame, 0);
+                }
             }
             else if (callee.isNative())
             {
@@ -987,7 +1105,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             }
             else if (callee.isStruct())
             {
-                int index = callee.as.integer;
+                int index = callee.asId();
 
                 StructDef *def = structs[index];
 
@@ -998,8 +1116,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
 
                 Value value = makeStructInstance();
-                StructInstance *instance = value.as.sInstance;
-                instance->marked = 0;
+                StructInstance *instance = value.asStructInstance();
                 instance->def = def;
 
                 instance->values.reserve(def->argCount);
@@ -1024,6 +1141,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 Value value = makeClassInstance();
                 ClassInstance *instance = value.asClassInstance();
                 instance->klass = klass;
+                instance->shape = getClassShape(klass);
                 instance->fields.reserve(klass->fieldCount);
 
                 // Inicializa fields com valores default ou nil
@@ -1040,7 +1158,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
 
                 // Verifica se há NativeClass na cadeia de herança (direta ou indireta)
-                NativeClassDef *nativeKlass = instance->getNativeSuperclass();
+                NativeClassDef *nativeKlass = instance->shape->nativeBase;
                 if (nativeKlass)
                 {
                     // Chama constructor nativo se existir (retorna userData)
@@ -1114,7 +1232,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
                 Value literal = makeNativeClassInstance(klass->persistent);
                 // Cria instance wrapper
-                NativeClassInstance *instance = literal.as.sClassInstance;
+                NativeClassInstance *instance = literal.asNativeClassInstance();
 
                 instance->klass = klass;
                 instance->userData = userData;
@@ -1141,7 +1259,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                 Value literal = makeNativeStructInstance(def->persistent);
                 // Cria instance wrapper
-                NativeStructInstance *instance = literal.as.sNativeStruct;
+                NativeStructInstance *instance = literal.asNativeStructInstance();
 
                 instance->def = def;
                 instance->data = data;
@@ -1154,9 +1272,9 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             }
             else if (callee.isModuleRef())
             {
-                uint32 packed = callee.as.unsignedInteger;
-                uint16 moduleId = (callee.as.unsignedInteger >> 16) & 0xFFFF;
-                uint16 funcId = callee.as.unsignedInteger & 0xFFFF;
+                uint32 packed = callee.asModuleRef();
+                uint16 moduleId = (callee.asModuleRef() >> 16) & 0xFFFF;
+                uint16 funcId = callee.asModuleRef() & 0xFFFF;
 
                 if (moduleId >= modules.size())
                 {
@@ -1248,6 +1366,47 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             break;
         }
 
+        // Callee e aridade resolvidos pelo compilador; o OP_CALL argc vem a seguir
+        case OP_CALL_DIRECT:
+        {
+            uint16 index = READ_SHORT();
+            uint8 argCount = ip[1];
+            Value callee = NPEEK(argCount);
+
+            // O global foi reatribuído: corre o OP_CALL genérico
+            if (!callee.isFunction() || callee.asFunctionId() != index)
+                break;
+
+            Function *targetFunc = functions[index];
+            ip += 2;
+            STORE_FRAME();
+
+            // Como no OP_CALL: o erro sai com o ip/linha desta chamada
+            if (fiber->frameCount >= FRAMES_MAX)
+            {
+                runtimeError("Stack overflow");
+                return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
+            }
+
+            CallFrame *newFrame = &fiber->frames[fiber->frameCount++];
+            newFrame->func = targetFunc;
+            newFrame->closure = nullptr;
+            newFrame->ip = targetFunc->chunk->code;
+            newFrame->slots = fiber->stackTop - argCount - 1;
+
+            if (registerTierEnabled_)
+            {
+                if (!targetFunc->regCode && !targetFunc->regTierFailed &&
+                    ++targetFunc->callCount >= REGISTER_TIER_THRESHOLD)
+                    promoteToRegisterTier(targetFunc);
+                if (targetFunc->regCode)
+                    newFrame->ip = runRegisterTier(fiber, newFrame, 0);
+            }
+
+            LOAD_FRAME();
+            break;
+        }
+
         case OP_RETURN:
         {
 
@@ -1268,6 +1427,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 {
                     Upvalue *upvalue = openUpvalues;
                     upvalue->closed = *upvalue->location;
+                    writeBarrier(upvalue, upvalue->closed);
                     upvalue->location = &upvalue->closed;
                     openUpvalues = upvalue->nextOpen;
                 }
@@ -1341,6 +1501,10 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             *fiber->stackTop++ = result;
             LOAD_FRAME();
 
+            // Caller no register tier: continua lá depois do OP_CALL
+            if (func->regCode && registerTierEnabled_)
+                ip = resumeRegisterTier(fiber, frame, ip);
+
             break;
         }
 
@@ -1370,6 +1534,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 {
                     Upvalue *upvalue = openUpvalues;
                     upvalue->closed = *upvalue->location;
+                    writeBarrier(upvalue, upvalue->closed);
                     upvalue->location = &upvalue->closed;
                     openUpvalues = upvalue->nextOpen;
                 }
@@ -1623,10 +1788,86 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
             // ========== PROPERTY ACCESS ==========
 
+        // Private de outro processo com índice resolvido pelo compilador. O IC
+        // de class/struct vem primeiro, no mesmo case: um p.x num struct não
+        // paga nada a mais; senão cai no OP_GET_PROPERTY com ip já no nome
+        case OP_GET_PROC_PRIVATE:
+        {
+            uint8 privateIdx = READ_BYTE();
+            Value object = PEEK();
+            PropertyCache *cache = &func->chunk->propertyCaches[(uint16)((ip[2] << 8) | ip[3])];
+            if (object.isClassInstance())
+            {
+                ClassInstance *instance = object.asClassInstance();
+                int slot = cache->find(instance->shape);
+                if (slot >= 0)
+                {
+                    propertyCacheHits++;
+                    ip += 4; // name, cache
+                    DROP();
+                    PUSH(instance->fields[slot]);
+                    break;
+                }
+            }
+            else if (object.isStructInstance())
+            {
+                StructInstance *inst = object.asStructInstance();
+                int slot = inst ? cache->find(inst->def) : -1;
+                if (slot >= 0)
+                {
+                    propertyCacheHits++;
+                    ip += 4;
+                    DROP();
+                    PUSH(inst->values[slot]);
+                    break;
+                }
+            }
+            else if (object.isProcessInstance())
+            {
+                Process *proc = object.asProcess();
+                if (proc && proc->state != FiberState::DEAD)
+                {
+                    ip += 4;
+                    DROP();
+                    PUSH(proc->privates[privateIdx]);
+                    break;
+                }
+            }
+        }
+            [[fallthrough]];
         case OP_GET_PROPERTY:
         {
             Value object = PEEK();
             Value nameValue = READ_CONSTANT();
+            PropertyCache *cache = &func->chunk->propertyCaches[READ_SHORT()];
+
+            // === INLINE CACHE (class/struct já vistos nesta instrução) ===
+            if (object.isClassInstance())
+            {
+                ClassInstance *instance = object.asClassInstance();
+                int slot = cache->find(instance->shape);
+                if (slot >= 0)
+                {
+                    propertyCacheHits++;
+                    DROP();
+                    PUSH(instance->fields[slot]);
+                    break;
+                }
+                propertyCacheMisses++;
+            }
+            else if (object.isStructInstance())
+            {
+                StructInstance *inst = object.asStructInstance();
+                int slot = inst ? cache->find(inst->def) : -1;
+                if (slot >= 0)
+                {
+                    propertyCacheHits++;
+                    DROP();
+                    PUSH(inst->values[slot]);
+                    break;
+                }
+                propertyCacheMisses++;
+            }
 
             // printf("\nGet Object: '");
             // printValue(object);
@@ -1702,6 +1943,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     uint8 value = 0;
                     if (inst->def->names.get(nameValue.asString(), &value))
                     {
+                        cache->add(inst->def, value);
 
                         DROP();
                         PUSH(inst->values[value]);
@@ -1718,24 +1960,22 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 {
                     ClassInstance *instance = object.asClassInstance();
 
-                    // bool inherited = instance->klass->inherited;
-
-                    uint8_t fieldIdx;
-                    if (instance->klass->fieldNames.get(nameValue.asString(), &fieldIdx))
+                    // Shape: fields (próprios/herdados) e properties nativas num só lookup
+                    ShapeSlot shapeSlot;
+                    if (instance->shape->find(nameValue.asString(), &shapeSlot))
                     {
                         DROP();
-                        PUSH(instance->fields[fieldIdx]);
-                        break;
-                    }
-
-                    // Verifica propriedades herdadas da NativeClass
-                    NativeProperty nativeProp;
-                    if (instance->getNativeProperty(nameValue.asString(), &nativeProp))
-                    {
-                        DROP(); // Remove object
-                        // Chama getter nativo com userData do híbrido
-                        Value result = nativeProp.getter(this, instance->nativeUserData);
-                        PUSH(result);
+                        if (shapeSlot.kind == ShapeSlotKind::FIELD)
+                        {
+                            cache->add(instance->shape, shapeSlot.index);
+                            PUSH(instance->fields[shapeSlot.index]);
+                        }
+                        else
+                        {
+                            // Chama getter nativo com userData do híbrido
+                            const NativeProperty &nativeProp = instance->shape->nativeProps[shapeSlot.index];
+                            PUSH(nativeProp.getter(this, instance->nativeUserData));
+                        }
                         break;
                     }
 
@@ -1859,12 +2099,101 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             PUSH(makeNil());
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
+
+        case OP_SET_PROC_PRIVATE:
+        {
+            uint8 privateIdx = READ_BYTE();
+            Value value = PEEK();
+            Value object = PEEK2();
+            PropertyCache *cache = &func->chunk->propertyCaches[(uint16)((ip[2] << 8) | ip[3])];
+            if (object.isClassInstance())
+            {
+                ClassInstance *instance = object.asClassInstance();
+                int slot = cache->find(instance->shape);
+                if (slot >= 0)
+                {
+                    propertyCacheHits++;
+                    ip += 4; // name, cache
+                    instance->fields[slot] = value;
+                    writeBarrier(instance, value);
+                    DROP();
+                    DROP();
+                    PUSH(value);
+                    break;
+                }
+            }
+            else if (object.isStructInstance())
+            {
+                StructInstance *inst = object.asStructInstance();
+                int slot = inst ? cache->find(inst->def) : -1;
+                if (slot >= 0)
+                {
+                    propertyCacheHits++;
+                    ip += 4;
+                    inst->values[slot] = value;
+                    writeBarrier(inst, value);
+                    DROP();
+                    DROP();
+                    PUSH(value);
+                    break;
+                }
+            }
+            else if (object.isProcessInstance())
+            {
+                Process *proc = object.asProcess();
+                if (proc && proc->state != FiberState::DEAD)
+                {
+                    ip += 4;
+                    proc->privates[privateIdx] = value;
+                    DROP();
+                    DROP();
+                    PUSH(value);
+                    break;
+                }
+            }
+        }
+            [[fallthrough]];
         case OP_SET_PROPERTY:
         {
             // Stack: [object, value]
             Value value = PEEK();
             Value object = PEEK2();
             Value nameValue = READ_CONSTANT();
+            PropertyCache *cache = &func->chunk->propertyCaches[READ_SHORT()];
+
+            // === INLINE CACHE (class/struct já vistos nesta instrução) ===
+            if (object.isClassInstance())
+            {
+                ClassInstance *instance = object.asClassInstance();
+                int slot = cache->find(instance->shape);
+                if (slot >= 0)
+                {
+                    propertyCacheHits++;
+                    instance->fields[slot] = value;
+                    writeBarrier(instance, value);
+                    DROP();      // Remove value
+                    DROP();      // Remove object
+                    PUSH(value); // Push value back
+                    break;
+                }
+                propertyCacheMisses++;
+            }
+            else if (object.isStructInstance())
+            {
+                StructInstance *inst = object.asStructInstance();
+                int slot = inst ? cache->find(inst->def) : -1;
+                if (slot >= 0)
+                {
+                    propertyCacheHits++;
+                    inst->values[slot] = value;
+                    writeBarrier(inst, value);
+                    DROP();      // Remove value
+                    DROP();      // Remove object
+                    PUSH(value); // Push value back
+                    break;
+                }
+                propertyCacheMisses++;
+            }
 
             // printf("Set Value: '");
             // printValue(value);
@@ -1937,7 +2266,9 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 uint8 valueIndex = 0;
                 if (inst->def->names.get(nameValue.asString(), &valueIndex))
                 {
+                    cache->add(inst->def, valueIndex);
                     inst->values[valueIndex] = value;
+                    writeBarrier(inst, value);
                 }
                 else
                 {
@@ -1956,10 +2287,13 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             {
                 ClassInstance *instance = object.asClassInstance();
 
-                uint8_t fieldIdx;
-                if (instance->klass->fieldNames.get(nameValue.asString(), &fieldIdx))
+                ShapeSlot shapeSlot;
+                bool found = instance->shape->find(nameValue.asString(), &shapeSlot);
+                if (found && shapeSlot.kind == ShapeSlotKind::FIELD)
                 {
-                    instance->fields[fieldIdx] = value;
+                    cache->add(instance->shape, shapeSlot.index);
+                    instance->fields[shapeSlot.index] = value;
+                    writeBarrier(instance, value);
                     // Stack: [obj, value] -> queremos [value]
                     DROP();      // Remove value
                     DROP();      // Remove object
@@ -1967,10 +2301,10 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     break;
                 }
 
-                // Verifica propriedades herdadas da NativeClass
-                NativeProperty nativeProp;
-                if (instance->getNativeProperty(nameValue.asString(), &nativeProp))
+                // Property herdada da NativeClass
+                if (found)
                 {
+                    const NativeProperty &nativeProp = instance->shape->nativeProps[shapeSlot.index];
                     if (!nativeProp.setter)
                     {
                         runtimeError("Property '%s' is read-only", name);
@@ -2118,7 +2452,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                     }
                     String **fieldPtr = (String **)ptr;
-                    *fieldPtr = value.asString();
+                    // A struct nativa guarda o ponteiro fora do alcance do GC
+                    *fieldPtr = stringPool.intern(value.asString());
                     break;
                 }
                 }
@@ -2142,10 +2477,13 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
             break;
         }
+        case OP_INVOKE_BUILTIN:
         case OP_INVOKE:
         {
+            // OP_INVOKE_BUILTIN traz o id de StaticNames resolvido pelo compilador
             Value nameValue = READ_CONSTANT();
             uint8_t argCount = READ_BYTE();
+            int methodId = (instruction == OP_INVOKE_BUILTIN) ? (int)READ_BYTE() : -1;
 
             if (!nameValue.isString())
             {
@@ -2156,6 +2494,10 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             const char *name = nameValue.asStringChars();
             Value receiver = NPEEK(argCount);
 
+            // OP_INVOKE genérico: resolve o id em runtime
+            if (methodId < 0 && (receiver.isString() || receiver.isArray() || receiver.isMap() || receiver.isBuffer()))
+                methodId = getStaticNameId(nameValue.asString());
+
 #define ARGS_CLEANUP() fiber->stackTop -= (argCount + 1)
 
             // === STRING METHODS ===
@@ -2163,23 +2505,23 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             {
                 String *str = receiver.asString();
 
-                if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LENGTH]))
+                if (methodId == (int)StaticNames::LENGTH)
                 {
                     int len = str->length();
                     ARGS_CLEANUP();
                     PUSH(makeInt(len));
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::UPPER]))
+                else if (methodId == (int)StaticNames::UPPER)
                 {
                     ARGS_CLEANUP();
                     PUSH(makeString(stringPool.upper(str)));
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LOWER]))
+                else if (methodId == (int)StaticNames::LOWER)
                 {
                     ARGS_CLEANUP();
                     PUSH(makeString(stringPool.lower(str)));
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CONCAT]))
+                else if (methodId == (int)StaticNames::CONCAT)
                 {
                     if (argCount != 1)
                     {
@@ -2198,7 +2540,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     ARGS_CLEANUP();
                     PUSH(makeString(result));
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SUB]))
+                else if (methodId == (int)StaticNames::SUB)
                 {
                     if (argCount != 2)
                     {
@@ -2222,7 +2564,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     ARGS_CLEANUP();
                     PUSH(makeString(result));
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REPLACE]))
+                else if (methodId == (int)StaticNames::REPLACE)
                 {
                     if (argCount != 2)
                     {
@@ -2246,7 +2588,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     ARGS_CLEANUP();
                     PUSH(makeString(result));
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::AT]))
+                else if (methodId == (int)StaticNames::AT)
                 {
                     if (argCount != 1)
                     {
@@ -2266,7 +2608,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeString(result));
                 }
 
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CONTAINS]))
+                else if (methodId == (int)StaticNames::CONTAINS)
                 {
                     if (argCount != 1)
                     {
@@ -2286,14 +2628,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeBool(result));
                 }
 
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::TRIM]))
+                else if (methodId == (int)StaticNames::TRIM)
                 {
                     String *result = stringPool.trim(str);
                     ARGS_CLEANUP();
                     PUSH(makeString(result));
                 }
 
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::STARTWITH]))
+                else if (methodId == (int)StaticNames::STARTWITH)
                 {
                     if (argCount != 1)
                     {
@@ -2313,7 +2655,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeBool(result));
                 }
 
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::ENDWITH]))
+                else if (methodId == (int)StaticNames::ENDWITH)
                 {
                     if (argCount != 1)
                     {
@@ -2333,7 +2675,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeBool(result));
                 }
 
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::INDEXOF]))
+                else if (methodId == (int)StaticNames::INDEXOF)
                 {
                     if (argCount < 1 || argCount > 2)
                     {
@@ -2377,7 +2719,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     ARGS_CLEANUP();
                     PUSH(makeInt(result));
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REPEAT]))
+                else if (methodId == (int)StaticNames::REPEAT)
                 {
                     if (argCount != 1)
                     {
@@ -2396,7 +2738,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     ARGS_CLEANUP();
                     PUSH(makeString(result));
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SPLIT]))
+                else if (methodId == (int)StaticNames::SPLIT)
                 {
                     if (argCount != 1)
                     {
@@ -2428,14 +2770,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                             // Cria string de 1 char
                             char buf[2] = {strChars[i], '\0'};
 
-                            ptr->values.push(makeString(createString(buf, 1)));
+                            ptr->values.push(makeString(createRuntimeString(buf, 1)));
                         }
                     }
                     else
                     {
                         // CASO 2: Split Normal
 
-                        const char *start = separator;
+                        const char *start = strChars;
                         const char *end = strChars + strLen;
                         const char *current = start;
                         const char *found = nullptr;
@@ -2444,8 +2786,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         {
                             int partLen = found - current;
 
-                            // create() já trata de alocar e internar a string
-                            ptr->values.push(makeString(createString(current, partLen)));
+                            // String de runtime: o array mantém-na viva
+                            ptr->values.push(makeString(createRuntimeString(current, partLen)));
 
                             // Avança ponteiro
                             current = found + sepLen;
@@ -2456,7 +2798,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         int remaining = end - current;
                         if (remaining >= 0)
                         {
-                            ptr->values.push(makeString(createString(current, remaining)));
+                            ptr->values.push(makeString(createRuntimeString(current, remaining)));
                         }
                     }
 
@@ -2476,7 +2818,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             {
                 ArrayInstance *arr = receiver.asArray();
                 uint32 size = arr->values.size();
-                if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::PUSH]))
+                if (methodId == (int)StaticNames::PUSH)
                 {
                     if (argCount != 1)
                     {
@@ -2485,13 +2827,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
                     Value item = PEEK();
                     arr->values.push(item);
+                    writeBarrier(arr, item);
 
                     ARGS_CLEANUP();
 
                     PUSH(receiver);
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::POP]))
+                else if (methodId == (int)StaticNames::POP)
                 {
                     if (argCount != 0)
                     {
@@ -2515,7 +2858,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::BACK]))
+                else if (methodId == (int)StaticNames::BACK)
                 {
                     if (argCount != 0)
                     {
@@ -2538,7 +2881,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LENGTH]))
+                else if (methodId == (int)StaticNames::LENGTH)
                 {
                     if (argCount != 0)
                     {
@@ -2550,7 +2893,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeInt(size));
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CLEAR]))
+                else if (methodId == (int)StaticNames::CLEAR)
                 {
                     if (argCount != 0)
                     {
@@ -2562,7 +2905,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(receiver);
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REMOVE]))
+                else if (methodId == (int)StaticNames::REMOVE)
                 {
                     if (argCount != 1)
                     {
@@ -2582,7 +2925,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(receiver);
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::INSERT]))
+                else if (methodId == (int)StaticNames::INSERT)
                 {
                     if (argCount != 2)
                     {
@@ -2603,11 +2946,12 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
                     Value item = NPEEK(0);
                     arr->values.insert(valueindex, item);
+                    writeBarrier(arr, item);
                     ARGS_CLEANUP();
                     PUSH(receiver);
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::FIND]))
+                else if (methodId == (int)StaticNames::FIND)
                 {
                     if (argCount != 1)
                     {
@@ -2629,7 +2973,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeInt(foundIndex));
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CONTAINS]))
+                else if (methodId == (int)StaticNames::CONTAINS)
                 {
                     if (argCount != 1)
                     {
@@ -2650,7 +2994,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeBool(found));
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REVERSE]))
+                else if (methodId == (int)StaticNames::REVERSE)
                 {
                     if (argCount != 0)
                     {
@@ -2664,7 +3008,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(receiver);
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SLICE]))
+                else if (methodId == (int)StaticNames::SLICE)
                 {
                     if (argCount < 1 || argCount > 2)
                     {
@@ -2707,7 +3051,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(newArray);
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CONCAT]))
+                else if (methodId == (int)StaticNames::CONCAT)
                 {
                     if (argCount != 1)
                     {
@@ -2738,7 +3082,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(newArray);
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::FIRST]))
+                else if (methodId == (int)StaticNames::FIRST)
                 {
                     if (argCount != 0)
                     {
@@ -2758,7 +3102,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LAST]))
+                else if (methodId == (int)StaticNames::LAST)
                 {
                     if (argCount != 0)
                     {
@@ -2778,7 +3122,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::FILL]))
+                else if (methodId == (int)StaticNames::FILL)
                 {
                     if (argCount != 1)
                     {
@@ -2787,6 +3131,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     Value fillValue = PEEK();
+                    writeBarrier(arr, fillValue);
 
                     for (uint32 i = 0; i < size; i++)
                     {
@@ -2809,7 +3154,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             {
                 MapInstance *map = receiver.asMap();
 
-                if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::HAS]))
+                if (methodId == (int)StaticNames::HAS)
                 {
                     if (argCount != 1)
                     {
@@ -2832,7 +3177,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeBool(exists));
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REMOVE]))
+                else if (methodId == (int)StaticNames::REMOVE)
                 {
                     if (argCount != 1)
                     {
@@ -2850,11 +3195,12 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                   
                     map->table.set(key.asString(), makeNil());
+                    writeBarrier(map, key);
                     ARGS_CLEANUP();
                     PUSH(makeNil());
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CLEAR]))
+                else if (methodId == (int)StaticNames::CLEAR)
                 {
                     if (argCount != 0)
                     {
@@ -2867,7 +3213,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeNil());
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LENGTH]))
+                else if (methodId == (int)StaticNames::LENGTH)
                 {
                     if (argCount != 0)
                     {
@@ -2878,7 +3224,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeInt(map->table.count));
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::KEYS]))
+                else if (methodId == (int)StaticNames::KEYS)
                 {
                     if (argCount != 0)
                     {
@@ -2897,7 +3243,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(keys);
                     break;
                 }
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::VALUES]))
+                else if (methodId == (int)StaticNames::VALUES)
                 {
                     if (argCount != 0)
                     {
@@ -3032,7 +3378,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                 // buf.fill(value)
 
-                if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::FILL]))
+                if (methodId == (int)StaticNames::FILL)
                 {
                     if (argCount != 1)
                     {
@@ -3188,7 +3534,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
 
                 //   copy(dstOffset, srcBuffer, srcOffset, count)
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::COPY]))
+                else if (methodId == (int)StaticNames::COPY)
                 {
                     if (argCount != 4)
                     {
@@ -3265,7 +3611,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
 
                 // buf.slice(start, end)
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SLICE]))
+                else if (methodId == (int)StaticNames::SLICE)
                 {
                     if (argCount != 2)
                     {
@@ -3323,7 +3669,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
 
                 // buf.clear()
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::CLEAR]))
+                else if (methodId == (int)StaticNames::CLEAR)
                 {
                     if (argCount != 0)
                     {
@@ -3339,7 +3685,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
 
                 // buf.length()
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::LENGTH]))
+                else if (methodId == (int)StaticNames::LENGTH)
                 {
                     if (argCount != 0)
                     {
@@ -3351,7 +3697,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     PUSH(makeInt(buf->count));
                     break;
                 } // buf.save(filename) - Salva dados RAW
-                else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SAVE]))
+                else if (methodId == (int)StaticNames::SAVE)
                 {
                     if (argCount != 1)
                     {
@@ -3389,7 +3735,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     // ========================================
 
                     // buf.writeByte(value)
-                    if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_BYTE]))
+                    if (methodId == (int)StaticNames::WRITE_BYTE)
                     {
                         if (argCount != 1)
                         {
@@ -3412,7 +3758,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.writeShort(value) - int16
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_SHORT]))
+                    else if (methodId == (int)StaticNames::WRITE_SHORT)
                     {
                         if (argCount != 1)
                         {
@@ -3436,7 +3782,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.writeUShort(value) - uint16
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_USHORT]))
+                    else if (methodId == (int)StaticNames::WRITE_USHORT)
                     {
                         if (argCount != 1)
                         {
@@ -3460,7 +3806,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.writeInt(value) - int32
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_INT]))
+                    else if (methodId == (int)StaticNames::WRITE_INT)
                     {
                         if (argCount != 1)
                         {
@@ -3484,7 +3830,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.writeUInt(value) - uint32 (aceita double para valores > 2^31)
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_UINT]))
+                    else if (methodId == (int)StaticNames::WRITE_UINT)
                     {
                         if (argCount != 1)
                         {
@@ -3509,7 +3855,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.writeFloat(value)
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_FLOAT]))
+                    else if (methodId == (int)StaticNames::WRITE_FLOAT)
                     {
                         if (argCount != 1)
                         {
@@ -3533,7 +3879,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.writeDouble(value)
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_DOUBLE]))
+                    else if (methodId == (int)StaticNames::WRITE_DOUBLE)
                     {
                         if (argCount != 1)
                         {
@@ -3557,7 +3903,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.writeString(str) - Escreve bytes da string (UTF-8)
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::WRITE_STRING]))
+                    else if (methodId == (int)StaticNames::WRITE_STRING)
                     {
                         if (argCount != 1)
                         {
@@ -3594,7 +3940,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     // ========================================
 
                     // buf.readByte()
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_BYTE]))
+                    else if (methodId == (int)StaticNames::READ_BYTE)
                     {
                         if (argCount != 0)
                         {
@@ -3617,7 +3963,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.readShort()
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_SHORT]))
+                    else if (methodId == (int)StaticNames::READ_SHORT)
                     {
                         if (argCount != 0)
                         {
@@ -3641,7 +3987,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.readUShort()
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_USHORT]))
+                    else if (methodId == (int)StaticNames::READ_USHORT)
                     {
                         if (argCount != 0)
                         {
@@ -3665,7 +4011,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.readInt()
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_INT]))
+                    else if (methodId == (int)StaticNames::READ_INT)
                     {
                         if (argCount != 0)
                         {
@@ -3689,7 +4035,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.readUInt() - Retorna como double (para valores > 2^31)
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_UINT]))
+                    else if (methodId == (int)StaticNames::READ_UINT)
                     {
                         if (argCount != 0)
                         {
@@ -3713,7 +4059,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.readFloat()
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_FLOAT]))
+                    else if (methodId == (int)StaticNames::READ_FLOAT)
                     {
                         if (argCount != 0)
                         {
@@ -3737,7 +4083,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.readDouble()
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_DOUBLE]))
+                    else if (methodId == (int)StaticNames::READ_DOUBLE)
                     {
                         if (argCount != 0)
                         {
@@ -3761,7 +4107,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.readString(length)
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::READ_STRING]))
+                    else if (methodId == (int)StaticNames::READ_STRING)
                     {
                         if (argCount != 1)
                         {
@@ -3794,7 +4140,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         memcpy(temp, buf->data + buf->cursor, length);
                         temp[length] = 0;
 
-                        String *str = createString(temp);
+                        String *str = createRuntimeString(temp);
                         free(temp);
 
                         buf->cursor += length;
@@ -3809,7 +4155,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     // ========================================
 
                     // buf.seek(position)
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SEEK]))
+                    else if (methodId == (int)StaticNames::SEEK)
                     {
                         if (argCount != 1)
                         {
@@ -3840,7 +4186,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.tell()
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::TELL]))
+                    else if (methodId == (int)StaticNames::TELL)
                     {
                         if (argCount != 0)
                         {
@@ -3854,7 +4200,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.rewind()
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REWIND]))
+                    else if (methodId == (int)StaticNames::REWIND)
                     {
                         if (argCount != 0)
                         {
@@ -3870,7 +4216,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.skip(bytes)
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::SKIP]))
+                    else if (methodId == (int)StaticNames::SKIP)
                     {
                         if (argCount != 1)
                         {
@@ -3900,7 +4246,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // buf.remaining()
-                    else if (compare_strings(nameValue.asString(), staticNames[(int)StaticNames::REMAINING]))
+                    else if (methodId == (int)StaticNames::REMAINING)
                     {
                         if (argCount != 0)
                         {
@@ -4110,6 +4456,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 else
                 {
                     arr->values[i] = value;
+                    writeBarrier(arr, value);
                 }
 
                 PUSH(value); // Assignment returns value
@@ -4127,6 +4474,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                 MapInstance *map = container.asMap();
                 map->table.set(index.asString(), value);
+                writeBarrier(map, index);
+                writeBarrier(map, value);
 
                 PUSH(value); // Assignment returns value
                 break;
@@ -4384,8 +4733,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 return {FiberResult::ERROR, instructionsRun, 0, 0};
             }
 
-            ArrayInstance *array = seq.as.array;
-            int index = iter.isNil() ? 0 : iter.as.integer + 1;
+            ArrayInstance *array = seq.asArray();
+            int index = iter.isNil() ? 0 : iter.asInt() + 1;
 
             if (index < (int)array->values.size())
             {
@@ -4414,8 +4763,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
 
-            ArrayInstance *array = seq.as.array;
-            int index = iter.as.integer;
+            ArrayInstance *array = seq.asArray();
+            int index = iter.asInt();
 
             if (index < 0 || index >= (int)array->values.size())
             {
@@ -4457,6 +4806,31 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             break;
         }
 
+        case OP_PICK:
+        {
+            uint8_t depth = READ_BYTE();
+            Value v = NPEEK(depth);
+            PUSH(v);
+            break;
+        }
+
+        case OP_SLIDE:
+        {
+            uint8_t count = READ_BYTE();
+            Value result = POP();
+            fiber->stackTop -= count;
+            PUSH(result);
+            break;
+        }
+
+        case OP_SWITCH_TABLE:
+        {
+            const SwitchTable *table = &func->chunk->switchTables[READ_SHORT()];
+            Value value = POP();
+            ip = func->chunk->code + table->targets[switchTableCase(table, value)];
+            break;
+        }
+
         case OP_TRY:
         {
             uint16_t catchAddr = READ_SHORT();
@@ -4476,6 +4850,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             handler.pendingError = makeNil();
             handler.hasPendingError = false;
             handler.catchConsumed = false;
+            handler.hasPendingReturn = false;
+            handler.pendingReturnCount = 0;
 
             fiber->tryDepth++;
             break;
@@ -5029,7 +5405,6 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
                 // Info("Free  Struct address: %p", (void*)instance);
-                instance->marked = 1;
                 freed = true;
             }
             else if (object.isClassInstance())
@@ -5040,7 +5415,6 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     runtimeError("Class instance is nil");
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
-                instance->marked = 1;
                 freed = true;
             }
             else if (object.isNativeClassInstance())
@@ -5051,7 +5425,6 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     runtimeError("Native class instance is nil");
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
-                instance->marked = 1;
                 freed = true;
             }
             else if (object.isNativeStructInstance())
@@ -5063,7 +5436,6 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
                 // Info("Free  Native Struct address: %p", (void*)instance);
-                instance->marked = 1;
                 freed = true;
             }
             else if (object.isBuffer())
@@ -5074,7 +5446,6 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     runtimeError("Buffer instance is nil");
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
-                instance->marked = 1;
                 freed = true;
             }
             else if (object.isMap())
@@ -5086,7 +5457,6 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     runtimeError("Map instance is nil");
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
-                instance->marked = 1;
                 freed = true;
             }
             else if (object.isArray())
@@ -5097,7 +5467,6 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     runtimeError("Array instance is nil");
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
-                instance->marked = 1;
                 freed = true;
             }
 
@@ -5111,7 +5480,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             int funcID = funcVal.asFunctionId();
             Function *function = functions[funcID];
             Value closure = makeClosure();
-            Closure *closurePtr = closure.as.closure;
+            Closure *closurePtr = closure.asClosure();
             closurePtr->functionId = funcID;
             closurePtr->upvalueCount = function->upvalueCount;
 
@@ -5213,7 +5582,9 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
 
-            *frame->closure->upvalues[slot]->location = PEEK();
+            Upvalue *upvalue = frame->closure->upvalues[slot];
+            *upvalue->location = PEEK();
+            writeBarrier(upvalue, PEEK());
             break;
         }
 
@@ -5224,6 +5595,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             {
                 Upvalue *upvalue = openUpvalues;
                 upvalue->closed = *upvalue->location;
+                writeBarrier(upvalue, upvalue->closed);
                 upvalue->location = &upvalue->closed;
                 openUpvalues = upvalue->nextOpen;
             }
@@ -5290,6 +5662,118 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             break;
         }
 
+        // ============================================
+        // QUICKENED ARITHMETIC / COMPARISON
+        // ============================================
+        case OP_ADD_II:
+            QUICK_BINARY_OP(isInt, asInt, makeInt, +, OP_ADD);
+            break;
+        case OP_ADD_DD:
+            QUICK_BINARY_OP(isDouble, asDouble, makeDouble, +, OP_ADD);
+            break;
+        case OP_SUBTRACT_II:
+            QUICK_BINARY_OP(isInt, asInt, makeInt, -, OP_SUBTRACT);
+            break;
+        case OP_SUBTRACT_DD:
+            QUICK_BINARY_OP(isDouble, asDouble, makeDouble, -, OP_SUBTRACT);
+            break;
+        case OP_MULTIPLY_II:
+            QUICK_BINARY_OP(isInt, asInt, makeInt, *, OP_MULTIPLY);
+            break;
+        case OP_MULTIPLY_DD:
+            QUICK_BINARY_OP(isDouble, asDouble, makeDouble, *, OP_MULTIPLY);
+            break;
+        case OP_LESS_II:
+            QUICK_BINARY_OP(isInt, asInt, makeBool, <, OP_LESS);
+            break;
+        case OP_LESS_DD:
+            QUICK_BINARY_OP(isDouble, asDouble, makeBool, <, OP_LESS);
+            break;
+        case OP_GREATER_II:
+            QUICK_BINARY_OP(isInt, asInt, makeBool, >, OP_GREATER);
+            break;
+        case OP_GREATER_DD:
+            QUICK_BINARY_OP(isDouble, asDouble, makeBool, >, OP_GREATER);
+            break;
+
+        // ========== SUPERINSTRUCTIONS ==========
+        // ip aponta para o operando do GET original; seq percorre os bytes que
+        // o compilador deixou no chunk. Fallback = executar como o GET.
+
+        case OP_INC_LOCAL:
+        {
+            uint8 *seq = ip + 1;
+            Value old = stackStart[ip[0]];
+            bool postfix = (seq[0] == OP_DUP);
+            seq += postfix;
+            Value rhs, result;
+            bool ok;
+            SUPER_OPERAND(seq, rhs);
+            SUPER_ARITH(old, rhs, SUPER_IS_SUB(seq[0]), result, ok);
+            if (!ok)
+            {
+                PUSH(old);
+                ip++;
+                break;
+            }
+            stackStart[ip[0]] = result;
+            PUSH(postfix ? old : result);
+            ip = seq + 3 + postfix; // ADD|SUBTRACT, SET_LOCAL s [, POP]
+            break;
+        }
+
+        case OP_INC_PRIVATE:
+        {
+            uint8 *seq = ip + 1;
+            Value old = process->privates[ip[0]];
+            bool postfix = (seq[0] == OP_DUP);
+            seq += postfix;
+            Value rhs, result;
+            bool ok;
+            SUPER_OPERAND(seq, rhs);
+            SUPER_ARITH(old, rhs, SUPER_IS_SUB(seq[0]), result, ok);
+            if (!ok)
+            {
+                PUSH(old);
+                ip++;
+                break;
+            }
+            process->privates[ip[0]] = result;
+            PUSH(postfix ? old : result);
+            ip = seq + 3 + postfix; // ADD|SUBTRACT, SET_PRIVATE p [, POP]
+            break;
+        }
+
+        case OP_CMP_LOCAL_JUMP:
+        {
+            uint8 *seq = ip + 1;
+            Value lhs = stackStart[ip[0]];
+            Value rhs;
+            SUPER_OPERAND(seq, rhs);
+            bool less = SUPER_IS_LESS(seq[0]);
+            bool result;
+            double da, db;
+            if (lhs.isInt() && rhs.isInt())
+                result = less ? lhs.asInt() < rhs.asInt() : lhs.asInt() > rhs.asInt();
+            else if (toNumberPair(lhs, rhs, da, db))
+                result = less ? da < db : da > db;
+            else
+            {
+                PUSH(lhs);
+                ip++;
+                break;
+            }
+            ip = seq + 4; // LESS|GREATER, JUMP_IF_FALSE hi lo
+            if (!result)
+                ip += (uint16)((seq[2] << 8) | seq[3]);
+            // if/while/for fazem OP_POP da condição nos dois destinos: nem chega a ser empilhada
+            if (*ip == OP_POP)
+                ip++;
+            else
+                PUSH(makeBool(result));
+            break;
+        }
+
         default:
         {
             if (debugMode_)
@@ -0,0 +1,856 @@
+/**
+ * @file interpreter_runtime_tail.cpp
+ * @brief VM runtime using tail calls between per-opcode handler functions
+ *
+ * Each hot opcode is a small function that ends by tail-calling the handler
+ * of the next instruction. ip, stack top, frame slots and the constant table
+ * travel as arguments, so they stay in registers instead of spilling across
+ * one huge function like in the goto/switch loops.
+ *
+ * Only the common paths live here: locals/globals/privates, numeric
+ * arithmetic and comparisons (plus the quickened forms), jumps, script
+ * calls/returns, superinstructions, property inline-cache hits and a few math
+ * opcodes. Everything else (cold opcodes, strings, errors, exceptions,
+ * natives, frame/yield...) goes through TailDispatch::op_slow, which saves the
+ * state and lets the computed-goto loop run exactly that instruction
+ * (run_fiber_step) before coming back here.
+ *
+ * @note Compiled only with USE_TAIL_CALLS (cmake -DBU_TAIL_CALLS=ON)
+ * @note clang (and GCC >= 15) guarantee the tail calls with musttail; older
+ *       GCC relies on sibling call optimization, so build with -O2 or higher
+ */
+#include "interpreter.hpp"
+#include "opcode.hpp"
+#include "debug.hpp"
+#include <cmath>
+
+#if USE_TAIL_CALLS
+
+#ifndef USE_COMPUTED_GOTO
+#error "USE_TAIL_CALLS precisa do loop computed goto para os opcodes frios"
+#endif
+
+#if defined(__has_attribute)
+#if __has_attribute(musttail)
+#define MUSTTAIL __attribute__((musttail))
+#endif
+#endif
+#ifndef MUSTTAIL
+#define MUSTTAIL
+#endif
+
+#if USE_OPCODE_PROFILE
+#define PROFILE_OPCODE(op) Debug::profileOpcode(op)
+#else
+#define PROFILE_OPCODE(op) ((void)0)
+#endif
+
+struct TailState
+{
+    Interpreter *vm;
+    Fiber *fiber;
+    Process *process;
+};
+
+// ip aponta para depois do opcode (como depois do READ_BYTE nos outros loops)
+#define TAIL_ARGS TailState *S, uint8 *ip, Value *sp, Value *slots, const Value *K
+typedef void (*TailHandler)(TAIL_ARGS);
+
+#define NEXT()                                       \
+    do                                               \
+    {                                                \
+        PROFILE_OPCODE(*ip);                         \
+        MUSTTAIL return table[*ip](S, ip + 1, sp, slots, K); \
+    } while (0)
+
+// O loop goto executa esta instrução (ip ainda no operando)
+#define SLOW() MUSTTAIL return op_slow(S, ip, sp, slots, K)
+
+#define TAIL_GOTO(HANDLER) MUSTTAIL return HANDLER(S, ip, sp, slots, K)
+
+#define READ_U16(p) ((uint16)(((p)[0] << 8) | (p)[1]))
+#define IS_NUM(v) ((v).isInt() || (v).isDouble())
+#define NUM(v) ((v).isInt() ? (double)(v).asInt() : (v).asDouble())
+
+// Nova frame para uma função de script já validada (aridade, FRAMES_MAX)
+#define TAIL_ENTER(TARGET, ARGC)                                                   \
+    do                                                                             \
+    {                                                                              \
+        Interpreter *_vm = S->vm;                                                  \
+        Fiber *_fiber = S->fiber;                                                  \
+        _fiber->frames[_fiber->frameCount - 1].ip = ip;                            \
+        CallFrame *_nf = &_fiber->frames[_fiber->frameCount++];                    \
+        _nf->func = (TARGET);                                                      \
+        _nf->closure = nullptr;                                                    \
+        _nf->ip = (TARGET)->chunk->code;                                           \
+        _nf->slots = sp - (ARGC) - 1;                                              \
+        slots = _nf->slots;                                                        \
+        ip = _nf->ip;                                                              \
+        K = (TARGET)->chunk->constants.data;                                       \
+        if (_vm->registerTierEnabled_)                                             \
+        {                                                                          \
+            if (!(TARGET)->regCode && !(TARGET)->regTierFailed &&                  \
+                ++(TARGET)->callCount >= REGISTER_TIER_THRESHOLD)                  \
+                _vm->promoteToRegisterTier(TARGET);                                \
+            if ((TARGET)->regCode)                                                 \
+            {                                                                      \
+                _fiber->stackTop = sp;                                             \
+                ip = _vm->runRegisterTier(_fiber, _nf, 0);                         \
+                sp = _fiber->stackTop;                                             \
+            }                                                                      \
+        }                                                                          \
+        NEXT();                                                                    \
+    } while (0)
+
+// Aritmética genérica: int/int, double/double e mistos; o resto no loop goto
+#define TAIL_ARITH(OPER, OP_II, OP_DD)                                  \
+    Value a = sp[-2];                                                   \
+    Value b = sp[-1];                                                   \
+    if (a.isInt() && b.isInt())                                         \
+    {                                                                   \
+        if (S->vm->quickeningEnabled_)                                  \
+            ip[-1] = OP_II;                                             \
+        sp[-2] = Value::fromInt(a.asInt() OPER b.asInt());              \
+    }                                                                   \
+    else if (a.isDouble() && b.isDouble())                              \
+    {                                                                   \
+        if (S->vm->quickeningEnabled_)                                  \
+            ip[-1] = OP_DD;                                             \
+        sp[-2] = Value::fromDouble(a.asDouble() OPER b.asDouble());     \
+    }                                                                   \
+    else if (IS_NUM(a) && IS_NUM(b))                                    \
+        sp[-2] = Value::fromDouble(NUM(a) OPER NUM(b));                 \
+    else                                                                \
+        SLOW();                                                         \
+    sp--;                                                               \
+    NEXT()
+
+#define TAIL_COMPARE(OPER)                                              \
+    Value a = sp[-2];                                                   \
+    Value b = sp[-1];                                                   \
+    if (!IS_NUM(a) || !IS_NUM(b))                                       \
+        SLOW();                                                         \
+    sp[-2] = Value::fromBool(NUM(a) OPER NUM(b));                       \
+    sp--;                                                               \
+    NEXT()
+
+// Quickened: guard falhou -> volta ao opcode genérico
+#define TAIL_QUICK(IS, AS, FROM, OPER, GENERIC_OP, GENERIC)            \
+    if (sp[-2].IS() && sp[-1].IS())                                     \
+    {                                                                   \
+        sp[-2] = Value::FROM(sp[-2].AS() OPER sp[-1].AS());             \
+        sp--;                                                           \
+        NEXT();                                                         \
+    }                                                                   \
+    ip[-1] = GENERIC_OP;                                                \
+    TAIL_GOTO(GENERIC)
+
+#define TAIL_MATH1(EXPR)                                                \
+    Value v = sp[-1];                                                   \
+    if (!IS_NUM(v))                                                     \
+        SLOW();                                                         \
+    double d = NUM(v);                                                  \
+    sp[-1] = Value::fromDouble(EXPR);                                   \
+    NEXT()
+
+// Superinstructions: operando da direita (CONSTANT/GET_LOCAL/GET_PRIVATE)
+#define TAIL_SUPER_OPERAND(SEQ, OUT)                                    \
+    if ((SEQ)[0] == OP_CONSTANT)                                        \
+    {                                                                   \
+        OUT = K[READ_U16((SEQ) + 1)];                                   \
+        SEQ += 3;                                                       \
+    }                                                                   \
+    else                                                                \
+    {                                                                   \
+        OUT = ((SEQ)[0] == OP_GET_LOCAL) ? slots[(SEQ)[1]]              \
+                                         : S->process->privates[(SEQ)[1]]; \
+        SEQ += 2;                                                       \
+    }
+
+#define TAIL_IS_SUB(OP) ((OP) == OP_SUBTRACT || (OP) == OP_SUBTRACT_II || (OP) == OP_SUBTRACT_DD)
+#define TAIL_IS_LESS(OP) ((OP) == OP_LESS || (OP) == OP_LESS_II || (OP) == OP_LESS_DD)
+
+// GET [DUP] <rhs> ADD|SUBTRACT SET [POP] sobre VAR; senão comporta-se como o GET
+#define TAIL_SUPER_INC(VAR)                                             \
+    uint8 *seq = ip + 1;                                                \
+    Value old = VAR;                                                    \
+    bool postfix = (seq[0] == OP_DUP);                                  \
+    seq += postfix;                                                     \
+    Value rhs;                                                          \
+    TAIL_SUPER_OPERAND(seq, rhs);                                       \
+    bool sub = TAIL_IS_SUB(seq[0]);                                     \
+    Value result;                                                       \
+    if (old.isInt() && rhs.isInt())                                     \
+        result = Value::fromInt(sub ? old.asInt() - rhs.asInt() : old.asInt() + rhs.asInt()); \
+    else if (IS_NUM(old) && IS_NUM(rhs))                                \
+        result = Value::fromDouble(sub ? NUM(old) - NUM(rhs) : NUM(old) + NUM(rhs)); \
+    else                                                                \
+    {                                                                   \
+        *sp++ = old;                                                    \
+        ip++;                                                           \
+        NEXT();                                                         \
+    }                                                                   \
+    VAR = result;                                                       \
+    *sp++ = postfix ? old : result;                                     \
+    ip = seq + 3 + postfix;                                             \
+    NEXT()
+
+struct TailDispatch
+{
+    static TailHandler table[256];
+
+    static void init()
+    {
+        for (int i = 0; i < 256; i++)
+            table[i] = op_slow;
+
+        table[OP_CONSTANT] = op_constant;
+        table[OP_NIL] = op_nil;
+        table[OP_TRUE] = op_true;
+        table[OP_FALSE] = op_false;
+        table[OP_POP] = op_pop;
+        table[OP_DUP] = op_dup;
+        table[OP_NOT] = op_not;
+        table[OP_DISCARD] = op_discard;
+        table[OP_PICK] = op_pick;
+        table[OP_SLIDE] = op_slide;
+
+        table[OP_ADD] = op_add;
+        table[OP_SUBTRACT] = op_subtract;
+        table[OP_MULTIPLY] = op_multiply;
+        table[OP_DIVIDE] = op_divide;
+        table[OP_NEGATE] = op_negate;
+
+        table[OP_EQUAL] = op_equal;
+        table[OP_NOT_EQUAL] = op_not_equal;
+        table[OP_GREATER] = op_greater;
+        table[OP_GREATER_EQUAL] = op_greater_equal;
+        table[OP_LESS] = op_less;
+        table[OP_LESS_EQUAL] = op_less_equal;
+
+        table[OP_GET_LOCAL] = op_get_local;
+        table[OP_SET_LOCAL] = op_set_local;
+        table[OP_GET_GLOBAL] = op_get_global;
+        table[OP_SET_GLOBAL] = op_set_global;
+        table[OP_GET_PRIVATE] = op_get_private;
+        table[OP_SET_PRIVATE] = op_set_private;
+
+        table[OP_JUMP] = op_jump;
+        table[OP_JUMP_IF_FALSE] = op_jump_if_false;
+        table[OP_JUMP_IF_TRUE] = op_jump_if_true;
+        table[OP_LOOP] = op_loop;
+        table[OP_SWITCH_TABLE] = op_switch_table;
+
+        table[OP_CALL] = op_call;
+        table[OP_CALL_DIRECT] = op_call_direct;
+        table[OP_RETURN] = op_return;
+
+        table[OP_GET_PROPERTY] = op_get_property;
+        table[OP_SET_PROPERTY] = op_set_property;
+        table[OP_GET_PROC_PRIVATE] = op_get_proc_private;
+        table[OP_SET_PROC_PRIVATE] = op_set_proc_private;
+
+        table[OP_SIN] = op_sin;
+        table[OP_COS] = op_cos;
+        table[OP_SQRT] = op_sqrt;
+        table[OP_ATAN2] = op_atan2;
+        table[OP_POW] = op_pow;
+
+        table[OP_ADD_II] = op_add_ii;
+        table[OP_ADD_DD] = op_add_dd;
+        table[OP_SUBTRACT_II] = op_subtract_ii;
+        table[OP_SUBTRACT_DD] = op_subtract_dd;
+        table[OP_MULTIPLY_II] = op_multiply_ii;
+        table[OP_MULTIPLY_DD] = op_multiply_dd;
+        table[OP_LESS_II] = op_less_ii;
+        table[OP_LESS_DD] = op_less_dd;
+        table[OP_GREATER_II] = op_greater_ii;
+        table[OP_GREATER_DD] = op_greater_dd;
+
+        table[OP_INC_LOCAL] = op_inc_local;
+        table[OP_INC_PRIVATE] = op_inc_private;
+        table[OP_CMP_LOCAL_JUMP] = op_cmp_local_jump;
+    }
+
+    // Fim da cadeia: guarda o estado para o run_fiber_step
+    static void op_slow(TAIL_ARGS)
+    {
+        (void)slots;
+        (void)K;
+        Fiber *fiber = S->fiber;
+        fiber->frames[fiber->frameCount - 1].ip = ip - 1;
+        fiber->stackTop = sp;
+    }
+
+    // ========== LITERALS / STACK ==========
+
+    static void op_constant(TAIL_ARGS)
+    {
+        *sp++ = K[READ_U16(ip)];
+        ip += 2;
+        NEXT();
+    }
+
+    static void op_nil(TAIL_ARGS)
+    {
+        *sp++ = Value();
+        NEXT();
+    }
+
+    static void op_true(TAIL_ARGS)
+    {
+        *sp++ = Value::fromBool(true);
+        NEXT();
+    }
+
+    static void op_false(TAIL_ARGS)
+    {
+        *sp++ = Value::fromBool(false);
+        NEXT();
+    }
+
+    static void op_pop(TAIL_ARGS)
+    {
+        sp--;
+        NEXT();
+    }
+
+    static void op_dup(TAIL_ARGS)
+    {
+        *sp = sp[-1];
+        sp++;
+        NEXT();
+    }
+
+    static void op_not(TAIL_ARGS)
+    {
+        sp[-1] = Value::fromBool(!isTruthy(sp[-1]));
+        NEXT();
+    }
+
+    static void op_discard(TAIL_ARGS)
+    {
+        sp -= *ip++;
+        NEXT();
+    }
+
+    static void op_pick(TAIL_ARGS)
+    {
+        Value v = sp[-1 - *ip++];
+        *sp++ = v;
+        NEXT();
+    }
+
+    static void op_slide(TAIL_ARGS)
+    {
+        Value result = sp[-1];
+        sp -= *ip++;
+        sp[-1] = result;
+        NEXT();
+    }
+
+    // ========== ARITHMETIC ==========
+
+    static void op_add(TAIL_ARGS) { TAIL_ARITH(+, OP_ADD_II, OP_ADD_DD); }
+    static void op_subtract(TAIL_ARGS) { TAIL_ARITH(-, OP_SUBTRACT_II, OP_SUBTRACT_DD); }
+    static void op_multiply(TAIL_ARGS) { TAIL_ARITH(*, OP_MULTIPLY_II, OP_MULTIPLY_DD); }
+
+    // int/int exato fica int; divisão por zero e o resto no loop goto
+    static void op_divide(TAIL_ARGS)
+    {
+        Value a = sp[-2];
+        Value b = sp[-1];
+        if (a.isInt() && b.isInt())
+        {
+            int ia = a.asInt(), ib = b.asInt();
+            if (ib == 0)
+                SLOW();
+            sp[-2] = (ia % ib == 0) ? Value::fromInt(ia / ib) : Value::fromDouble((double)ia / ib);
+        }
+        else if (a.isDouble() && IS_NUM(b))
+        {
+            double db = NUM(b);
+            if (db == 0.0)
+                SLOW();
+            sp[-2] = Value::fromDouble(a.asDouble() / db);
+        }
+        else
+            SLOW();
+        sp--;
+        NEXT();
+    }
+
+    static void op_negate(TAIL_ARGS)
+    {
+        Value v = sp[-1];
+        if (v.isInt())
+            sp[-1] = Value::fromInt(-v.asInt());
+        else if (v.isDouble())
+            sp[-1] = Value::fromDouble(-v.asDouble());
+        else
+            SLOW();
+        NEXT();
+    }
+
+    // ========== COMPARISONS ==========
+
+    static void op_equal(TAIL_ARGS)
+    {
+        sp[-2] = Value::fromBool(valuesEqual(sp[-2], sp[-1]));
+        sp--;
+        NEXT();
+    }
+
+    static void op_not_equal(TAIL_ARGS)
+    {
+        sp[-2] = Value::fromBool(!valuesEqual(sp[-2], sp[-1]));
+        sp--;
+        NEXT();
+    }
+
+    static void op_greater(TAIL_ARGS)
+    {
+        if (S->vm->quickeningEnabled_)
+        {
+            if (sp[-2].isInt() && sp[-1].isInt())
+                ip[-1] = OP_GREATER_II;
+            else if (sp[-2].isDouble() && sp[-1].isDouble())
+                ip[-1] = OP_GREATER_DD;
+        }
+        TAIL_COMPARE(>);
+    }
+
+    static void op_less(TAIL_ARGS)
+    {
+        if (S->vm->quickeningEnabled_)
+        {
+            if (sp[-2].isInt() && sp[-1].isInt())
+                ip[-1] = OP_LESS_II;
+            else if (sp[-2].isDouble() && sp[-1].isDouble())
+                ip[-1] = OP_LESS_DD;
+        }
+        TAIL_COMPARE(<);
+    }
+
+    static void op_greater_equal(TAIL_ARGS) { TAIL_COMPARE(>=); }
+    static void op_less_equal(TAIL_ARGS) { TAIL_COMPARE(<=); }
+
+    // ========== VARIABLES ==========
+
+    static void op_get_local(TAIL_ARGS)
+    {
+        *sp++ = slots[*ip++];
+        NEXT();
+    }
+
+    static void op_set_local(TAIL_ARGS)
+    {
+        slots[*ip++] = sp[-1];
+        NEXT();
+    }
+
+    static void op_get_global(TAIL_ARGS)
+    {
+        *sp++ = S->vm->globalsArray[READ_U16(ip)];
+        ip += 2;
+        NEXT();
+    }
+
+    static void op_set_global(TAIL_ARGS)
+    {
+        S->vm->globalsArray[READ_U16(ip)] = sp[-1];
+        ip += 2;
+        NEXT();
+    }
+
+    static void op_get_private(TAIL_ARGS)
+    {
+        *sp++ = S->process->privates[*ip++];
+        NEXT();
+    }
+
+    static void op_set_private(TAIL_ARGS)
+    {
+        S->process->privates[*ip++] = sp[-1];
+        NEXT();
+    }
+
+    // ========== CONTROL FLOW ==========
+
+    static void op_jump(TAIL_ARGS)
+    {
+        ip += 2 + READ_U16(ip);
+        NEXT();
+    }
+
+    static void op_switch_table(TAIL_ARGS)
+    {
+        Fiber *fiber = S->fiber;
+        Code *chunk = fiber->frames[fiber->frameCount - 1].func->chunk;
+        // 'table' é a tabela de handlers do NEXT()
+        const SwitchTable *cases = &chunk->switchTables[READ_U16(ip)];
+        ip = chunk->code + cases->targets[switchTableCase(cases, sp[-1])];
+        sp--;
+        NEXT();
+    }
+
+    static void op_jump_if_false(TAIL_ARGS)
+    {
+        uint16 offset = READ_U16(ip);
+        ip += 2;
+        if (isFalsey(sp[-1]))
+            ip += offset;
+        NEXT();
+    }
+
+    static void op_jump_if_true(TAIL_ARGS)
+    {
+        uint16 offset = READ_U16(ip);
+        ip += 2;
+        if (!isFalsey(sp[-1]))
+            ip += offset;
+        NEXT();
+    }
+
+    static void op_loop(TAIL_ARGS)
+    {
+        // GC pendente: o loop goto faz o safe point com a stack sincronizada
+        if (S->vm->gcPending())
+            SLOW();
+        ip = ip + 2 - READ_U16(ip);
+        NEXT();
+    }
+
+    // ========== FUNCTIONS ==========
+
+    // Só funções de script; natives, classes, closures, erros... no loop goto
+    static void op_call(TAIL_ARGS)
+    {
+        uint8 argCount = ip[0];
+        Value callee = sp[-1 - argCount];
+        if (!callee.isFunction())
+            SLOW();
+        Function *target = S->vm->functions[callee.asFunctionId()];
+        if (!target || target->arity != argCount || S->fiber->frameCount >= FRAMES_MAX)
+            SLOW();
+        ip++;
+        TAIL_ENTER(target, argCount);
+    }
+
+    static void op_call_direct(TAIL_ARGS)
+    {
+        uint16 index = READ_U16(ip);
+        uint8 argCount = ip[3];
+        Value callee = sp[-1 - argCount];
+        if (!callee.isFunction() || callee.asFunctionId() != index)
+        {
+            ip += 2; // OP_CALL genérico
+            NEXT();
+        }
+        // Overflow: o loop goto guarda a frame e só depois dá o erro
+        if (S->fiber->frameCount >= FRAMES_MAX)
+            SLOW();
+        Function *target = S->vm->functions[index];
+        ip += 4; // func, OP_CALL argc
+        TAIL_ENTER(target, argCount);
+    }
+
+    // Retorno simples para outra frame de script; finally, upvalues abertos,
+    // fim da fiber e fronteira C++ ficam no loop goto
+    static void op_return(TAIL_ARGS)
+    {
+        Interpreter *vm = S->vm;
+        Fiber *fiber = S->fiber;
+        if (vm->hasFatalError_ || fiber->tryDepth > 0 || fiber->frameCount <= 1)
+            SLOW();
+        if (vm->openUpvalues != nullptr && vm->openUpvalues->location >= slots)
+            SLOW();
+        if (vm->stopOnCallReturn_ && fiber == vm->callReturnFiber_ &&
+            fiber->frameCount - 1 == vm->callReturnTargetFrameCount_)
+            SLOW();
+
+        slots[0] = sp[-1];
+        sp = slots + 1;
+        fiber->frameCount--;
+
+        CallFrame *frame = &fiber->frames[fiber->frameCount - 1];
+        ip = frame->ip;
+        slots = frame->slots;
+        K = frame->func->chunk->constants.data;
+
+        if (frame->func->regCode && vm->registerTierEnabled_)
+        {
+            fiber->stackTop = sp;
+            ip = vm->resumeRegisterTier(fiber, frame, ip);
+            sp = fiber->stackTop;
+        }
+        NEXT();
+    }
+
+    // ========== PROPERTIES ==========
+
+    // Só hits do inline cache; misses (e o resto) no loop goto
+    static void op_get_property(TAIL_ARGS)
+    {
+        Value object = sp[-1];
+        Fiber *fiber = S->fiber;
+        PropertyCache *cache = &fiber->frames[fiber->frameCount - 1].func->chunk->propertyCaches[READ_U16(ip + 2)];
+        int slot = -1;
+        if (object.isClassInstance())
+        {
+            ClassInstance *instance = object.asClassInstance();
+            slot = cache->find(instance->shape);
+            if (slot >= 0)
+                sp[-1] = instance->fields[slot];
+        }
+        else if (object.isStructInstance())
+        {
+            StructInstance *inst = object.asStructInstance();
+            slot = inst ? cache->find(inst->def) : -1;
+            if (slot >= 0)
+                sp[-1] = inst->values[slot];
+        }
+        if (slot < 0)
+            SLOW();
+        S->vm->propertyCacheHits++;
+        ip += 4;
+        NEXT();
+    }
+
+    static void op_set_property(TAIL_ARGS)
+    {
+        Value object = sp[-2];
+        Fiber *fiber = S->fiber;
+        PropertyCache *cache = &fiber->frames[fiber->frameCount - 1].func->chunk->propertyCaches[READ_U16(ip + 2)];
+        int slot = -1;
+        if (object.isClassInstance())
+        {
+            ClassInstance *instance = object.asClassInstance();
+            slot = cache->find(instance->shape);
+            if (slot >= 0)
+            {
+                instance->fields[slot] = sp[-1];
+                S->vm->writeBarrier(instance, sp[-1]);
+            }
+        }
+        else if (object.isStructInstance())
+        {
+            StructInstance *inst = object.asStructInstance();
+            slot = inst ? cache->find(inst->def) : -1;
+            if (slot >= 0)
+            {
+                inst->values[slot] = sp[-1];
+                S->vm->writeBarrier(inst, sp[-1]);
+            }
+        }
+        if (slot < 0)
+            SLOW();
+        S->vm->propertyCacheHits++;
+        sp[-2] = sp[-1];
+        sp--;
+        ip += 4;
+        NEXT();
+    }
+
+    // Processo vivo: o private. Class/struct: o mesmo IC do op_get_property,
+    // sem sair para o loop goto (p.x num struct não é mais lento que p.w)
+    static void op_get_proc_private(TAIL_ARGS)
+    {
+        Value object = sp[-1];
+        if (object.isProcessInstance())
+        {
+            Process *proc = object.asProcess();
+            if (!proc || proc->state == FiberState::DEAD)
+                SLOW();
+            sp[-1] = proc->privates[ip[0]];
+            ip += 5; // idx, name, cache
+            NEXT();
+        }
+        Fiber *fiber = S->fiber;
+        PropertyCache *cache = &fiber->frames[fiber->frameCount - 1].func->chunk->propertyCaches[READ_U16(ip + 3)];
+        int slot = -1;
+        if (object.isClassInstance())
+        {
+            ClassInstance *instance = object.asClassInstance();
+            slot = cache->find(instance->shape);
+            if (slot >= 0)
+                sp[-1] = instance->fields[slot];
+        }
+        else if (object.isStructInstance())
+        {
+            StructInstance *inst = object.asStructInstance();
+            slot = inst ? cache->find(inst->def) : -1;
+            if (slot >= 0)
+                sp[-1] = inst->values[slot];
+        }
+        if (slot < 0)
+            SLOW();
+        S->vm->propertyCacheHits++;
+        ip += 5;
+        NEXT();
+    }
+
+    static void op_set_proc_private(TAIL_ARGS)
+    {
+        Value object = sp[-2];
+        if (object.isProcessInstance())
+        {
+            Process *proc = object.asProcess();
+            if (!proc || proc->state == FiberState::DEAD)
+                SLOW();
+            proc->privates[ip[0]] = sp[-1];
+        }
+        else
+        {
+            Fiber *fiber = S->fiber;
+            PropertyCache *cache = &fiber->frames[fiber->frameCount - 1].func->chunk->propertyCaches[READ_U16(ip + 3)];
+            int slot = -1;
+            if (object.isClassInstance())
+            {
+                ClassInstance *instance = object.asClassInstance();
+                slot = cache->find(instance->shape);
+                if (slot >= 0)
+                {
+                    instance->fields[slot] = sp[-1];
+                    S->vm->writeBarrier(instance, sp[-1]);
+                }
+            }
+            else if (object.isStructInstance())
+            {
+                StructInstance *inst = object.asStructInstance();
+                slot = inst ? cache->find(inst->def) : -1;
+                if (slot >= 0)
+                {
+                    inst->values[slot] = sp[-1];
+                    S->vm->writeBarrier(inst, sp[-1]);
+                }
+            }
+            if (slot < 0)
+                SLOW();
+            S->vm->propertyCacheHits++;
+        }
+        sp[-2] = sp[-1];
+        sp--;
+        ip += 5;
+        NEXT();
+    }
+
+    // ========== MATH ==========
+
+    static void op_sin(TAIL_ARGS) { TAIL_MATH1(std::sin(d)); }
+    static void op_cos(TAIL_ARGS) { TAIL_MATH1(std::cos(d)); }
+
+    static void op_sqrt(TAIL_ARGS)
+    {
+        if (sp[-1].isInt() ? sp[-1].asInt() < 0 : (sp[-1].isDouble() && sp[-1].asDouble() < 0))
+            SLOW();
+        TAIL_MATH1(std::sqrt(d));
+    }
+
+    static void op_atan2(TAIL_ARGS)
+    {
+        Value vy = sp[-2];
+        Value vx = sp[-1];
+        if (!IS_NUM(vx) || !IS_NUM(vy))
+            SLOW();
+        sp[-2] = Value::fromDouble(std::atan2(NUM(vy), NUM(vx)));
+        sp--;
+        NEXT();
+    }
+
+    static void op_pow(TAIL_ARGS)
+    {
+        Value vbase = sp[-2];
+        Value vexp = sp[-1];
+        if (!IS_NUM(vexp) || !IS_NUM(vbase))
+            SLOW();
+        sp[-2] = Value::fromDouble(std::pow(NUM(vbase), NUM(vexp)));
+        sp--;
+        NEXT();
+    }
+
+    // ========== QUICKENED ==========
+
+    static void op_add_ii(TAIL_ARGS) { TAIL_QUICK(isInt, asInt, fromInt, +, OP_ADD, op_add); }
+    static void op_add_dd(TAIL_ARGS) { TAIL_QUICK(isDouble, asDouble, fromDouble, +, OP_ADD, op_add); }
+    static void op_subtract_ii(TAIL_ARGS) { TAIL_QUICK(isInt, asInt, fromInt, -, OP_SUBTRACT, op_subtract); }
+    static void op_subtract_dd(TAIL_ARGS) { TAIL_QUICK(isDouble, asDouble, fromDouble, -, OP_SUBTRACT, op_subtract); }
+    static void op_multiply_ii(TAIL_ARGS) { TAIL_QUICK(isInt, asInt, fromInt, *, OP_MULTIPLY, op_multiply); }
+    static void op_multiply_dd(TAIL_ARGS) { TAIL_QUICK(isDouble, asDouble, fromDouble, *, OP_MULTIPLY, op_multiply); }
+    static void op_less_ii(TAIL_ARGS) { TAIL_QUICK(isInt, asInt, fromBool, <, OP_LESS, op_less); }
+    static void op_less_dd(TAIL_ARGS) { TAIL_QUICK(isDouble, asDouble, fromBool, <, OP_LESS, op_less); }
+    static void op_greater_ii(TAIL_ARGS) { TAIL_QUICK(isInt, asInt, fromBool, >, OP_GREATER, op_greater); }
+    static void op_greater_dd(TAIL_ARGS) { TAIL_QUICK(isDouble, asDouble, fromBool, >, OP_GREATER, op_greater); }
+
+    // ========== SUPERINSTRUCTIONS ==========
+
+    static void op_inc_local(TAIL_ARGS) { TAIL_SUPER_INC(slots[ip[0]]); }
+    static void op_inc_private(TAIL_ARGS) { TAIL_SUPER_INC(S->process->privates[ip[0]]); }
+
+    static void op_cmp_local_jump(TAIL_ARGS)
+    {
+        uint8 *seq = ip + 1;
+        Value lhs = slots[ip[0]];
+        Value rhs;
+        TAIL_SUPER_OPERAND(seq, rhs);
+        if (!IS_NUM(lhs) || !IS_NUM(rhs))
+        {
+            *sp++ = lhs;
+            ip++;
+            NEXT();
+        }
+        bool result = TAIL_IS_LESS(seq[0]) ? NUM(lhs) < NUM(rhs) : NUM(lhs) > NUM(rhs);
+        ip = seq + 4; // LESS|GREATER, JUMP_IF_FALSE hi lo
+        if (!result)
+            ip += READ_U16(seq + 2);
+        if (*ip == OP_POP)
+            ip++;
+        else
+            *sp++ = Value::fromBool(result);
+        NEXT();
+    }
+};
+
+TailHandler TailDispatch::table[256];
+
+static struct TailTableInit
+{
+    TailTableInit() { TailDispatch::init(); }
+} tailTableInit;
+
+FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
+{
+    currentFiber = fiber;
+    TailState state = {this, fiber, process};
+
+    for (;;)
+    {
+        CallFrame *frame = &fiber->frames[fiber->frameCount - 1];
+        uint8 *ip = frame->ip;
+        TailDispatch::table[*ip](&state, ip + 1, fiber->stackTop, frame->slots,
+                                 frame->func->chunk->constants.data);
+
+        FiberResult result = run_fiber_step(fiber, process);
+        if (result.reason != FiberResult::STEP)
+            return result;
+    }
+}
+
+#undef TAIL_ARGS
+#undef NEXT
+#undef SLOW
+#undef TAIL_GOTO
+#undef READ_U16
+#undef IS_NUM
+#undef NUM
+#undef TAIL_ENTER
+#undef TAIL_ARITH
+#undef TAIL_COMPARE
+#undef TAIL_QUICK
+#undef TAIL_MATH1
+#undef TAIL_SUPER_OPERAND
+#undef TAIL_IS_SUB
+#undef TAIL_IS_LESS
+#undef TAIL_SUPER_INC
+
+#endif // USE_TAIL_CALLS
@@ -9,13 +9,13 @@
 void Interpreter::checkType(int index, ValueType expected, const char *funcName)
 {
     Value v = peek(index);
-    if (v.type != expected)
+    if (v.getType() != expected)
     {
         runtimeError("%s expects %s at index %d, got %s",
                      funcName,
                      valueTypeToString(expected),
                      index,
-                     valueTypeToString(v.type));
+                     valueTypeToString(v.getType()));
     }
 }
 
@@ -109,37 +109,37 @@ Value Interpreter::pop()
 // Type checking
 ValueType Interpreter::getType(int index)
 {
-    return peek(index).type;
+    return peek(index).getType();
 }
 
 bool Interpreter::isInt(int index)
 {
-    return peek(index).type == ValueType::INT;
+    return peek(index).getType() == ValueType::INT;
 }
 
 bool Interpreter::isDouble(int index)
 {
-    return peek(index).type == ValueType::DOUBLE;
+    return peek(index).getType() == ValueType::DOUBLE;
 }
 
 bool Interpreter::isString(int index)
 {
-    return peek(index).type == ValueType::STRING;
+    return peek(index).getType() == ValueType::STRING;
 }
 
 bool Interpreter::isBool(int index)
 {
-    return peek(index).type == ValueType::BOOL;
+    return peek(index).getType() == ValueType::BOOL;
 }
 
 bool Interpreter::isNil(int index)
 {
-    return peek(index).type == ValueType::NIL;
+    return peek(index).getType() == ValueType::NIL;
 }
 
 bool Interpreter::isFunction(int index)
 {
-    return peek(index).type == ValueType::FUNCTION;
+    return peek(index).getType() == ValueType::FUNCTION;
 }
 
 void Interpreter::pushInt(int n)
@@ -169,7 +169,7 @@ void Interpreter::pushDouble(double d)
 
 void Interpreter::pushString(const char *s)
 {
-    push(makeString(s));
+    push(makeRuntimeString(s));
 }
 
 void Interpreter::pushBool(bool b)
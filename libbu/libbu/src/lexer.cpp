@@ -1,37 +1,41 @@
 #include "token.hpp"
 #include "lexer.hpp"
+#include "pool.hpp"
+#include "string.hpp"
 #include "utf8_utils.h"
 #include <cctype>
+#include <cstring>
 #include <iostream>
 
-Lexer::Lexer(const std::string &src)
+Lexer::Lexer(const std::string &src, StringPool *pool)
     : source(src),
+      pool(pool),
       start(0),
       current(0),
       line(1),
       column(1),
       tokenColumn(1),
       hasPendingError(false),
-      pendingErrorMessage(""),
+      pendingErrorMessage(nullptr),
       pendingErrorLine(0),
       pendingErrorColumn(0)
 {
     initKeywords();
 }
 
-Lexer::Lexer(const char *src, size_t len)
-    : source(src, len), start(0), current(0), line(1),
+Lexer::Lexer(const char *src, size_t len, StringPool *pool)
+    : source(src, len), pool(pool), start(0), current(0), line(1),
       column(1),
       tokenColumn(1),
       hasPendingError(false),
-      pendingErrorMessage(""),
+      pendingErrorMessage(nullptr),
       pendingErrorLine(0),
       pendingErrorColumn(0)
 {
     initKeywords();
 }
 
-void Lexer::setPendingError(const std::string &message)
+void Lexer::setPendingError(const char *message)
 {
     if (!hasPendingError)
     {
@@ -46,6 +50,7 @@ void Lexer::initKeywords()
 {
     keywords = {
         {"var", TOKEN_VAR},
+        {"const", TOKEN_CONST},
         {"def", TOKEN_DEF},
         {"if", TOKEN_IF},
         {"elif", TOKEN_ELIF},
@@ -263,14 +268,26 @@ void Lexer::skipWhitespace()
     }
 }
 
-Token Lexer::makeToken(TokenType type, const std::string &lexeme)
+Token Lexer::makeToken(TokenType type, String *interned)
 {
-    return Token(type, lexeme, line, tokenColumn);
+    return Token(type, source.data() + start, (uint32_t)(current - start), line, tokenColumn, interned);
 }
 
-Token Lexer::errorToken(const std::string &message)
+Token Lexer::errorToken(const char *message)
 {
-    return Token(TOKEN_ERROR, message, line, tokenColumn);
+    return Token(TOKEN_ERROR, message, (uint32_t)std::strlen(message), line, tokenColumn);
+}
+
+// Interna 'scratch' no pool do VM. O pool procura pela C string, por isso um
+// '\0' embebido corta a string (o literal sempre foi lido como C string)
+String *Lexer::intern()
+{
+    if (!pool)
+    {
+        deferred_.push_back(scratch);
+        return nullptr;
+    }
+    return pool->create(scratch.c_str());
 }
 
 bool Lexer::isKeyword(const std::string &name)
@@ -290,8 +307,7 @@ Token Lexer::number()
             advance();
         }
 
-        std::string numStr = source.substr(start, current - start);
-        return makeToken(TOKEN_INT, numStr);
+        return makeToken(TOKEN_INT);
     }
 
     // Normal int/float
@@ -311,8 +327,7 @@ Token Lexer::number()
         }
     }
 
-    std::string numStr = source.substr(start, current - start);
-    return makeToken(type, numStr);
+    return makeToken(type);
 }
  
 
@@ -331,17 +346,15 @@ Token Lexer::identifier()
         }
     }
 
-    std::string text = source.substr(start, current - start);
+    scratch.assign(source, start, current - start);
 
-    auto it = keywords.find(text);
+    auto it = keywords.find(scratch);
     if (it != keywords.end())
     {
-        return makeToken(it->second, text);
+        return makeToken(it->second, intern());
     }
 
- 
-
-    return makeToken(TOKEN_IDENTIFIER, text);
+    return makeToken(TOKEN_IDENTIFIER, intern());
 }
 
 
@@ -349,7 +362,8 @@ Token Lexer::string()
 {
     const size_t MAX_STRING_LENGTH = 10000;
     size_t startPos = current;
-    std::string value;
+    std::string &value = scratch;
+    value.clear();
 
     while (peek() != '"' && !isAtEnd())
     {
@@ -537,14 +551,15 @@ Token Lexer::string()
     }
 
     advance(); // fecha "
-    return makeToken(TOKEN_STRING, value);
+    return makeToken(TOKEN_STRING, intern());
 }
 
 Token Lexer::verbatimString()
 {
     const size_t MAX_STRING_LENGTH = 10000;
     size_t startPos = current;
-    std::string value;
+    std::string &value = scratch;
+    value.clear();
 
     while (!isAtEnd())
     {
@@ -566,7 +581,7 @@ Token Lexer::verbatimString()
                 continue;
             }
             // Fim da string verbatim
-            return makeToken(TOKEN_STRING, value);
+            return makeToken(TOKEN_STRING, intern());
         }
 
         // Adiciona caractere literal (incluindo quebras de linha)
@@ -586,7 +601,7 @@ Token Lexer::scanToken()
 
     if (isAtEnd())
     {
-        return makeToken(TOKEN_EOF, "");
+        return makeToken(TOKEN_EOF);
     }
 
     char c = advance();
@@ -607,25 +622,25 @@ Token Lexer::scanToken()
     {
     // Single-char tokens
     case '(':
-        return makeToken(TOKEN_LPAREN, "(");
+        return makeToken(TOKEN_LPAREN);
     case ')':
-        return makeToken(TOKEN_RPAREN, ")");
+        return makeToken(TOKEN_RPAREN);
     case '{':
-        return makeToken(TOKEN_LBRACE, "{");
+        return makeToken(TOKEN_LBRACE);
     case '}':
-        return makeToken(TOKEN_RBRACE, "}");
+        return makeToken(TOKEN_RBRACE);
     case '[':
-        return makeToken(TOKEN_LBRACKET, "[");
+        return makeToken(TOKEN_LBRACKET);
     case ']':
-        return makeToken(TOKEN_RBRACKET, "]");
+        return makeToken(TOKEN_RBRACKET);
     case ',':
-        return makeToken(TOKEN_COMMA, ",");
+        return makeToken(TOKEN_COMMA);
     case ';':
-        return makeToken(TOKEN_SEMICOLON, ";");
+        return makeToken(TOKEN_SEMICOLON);
     case ':':
-        return makeToken(TOKEN_COLON, ":");
+        return makeToken(TOKEN_COLON);
     case '.':
-        return makeToken(TOKEN_DOT, ".");
+        return makeToken(TOKEN_DOT);
     
     case '@':
         // Verifica se é uma verbatim string @"..."
@@ -634,82 +649,82 @@ Token Lexer::scanToken()
             advance(); // consome o "
             return verbatimString();
         }
-        return makeToken(TOKEN_AT, "@");
+        return makeToken(TOKEN_AT);
 
     // Operators com compound assignment e increment/decrement
     case '+':
         if (match('+'))
-            return makeToken(TOKEN_PLUS_PLUS, "++");
+            return makeToken(TOKEN_PLUS_PLUS);
         if (match('='))
-            return makeToken(TOKEN_PLUS_EQUAL, "+=");
-        return makeToken(TOKEN_PLUS, "+");
+            return makeToken(TOKEN_PLUS_EQUAL);
+        return makeToken(TOKEN_PLUS);
 
     case '-':
         if (match('-'))
-            return makeToken(TOKEN_MINUS_MINUS, "--");
+            return makeToken(TOKEN_MINUS_MINUS);
         if (match('='))
-            return makeToken(TOKEN_MINUS_EQUAL, "-=");
-        return makeToken(TOKEN_MINUS, "-");
+            return makeToken(TOKEN_MINUS_EQUAL);
+        return makeToken(TOKEN_MINUS);
 
     case '*':
         if (match('='))
-            return makeToken(TOKEN_STAR_EQUAL, "*=");
-        return makeToken(TOKEN_STAR, "*");
+            return makeToken(TOKEN_STAR_EQUAL);
+        return makeToken(TOKEN_STAR);
 
     case '/':
         if (match('='))
-            return makeToken(TOKEN_SLASH_EQUAL, "/=");
-        return makeToken(TOKEN_SLASH, "/");
+            return makeToken(TOKEN_SLASH_EQUAL);
+        return makeToken(TOKEN_SLASH);
 
     case '%':
         if (match('='))
-            return makeToken(TOKEN_PERCENT_EQUAL, "%=");
-        return makeToken(TOKEN_PERCENT, "%");
+            return makeToken(TOKEN_PERCENT_EQUAL);
+        return makeToken(TOKEN_PERCENT);
 
     // Two-char tokens
     case '=':
         if (match('='))
         {
-            return makeToken(TOKEN_EQUAL_EQUAL, "==");
+            return makeToken(TOKEN_EQUAL_EQUAL);
         }
-        return makeToken(TOKEN_EQUAL, "=");
+        return makeToken(TOKEN_EQUAL);
 
     case '!':
         if (match('='))
         {
-            return makeToken(TOKEN_BANG_EQUAL, "!=");
+            return makeToken(TOKEN_BANG_EQUAL);
         }
-        return makeToken(TOKEN_BANG, "!");
+        return makeToken(TOKEN_BANG);
 
     case '&':
         if (match('&'))
-            return makeToken(TOKEN_AND_AND, "&&");
-        return makeToken(TOKEN_AMPERSAND, "&");
+            return makeToken(TOKEN_AND_AND);
+        return makeToken(TOKEN_AMPERSAND);
 
     case '|':
         if (match('|'))
-            return makeToken(TOKEN_OR_OR, "||");
-        return makeToken(TOKEN_PIPE, "|");
+            return makeToken(TOKEN_OR_OR);
+        return makeToken(TOKEN_PIPE);
 
     case '^':
-        return makeToken(TOKEN_CARET, "^");
+        return makeToken(TOKEN_CARET);
 
     case '~':
-        return makeToken(TOKEN_TILDE, "~");
+        return makeToken(TOKEN_TILDE);
 
     case '<':
         if (match('<'))
-            return makeToken(TOKEN_LEFT_SHIFT, "<<");
+            return makeToken(TOKEN_LEFT_SHIFT);
         if (match('='))
-            return makeToken(TOKEN_LESS_EQUAL, "<=");
-        return makeToken(TOKEN_LESS, "<");
+            return makeToken(TOKEN_LESS_EQUAL);
+        return makeToken(TOKEN_LESS);
 
     case '>':
         if (match('>'))
-            return makeToken(TOKEN_RIGHT_SHIFT, ">>");
+            return makeToken(TOKEN_RIGHT_SHIFT);
         if (match('='))
-            return makeToken(TOKEN_GREATER_EQUAL, ">=");
-        return makeToken(TOKEN_GREATER, ">");
+            return makeToken(TOKEN_GREATER_EQUAL);
+        return makeToken(TOKEN_GREATER);
 
     // String literals
     case '"':
@@ -724,7 +739,7 @@ Token Lexer::nextToken()
 
     if (hasPendingError)
     {
-        Token errorTok(TOKEN_ERROR, pendingErrorMessage,
+        Token errorTok(TOKEN_ERROR, pendingErrorMessage, (uint32_t)std::strlen(pendingErrorMessage),
                        pendingErrorLine, pendingErrorColumn);
         hasPendingError = false; // Limpa erro
         return errorTok;
@@ -734,7 +749,7 @@ Token Lexer::nextToken()
 
     if (hasPendingError)
     {
-        Token errorTok(TOKEN_ERROR, pendingErrorMessage,
+        Token errorTok(TOKEN_ERROR, pendingErrorMessage, (uint32_t)std::strlen(pendingErrorMessage),
                        pendingErrorLine, pendingErrorColumn);
         hasPendingError = false;
         return errorTok;
@@ -758,7 +773,11 @@ std::vector<Token> Lexer::scanAll()
     Token token;
     do
     {
+        size_t deferred = deferred_.size();
         token = nextToken();
+        // No máximo um intern por token
+        if (deferred_.size() != deferred)
+            deferredTokens_.push_back((uint32_t)tokens.size());
         tokens.push_back(token);
 
     } while (token.type != TOKEN_EOF && !hasPendingError);
@@ -766,6 +785,19 @@ std::vector<Token> Lexer::scanAll()
     return tokens;
 }
 
+void Lexer::internDeferred(StringPool *target, std::vector<Token> &tokens)
+{
+    for (size_t i = 0; i < deferredTokens_.size(); i++)
+    {
+        Token &token = tokens[deferredTokens_[i]];
+        if (token.type != TOKEN_ERROR)
+            token.str = target->create(deferred_[i].c_str());
+    }
+    deferred_.clear();
+    deferredTokens_.clear();
+    pool = target;
+}
+
 void Lexer::printTokens(const std::vector<Token> &toks) const
 {
     for (const Token &token : toks)
@@ -43,7 +43,7 @@ void StringPool::deallocString(String *s)
         return;
 
     //    Info("Dealloc string %p", s);
-    bytesAllocated -= sizeof(String) + s->length() + 1;
+    bytesAllocated -= sizeof(String) + s->length();
 
     if (s->isLong() && s->ptr)
         allocator.Free(s->ptr, s->length() + 1);
@@ -63,6 +63,7 @@ void StringPool::clear()
 
         deallocString(s);
     }
+    clearRuntime();
 
     dummyString->~String();
     allocator.Free(dummyString, sizeof(String));
@@ -88,8 +89,25 @@ String *StringPool::create(const char *str, uint32 len)
 
     // New string
     String *s = allocString();
+    fillString(s, str, len);
+    s->index = map.size();
+
+    // Info("Create string %s hash %d len %d", s->chars(), s->hash, s->length());
+    map.push(s);
+    pool.set(s->chars(), map.size() - 1);
+
+    // Store in pool
+
+    return s;
+}
+
+String *StringPool::create(const char *str)
+{
+    return create(str, std::strlen(str));
+}
 
-    // Copy data
+void StringPool::fillString(String *s, const char *str, uint32 len)
+{
     if (len <= String::SMALL_THRESHOLD)
     {
         s->length_and_flag = len;
@@ -104,22 +122,108 @@ String *StringPool::create(const char *str, uint32 len)
         s->ptr[len] = '\0';
     }
 
+    s->marked = allocMark;
     s->hash = hashString(s->chars(), len);
     bytesAllocated += sizeof(String) + len;
-    s->index = map.size();
+}
 
-    // Info("Create string %s hash %d len %d", s->chars(), s->hash, s->length());
-    map.push(s);
-    pool.set(s->chars(), map.size() - 1);
+// ========================================
+// STRINGS DE RUNTIME (GC)
+// ========================================
+// Sem lookup no map: "Score: " + score por frame cria uma string nova que o
+// sweep liberta quando deixa de ser referida. Igualdade e hashing já são por
+// conteúdo (compare_strings, StringEq), por isso não precisam de ser únicas.
 
-    // Store in pool
+String *StringPool::allocate(const char *str, uint32 len)
+{
+    String *s = allocString();
+    fillString(s, str, len);
+    s->index = -1;
 
+    runtimeBytes += sizeof(String) + len;
+    runtime.push(s);
     return s;
 }
 
-String *StringPool::create(const char *str)
+String *StringPool::intern(String *s)
 {
-    return create(str, std::strlen(str));
+    if (s->index >= 0)
+        return s;
+    return create(s->chars(), (uint32)s->length());
+}
+
+void StringPool::beginSweep(uint8 liveMark)
+{
+    sweepMark = liveMark;
+    sweepRead = 0;
+    sweepWrite = 0;
+    sweeping = true;
+}
+
+// As criadas depois do beginSweep vão para o fim do vector e também são
+// lidas (com allocMark == sweepMark ficam); só se compacta no fim
+size_t StringPool::sweepStep(size_t budget)
+{
+    if (!sweeping)
+        return 0;
+
+    size_t done = 0;
+    while (done < budget && sweepRead < runtime.size())
+    {
+        String *s = runtime[sweepRead++];
+        if (s->marked == sweepMark)
+        {
+            runtime[sweepWrite++] = s;
+        }
+        else
+        {
+            runtimeBytes -= sizeof(String) + s->length();
+            deallocString(s);
+        }
+        done++;
+    }
+
+    if (sweepRead == runtime.size())
+    {
+        runtime.resize(sweepWrite);
+        sweeping = false;
+    }
+    return done;
+}
+
+size_t StringPool::sweepYoung(uint8 liveMark)
+{
+    size_t kept = youngStart;
+    size_t freed = 0;
+    for (size_t i = youngStart; i < runtime.size(); i++)
+    {
+        String *s = runtime[i];
+        if (s->marked == liveMark)
+        {
+            s->marked = 0;
+            runtime[kept++] = s;
+        }
+        else
+        {
+            runtimeBytes -= sizeof(String) + s->length();
+            deallocString(s);
+            freed++;
+        }
+    }
+    runtime.resize(kept);
+    youngStart = kept;
+    return freed;
+}
+
+void StringPool::clearRuntime()
+{
+    for (size_t i = 0; i < runtime.size(); i++)
+        deallocString(runtime[i]);
+    runtime.clear();
+    runtimeBytes = 0;
+    sweeping = false;
+    allocMark = 0;
+    youngStart = 0;
 }
 // ========================================
 // CONCAT - OTIMIZADO
@@ -144,8 +248,7 @@ String *StringPool::concat(String *a, String *b)
     std::memcpy(temp + lenA, b->chars(), lenB);
     temp[totalLen] = '\0';
 
-    //  Cria string (com interning!)
-    return create(temp, totalLen);
+    return allocate(temp, totalLen);
 }
 
 // ========================================
@@ -169,7 +272,7 @@ String *StringPool::upper(String *src)
     }
     temp[len] = '\0';
 
-    return create(temp, len);
+    return allocate(temp, len);
 }
 
 String *StringPool::lower(String *src)
@@ -188,7 +291,7 @@ String *StringPool::lower(String *src)
     }
     temp[len] = '\0';
 
-    return create(temp, len);
+    return allocate(temp, len);
 }
 
 // ========================================
@@ -213,11 +316,7 @@ String *StringPool::substring(String *src, uint32 start, uint32 end)
     if (newLen == 0)
         return create("", 0);
 
-    char *temp = (char *)alloca(newLen + 1);
-    std::memcpy(temp, src->chars() + start, newLen);
-    temp[newLen] = '\0';
-
-    return create(temp, newLen);
+    return allocate(src->chars() + start, newLen);
 }
 
 // ========================================
@@ -276,7 +375,7 @@ String *StringPool::replace(String *src, const char *oldStr, const char *newStr)
     std::memcpy(temp + destIdx, current, remainLen);
     temp[finalLen] = '\0';
 
-    return create(temp, finalLen);
+    return allocate(temp, finalLen);
 }
 
 // ========================================
@@ -297,8 +396,7 @@ String *StringPool::at(String *str, int index)
     if (index < 0 || index >= len)
         return create("", 0);
 
-    char buf[2] = {str->chars()[index], '\0'};
-    return create(buf, 1);
+    return allocate(str->chars() + index, 1);
 }
 
 // ========================================
@@ -363,12 +461,7 @@ String *StringPool::trim(String *str)
 
     size_t len = end - start + 1;
 
-    //  create() já lida com substring não null-terminated
-    char *temp = (char *)alloca(len + 1);
-    std::memcpy(temp, start, len);
-    temp[len] = '\0';
-
-    return create(temp, len);
+    return allocate(start, len);
 }
 
 // ========================================
@@ -447,7 +540,7 @@ String *StringPool::repeat(String *str, int count)
     }
     temp[totalLen] = '\0';
 
-    String *result = create(temp, totalLen);
+    String *result = allocate(temp, totalLen);
 
     if (!useAlloca)
     {
@@ -465,22 +558,22 @@ String *StringPool::toString(int value)
 {
     char buf[32];
 
-    snprintf(buf, sizeof(buf), "%d", value);
-    return create(buf);
+    int len = snprintf(buf, sizeof(buf), "%d", value);
+    return allocate(buf, len);
 }
 
 String *StringPool::toString(uint32 value)
 {
     char buf[32];
-    snprintf(buf, sizeof(buf), "%u", value);
-    return create(buf);
+    int len = snprintf(buf, sizeof(buf), "%u", value);
+    return allocate(buf, len);
 }
 
 String *StringPool::toString(double value)
 {
     char buf[32];
-    snprintf(buf, sizeof(buf), "%.6f", value);
-    return create(buf);
+    int len = snprintf(buf, sizeof(buf), "%.6f", value);
+    return allocate(buf, len);
 }
 
 // ========================================
@@ -513,13 +606,13 @@ String *StringPool::format(const char *fmt, ...)
         vsnprintf(heap, needed + 1, fmt, args);
         va_end(args);
 
-        String *result = create(heap, needed);
+        String *result = allocate(heap, needed);
         aFree(heap);
 
         return result;
     }
 
-    return create(buffer, len);
+    return allocate(buffer, len);
 }
 
 String *StringPool::getString(int index)
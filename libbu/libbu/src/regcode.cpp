@@ -0,0 +1,649 @@
+#include "regcode.hpp"
+#include "interpreter.hpp"
+#include "opcode.hpp"
+#include "code.hpp"
+
+// ============================================================
+// Tradução stack -> register
+// ============================================================
+// Interpretação abstrata do bytecode com uma stack simbólica: cada entrada
+// diz onde o valor está (o próprio slot, outro slot ou uma constante).
+// Só se emite código quando um valor é consumido, por isso
+// "GET_LOCAL a; GET_LOCAL b; ADD; SET_LOCAL c; POP" vira um único
+// ROP_ADD c, a, b. Antes de saltos, labels e chamadas tudo é
+// materializado no slot canónico (entrada k no slot k).
+
+uint32 RegCode::findResume(uint32 offset, uint16 depth) const
+{
+    int lo = 0, hi = (int)resumes.size() - 1;
+    while (lo <= hi)
+    {
+        int mid = (lo + hi) / 2;
+        const RegResume &r = resumes[mid];
+        if (r.offset == offset)
+            return r.depth == depth ? r.index : REG_NO_RESUME;
+        if (r.offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return REG_NO_RESUME;
+}
+
+// Quickened e superinstructions voltam ao opcode original
+static uint8 baseOpcode(uint8 op)
+{
+    switch (op)
+    {
+    case OP_ADD_II:
+    case OP_ADD_DD:
+        return OP_ADD;
+    case OP_SUBTRACT_II:
+    case OP_SUBTRACT_DD:
+        return OP_SUBTRACT;
+    case OP_MULTIPLY_II:
+    case OP_MULTIPLY_DD:
+        return OP_MULTIPLY;
+    case OP_LESS_II:
+    case OP_LESS_DD:
+        return OP_LESS;
+    case OP_GREATER_II:
+    case OP_GREATER_DD:
+        return OP_GREATER;
+    case OP_INC_LOCAL:
+    case OP_CMP_LOCAL_JUMP:
+        return OP_GET_LOCAL;
+    case OP_INC_PRIVATE:
+        return OP_GET_PRIVATE;
+    default:
+        return op;
+    }
+}
+
+// Tamanho da instrução, ou -1 se o tier não a suporta
+static int supportedLength(uint8 op)
+{
+    switch (op)
+    {
+    case OP_NIL:
+    case OP_TRUE:
+    case OP_FALSE:
+    case OP_POP:
+    case OP_NOT:
+    case OP_DUP:
+    case OP_ADD:
+    case OP_SUBTRACT:
+    case OP_MULTIPLY:
+    case OP_DIVIDE:
+    case OP_NEGATE:
+    case OP_MODULO:
+    case OP_EQUAL:
+    case OP_NOT_EQUAL:
+    case OP_GREATER:
+    case OP_GREATER_EQUAL:
+    case OP_LESS:
+    case OP_LESS_EQUAL:
+    case OP_RETURN:
+    case OP_ATAN2:
+    case OP_POW:
+        return 1;
+    case OP_GET_LOCAL:
+    case OP_SET_LOCAL:
+    case OP_CALL:
+    case OP_DISCARD:
+    case OP_PICK:
+    case OP_SLIDE:
+        return 2;
+    case OP_CONSTANT:
+    case OP_CALL_DIRECT:
+    case OP_GET_GLOBAL:
+    case OP_SET_GLOBAL:
+    case OP_JUMP:
+    case OP_JUMP_IF_FALSE:
+    case OP_JUMP_IF_TRUE:
+    case OP_LOOP:
+        return 3;
+    default:
+        if (op >= OP_SIN && op <= OP_EXP)
+            return 1;
+        return -1;
+    }
+}
+
+static bool isCompare(uint8 op) { return op >= ROP_EQ && op <= ROP_GE; }
+
+class RegTranslator
+{
+    Function *func;
+    Code *chunk;
+    RegCode *out;
+
+    Vector<uint16> stack; // stack simbólica: RK de cada entrada
+    int lastProducer = -1; // instrução cujo destino é o topo (pode ser redirecionada)
+
+    Vector<int> regIndexAt;  // offset -> índice register (-1 = sem label)
+    Vector<int> targetDepth; // offset -> profundidade nos alvos de saltos
+    Vector<uint8> isTarget;
+
+    struct Fixup
+    {
+        uint32 instr;
+        uint32 target;
+    };
+    Vector<Fixup> fixups;
+
+    uint16 nilK, trueK, falseK;
+
+public:
+    RegTranslator(Function *f, RegCode *rc) : func(f), chunk(f->chunk), out(rc) {}
+
+    bool run();
+
+private:
+    uint8 opAt(size_t offset) const { return baseOpcode(chunk->code[offset]); }
+
+    uint16 depth() const { return (uint16)stack.size(); }
+
+    void push(uint16 src)
+    {
+        stack.push(src);
+        if (stack.size() > out->frameSize)
+            out->frameSize = (uint16)stack.size();
+    }
+
+    // Entrada produzida no próprio slot pela última instrução emitida
+    void pushProduced()
+    {
+        push(depth());
+        lastProducer = (int)out->code.size() - 1;
+    }
+
+    int emit(uint8 op, uint8 flag, uint16 a, uint16 b, uint16 c, uint32 offset)
+    {
+        RegInstr in = {op, flag, a, b, c};
+        RegDeopt d;
+        d.offset = offset;
+        d.depth = depth();
+        d.pendingStart = (uint32)out->pending.size();
+        d.pendingCount = 0;
+        for (uint16 k = 0; k < stack.size(); k++)
+        {
+            if (stack[k] != k)
+            {
+                out->pending.push(k);
+                out->pending.push(stack[k]);
+                d.pendingCount++;
+            }
+        }
+        out->code.push(in);
+        out->deopts.push(d);
+        lastProducer = -1;
+        return (int)out->code.size() - 1;
+    }
+
+    void materialize(uint16 k, uint32 offset)
+    {
+        if (stack[k] == k)
+            return;
+        uint16 src = stack[k];
+        stack[k] = k; // a instrução já vê a entrada no sítio
+        emit(ROP_MOVE, 0, k, src, 0, offset);
+    }
+
+    void flush(uint32 offset, uint16 count)
+    {
+        for (uint16 k = 0; k < count; k++)
+            materialize(k, offset);
+    }
+
+    void binary(uint8 op, uint32 offset)
+    {
+        uint16 top = depth() - 1;
+        emit(op, 0, top - 1, stack[top - 1], stack[top], offset);
+        stack.pop();
+        stack.pop();
+        pushProduced();
+    }
+
+    void unary(uint8 op, uint8 flag, uint32 offset)
+    {
+        uint16 top = depth() - 1;
+        emit(op, flag, top, stack[top], 0, offset);
+        stack.pop();
+        pushProduced();
+    }
+
+    bool setLocal(uint16 slot, uint32 offset, uint32 next);
+    bool jumpIfFalse(uint32 offset, uint32 target);
+    bool jumpTo(uint8 op, uint32 offset, uint32 target);
+};
+
+bool RegTranslator::setLocal(uint16 slot, uint32 offset, uint32 next)
+{
+    uint16 top = depth() - 1;
+    if (slot >= top)
+        return false;
+
+    // Entradas logo largadas por POPs seguidos não precisam do valor antigo
+    uint16 live = depth();
+    for (uint32 p = next; p < chunk->count && live > 0 && !isTarget[p] && chunk->code[p] == OP_POP; p++)
+        live--;
+
+    bool hazard = false;
+    for (uint16 j = 0; j < live && j < top; j++)
+    {
+        if (j != slot && stack[j] == slot)
+        {
+            materialize(j, offset);
+            hazard = true;
+        }
+    }
+
+    if (!hazard && lastProducer >= 0 && stack[top] == top && out->code[lastProducer].a == top)
+        out->code[lastProducer].a = slot;
+    else if (stack[top] != slot)
+        emit(ROP_MOVE, 0, slot, stack[top], 0, offset);
+
+    stack[slot] = slot;
+    stack[top] = slot;
+    lastProducer = -1;
+    return true;
+}
+
+bool RegTranslator::jumpTo(uint8 op, uint32 offset, uint32 target)
+{
+    if (target > chunk->count)
+        return false;
+
+    flush(offset, depth());
+    if (targetDepth[target] == -1)
+        targetDepth[target] = depth();
+    else if (targetDepth[target] != depth())
+        return false;
+
+    int idx = emit(op, 0, 0, op == ROP_JMPF ? stack[depth() - 1] : 0, 0, offset);
+    fixups.push({(uint32)idx, target});
+    return true;
+}
+
+bool RegTranslator::jumpIfFalse(uint32 offset, uint32 target)
+{
+    if (target >= chunk->count)
+        return false;
+
+    uint16 top = depth() - 1;
+    bool fuse = lastProducer >= 0 &&
+                lastProducer == (int)out->code.size() - 1 &&
+                isCompare(out->code[lastProducer].op) &&
+                out->code[lastProducer].a == top &&
+                opAt(offset + 3) == OP_POP &&
+                opAt(target) == OP_POP;
+
+    if (!fuse)
+        return jumpTo(ROP_JMPF, offset, target);
+
+    // O bool nunca é lido (os dois caminhos começam com POP): o compare
+    // passa a ser o próprio salto e o slot do topo fica por escrever.
+    RegInstr cmp = out->code[lastProducer];
+    RegDeopt d = out->deopts[lastProducer];
+    out->code.pop();
+    out->deopts.pop();
+
+    flush(offset, top);
+    if (targetDepth[target] == -1)
+        targetDepth[target] = depth();
+    else if (targetDepth[target] != depth())
+        return false;
+
+    uint8 op = (uint8)(ROP_JEQ + (cmp.op - ROP_EQ));
+    out->code.push({op, cmp.flag, 0, cmp.b, cmp.c});
+    out->deopts.push(d);
+    fixups.push({(uint32)out->code.size() - 1, target});
+    lastProducer = -1;
+    return true;
+}
+
+bool RegTranslator::run()
+{
+    size_t count = chunk->count;
+
+    // Constantes: as do chunk + nil/true/false
+    size_t nConst = chunk->constants.size();
+    if (nConst + 3 >= REG_K)
+        return false;
+    for (size_t i = 0; i < nConst; i++)
+        out->constants.push(chunk->constants[i]);
+    nilK = (uint16)(REG_K | out->constants.size());
+    out->constants.push(Value());
+    trueK = (uint16)(REG_K | out->constants.size());
+    out->constants.push(Value::fromBool(true));
+    falseK = (uint16)(REG_K | out->constants.size());
+    out->constants.push(Value::fromBool(false));
+
+    // Pass 1: tudo suportado? onde estão os alvos dos saltos?
+    isTarget.resize(count + 1);
+    regIndexAt.resize(count + 1);
+    targetDepth.resize(count + 1);
+    for (size_t i = 0; i <= count; i++)
+    {
+        isTarget[i] = 0;
+        regIndexAt[i] = -1;
+        targetDepth[i] = -1;
+    }
+
+    for (size_t off = 0; off < count;)
+    {
+        uint8 op = opAt(off);
+        int len = supportedLength(op);
+        if (len < 0 || off + len > count)
+            return false;
+        if (op == OP_JUMP || op == OP_JUMP_IF_FALSE || op == OP_JUMP_IF_TRUE || op == OP_LOOP)
+        {
+            uint16 jump = (uint16)((chunk->code[off + 1] << 8) | chunk->code[off + 2]);
+            long target = (op == OP_LOOP) ? (long)(off + 3) - jump : (long)(off + 3) + jump;
+            if (target < 0 || target > (long)count)
+                return false;
+            isTarget[target] = 1;
+        }
+        off += len;
+    }
+
+    // Pass 2: tradução
+    for (uint16 i = 0; i <= func->arity; i++)
+        push(i);
+
+    bool reachable = true;
+    long directAt = -1; // último OP_CALL_DIRECT
+    for (size_t off = 0; off < count;)
+    {
+        uint32 offset = (uint32)off;
+        uint8 op = opAt(off);
+        int len = supportedLength(op);
+        uint32 next = offset + len;
+
+        if (isTarget[off])
+        {
+            if (reachable)
+            {
+                flush(offset, depth());
+                if (targetDepth[off] == -1)
+                    targetDepth[off] = depth();
+                else if (targetDepth[off] != depth())
+                    return false;
+            }
+            else
+            {
+                // Só alcançado por um salto para trás ainda não visto (ex.: o
+                // increment do for): assume a profundidade do salto anterior,
+                // o LOOP confirma em jumpTo()
+                if (targetDepth[off] == -1)
+                    targetDepth[off] = depth();
+                stack.clear();
+                for (int k = 0; k < targetDepth[off]; k++)
+                    push((uint16)k);
+                reachable = true;
+            }
+            lastProducer = -1;
+            regIndexAt[off] = (int)out->code.size();
+        }
+
+        if (!reachable)
+        {
+            off = next;
+            continue;
+        }
+
+        const uint8 *arg = chunk->code + off + 1;
+        uint16 top = depth() - 1;
+
+        switch (op)
+        {
+        case OP_CONSTANT:
+        {
+            uint16 index = (uint16)((arg[0] << 8) | arg[1]);
+            push((uint16)(REG_K | index));
+            lastProducer = -1;
+            break;
+        }
+        case OP_NIL:
+            push(nilK);
+            lastProducer = -1;
+            break;
+        case OP_TRUE:
+            push(trueK);
+            lastProducer = -1;
+            break;
+        case OP_FALSE:
+            push(falseK);
+            lastProducer = -1;
+            break;
+
+        case OP_POP:
+            if (depth() == 0)
+                return false;
+            stack.pop();
+            lastProducer = -1;
+            break;
+        case OP_DISCARD:
+            if (arg[0] > depth())
+                return false;
+            for (int k = 0; k < arg[0]; k++)
+                stack.pop();
+            lastProducer = -1;
+            break;
+        case OP_DUP:
+            if (depth() == 0)
+                return false;
+            push(stack[top]);
+            lastProducer = -1;
+            break;
+        case OP_PICK:
+            if (arg[0] >= depth())
+                return false;
+            push(stack[top - arg[0]]);
+            lastProducer = -1;
+            break;
+        case OP_SLIDE:
+        {
+            // Resultado de uma função inlined desce para o slot do callee
+            if (arg[0] >= depth())
+                return false;
+            uint16 result = stack[top];
+            bool produced = lastProducer >= 0 && result == top && out->code[lastProducer].a == top;
+            for (int k = 0; k <= arg[0]; k++)
+                stack.pop();
+            uint16 slot = depth();
+            if (produced)
+            {
+                out->code[lastProducer].a = slot;
+                push(slot);
+            }
+            else
+            {
+                push(result);
+                if (!REG_IS_K(result) && result > slot)
+                    materialize(slot, offset);
+            }
+            lastProducer = -1;
+            break;
+        }
+
+        case OP_GET_LOCAL:
+            if (arg[0] >= depth())
+                return false;
+            push(stack[arg[0]]);
+            lastProducer = -1;
+            break;
+        case OP_SET_LOCAL:
+            if (depth() == 0 || !setLocal(arg[0], offset, next))
+                return false;
+            break;
+
+        case OP_GET_GLOBAL:
+            emit(ROP_GETG, 0, depth(), (uint16)((arg[0] << 8) | arg[1]), 0, offset);
+            pushProduced();
+            break;
+        case OP_SET_GLOBAL:
+            if (depth() == 0)
+                return false;
+            emit(ROP_SETG, 0, (uint16)((arg[0] << 8) | arg[1]), stack[top], 0, offset);
+            break;
+
+        case OP_ADD:
+        case OP_SUBTRACT:
+        case OP_MULTIPLY:
+        case OP_DIVIDE:
+        case OP_MODULO:
+        case OP_EQUAL:
+        case OP_NOT_EQUAL:
+        case OP_LESS:
+        case OP_LESS_EQUAL:
+        case OP_GREATER:
+        case OP_GREATER_EQUAL:
+        case OP_ATAN2:
+        case OP_POW:
+        {
+            if (depth() < 2)
+                return false;
+            uint8 rop;
+            switch (op)
+            {
+            case OP_ADD: rop = ROP_ADD; break;
+            case OP_SUBTRACT: rop = ROP_SUB; break;
+            case OP_MULTIPLY: rop = ROP_MUL; break;
+            case OP_DIVIDE: rop = ROP_DIV; break;
+            case OP_MODULO: rop = ROP_MOD; break;
+            case OP_EQUAL: rop = ROP_EQ; break;
+            case OP_NOT_EQUAL: rop = ROP_NE; break;
+            case OP_LESS: rop = ROP_LT; break;
+            case OP_LESS_EQUAL: rop = ROP_LE; break;
+            case OP_GREATER: rop = ROP_GT; break;
+            case OP_GREATER_EQUAL: rop = ROP_GE; break;
+            default: rop = ROP_MATH2; break;
+            }
+            binary(rop, offset);
+            if (rop == ROP_MATH2)
+                out->code.back().flag = op;
+            break;
+        }
+
+        case OP_NEGATE:
+            if (depth() == 0)
+                return false;
+            unary(ROP_NEG, 0, offset);
+            break;
+        case OP_NOT:
+            if (depth() == 0)
+                return false;
+            // NOT de um compare acabado de emitir: só inverte o resultado
+            if (lastProducer >= 0 && isCompare(out->code[lastProducer].op) && out->code[lastProducer].a == top)
+                out->code[lastProducer].flag ^= 1;
+            else
+                unary(ROP_NOT, 0, offset);
+            break;
+
+        case OP_JUMP:
+        case OP_LOOP:
+        {
+            uint16 jump = (uint16)((arg[0] << 8) | arg[1]);
+            uint32 target = (op == OP_LOOP) ? next - jump : next + jump;
+            if (!jumpTo(ROP_JMP, offset, target))
+                return false;
+            reachable = false;
+            break;
+        }
+        case OP_JUMP_IF_FALSE:
+        {
+            if (depth() == 0)
+                return false;
+            uint16 jump = (uint16)((arg[0] << 8) | arg[1]);
+            if (!jumpIfFalse(offset, next + jump))
+                return false;
+            break;
+        }
+        case OP_JUMP_IF_TRUE:
+        {
+            // NOT + JUMP_IF_FALSE do peephole: os dois destinos fazem POP,
+            // por isso o valor negado no slot do topo nunca é lido
+            if (depth() == 0)
+                return false;
+            if (lastProducer >= 0 && isCompare(out->code[lastProducer].op) && out->code[lastProducer].a == top)
+                out->code[lastProducer].flag ^= 1;
+            else
+                unary(ROP_NOT, 0, offset);
+            uint16 jump = (uint16)((arg[0] << 8) | arg[1]);
+            if (!jumpIfFalse(offset, next + jump))
+                return false;
+            break;
+        }
+
+        case OP_CALL_DIRECT:
+            // Prefixo sem efeito na stack: o OP_CALL seguinte sai por aqui
+            directAt = (long)offset;
+            break;
+
+        case OP_CALL:
+        {
+            uint8 argc = arg[0];
+            if (argc + 1 > depth())
+                return false;
+            uint16 callee = depth() - argc - 1;
+            uint32 exitAt = (directAt >= 0 && (uint32)directAt + 3 == offset) ? (uint32)directAt : offset;
+            flush(exitAt, depth());
+            emit(ROP_CALL, argc, callee, 0, 0, exitAt);
+            for (int k = 0; k <= argc; k++)
+                stack.pop();
+            push(callee);
+            out->resumes.push({next, (uint32)out->code.size(), depth()});
+            break;
+        }
+
+        case OP_RETURN:
+            if (depth() == 0)
+                return false;
+            emit(ROP_RET, 0, top, stack[top], 0, offset);
+            reachable = false;
+            break;
+
+        default:
+            if (op >= OP_SIN && op <= OP_EXP)
+            {
+                if (depth() == 0)
+                    return false;
+                unary(ROP_MATH1, op, offset);
+                break;
+            }
+            return false;
+        }
+
+        off = next;
+    }
+
+    if (reachable)
+        return false; // o compilador termina sempre com RETURN
+
+    for (size_t i = 0; i < fixups.size(); i++)
+    {
+        int index = regIndexAt[fixups[i].target];
+        if (index < 0)
+            return false;
+        out->code[fixups[i].instr].a = (uint16)index;
+    }
+
+    return out->code.size() < 0xFFFF;
+}
+
+RegCode *RegCode::translate(Function *func)
+{
+    if (!func || !func->chunk || func->upvalueCount > 0)
+        return nullptr;
+
+    RegCode *rc = new RegCode();
+    RegTranslator translator(func, rc);
+    if (!translator.run())
+    {
+        delete rc;
+        return nullptr;
+    }
+    return rc;
+}
@@ -0,0 +1,100 @@
+#include "slab.hpp"
+#include <cstring>
+
+SlabPool::SlabPool()
+{
+	m_slotSize = 0;
+	m_slabs = nullptr;
+	m_slabCount = 0;
+	m_freeList = nullptr;
+	m_live = 0;
+	m_regionNext = nullptr;
+	m_regionLeft = 0;
+	m_regions = nullptr;
+	m_regionCount = 0;
+	m_regionCapacity = 0;
+}
+
+SlabPool::~SlabPool()
+{
+	clear();
+}
+
+void SlabPool::init(size_t objectSize)
+{
+	assert(m_slabs == nullptr);
+	size_t size = (objectSize + 15) & ~(size_t)15;
+	if (size < SLAB_MIN_SLOT)
+		size = SLAB_MIN_SLOT;
+	m_slotSize = size;
+}
+
+void SlabPool::grow()
+{
+	assert(m_slotSize > 0);
+
+	if (m_regionLeft == 0)
+	{
+		if (m_regionCount == m_regionCapacity)
+		{
+			m_regionCapacity = m_regionCapacity ? m_regionCapacity * 2 : 8;
+			m_regions = (void **)aRealloc(m_regions, m_regionCapacity * sizeof(void *));
+		}
+		// Um slab a mais para poder alinhar o início a SLAB_SIZE
+		char *raw = (char *)aAlloc((SLABS_PER_REGION + 1) * SLAB_SIZE);
+		m_regions[m_regionCount++] = raw;
+		uintptr_t aligned = ((uintptr_t)raw + SLAB_SIZE - 1) & ~(uintptr_t)(SLAB_SIZE - 1);
+		m_regionNext = (char *)aligned;
+		m_regionLeft = SLABS_PER_REGION;
+	}
+
+	Slab *slab = (Slab *)m_regionNext;
+	m_regionNext += SLAB_SIZE;
+	m_regionLeft--;
+
+	size_t header = (sizeof(Slab) + 15) & ~(size_t)15;
+	std::memset(slab, 0, sizeof(Slab));
+	slab->pool = this;
+	slab->slots = (char *)slab + header;
+	slab->slotSize = (uint32)m_slotSize;
+	slab->slotCount = (uint32)((SLAB_SIZE - header) / m_slotSize);
+	slab->slotMagic = (uint32)(0xFFFFFFFFu / m_slotSize + 1);
+	slab->liveCount = 0;
+
+	// À cabeça: um sweep a meio não passa por ele, mas o que nasce durante o
+	// sweep já vem marcado
+	slab->next = m_slabs;
+	m_slabs = slab;
+	m_slabCount++;
+
+	// Free list pela ordem dos endereços
+	for (size_t i = slab->slotCount; i-- > 0;)
+	{
+		SlabFreeSlot *slot = (SlabFreeSlot *)(slab->slots + i * m_slotSize);
+		slot->next = m_freeList;
+		m_freeList = slot;
+	}
+}
+
+void SlabPool::clearMarks()
+{
+	for (Slab *slab = m_slabs; slab; slab = slab->next)
+		std::memset(slab->marks, 0, sizeof(slab->marks));
+}
+
+void SlabPool::clear()
+{
+	for (size_t i = 0; i < m_regionCount; i++)
+		aFree(m_regions[i]);
+	aFree(m_regions);
+
+	m_slabs = nullptr;
+	m_slabCount = 0;
+	m_freeList = nullptr;
+	m_live = 0;
+	m_regionNext = nullptr;
+	m_regionLeft = 0;
+	m_regions = nullptr;
+	m_regionCount = 0;
+	m_regionCapacity = 0;
+}
@@ -1,22 +1,35 @@
 #include "token.hpp"
+#include "string.hpp"
 #include <sstream>
 
 Token::Token()
 {
     type = TOKEN_EOF;
-    lexeme = "";
+    start = "";
+    length = 0;
+    str = nullptr;
     line = 0;
     column = 0;
 }
 
-Token::Token(TokenType t, const std::string &lex, int l, int c)
-    : type(t), lexeme(lex), line(l), column(c) {}
+Token::Token(TokenType t, const char *s, uint32_t len, int l, int c, String *interned)
+    : type(t), start(s), length(len), str(interned), line(l), column(c) {}
+
+const char *Token::chars() const
+{
+    return str ? str->chars() : "";
+}
+
+std::string Token::text() const
+{
+    return std::string(start, length);
+}
 
 std::string Token::toString() const
 {
     std::ostringstream oss;
     oss << "Token(" << tokenTypeToString(type)
-        << ", '" << lexeme << "', " << locationString() << ")";
+        << ", '" << text() << "', " << locationString() << ")";
     return oss.str();
 }
 
@@ -48,6 +61,8 @@ const char *tokenTypeToString(TokenType type)
 
     case TOKEN_VAR:
         return "VAR";
+    case TOKEN_CONST:
+        return "CONST";
     case TOKEN_DEF:
         return "DEF";
     case TOKEN_IF:
@@ -10,10 +10,6 @@
 #include "platform.hpp"
 #include <stdarg.h>
 
-Value::Value() : type(ValueType::NIL)
-{
-    as.byte = 0;
-}
 
  
 
@@ -103,32 +99,32 @@ const char *valueTypeToString(ValueType type)
 
 void printValue(const Value &value)
 {
-    switch (value.type)
+    switch (value.getType())
     {
     case ValueType::NIL:
         OsPrintf("nil");
         break;
     case ValueType::BOOL:
-        OsPrintf("%s", value.as.boolean ? "true" : "false");
+        OsPrintf("%s", value.asBool() ? "true" : "false");
         break;
     case ValueType::BYTE:
-        OsPrintf("%d", value.as.byte);
+        OsPrintf("%d", value.asByte());
         break;
     case ValueType::INT:
-        OsPrintf("%d", value.as.integer);
+        OsPrintf("%d", value.asInt());
         break;
     case ValueType::UINT:
-        OsPrintf("%u", value.as.unsignedInteger);
+        OsPrintf("%u", value.asUInt());
         break;
     case ValueType::FLOAT:
-        OsPrintf("%.4f", value.as.real);
+        OsPrintf("%.4f", value.asFloat());
         break;
     case ValueType::DOUBLE:
-        OsPrintf("%.4f", value.as.number);
+        OsPrintf("%.4f", value.asDouble());
         break;
     case ValueType::STRING:
     {
-        String *str = value.as.string;
+        String *str = value.asString();
         const char *chars = str->chars();
         size_t len = str->length();
 
@@ -206,7 +202,7 @@ void printValue(const Value &value)
     }
     case ValueType::STRUCTINSTANCE:
     {
-        StructInstance *instance = value.as.sInstance;
+        StructInstance *instance = value.asStructInstance();
         OsPrintf("struct '%s' [", instance->def->name->chars());
 
         bool first = true;
@@ -239,25 +235,25 @@ void printValue(const Value &value)
     }
     case ValueType::NATIVECLASSINSTANCE:
     {
-        NativeClassInstance *inst = value.as.sClassInstance;
+        NativeClassInstance *inst = value.asNativeClassInstance();
         OsPrintf("<native_instance %s>", inst->klass->name->chars());
         break;
     }
     case ValueType::NATIVESTRUCTINSTANCE:
     {
-        NativeStructInstance *inst = value.as.sNativeStruct;
+        NativeStructInstance *inst = value.asNativeStructInstance();
         OsPrintf("<native_struct_instance %s>", inst->def->name->chars());
         break;
     }
     case ValueType::POINTER:
     {
 
-        OsPrintf("<pointer %p>", value.as.pointer);
+        OsPrintf("<pointer %p>", value.asPointer());
         break;
     }
     case ValueType::MODULEREFERENCE:
     {
-        OsPrintf("<module_reference %d %d %d>", value.as.unsignedInteger >> 24, (value.as.unsignedInteger >> 12) & 0xFFF, value.as.unsignedInteger & 0xFFF);
+        OsPrintf("<module_reference %d %d %d>", value.asModuleRef() >> 24, (value.asModuleRef() >> 12) & 0xFFF, value.asModuleRef() & 0xFFF);
         break;
     }
     case ValueType::NATIVESTRUCT:
@@ -278,7 +274,7 @@ void printValue(const Value &value)
  
     default:
     {
-        const char* str = valueTypeToString(value.type);
+        const char* str = valueTypeToString(value.getType());
         OsPrintf("<?%s?>", str);
         break;
     }
@@ -293,31 +289,31 @@ void printValueNl(const Value &value)
 
 void valueToBuffer(const Value &v, char *out, size_t size)
 {
-    switch (v.type)
+    switch (v.getType())
     {
     case ValueType::NIL:
         snprintf(out, size, "nil");
         break;
     case ValueType::BOOL:
-        snprintf(out, size, "%s", v.as.boolean ? "true" : "false");
+        snprintf(out, size, "%s", v.asBool() ? "true" : "false");
         break;
     case ValueType::BYTE:
-        snprintf(out, size, "%u", v.as.byte);
+        snprintf(out, size, "%u", v.asByte());
         break;
     case ValueType::INT:
-        snprintf(out, size, "%d", v.as.integer);
+        snprintf(out, size, "%d", v.asInt());
         break;
     case ValueType::UINT:
-        snprintf(out, size, "%u", v.as.unsignedInteger);
+        snprintf(out, size, "%u", v.asUInt());
         break;
     case ValueType::FLOAT:
-        snprintf(out, size, "%.4f", v.as.real);
+        snprintf(out, size, "%.4f", v.asFloat());
         break;
     case ValueType::DOUBLE:
-        snprintf(out, size, "%.4f", v.as.number);
+        snprintf(out, size, "%.4f", v.asDouble());
         break;
     case ValueType::STRING:
-        snprintf(out, size, "%s", v.as.string->chars());
+        snprintf(out, size, "%s", v.asString()->chars());
         break;
     case ValueType::ARRAY:
         snprintf(out, size, "[array]");
@@ -325,7 +325,7 @@ namespace Bindings
             heur);
 
         Value value = vm->makeArray();
-        ArrayInstance *arr = value.as.array;
+        ArrayInstance *arr = value.asArray();
         for (size_t i = 0; i < path.size(); i++)
         {
             Vector2 point = path[i];
@@ -981,7 +981,7 @@ namespace Bindings
 
         int targetBlueprint = args[0].asInt();
         Value arr = vm->makeArray();
-        ArrayInstance *array = arr.as.array;
+        ArrayInstance *array = arr.asArray();
 
         const auto &alive = vm->getAliveProcesses();
         for (size_t i = 0; i < alive.size(); i++)
@@ -98,6 +98,9 @@ bool CAN_RESIZE = true;
 bool CAN_CLOSE = false;
 Color BACKGROUND_COLOR = BLACK;
 
+// Tempo por frame para o GC incremental (vm.gcStep), em microsegundos
+int GC_FRAME_BUDGET_US = 1000;
+
 // ============================================================
 // Native Functions for Script Configuration
 // ============================================================
@@ -428,6 +431,10 @@ int main(int argc, char *argv[])
     std::ifstream file(scriptFile);
     std::string code((std::istreambuf_iterator<char>(file)),
                      std::istreambuf_iterator<char>());
+
+    // Bytecode cache ao lado do script (main.bu -> main.buc)
+    std::string cachePath = std::string(scriptFile) + "c";
+    vm.setBytecodeCache(cachePath.c_str());
     SetTraceLogLevel(LOG_NONE);
     InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_TITLE.c_str());
     SetExitKey(KEY_NULL); // Disable default ESC exit from Raylib.
@@ -503,6 +510,7 @@ int main(int argc, char *argv[])
         gParticleSystem.update(dt);
         BindingsDraw::resetDrawCommands();
         vm.update(dt);
+        vm.gcStep(GC_FRAME_BUDGET_US);
         RenderScene();
         gParticleSystem.cleanup();
         gParticleSystem.draw();
@@ -15,6 +15,21 @@ namespace BindingsMessage
 
     static std::unordered_map<uint32, std::deque<Message>> messages;
 
+    // As mensagens em fila guardam Values (strings de runtime, arrays...) que
+    // só existem aqui até ao pop: são roots do GC
+    static void markMessages(Interpreter *vm, void *userdata)
+    {
+        (void)userdata;
+        for (auto &entry : messages)
+        {
+            for (const Message &msg : entry.second)
+            {
+                vm->markRootValue(msg.type);
+                vm->markRootValue(msg.data);
+            }
+        }
+    }
+
 
     int native_send(Interpreter *vm, Process *proc, int argCount, Value *args)
     {
@@ -100,7 +115,7 @@ namespace BindingsMessage
         {
             for (const Message &msg : it->second)
             {
-                if (msg.type.type == args[0].type)
+                if (msg.type.getType() == args[0].getType())
                 {
                     vm->pushBool(true);
                     return 1;
@@ -230,5 +245,6 @@ namespace BindingsMessage
         vm.registerNativeProcess("pop_ex_message", native_pop_ex_message, 0);
         vm.registerNativeProcess("count_messages", native_count_messages, 0);
         vm.registerNativeProcess("peek_message", native_peek_message, 1);
+        vm.addGCRootMarker(markMessages);
     }
 }
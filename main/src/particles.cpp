@@ -552,7 +552,7 @@ namespace BindingsParticles
         float x = (float)args[0].asNumber();
         float y = (float)args[1].asNumber();
         int graph = (int)args[2].asInt();
-        bool facingRight = args[3].as.boolean;
+        bool facingRight = args[3].asBool();
 
         Emitter *emitter = gParticleSystem.createShellEjection({x, y}, graph, facingRight);
        
@@ -590,7 +590,7 @@ namespace BindingsParticles
             vm->pushNil();
             return 1;
         }
-        bool persistent = args[0].as.boolean;
+        bool persistent = args[0].asBool();
         int graph = (int)args[1].asInt();
         int maxParticles = (int)args[2].asInt();
         EmitterType type = persistent ? EMITTER_CONTINUOUS : EMITTER_ONESHOT;
@@ -634,7 +634,7 @@ namespace BindingsParticles
         float x = (float)args[0].asNumber();
         float y = (float)args[1].asNumber();
         int graph = (int)args[2].asInt();
-        bool facingRight = args[3].as.boolean;
+        bool facingRight = args[3].asBool();
         
 
         Emitter *emitter = gParticleSystem.createLandingDust({x, y}, graph,  facingRight);
@@ -675,7 +675,7 @@ namespace BindingsParticles
         float x = (float)args[0].asNumber();
         float y = (float)args[1].asNumber();
         int graph = (int)args[2].asInt();
-        bool hitFromLeft = args[3].as.boolean;
+        bool hitFromLeft = args[3].asBool();
         float size_start = (float)args[4].asNumber();
         float size_end = (float)args[5].asNumber();
 
@@ -1054,7 +1054,7 @@ namespace BindingsParticles
                 vm->pushNil();
                 return nullptr;
             }
-            bool persistent = args[0].as.boolean;
+            bool persistent = args[0].asBool();
             int graph = (int)args[1].asInt();
             int maxParticles = (int)args[2].asInt();
             EmitterType type = persistent ? EMITTER_CONTINUOUS : EMITTER_ONESHOT;
@@ -441,7 +441,7 @@ namespace BindingsProcess
         }
         if (!args[0].isProcessInstance())
         {
-            Error("atach expects 1 integer argument (childProcID)  get %s", valueTypeToString(args[0].type));
+            Error("atach expects 1 integer argument (childProcID)  get %s", valueTypeToString(args[0].getType()));
             return 0;
         }
 
@@ -408,7 +408,7 @@ static int native_make_range(Interpreter *vm, int argCount, Value *args)
     int end = (int)args[1].asNumber();
 
     Value arrVal = vm->makeArray();
-    ArrayInstance *arr = arrVal.as.array;
+    ArrayInstance *arr = arrVal.asArray();
     for (int i = start; i < end; i++)
     {
         arr->values.push(vm->makeInt(i));
@@ -430,7 +430,7 @@ static int native_make_info(Interpreter *vm, int argCount, Value *args)
     }
 
     Value mapVal = vm->makeMap();
-    MapInstance *map = mapVal.as.map;
+    MapInstance *map = mapVal.asMap();
     map->table.set(vm->createString("name"), args[0]);
     map->table.set(vm->createString("age"), args[1]);
     vm->push(mapVal);
@@ -459,6 +459,57 @@ static int native_proc_ping(Interpreter *vm, Process *proc, int argCount, Value
     return 1;
 }
 
+// ============================================================
+// Compile-error test: compiles source in a separate VM
+// native_compiles(src) -> true if it compiles, false on error
+// ============================================================
+static int native_compiles(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isString())
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+
+    std::string source = args[0].asStringChars();
+    Interpreter other;
+    other.registerAll();
+    vm->pushBool(other.compile(source.c_str(), false));
+    return 1;
+}
+
+// ============================================================
+// Host roots test: values kept only on the C++ side, marked through
+// addGCRootMarker (como as filas de mensagens do main)
+// native_keep(v) -> index, native_kept(i) -> v
+// ============================================================
+static std::vector<Value> hostKept;
+
+static void markHostKept(Interpreter *vm, void *userdata)
+{
+    for (size_t i = 0; i < hostKept.size(); i++)
+        vm->markRootValue(hostKept[i]);
+}
+
+static int native_keep(Interpreter *vm, int argCount, Value *args)
+{
+    hostKept.push_back(argCount > 0 ? args[0] : vm->makeNil());
+    vm->push(vm->makeInt((int)hostKept.size() - 1));
+    return 1;
+}
+
+static int native_kept(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isNumber() || args[0].asInt() < 0 ||
+        (size_t)args[0].asInt() >= hostKept.size())
+    {
+        vm->pushNil();
+        return 1;
+    }
+    vm->push(hostKept[args[0].asInt()]);
+    return 1;
+}
+
 // ============================================================
 // Register all test native bindings
 // ============================================================
@@ -474,6 +525,13 @@ static void registerTestBindings(Interpreter &vm)
     vm.registerNative("native_make_range", native_make_range, 2);
     vm.registerNative("native_make_info", native_make_info, 2);
     vm.registerNativeProcess("native_proc_ping", native_proc_ping, 1);
+    vm.registerNative("native_compiles", native_compiles, 1);
+
+    // --- Host roots ---
+    hostKept.clear();
+    vm.addGCRootMarker(markHostKept);
+    vm.registerNative("native_keep", native_keep, 1);
+    vm.registerNative("native_kept", native_kept, 1);
 
     // --- Native Struct: Point ---
     auto *point = vm.registerNativeStruct("Point", sizeof(TestPoint), point_ctor);
@@ -501,6 +559,18 @@ static void registerTestBindings(Interpreter &vm)
 // Run a single script in-process
 // Returns: 0=OK, 1=compile/runtime error
 // ============================================================
+static void setupVM(Interpreter &vm, FileLoaderContext &ctx)
+{
+    vm.registerAll();
+    registerTestBindings(vm);
+
+    ctx.searchPaths[0] = "scripts";
+    ctx.searchPaths[1] = "scripts/test";
+    ctx.searchPaths[2] = ".";
+    ctx.pathCount = 3;
+    vm.setFileLoader(multiPathFileLoader, &ctx);
+}
+
 static int runScript(const char *path)
 {
     std::string code = loadFile(path);
@@ -511,17 +581,55 @@ static int runScript(const char *path)
     }
 
     Interpreter vm;
-    vm.registerAll();
-    registerTestBindings(vm);
+    FileLoaderContext ctx;
+    setupVM(vm, ctx);
+
+    bool ok = vm.run(code.c_str(), false);
+    return ok ? 0 : 1;
+}
+
+// ============================================================
+// Bytecode cache round-trip: compile + save .buc in one VM, then
+// run() a fresh VM that must load it instead of compiling
+// ============================================================
+static int runScriptFromCache(const char *path)
+{
+    std::string code = loadFile(path);
+    if (code.empty())
+    {
+        fprintf(stderr, "  Could not read: %s\n", path);
+        return 1;
+    }
+
+    char cachePath[64];
+    snprintf(cachePath, sizeof(cachePath), "/tmp/bu_test_%d.buc", (int)getpid());
+
+    {
+        Interpreter vm;
+        FileLoaderContext ctx;
+        setupVM(vm, ctx);
+        if (!vm.compile(code.c_str(), false) || !vm.saveBytecode(cachePath, code.c_str()))
+        {
+            fprintf(stderr, "  Could not write bytecode cache\n");
+            remove(cachePath);
+            return 1;
+        }
+    }
 
+    Interpreter vm;
     FileLoaderContext ctx;
-    ctx.searchPaths[0] = "scripts";
-    ctx.searchPaths[1] = "scripts/test";
-    ctx.searchPaths[2] = ".";
-    ctx.pathCount = 3;
-    vm.setFileLoader(multiPathFileLoader, &ctx);
+    setupVM(vm, ctx);
+    vm.setBytecodeCache(cachePath);
 
     bool ok = vm.run(code.c_str(), false);
+    bool hit = vm.isBytecodeCacheHit();
+    remove(cachePath);
+
+    if (!hit)
+    {
+        fprintf(stderr, "  Bytecode cache was not used\n");
+        return 1;
+    }
     return ok ? 0 : 1;
 }
 
@@ -529,7 +637,7 @@ static int runScript(const char *path)
 // Run in child process to catch crashes/segfaults
 // Returns: 0=OK, 1=error, 2=crash, 3=timeout
 // ============================================================
-static int runScriptSafe(const char *path, bool verbose, int timeoutSecs)
+static int runScriptSafe(const char *path, int (*runner)(const char *), bool verbose, int timeoutSecs)
 {
     fflush(stdout);
     fflush(stderr);
@@ -549,7 +657,7 @@ static int runScriptSafe(const char *path, bool verbose, int timeoutSecs)
             freopen("/dev/null", "w", stdout);
             freopen("/dev/null", "w", stderr);
         }
-        int result = runScript(path);
+        int result = runner(path);
         _exit(result);
     }
 
@@ -595,6 +703,7 @@ static void usage(const char *prog)
     printf("Usage: %s [options] [file.bu | directory]\n\n", prog);
     printf("  -v          Verbose (show script output)\n");
     printf("  -t <secs>   Timeout per test (default: 5)\n");
+    printf("  -b          Skip the bytecode cache (.buc) round-trip pass\n");
     printf("  -h          Help\n\n");
     printf("Default: runs all scripts/test/*.bu\n");
 }
@@ -602,6 +711,7 @@ static void usage(const char *prog)
 int main(int argc, char *argv[])
 {
     bool verbose = false;
+    bool cachePass = true;
     int timeout = 5;
     const char *target = nullptr;
 
@@ -609,6 +719,7 @@ int main(int argc, char *argv[])
     {
         if (strcmp(argv[i], "-v") == 0)                       verbose = true;
         else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)  timeout = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-b") == 0)                  cachePass = false;
         else if (strcmp(argv[i], "-h") == 0)                  { usage(argv[0]); return 0; }
         else                                                   target = argv[i];
     }
@@ -643,35 +754,54 @@ int main(int argc, char *argv[])
     int passed = 0, failed = 0, crashed = 0, timedout = 0;
     std::vector<std::string> failedNames;
 
-    for (auto &file : files)
+    struct Pass
     {
-        std::string name = getBasename(file);
-        printf("  %-45s", name.c_str());
-        fflush(stdout);
+        const char *title;
+        const char *tag;
+        int (*runner)(const char *);
+    };
+    const Pass passes[] = {
+        {nullptr, "", runScript},
+        {"Bytecode cache round-trip (.buc)", " [buc]", runScriptFromCache},
+    };
+    int passCount = cachePass ? 2 : 1;
 
-        int result = runScriptSafe(file.c_str(), verbose, timeout);
+    for (int p = 0; p < passCount; p++)
+    {
+        if (passes[p].title)
+            printf("\n" C_CYAN "%s" C_RESET "\n", passes[p].title);
 
-        switch (result)
+        for (auto &file : files)
         {
-        case 0:
-            printf(C_GREEN "PASS" C_RESET "\n");
-            passed++;
-            break;
-        case 1:
-            printf(C_RED "FAIL" C_RESET "\n");
-            failed++;
-            failedNames.push_back(name);
-            break;
-        case 2:
-            printf(C_RED "CRASH" C_RESET "\n");
-            crashed++;
-            failedNames.push_back(name + " (CRASH)");
-            break;
-        case 3:
-            printf(C_YELLOW "TIMEOUT" C_RESET " (>%ds)\n", timeout);
-            timedout++;
-            failedNames.push_back(name + " (TIMEOUT)");
-            break;
+            std::string name = getBasename(file);
+            printf("  %-45s", name.c_str());
+            fflush(stdout);
+
+            int result = runScriptSafe(file.c_str(), passes[p].runner, verbose, timeout);
+            name += passes[p].tag;
+
+            switch (result)
+            {
+            case 0:
+                printf(C_GREEN "PASS" C_RESET "\n");
+                passed++;
+                break;
+            case 1:
+                printf(C_RED "FAIL" C_RESET "\n");
+                failed++;
+                failedNames.push_back(name);
+                break;
+            case 2:
+                printf(C_RED "CRASH" C_RESET "\n");
+                crashed++;
+                failedNames.push_back(name + " (CRASH)");
+                break;
+            case 3:
+                printf(C_YELLOW "TIMEOUT" C_RESET " (>%ds)\n", timeout);
+                timedout++;
+                failedNames.push_back(name + " (TIMEOUT)");
+                break;
+            }
         }
     }
 